@@ -0,0 +1,102 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file logm_performance_main.c
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <tinyara/arch.h>
+#include <tinyara/logm.h>
+
+#define LOGM_PERF_BURSTS    50
+#define LOGM_PERF_BURSTLEN  16
+#define LOGM_PERF_INTERVAL  10	/* ms */
+
+static uint32_t logm_perf_to_ns(uint32_t cycles)
+{
+	return (uint32_t)((uint64_t)cycles * 1000000000 / up_perf_getfreq());
+}
+
+static void logm_perf_run(const char *name, int deferred)
+{
+	uint32_t start;
+	uint32_t elapsed;
+	uint32_t total = 0;
+	uint32_t max = 0;
+	int irqoff_max;
+	int irqoff_avg;
+	int burst;
+	int i;
+
+	logm_set_values(LOGM_DEFERRED, deferred);
+	logm_set_values(LOGM_IRQOFF_MAX, 0);
+
+	for (burst = 0; burst < LOGM_PERF_BURSTS; burst++) {
+		for (i = 0; i < LOGM_PERF_BURSTLEN; i++) {
+			start = up_perf_gettime();
+			logm(LOGM_NORMAL, LOGM_UNKNOWN, LOGM_INF, "logm_perf %d/%d %s 0x%08x\n", burst, i, name, burst * i);
+			elapsed = up_perf_gettime() - start;
+
+			total += elapsed;
+			if (elapsed > max) {
+				max = elapsed;
+			}
+		}
+
+		/* Let the logm task drain the buffer before the next burst */
+
+		usleep(LOGM_PERF_INTERVAL * 5 * 1000);
+	}
+
+	logm_get_values(LOGM_IRQOFF_MAX, &irqoff_max);
+	logm_get_values(LOGM_IRQOFF_AVG, &irqoff_avg);
+
+	printf("%-10s caller avg %6lu ns max %6lu ns, irq off avg %6d ns max %6d ns\n", name,
+		   (unsigned long)logm_perf_to_ns(total / (LOGM_PERF_BURSTS * LOGM_PERF_BURSTLEN)),
+		   (unsigned long)logm_perf_to_ns(max), irqoff_avg, irqoff_max);
+}
+
+/****************************************************************************
+ * Name: logm_performance_main
+ ****************************************************************************/
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int logm_performance_main(int argc, char *argv[])
+#endif
+{
+	int interval;
+	int deferred;
+
+	logm_get_values(LOGM_INTERVAL, &interval);
+	logm_get_values(LOGM_DEFERRED, &deferred);
+	logm_set_values(LOGM_INTERVAL, LOGM_PERF_INTERVAL);
+
+	logm_perf_run("immediate", 0);
+#ifdef CONFIG_LOGM_DEFERRED
+	logm_perf_run("deferred", 1);
+#endif
+
+	logm_set_values(LOGM_INTERVAL, interval);
+	logm_set_values(LOGM_DEFERRED, deferred);
+
+	return 0;
+}
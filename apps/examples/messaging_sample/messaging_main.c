@@ -92,6 +92,11 @@ static void messaging_sample_run(int loop_cnt)
 
 	/* Wait for finishing previous test. */
 	sleep(1);
+
+	port_handle_messaging_sample();
+
+	/* Wait for finishing previous test. */
+	sleep(1);
 }
 
 static void messaging_sample_execute_infinitely(void)
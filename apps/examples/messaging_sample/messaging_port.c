@@ -0,0 +1,176 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <messaging/messaging.h>
+
+#define TEST4_PORT "test4_port"
+#define TEST4_DATA "HANDLE"
+#define TEST4_REPLY "REPLY_MSG"
+#define TEST4_COUNT 100
+
+#define MSG_PRIO 10
+#define TASK_PRIO 100
+#define STACKSIZE 2048
+#define BUFFER_SIZE 10
+
+extern int fail_cnt;
+static volatile bool port_recv_ready;
+
+static unsigned int port_elapsed_usec(struct timespec *start)
+{
+	struct timespec end;
+	clock_gettime(CLOCK_REALTIME, &end);
+	return (end.tv_sec - start->tv_sec) * 1000000 + (end.tv_nsec - start->tv_nsec) / 1000;
+}
+
+static int port_recv(int argc, FAR char *argv[])
+{
+	int ret;
+	int cnt;
+	msg_port_handle_t *handle;
+	char buf[BUFFER_SIZE];
+	msg_recv_buf_t recv_data;
+	msg_send_data_t reply_data;
+
+	handle = messaging_port_open(TEST4_PORT, MSG_PORT_RECV, BUFFER_SIZE);
+	if (handle == NULL) {
+		fail_cnt++;
+		printf("Fail to open the receive port handle.\n");
+		return ERROR;
+	}
+	port_recv_ready = true;
+
+	recv_data.buf = buf;
+	recv_data.buflen = BUFFER_SIZE;
+	reply_data.msg = TEST4_REPLY;
+	reply_data.msglen = sizeof(TEST4_REPLY);
+	reply_data.priority = MSG_PRIO;
+
+	/* Receive the noreply messages and then the sync messages. */
+	for (cnt = 0; cnt < TEST4_COUNT * 2; cnt++) {
+		ret = messaging_port_recv(handle, &recv_data);
+		if (ret < 0) {
+			fail_cnt++;
+			printf("Fail to receive through the port handle.\n");
+			break;
+		}
+		if (ret == MSG_REPLY_REQUIRED) {
+			ret = messaging_reply(TEST4_PORT, recv_data.sender_pid, &reply_data);
+			if (ret != OK) {
+				fail_cnt++;
+				printf("Fail to reply.\n");
+				break;
+			}
+		}
+	}
+
+	messaging_port_close(handle);
+	return OK;
+}
+
+static int port_send(int argc, FAR char *argv[])
+{
+	int ret;
+	int cnt;
+	msg_port_handle_t *handle;
+	char buf[BUFFER_SIZE];
+	msg_send_data_t send_data;
+	msg_recv_buf_t reply_data;
+	struct timespec start;
+
+	send_data.msg = TEST4_DATA;
+	send_data.msglen = sizeof(TEST4_DATA);
+	send_data.priority = MSG_PRIO;
+	reply_data.buf = buf;
+	reply_data.buflen = BUFFER_SIZE;
+
+	handle = messaging_port_open(TEST4_PORT, MSG_PORT_SEND, BUFFER_SIZE);
+	if (handle == NULL) {
+		fail_cnt++;
+		printf("Fail to open the send port handle.\n");
+		return ERROR;
+	}
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (cnt = 0; cnt < TEST4_COUNT; cnt++) {
+		ret = messaging_port_send(handle, &send_data);
+		if (ret != OK) {
+			fail_cnt++;
+			printf("Fail to send through the port handle.\n");
+			goto done;
+		}
+	}
+	printf("Success to send %d noreply messages through the handle in %u us.\n", TEST4_COUNT, port_elapsed_usec(&start));
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (cnt = 0; cnt < TEST4_COUNT; cnt++) {
+		ret = messaging_port_send_sync(handle, &send_data, &reply_data);
+		if (ret != OK) {
+			fail_cnt++;
+			printf("Fail to sync send through the port handle.\n");
+			goto done;
+		}
+	}
+	printf("Success to send %d sync messages through the handle in %u us. reply : [%s]\n", TEST4_COUNT, port_elapsed_usec(&start), (char *)reply_data.buf);
+
+done:
+	messaging_port_close(handle);
+	return OK;
+}
+
+void port_handle_messaging_sample(void)
+{
+	int ret;
+	int receiver_pid;
+
+	printf("\n--- Start the Port Handle messaging test. ---\n");
+
+	port_recv_ready = false;
+	receiver_pid = task_create("port_recv", TASK_PRIO, STACKSIZE, port_recv, NULL);
+	if (receiver_pid < 0) {
+		fail_cnt++;
+		printf("Fail to create port_recv task.\n");
+		return;
+	}
+
+	/* The sender handle can be opened after the receiver handle is opened. */
+	while (!port_recv_ready) {
+		usleep(10000);
+	}
+
+	ret = task_create("port_send", TASK_PRIO, STACKSIZE, port_send, NULL);
+	if (ret < 0) {
+		fail_cnt++;
+		task_delete(receiver_pid);
+		printf("Fail to create port_send task.\n");
+		return;
+	}
+
+	/* Wait for finishing port_send and port_recv tasks. */
+	sleep(2);
+}
@@ -0,0 +1,229 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file pipe_performance_main.c
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <tinyara/fs/ioctl.h>
+
+#define PIPE_PERF_TOTAL      (1024 * 1024)
+#define PIPE_PERF_FIFO_PATH  "/dev/pipe_perf"
+
+struct pipe_perf_s {
+	const char *name;
+	unsigned long bufsize;	/* 0 to keep CONFIG_DEV_PIPE_SIZE */
+	unsigned long rdwmark;	/* 0 to keep the default */
+	unsigned long wrwmark;	/* 0 to keep the default */
+};
+
+static const struct pipe_perf_s g_pipe_perf[] = {
+	{ "default buffer", 0, 0, 0 },
+	{ "16KB buffer", 16384, 0, 0 },
+	{ "16KB buffer, wmark 8KB", 16384, 0, 8192 },
+	{ "16KB buffer, wmarks 4KB/8KB", 16384, 4096, 8192 },
+};
+
+static const size_t g_pipe_perf_chunks[] = { 64, 512, 4096, 16384 };
+
+static size_t g_chunk;
+
+static unsigned long pipe_perf_elapsed_us(struct timespec *start, struct timespec *end)
+{
+	return (end->tv_sec - start->tv_sec) * 1000000 + (end->tv_nsec - start->tv_nsec) / 1000;
+}
+
+static void *pipe_perf_writer(void *arg)
+{
+	int fd = (int)arg;
+	char *buf;
+	size_t total = 0;
+	ssize_t ret;
+
+	buf = (char *)malloc(g_chunk);
+	if (buf == NULL) {
+		close(fd);
+		return NULL;
+	}
+
+	memset(buf, 0x5a, g_chunk);
+	while (total < PIPE_PERF_TOTAL) {
+		ret = write(fd, buf, g_chunk);
+		if (ret <= 0) {
+			printf("write failed, errno %d\n", errno);
+			break;
+		}
+		total += ret;
+	}
+
+	free(buf);
+	close(fd);
+	return NULL;
+}
+
+/*
+ * @fn                   :pipe_perf_run
+ * @description          :Stream PIPE_PERF_TOTAL bytes from a writer thread to the reader
+ * @return               :KB/s, or -1 on failure
+ */
+static long pipe_perf_run(int rdfd, int wrfd)
+{
+	pthread_t writer;
+	struct timespec start;
+	struct timespec end;
+	char *buf;
+	size_t total = 0;
+	ssize_t ret;
+	unsigned long usec;
+
+	buf = (char *)malloc(g_chunk);
+	if (buf == NULL) {
+		return -1;
+	}
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	if (pthread_create(&writer, NULL, pipe_perf_writer, (void *)wrfd) != 0) {
+		free(buf);
+		return -1;
+	}
+
+	while (total < PIPE_PERF_TOTAL) {
+		ret = read(rdfd, buf, g_chunk);
+		if (ret <= 0) {
+			break;
+		}
+		total += ret;
+	}
+	clock_gettime(CLOCK_REALTIME, &end);
+
+	pthread_join(writer, NULL);
+	free(buf);
+
+	usec = pipe_perf_elapsed_us(&start, &end);
+	if (total < PIPE_PERF_TOTAL || usec == 0) {
+		return -1;
+	}
+
+	return (long)((unsigned long long)total * 1000000 / 1024 / usec);
+}
+
+static int pipe_perf_setup(int fd, const struct pipe_perf_s *perf)
+{
+	if (perf->bufsize && ioctl(fd, PIPEIOC_SETSIZE, perf->bufsize) < 0) {
+		return ERROR;
+	}
+
+	if (perf->rdwmark && ioctl(fd, PIPEIOC_RDWMARK, perf->rdwmark) < 0) {
+		return ERROR;
+	}
+
+	if (perf->wrwmark && ioctl(fd, PIPEIOC_WRWMARK, perf->wrwmark) < 0) {
+		return ERROR;
+	}
+
+	return OK;
+}
+
+static void pipe_perf_pipe(const struct pipe_perf_s *perf)
+{
+	int fd[2];
+	long kbps;
+
+	if (pipe(fd) < 0) {
+		printf("pipe failed, errno %d\n", errno);
+		return;
+	}
+
+	if (pipe_perf_setup(fd[0], perf) != OK) {
+		printf("pipe %-28s : setup failed, errno %d\n", perf->name, errno);
+		close(fd[0]);
+		close(fd[1]);
+		return;
+	}
+
+	kbps = pipe_perf_run(fd[0], fd[1]);
+	close(fd[0]);
+	printf("pipe %-28s chunk %5d : %6ld KB/s\n", perf->name, g_chunk, kbps);
+}
+
+static void pipe_perf_fifo(const struct pipe_perf_s *perf)
+{
+	int rdfd;
+	int wrfd;
+	long kbps;
+
+	if (mkfifo(PIPE_PERF_FIFO_PATH, 0666) < 0) {
+		printf("mkfifo failed, errno %d\n", errno);
+		return;
+	}
+
+	/* Open the write side first, the read-only open waits for a writer */
+
+	wrfd = open(PIPE_PERF_FIFO_PATH, O_WRONLY);
+	rdfd = open(PIPE_PERF_FIFO_PATH, O_RDONLY);
+	if (rdfd < 0 || wrfd < 0 || pipe_perf_setup(rdfd, perf) != OK) {
+		printf("fifo %-28s : setup failed, errno %d\n", perf->name, errno);
+		if (wrfd >= 0) {
+			close(wrfd);
+		}
+		kbps = -1;
+	} else {
+		kbps = pipe_perf_run(rdfd, wrfd);
+		printf("fifo %-28s chunk %5d : %6ld KB/s\n", perf->name, g_chunk, kbps);
+	}
+
+	if (rdfd >= 0) {
+		close(rdfd);
+	}
+	unlink(PIPE_PERF_FIFO_PATH);
+}
+
+/****************************************************************************
+ * Name: Pipe Performance
+ ****************************************************************************/
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int pipe_performance_main(int argc, char *argv[])
+#endif
+{
+	int i;
+	int j;
+
+	printf("Pipe throughput, %d KB per run\n", PIPE_PERF_TOTAL / 1024);
+
+	for (i = 0; i < sizeof(g_pipe_perf) / sizeof(g_pipe_perf[0]); i++) {
+		for (j = 0; j < sizeof(g_pipe_perf_chunks) / sizeof(g_pipe_perf_chunks[0]); j++) {
+			g_chunk = g_pipe_perf_chunks[j];
+			pipe_perf_pipe(&g_pipe_perf[i]);
+			pipe_perf_fifo(&g_pipe_perf[i]);
+		}
+	}
+
+	return 0;
+}
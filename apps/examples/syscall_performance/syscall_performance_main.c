@@ -27,14 +27,18 @@
 #include <sys/ioctl.h>
 #include <sys/types.h>
 #include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
 
 #define NUM_LOOPS	1000000
 #define SEC_10	10
 #define TEST_MSGLEN	31
 #define TEST_TIMEDSEND_NMSGS	3
 #define SIGEV_SIGNAL	1		/* Notify via signal */
+#define MUTEX_CONTENDED_LOOPS	10000
 
 int sig_no = SIGRTMIN;
+static pthread_mutex_t g_perf_mutex;
 
 /*
  * measure_performance : variadic macro for time measurements for function calls
@@ -172,6 +176,94 @@ static void syscall_perf_timer_settime(void)
 	measure_performance(timer_settime, 4, timer_id, 0, NULL, NULL);
 }
 
+/*
+ * @fn                   :mutex_lock_unlock
+ * @description          :Lock and unlock the mutex once
+ * @return               :void
+ */
+static void mutex_lock_unlock(pthread_mutex_t *mutex)
+{
+	pthread_mutex_lock(mutex);
+	pthread_mutex_unlock(mutex);
+}
+
+/*
+ * @fn                   :syscall_perf_mutex_uncontended
+ * @description          :Measuring performance for pthread_mutex_lock and
+ *                        pthread_mutex_unlock of a mutex nobody else uses
+ * @return               :void
+ */
+static void syscall_perf_mutex_uncontended(void)
+{
+	pthread_mutex_init(&g_perf_mutex, NULL);
+
+	measure_performance(mutex_lock_unlock, 7, &g_perf_mutex);
+
+	pthread_mutex_destroy(&g_perf_mutex);
+}
+
+/*
+ * @fn                   :mutex_contender
+ * @description          :Hold the mutex across a yield so that every lock
+ *                        of the other thread has to wait
+ * @return               :void *
+ */
+static void *mutex_contender(void *arg)
+{
+	int i;
+
+	for (i = 0; i < MUTEX_CONTENDED_LOOPS; i++) {
+		pthread_mutex_lock(&g_perf_mutex);
+		sched_yield();
+		pthread_mutex_unlock(&g_perf_mutex);
+	}
+
+	return NULL;
+}
+
+/*
+ * @fn                   :syscall_perf_mutex_contended
+ * @description          :Measuring performance for pthread_mutex_lock and
+ *                        pthread_mutex_unlock of a mutex two threads of the
+ *                        same priority fight for
+ * @return               :void
+ */
+static void syscall_perf_mutex_contended(void)
+{
+	pthread_t tid[2];
+	pthread_attr_t attr;
+	struct sched_param param;
+	struct timespec stime;
+	struct timespec etime;
+	int i;
+
+	pthread_mutex_init(&g_perf_mutex, NULL);
+
+	pthread_attr_init(&attr);
+	param.sched_priority = sched_get_priority_min(SCHED_RR) + 1;
+	pthread_attr_setschedparam(&attr, &param);
+
+	clock_gettime(CLOCK_REALTIME, &stime);
+	for (i = 0; i < 2; i++) {
+		if (pthread_create(&tid[i], &attr, mutex_contender, NULL) != 0) {
+			printf("mutex_contended - pthread_create failed, errno %d\n", errno);
+			break;
+		}
+	}
+	while (--i >= 0) {
+		pthread_join(tid[i], NULL);
+	}
+	clock_gettime(CLOCK_REALTIME, &etime);
+
+	if (etime.tv_nsec - stime.tv_nsec < 0) {
+		etime.tv_sec--;
+		etime.tv_nsec += 1000000000;
+	}
+	printf("mutex_contended - [pass = %d] - timediff -> (%lld.%09ld secs)\n", 2 * MUTEX_CONTENDED_LOOPS, (long long)(etime.tv_sec - stime.tv_sec), etime.tv_nsec - stime.tv_nsec);
+
+	pthread_mutex_destroy(&g_perf_mutex);
+}
+
 /****************************************************************************
  * Name: Syscall Performance
  ****************************************************************************/
@@ -198,5 +290,9 @@ int syscall_performance_main(void)
 	/* System Call 6 */
 	syscall_perf_mq_open();
 
+	/* System Call 7 */
+	syscall_perf_mutex_uncontended();
+	syscall_perf_mutex_contended();
+
 	return 0;
 }
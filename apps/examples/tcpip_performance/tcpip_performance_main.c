@@ -0,0 +1,156 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file tcpip_performance_main.c
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <errno.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <time.h>
+#include <net/lwip/tcpip.h>
+
+#define TCPIP_PERF_COUNT       20000
+#define TCPIP_PERF_MAX_WINDOW  16
+
+static const int g_tcpip_perf_windows[] = { 1, 4, TCPIP_PERF_MAX_WINDOW };
+
+static struct tcpip_callback_msg *g_tcpip_perf_msgs[TCPIP_PERF_MAX_WINDOW];
+static sem_t g_tcpip_perf_done;
+
+static unsigned long tcpip_perf_elapsed_us(struct timespec *start, struct timespec *end)
+{
+	return (end->tv_sec - start->tv_sec) * 1000000 + (end->tv_nsec - start->tv_nsec) / 1000;
+}
+
+/* Runs in the tcpip thread, gives one credit back to the producer */
+
+static void tcpip_perf_callback(void *ctx)
+{
+	sem_post(&g_tcpip_perf_done);
+}
+
+static void tcpip_perf_wait(void)
+{
+	while (sem_wait(&g_tcpip_perf_done) != OK && errno == EINTR) {
+	}
+}
+
+static void tcpip_perf_report(const char *name, unsigned long usec)
+{
+	if (usec == 0) {
+		usec = 1;
+	}
+	printf("%-36s : %8lu msgs/s, %5lu ns/msg\n", name,
+		   (unsigned long)((unsigned long long)TCPIP_PERF_COUNT * 1000000 / usec),
+		   (unsigned long)((unsigned long long)usec * 1000 / TCPIP_PERF_COUNT));
+}
+
+/* tcpip_callback() allocates a message for every call, wait for each one */
+
+static void tcpip_perf_alloc(void)
+{
+	struct timespec start;
+	struct timespec end;
+	int i;
+
+	sem_init(&g_tcpip_perf_done, 0, 0);
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (i = 0; i < TCPIP_PERF_COUNT; i++) {
+		if (tcpip_callback(tcpip_perf_callback, NULL) != ERR_OK) {
+			printf("tcpip_callback failed at %d\n", i);
+			sem_destroy(&g_tcpip_perf_done);
+			return;
+		}
+		tcpip_perf_wait();
+	}
+	clock_gettime(CLOCK_REALTIME, &end);
+	sem_destroy(&g_tcpip_perf_done);
+
+	tcpip_perf_report("tcpip_callback, 1 in flight", tcpip_perf_elapsed_us(&start, &end));
+}
+
+/* Preallocated messages, up to window of them queued at the same time.
+ * The tcpip thread handles the messages in order, so the message of the
+ * oldest credit is free again when that credit comes back.
+ */
+
+static void tcpip_perf_window(int window)
+{
+	struct timespec start;
+	struct timespec end;
+	char name[40];
+	int i;
+
+	sem_init(&g_tcpip_perf_done, 0, window);
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (i = 0; i < TCPIP_PERF_COUNT; i++) {
+		tcpip_perf_wait();
+		while (tcpip_trycallback(g_tcpip_perf_msgs[i % window]) != ERR_OK) {
+			sched_yield();
+		}
+	}
+
+	/* Wait until the last messages are handled */
+
+	for (i = 0; i < window; i++) {
+		tcpip_perf_wait();
+	}
+	clock_gettime(CLOCK_REALTIME, &end);
+	sem_destroy(&g_tcpip_perf_done);
+
+	snprintf(name, sizeof(name), "tcpip_trycallback, %d in flight", window);
+	tcpip_perf_report(name, tcpip_perf_elapsed_us(&start, &end));
+}
+
+/****************************************************************************
+ * Name: tcpip Performance
+ ****************************************************************************/
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int tcpip_performance_main(int argc, char *argv[])
+#endif
+{
+	int i;
+
+	for (i = 0; i < TCPIP_PERF_MAX_WINDOW; i++) {
+		g_tcpip_perf_msgs[i] = tcpip_callbackmsg_new(tcpip_perf_callback, NULL);
+		if (g_tcpip_perf_msgs[i] == NULL) {
+			printf("tcpip_callbackmsg_new failed\n");
+			goto out;
+		}
+	}
+
+	printf("tcpip thread message rate, %d messages per run\n", TCPIP_PERF_COUNT);
+
+	tcpip_perf_alloc();
+	for (i = 0; i < sizeof(g_tcpip_perf_windows) / sizeof(g_tcpip_perf_windows[0]); i++) {
+		tcpip_perf_window(g_tcpip_perf_windows[i]);
+	}
+
+out:
+	for (i = 0; i < TCPIP_PERF_MAX_WINDOW; i++) {
+		if (g_tcpip_perf_msgs[i] != NULL) {
+			tcpip_callbackmsg_delete(g_tcpip_perf_msgs[i]);
+		}
+	}
+	return 0;
+}
@@ -43,63 +43,232 @@ static const struct tag_list ttrace_tags[] = {
 	{"lock",    "Lock",          TTRACE_TAG_LOCK},
 	{"task",    "TASK",          TTRACE_TAG_TASK},
 	{"ipc",     "IPC",           TTRACE_TAG_IPC},
+	{"irq",     "Interrupts",    TTRACE_TAG_IRQ},
+	{"sem",     "Semaphores",    TTRACE_TAG_SEM},
+	{"prio",    "Priority",      TTRACE_TAG_PRIO},
+	{"mq",      "Mqueue",        TTRACE_TAG_MQ},
+	{"work",    "Workqueue",     TTRACE_TAG_WORK},
+	{"heap",    "Heap",          TTRACE_TAG_HEAP},
+};
+
+/* Text of the kernel events, NULL for the end of a span */
+
+static const char *const kevent_formats[] = {
+	[TTRACE_KEV_IRQ_ENTER] = "irq %u",
+	[TTRACE_KEV_IRQ_EXIT] = NULL,
+	[TTRACE_KEV_SEM_BLOCK] = "sem_block 0x%08x holder=%u",
+	[TTRACE_KEV_SEM_WAKE] = "sem_wake 0x%08x pid=%u",
+	[TTRACE_KEV_PRIO_BOOST] = "prio_boost pid=%u prio=%u",
+	[TTRACE_KEV_PRIO_RESTORE] = "prio_restore pid=%u prio=%u",
+	[TTRACE_KEV_MQ_SEND_BLOCK] = "mq_send_block 0x%08x",
+	[TTRACE_KEV_MQ_RECV_BLOCK] = "mq_recv_block 0x%08x",
+	[TTRACE_KEV_MQ_WAKE] = "mq_wake 0x%08x pid=%u",
+	[TTRACE_KEV_WORK_START] = "work 0x%08x",
+	[TTRACE_KEV_WORK_END] = NULL,
+	[TTRACE_KEV_MALLOC] = "malloc 0x%08x size=%u",
+	[TTRACE_KEV_FREE] = "free 0x%08x size=%u",
 };
 
 int param = 0;
 int selected_tags = 0;
 int is_overwritable = 0;
+char *save_path = NULL;
 
 static void show_help(void);
 void wait_ttrace_dump(void);
 
-static int print_uid_packet(struct trace_packet *packet)
+struct ttrace_capture {
+	const struct ttrace_header_s *hdr;
+	const uint8_t *strtab;
+	const struct ttrace_task_s *tasks;
+	uint64_t ts;
+};
+
+static int find_string(const struct ttrace_capture *cap, uint64_t id, const char **str)
 {
-	int8_t uid = packet->codelen & ~TTRACE_CODE_UNIQUE;
-	printf("[%06d:%06d] %03d: %c|%u\r\n",
-		   packet->ts.tv_sec, packet->ts.tv_usec,
-		   packet->pid,
-		   packet->event_type, uid);
-	return sizeof(struct trace_packet) - TTRACE_MSG_BYTES;
+	uint32_t off = 0;
+
+	while (off < cap->hdr->strtab_len) {
+		if (--id == 0) {
+			*str = (const char *)&cap->strtab[off + 1];
+			return cap->strtab[off];
+		}
+		off += 1 + cap->strtab[off];
+	}
+
+	*str = "unknown";
+	return strlen(*str);
 }
 
-static int print_message_packet(struct trace_packet *packet)
+static int find_task(const struct ttrace_capture *cap, uint64_t pid, const char **name)
 {
-	printf("[%06d:%06d] %03d: %c|%s\r\n",
-		   packet->ts.tv_sec, packet->ts.tv_usec,
-		   packet->pid,
-		   packet->event_type,
-		   packet->msg.message);
-	return sizeof(struct trace_packet);
+	int i;
+
+	for (i = 0; i < cap->hdr->ntasks; i++) {
+		if (cap->tasks[i].pid == pid && cap->tasks[i].strid != 0) {
+			return find_string(cap, cap->tasks[i].strid, name);
+		}
+	}
+
+	*name = "unknown";
+	return strlen(*name);
 }
 
-static int print_sched_packet(struct trace_packet *packet)
+/* Print a kernel event as a begin or an end, or as a begin and an end at
+ * the same time for the events without a duration.
+ */
+
+static int print_kevent(const uint8_t *rec, int len, unsigned int pid, uint64_t usec)
 {
-	printf("[%06d:%06d] %03d: %c|prev_comm=%s prev_pid=%u prev_prio=%u prev_state=%u ==> next_comm=%s next_pid=%u next_prio=%u\r\n",
-		   packet->ts.tv_sec, packet->ts.tv_usec,
-		   packet->pid,
-		   (char)packet->event_type,
-		   packet->msg.sched_msg.prev_comm,
-		   packet->msg.sched_msg.prev_pid,
-		   packet->msg.sched_msg.prev_prio,
-		   packet->msg.sched_msg.prev_state,
-		   packet->msg.sched_msg.next_comm,
-		   packet->msg.sched_msg.next_pid,
-		   packet->msg.sched_msg.next_prio);
-	return sizeof(struct trace_packet);
+	const char *fmt;
+	uint64_t arg0;
+	uint64_t arg1;
+	int n = 1;
+	int ret;
+	uint8_t id;
+
+	if (len < 1 || (ret = ttrace_get_varint(&rec[n], len - n, &arg0)) == 0) {
+		return 0;
+	}
+	n += ret;
+	if ((ret = ttrace_get_varint(&rec[n], len - n, &arg1)) == 0) {
+		return 0;
+	}
+	n += ret;
+
+	id = rec[0];
+	if (id >= sizeof(kevent_formats) / sizeof(kevent_formats[0]) || id == 0) {
+		printf("%03u: b|kevent %u %u %u\r\n", pid, id, (unsigned int)arg0, (unsigned int)arg1);
+		return n;
+	}
+
+	fmt = kevent_formats[id];
+	if (fmt == NULL) {
+		printf("%03u: e|0\r\n", pid);
+		return n;
+	}
+
+	printf("%03u: b|", pid);
+	printf(fmt, (unsigned int)arg0, (unsigned int)arg1);
+	printf("\r\n");
+	if (id != TTRACE_KEV_IRQ_ENTER && id != TTRACE_KEV_WORK_START) {
+		printf("[%06u:%06u] %03u: e|0\r\n", (unsigned int)(usec / 1000000), (unsigned int)(usec % 1000000), pid);
+	}
+	return n;
 }
 
-static int print_packet(struct trace_packet *packet)
+static int print_record(struct ttrace_capture *cap, const uint8_t *rec, int len)
 {
-	int isSched = (packet->event_type == 's') ? 1 : 0;
-	int isUnique = packet->codelen & TTRACE_CODE_UNIQUE;
+	uint64_t delta;
+	uint64_t usec;
+	uint64_t pid;
+	uint64_t val;
+	uint64_t next_pid;
+	const char *str;
+	const char *next_str;
+	int slen;
+	int next_slen;
+	int n;
+	int ret;
+
+	if (len < 2 || (ret = ttrace_get_varint(&rec[1], len - 1, &delta)) == 0) {
+		return 0;
+	}
+	delta = ttrace_unzigzag(delta);
+	n = 1 + ret;
+	if ((ret = ttrace_get_varint(&rec[n], len - n, &pid)) == 0) {
+		return 0;
+	}
+	n += ret;
 
-	if (isSched) {
-		return print_sched_packet(packet);
-	} else if (isUnique) {
-		return print_uid_packet(packet);
-	} else {
-		return print_message_packet(packet);
+	cap->ts += delta;
+	usec = cap->ts * 1000000 / cap->hdr->freq;
+	printf("[%06u:%06u] ", (unsigned int)(usec / 1000000), (unsigned int)(usec % 1000000));
+
+	switch (rec[0]) {
+	case TTRACE_REC_BEGIN:
+		if ((ret = ttrace_get_varint(&rec[n], len - n, &val)) == 0) {
+			return 0;
+		}
+		n += ret;
+		slen = find_string(cap, val, &str);
+		printf("%03u: b|%.*s\r\n", (unsigned int)pid, slen, str);
+		break;
+	case TTRACE_REC_BEGIN_STR:
+		if (n >= len || n + 1 + rec[n] > len) {
+			return 0;
+		}
+		printf("%03u: b|%.*s\r\n", (unsigned int)pid, rec[n], (const char *)&rec[n + 1]);
+		n += 1 + rec[n];
+		break;
+	case TTRACE_REC_BEGIN_UID:
+		if (n >= len) {
+			return 0;
+		}
+		printf("%03u: b|%u\r\n", (unsigned int)pid, rec[n]);
+		n += 1;
+		break;
+	case TTRACE_REC_END:
+		printf("%03u: e|0\r\n", (unsigned int)pid);
+		break;
+	case TTRACE_REC_SCHED:
+		if (n + 2 > len || (ret = ttrace_get_varint(&rec[n + 2], len - n - 2, &next_pid)) == 0 || n + 2 + ret >= len) {
+			return 0;
+		}
+		slen = find_task(cap, pid, &str);
+		next_slen = find_task(cap, next_pid, &next_str);
+		printf("%03u: s|prev_comm=%.*s prev_pid=%u prev_prio=%u prev_state=%u ==> next_comm=%.*s next_pid=%u next_prio=%u\r\n",
+			   (unsigned int)pid, slen, str, (unsigned int)pid, rec[n], rec[n + 1],
+			   next_slen, next_str, (unsigned int)next_pid, rec[n + 2 + ret]);
+		n += 2 + ret + 1;
+		break;
+	case TTRACE_REC_KEVENT:
+		ret = print_kevent(&rec[n], len - n, (unsigned int)pid, usec);
+		if (ret == 0) {
+			return 0;
+		}
+		n += ret;
+		break;
+	default:
+		return 0;
 	}
+
+	return n;
+}
+
+static int print_capture(const char *buffer, int len)
+{
+	struct ttrace_capture cap;
+	int offset;
+	int ret;
+
+	cap.hdr = (const struct ttrace_header_s *)buffer;
+	if (len < sizeof(struct ttrace_header_s) || cap.hdr->magic != TTRACE_MAGIC || cap.hdr->version != TTRACE_VERSION || cap.hdr->freq == 0) {
+		printf("Invalid trace header\r\n");
+		return TTRACE_INVALID;
+	}
+
+	offset = cap.hdr->hdrlen;
+	cap.strtab = (const uint8_t *)buffer + offset;
+	offset += cap.hdr->strtab_len;
+	cap.tasks = (const struct ttrace_task_s *)(buffer + offset);
+	offset += cap.hdr->ntasks * sizeof(struct ttrace_task_s);
+	cap.ts = ((uint64_t)cap.hdr->ts_base_hi << 32) | cap.hdr->ts_base_lo;
+
+	if (cap.hdr->dropped > 0) {
+		printf("%u records were dropped\r\n", cap.hdr->dropped);
+	}
+
+	while (offset < len) {
+		ret = print_record(&cap, (const uint8_t *)buffer + offset, len - offset);
+		if (ret == 0) {
+			printf("Broken record at %d\r\n", offset);
+			return TTRACE_INVALID;
+		}
+		offset += ret;
+	}
+
+	return TTRACE_VALID;
 }
 
 static void show_help()
@@ -112,6 +281,7 @@ static void show_help()
 	printf("    -i     Show information(state, available/selected/TP used tags, bufsize)\r\n");
 	printf("    -d     Dump trace buffer, It should be run after finish\r\n");
 	printf("    -p     Print trace buffer, It should be run after finish\r\n");
+	printf("    -w     Save trace buffer to a file, It should be run after finish\r\n");
 }
 
 static int assign_tag(char *name)
@@ -143,10 +313,11 @@ static int parse_args(int argc, char **args)
 	 * -g : TTRACE_FUNC_TAG, TP's tag(hidden to user)
 	 * -d : TTRACE_DUMP, dump mode(hang), It should be run after finish.
 	 * -p : TTRACE_PRINT, print traces, It should be run after finish.
+	 * -w : TTRACE_SAVE, save the binary capture to a file, It should be run after finish.
 	 */
 	while (1) {
 		optarg = NULL;
-		ret = getopt(argc, args, "sofidpb:");
+		ret = getopt(argc, args, "sofidpb:w:");
 		if (ret == '?') {
 			show_help();
 			return TTRACE_INVALID;
@@ -161,6 +332,12 @@ static int parse_args(int argc, char **args)
 			continue;
 		}
 
+		if (ret == 'w') {
+			save_path = optarg;
+			cmd = ret;
+			continue;
+		}
+
 		cmd = ret;
 		printf("cmd: %d, %c, optarg: %d, %c, %s\r\n", cmd, cmd, optarg, optarg, optarg);
 
@@ -235,7 +412,7 @@ static int read_tracebuffer(FILE *file, int bufsize)
 {
 	char *buffer = NULL;
 	int read_len = 0;
-	int offset = 0;
+	int ret;
 
 	buffer = alloc_tracebuffer(bufsize);
 	if (buffer == NULL) {
@@ -244,15 +421,47 @@ static int read_tracebuffer(FILE *file, int bufsize)
 
 	read_len = fread(buffer, sizeof(char), bufsize, file);
 	if (read_len < 0) {
+		free_tracebuffer(buffer);
 		return TTRACE_INVALID;
 	}
 
-	while (offset < read_len) {
-		offset += print_packet((struct trace_packet *)(buffer + offset));
+	ret = print_capture(buffer, read_len);
+
+	free_tracebuffer(buffer);
+	return ret;
+}
+
+static int save_tracebuffer(FILE *file, int bufsize)
+{
+	FILE *out;
+	char *buffer = NULL;
+	int read_len = 0;
+	int ret = TTRACE_VALID;
+
+	buffer = alloc_tracebuffer(bufsize);
+	if (buffer == NULL) {
+		return TTRACE_INVALID;
+	}
+
+	read_len = fread(buffer, sizeof(char), bufsize, file);
+
+	out = fopen(save_path, "w");
+	if (out == NULL) {
+		printf("Failed to open : %s\r\n", save_path);
+		free_tracebuffer(buffer);
+		return TTRACE_INVALID;
 	}
 
+	if (read_len <= 0 || fwrite(buffer, sizeof(char), read_len, out) != read_len) {
+		printf("Failed to save trace to %s\r\n", save_path);
+		ret = TTRACE_INVALID;
+	} else {
+		printf("Saved %d bytes to %s\r\n", read_len, save_path);
+	}
+
+	fclose(out);
 	free_tracebuffer(buffer);
-	return TTRACE_VALID;
+	return ret;
 }
 
 void wait_ttrace_dump()
@@ -275,7 +484,6 @@ static int send_cmds(FILE *file, int cmd)
 	if (cmd == TTRACE_START) {
 		ret = run_cmd(file, TTRACE_SELECTED_TAG, selected_tags);
 		ret = run_cmd(file, TTRACE_OVERWRITE, is_overwritable);
-		ret = run_cmd(file, TTRACE_SET_BUFSIZE, (unsigned long)sizeof(struct trace_packet));
 	} else if (cmd == TTRACE_FINISH) {
 		ret = run_cmd(file, TTRACE_OVERWRITE, 0);
 		bufsize = run_cmd(file, TTRACE_USED_BUFSIZE, param);
@@ -286,6 +494,12 @@ static int send_cmds(FILE *file, int cmd)
 		}
 		ret = read_tracebuffer(file, bufsize);
 		return ret;
+	} else if (cmd == TTRACE_SAVE) {
+		bufsize = run_cmd(file, TTRACE_USED_BUFSIZE, param);
+		if (bufsize <= 0) {
+			return TTRACE_NODATA;
+		}
+		return save_tracebuffer(file, bufsize);
 	}
 
 	if (run_cmd(file, cmd, param) == TTRACE_INVALID) {
@@ -66,6 +66,9 @@
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/select.h>
+#ifdef CONFIG_NET_SENDFILE
+#include <sys/sendfile.h>
+#endif
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -91,6 +94,12 @@
 
 #define __TINYARA__ 1			/* Flags some unusual TinyAra dependencies */
 
+/* Bytes given to one sendfile() call by RETR.  sendfile() returns when they
+ * are acknowledged, so it should be much larger than the send window.
+ */
+
+#define FTPD_SENDFILE_COUNT (64 * 1024)
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -1591,6 +1600,29 @@ static int ftpd_stream(FAR struct ftpd_session_s *session, int cmdtype)
 		goto errout_with_session;
 	}
 
+#ifdef CONFIG_NET_SENDFILE
+	if (cmdtype == 0 && session->type != FTPD_SESSIONTYPE_A) {
+		/* A binary file needs no conversion, so it is sent by reference from
+		 * the file system instead of through the session buffer.
+		 */
+
+		do {
+			wrbytes = sendfile(session->data.sd, session->fd, NULL, FTPD_SENDFILE_COUNT);
+		} while (wrbytes > 0);
+
+		if (wrbytes < 0) {
+			errval = errno;
+			ndbg("sendfile() failed: %d\n", errval);
+			(void)ftpd_response(session->cmd.sd, session->txtimeout, g_respfmt1, 550, ' ', "Data send error !");
+			ret = -errval;
+		} else {
+			(void)ftpd_response(session->cmd.sd, session->txtimeout, g_respfmt1, 226, ' ', "Transfer complete");
+			ret = 0;
+		}
+		goto errout_with_session;
+	}
+#endif
+
 	for (;;) {
 		/* Read from the source (file or TCP connection) */
 
@@ -294,6 +294,19 @@ int http_server_deregister_cb(struct http_server_t *server, int method, const ch
  */
 int http_send_response(struct http_client_t *client, int status, const char *body, struct http_keyvalue_list_t *headers);
 
+/**
+ * @brief http_send_file() sends a file as the response.
+ *        Without TLS and with CONFIG_NET_SENDFILE, the file is sent
+ *        with sendfile() and does not go through a user buffer.
+ *
+ * @param[in] client a pointer of HTTP client.
+ * @param[in] path path of the file to send.
+ * @return On success, HTTP_OK(0) is returned.
+ *         On failure, HTTP_ERROR(-1) is returned.
+ * @since TizenRT v2.1
+ */
+int http_send_file(struct http_client_t *client, const char *path);
+
 #ifdef CONFIG_NET_SECURITY_TLS
 /**
  * @brief http_tls_init() initializes the TLS configuere for webserver.
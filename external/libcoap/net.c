@@ -67,6 +67,11 @@
 
 #if defined(WITH_POSIX)
 
+/* Datagrams which coap_read() takes with one recvmmsg() call */
+#if defined(CONFIG_NETUTILS_LIBCOAP_READ_BATCH) && CONFIG_NETUTILS_LIBCOAP_READ_BATCH > 1
+#define COAP_READ_BATCH CONFIG_NETUTILS_LIBCOAP_READ_BATCH
+#endif
+
 time_t clock_offset;
 
 static inline coap_queue_t *coap_malloc_node(void)
@@ -952,72 +957,16 @@ static inline int check_opt_size(coap_opt_t *opt, unsigned char *maxpos)
 	return 0;
 }
 
-int coap_read(coap_context_t *ctx)
+/**
+ * Parses the @p bytes_read bytes of @p buf received from @p src and adds
+ * the PDU to the receive queue of @p ctx. This function returns @c 0 on
+ * success, or @c -1 if the data was discarded.
+ */
+static int coap_queue_read(coap_context_t *ctx, char *buf, ssize_t bytes_read, coap_address_t *src, coap_address_t *dst)
 {
-#ifdef WITH_POSIX
-	static char buf[COAP_MAX_PDU_SIZE];
-#endif
-#if defined(WITH_LWIP) || defined(WITH_CONTIKI)
-	char *buf;
-#endif
-	coap_hdr_t *pdu;
-	ssize_t bytes_read = -1;
-	coap_address_t src, dst;
+	coap_hdr_t *pdu = (coap_hdr_t *) buf;
 	coap_queue_t *node;
 
-#ifdef WITH_CONTIKI
-	buf = uip_appdata;
-#endif							/* WITH_CONTIKI */
-#ifdef WITH_LWIP
-	LWIP_ASSERT("No package pending", ctx->pending_package != NULL);
-	LWIP_ASSERT("Can only deal with contiguous PBUFs to read the initial details", ctx->pending_package->tot_len == ctx->pending_package->len);
-	buf = ctx->pending_package->payload;
-#endif							/* WITH_LWIP */
-
-	pdu = (coap_hdr_t *) buf;
-
-	coap_address_init(&src);
-
-#ifdef WITH_POSIX
-	switch (ctx->protocol) {
-	case COAP_PROTO_UDP:
-		bytes_read = recvfrom(ctx->sockfd, buf, sizeof(buf), 0, &src.addr.sa, &src.size);
-		break;
-	case COAP_PROTO_TCP:
-		bytes_read = recv(ctx->sockfd, buf, sizeof(buf), 0);
-		break;
-#ifdef WITH_MBEDTLS
-	case COAP_PROTO_DTLS:
-	case COAP_PROTO_TLS:
-		bytes_read = mbedtls_ssl_read(ctx->session->ssl, (unsigned char *)buf, sizeof(buf));
-		break;
-#endif
-	default:
-		warn("coap_read : not supported protocol %d\n", ctx->protocol);
-		goto error_early;
-	}
-#endif /* WITH_POSIX */
-#ifdef WITH_CONTIKI
-	if (uip_newdata()) {
-		uip_ipaddr_copy(&src.addr, &UIP_IP_BUF->srcipaddr);
-		src.port = UIP_UDP_BUF->srcport;
-		uip_ipaddr_copy(&dst.addr, &UIP_IP_BUF->destipaddr);
-		dst.port = UIP_UDP_BUF->destport;
-
-		bytes_read = uip_datalen();
-		((char *)uip_appdata)[bytes_read] = 0;
-		PRINTF("Server received %d bytes from [", (int)bytes_read);
-		PRINT6ADDR(&src.addr);
-		PRINTF("]:%d\n", uip_ntohs(src.port));
-	}
-#endif							/* WITH_CONTIKI */
-#ifdef WITH_LWIP
-	/* FIXME: use lwip address operation functions */
-	src.addr.addr = ctx->pending_address.addr;
-	src.port = ctx->pending_port;
-	bytes_read = ctx->pending_package->tot_len;
-#endif							/* WITH_LWIP */
-
 	if (bytes_read < 0) {
 		warn("coap_read: failed to read, ret %d, errno %d\n", bytes_read, errno);
 		goto error_early;
@@ -1073,8 +1022,8 @@ int coap_read(coap_context_t *ctx)
 		}
 
 		coap_ticks(&node->t);
-		memcpy(&node->local, &dst, sizeof(coap_address_t));
-		memcpy(&node->remote, &src, sizeof(coap_address_t));
+		memcpy(&node->local, dst, sizeof(coap_address_t));
+		memcpy(&node->remote, src, sizeof(coap_address_t));
 
 		if (!coap_pdu_parse((unsigned char *)buf, bytes_read, node->pdu)) {
 			warn("coap_read : discard malformed PDU");
@@ -1093,8 +1042,8 @@ int coap_read(coap_context_t *ctx)
 		}
 
 		coap_ticks(&node->t);
-		memcpy(&node->local, &dst, sizeof(coap_address_t));
-		memcpy(&node->remote, &src, sizeof(coap_address_t));
+		memcpy(&node->local, dst, sizeof(coap_address_t));
+		memcpy(&node->remote, src, sizeof(coap_address_t));
 
 		if (!coap_pdu_parse2((unsigned char*)buf, bytes_read, node->pdu, transport)) {
 			/* FIXME : prevent printing log when continuously received wrong PDU */
@@ -1119,7 +1068,7 @@ int coap_read(coap_context_t *ctx)
 #endif
 		unsigned char addr[INET6_ADDRSTRLEN + 8];
 
-		if (coap_print_addr(&src, addr, INET6_ADDRSTRLEN + 8)) {
+		if (coap_print_addr(src, addr, INET6_ADDRSTRLEN + 8)) {
 			debug("** received %d bytes from %s:\n", (int)bytes_read, addr);
 		}
 
@@ -1142,6 +1091,122 @@ error_early:
 	return -1;
 }
 
+#ifdef COAP_READ_BATCH
+/**
+ * Reads the UDP datagrams which have arrived with one recvmmsg() call,
+ * waiting for the first one only, and adds their PDUs to the receive
+ * queue of @p ctx. This function returns @c 0 if at least one PDU was
+ * queued, or @c -1 otherwise.
+ */
+static int coap_read_batch(coap_context_t *ctx)
+{
+	static char bufs[COAP_READ_BATCH][COAP_MAX_PDU_SIZE];
+	struct mmsghdr msgs[COAP_READ_BATCH];
+	struct iovec iov[COAP_READ_BATCH];
+	coap_address_t src[COAP_READ_BATCH];
+	coap_address_t dst;
+	int queued = 0;
+	int count;
+	int i;
+
+	memset(msgs, 0, sizeof(msgs));
+	for (i = 0; i < COAP_READ_BATCH; i++) {
+		coap_address_init(&src[i]);
+		iov[i].iov_base = bufs[i];
+		iov[i].iov_len = sizeof(bufs[i]);
+		msgs[i].msg_hdr.msg_name = &src[i].addr.sa;
+		msgs[i].msg_hdr.msg_namelen = src[i].size;
+		msgs[i].msg_hdr.msg_iov = &iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+	coap_address_init(&dst);
+
+	count = recvmmsg(ctx->sockfd, msgs, COAP_READ_BATCH, MSG_WAITFORONE, NULL);
+	if (count < 0) {
+		warn("coap_read: failed to read, ret %d, errno %d\n", count, errno);
+		return -1;
+	}
+
+	for (i = 0; i < count; i++) {
+		src[i].size = msgs[i].msg_hdr.msg_namelen;
+		if (coap_queue_read(ctx, bufs[i], (ssize_t)msgs[i].msg_len, &src[i], &dst) == 0) {
+			queued++;
+		}
+	}
+
+	return queued > 0 ? 0 : -1;
+}
+#endif							/* COAP_READ_BATCH */
+
+int coap_read(coap_context_t *ctx)
+{
+#ifdef WITH_POSIX
+	static char buf[COAP_MAX_PDU_SIZE];
+#endif
+#if defined(WITH_LWIP) || defined(WITH_CONTIKI)
+	char *buf;
+#endif
+	ssize_t bytes_read = -1;
+	coap_address_t src, dst;
+
+#ifdef WITH_CONTIKI
+	buf = uip_appdata;
+#endif							/* WITH_CONTIKI */
+#ifdef WITH_LWIP
+	LWIP_ASSERT("No package pending", ctx->pending_package != NULL);
+	LWIP_ASSERT("Can only deal with contiguous PBUFs to read the initial details", ctx->pending_package->tot_len == ctx->pending_package->len);
+	buf = ctx->pending_package->payload;
+#endif							/* WITH_LWIP */
+
+	coap_address_init(&src);
+
+#ifdef WITH_POSIX
+	switch (ctx->protocol) {
+	case COAP_PROTO_UDP:
+#ifdef COAP_READ_BATCH
+		return coap_read_batch(ctx);
+#else
+		bytes_read = recvfrom(ctx->sockfd, buf, sizeof(buf), 0, &src.addr.sa, &src.size);
+		break;
+#endif
+	case COAP_PROTO_TCP:
+		bytes_read = recv(ctx->sockfd, buf, sizeof(buf), 0);
+		break;
+#ifdef WITH_MBEDTLS
+	case COAP_PROTO_DTLS:
+	case COAP_PROTO_TLS:
+		bytes_read = mbedtls_ssl_read(ctx->session->ssl, (unsigned char *)buf, sizeof(buf));
+		break;
+#endif
+	default:
+		warn("coap_read : not supported protocol %d\n", ctx->protocol);
+		return -1;
+	}
+#endif /* WITH_POSIX */
+#ifdef WITH_CONTIKI
+	if (uip_newdata()) {
+		uip_ipaddr_copy(&src.addr, &UIP_IP_BUF->srcipaddr);
+		src.port = UIP_UDP_BUF->srcport;
+		uip_ipaddr_copy(&dst.addr, &UIP_IP_BUF->destipaddr);
+		dst.port = UIP_UDP_BUF->destport;
+
+		bytes_read = uip_datalen();
+		((char *)uip_appdata)[bytes_read] = 0;
+		PRINTF("Server received %d bytes from [", (int)bytes_read);
+		PRINT6ADDR(&src.addr);
+		PRINTF("]:%d\n", uip_ntohs(src.port));
+	}
+#endif							/* WITH_CONTIKI */
+#ifdef WITH_LWIP
+	/* FIXME: use lwip address operation functions */
+	src.addr.addr = ctx->pending_address.addr;
+	src.port = ctx->pending_port;
+	bytes_read = ctx->pending_package->tot_len;
+#endif							/* WITH_LWIP */
+
+	return coap_queue_read(ctx, buf, bytes_read, &src, &dst);
+}
+
 int coap_remove_from_queue(coap_queue_t **queue, coap_tid_t id, coap_queue_t **node)
 {
 	coap_queue_t *p, *q;
@@ -17,6 +17,10 @@
  ****************************************************************************/
 
 #include <fcntl.h>
+#include <sys/stat.h>
+#ifdef CONFIG_NET_SENDFILE
+#include <sys/sendfile.h>
+#endif
 #include <protocols/webserver/http_err.h>
 #include <protocols/webserver/http_keyvalue_list.h>
 #include <protocols/webclient.h>
@@ -573,16 +577,8 @@ void http_handle_file(struct http_client_t *client, int method, const char *url,
 
 	switch (method) {
 	case HTTP_METHOD_GET:
-		if ((f = fopen(url, "r")) != NULL) {
-			fgets(entity, HTTP_CONF_MAX_ENTITY_LENGTH, f);
-			if (http_send_response(client, 200, entity, NULL) == HTTP_ERROR) {
-				HTTP_LOGE("Error: Fail to send response\n");
-			}
-			fclose(f);
-		} else {
-			if (http_send_response(client, 404, HTTP_ERROR_404, NULL) == HTTP_ERROR) {
-				HTTP_LOGE("Error: Fail to send response\n");
-			}
+		if (http_send_file(client, url) == HTTP_ERROR) {
+			HTTP_LOGE("Error: Fail to send response\n");
 		}
 		break;
 	case HTTP_METHOD_POST:
@@ -658,10 +654,34 @@ void http_handle_file(struct http_client_t *client, int method, const char *url,
 	}
 }
 
+static int http_client_send(struct http_client_t *client, const char *buf, int sndlen)
+{
+	int buflen = 0;
+	int ret;
+
+	while (sndlen > 0) {
+#ifdef CONFIG_NET_SECURITY_TLS
+		if (client->server->tls_init) {
+			ret = mbedtls_ssl_write(&(client->tls_ssl), (unsigned char *)buf + buflen, sndlen);
+		} else
+#endif
+		{
+			ret = send(client->client_fd, buf + buflen, sndlen, 0);
+		}
+
+		if (ret < 1) {
+			return HTTP_ERROR;
+		}
+		sndlen -= ret;
+		buflen += ret;
+	}
+	return HTTP_OK;
+}
+
 int http_send_response(struct http_client_t *client, int status, const char *body, struct http_keyvalue_list_t *headers)
 {
 	char *buf;
-	int buflen = 0, ret, sndlen;
+	int buflen = 0, ret;
 	struct http_keyvalue_t *cur = NULL;
 
 	buf = HTTP_MALLOC(HTTP_CONF_MAX_REQUEST_LENGTH);
@@ -717,26 +737,75 @@ int http_send_response(struct http_client_t *client, int status, const char *bod
 		}
 	}
 
-	sndlen = strlen(buf);
-	buflen = 0;
-	while (sndlen > 0) {
-#ifdef CONFIG_NET_SECURITY_TLS
-		if (client->server->tls_init) {
-			ret = mbedtls_ssl_write(&(client->tls_ssl), (unsigned char *)buf + buflen, sndlen);
-		} else
-#endif
-		{
-			ret = send(client->client_fd, buf + buflen, sndlen, 0);
-		}
+	ret = http_client_send(client, buf, strlen(buf));
+	HTTP_FREE(buf);
+	return ret;
+}
 
-		if (ret < 1) {
-			HTTP_FREE(buf);
-			return HTTP_ERROR;
-		} else {
-			sndlen -= ret;
-			buflen += ret;
+int http_send_file(struct http_client_t *client, const char *path)
+{
+	struct stat st;
+	char *buf;
+	off_t sent = 0;
+	ssize_t ret;
+	int buflen;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		HTTP_LOGE("fail to open %s\n", path);
+		return http_send_response(client, 404, HTTP_ERROR_404, NULL);
+	}
+
+	if (fstat(fd, &st) < 0) {
+		HTTP_LOGE("fail to stat %s\n", path);
+		close(fd);
+		return http_send_response(client, 500, HTTP_ERROR_500, NULL);
+	}
+
+	buf = HTTP_MALLOC(HTTP_CONF_MAX_REQUEST_LENGTH);
+	if (buf == NULL) {
+		HTTP_LOGE("Error: Fail to malloc buffer\n");
+		close(fd);
+		return HTTP_ERROR;
+	}
+
+	buflen = snprintf(buf, HTTP_CONF_MAX_REQUEST_LENGTH,
+					  "HTTP/1.1 200 OK\r\n"
+					  "Content-type: text/html\r\n"
+					  "Connection: close\r\n"
+					  "Content-Length: %ld\r\n"
+					  "\r\n",
+					  (long)st.st_size);
+	if (http_client_send(client, buf, buflen) != HTTP_OK) {
+		HTTP_FREE(buf);
+		close(fd);
+		return HTTP_ERROR;
+	}
+
+#ifdef CONFIG_NET_SENDFILE
+	if (!client->server->tls_init) {
+		/* The file goes to the socket by reference, not through buf */
+		while (sent < st.st_size) {
+			ret = sendfile(client->client_fd, fd, NULL, st.st_size - sent);
+			if (ret <= 0) {
+				break;
+			}
+			sent += ret;
+		}
+	} else
+#endif
+	{
+		while (sent < st.st_size) {
+			ret = read(fd, buf, HTTP_CONF_MAX_REQUEST_LENGTH);
+			if (ret <= 0 || http_client_send(client, buf, ret) != HTTP_OK) {
+				break;
+			}
+			sent += ret;
 		}
 	}
+
 	HTTP_FREE(buf);
-	return HTTP_OK;
+	close(fd);
+	return (sent == st.st_size) ? HTTP_OK : HTTP_ERROR;
 }
@@ -81,6 +81,23 @@ struct msg_callback_info_s {
 };
 typedef struct msg_callback_info_s msg_callback_info_t;
 
+/**
+ * @brief The mode of message port handle
+ * @details MSG_PORT_SEND : The handle sends messages to the receiver of the port.\n
+ * MSG_PORT_RECV : The handle receives messages from the port.
+ */
+enum msg_port_mode_e {
+	MSG_PORT_SEND = 0,
+	MSG_PORT_RECV = 1,
+	MSG_PORT_MODE_MAX
+};
+typedef enum msg_port_mode_e msg_port_mode_t;
+
+/**
+ * @brief The handle of opened message port
+ */
+typedef struct msg_port_handle_s msg_port_handle_t;
+
 /**
  * @brief Send(unicast) message with sync mode.
  * @details @b #include <messaging/messaging.h>\n
@@ -203,6 +220,62 @@ int messaging_recv_nonblock(const char *port_name, msg_recv_buf_t *recv_buf, msg
  */
 int messaging_cleanup(const char *port_name);
 
+/**
+ * @brief Open the message port and return the handle for repeated send or receive.
+ * @details @b #include <messaging/messaging.h>\n
+ * With MSG_PORT_RECV, the receiver is registered to the port until messaging_port_close is called.\n
+ * With MSG_PORT_SEND, the receiver of the port should be opened with MSG_PORT_RECV before.\n
+ * The message queue and the packet buffer are kept in the handle,\n
+ * so send and receive through the handle do not open the message queue every time.
+ * @param[in] port_name The message port name.
+ * @param[in] mode MSG_PORT_SEND or MSG_PORT_RECV
+ * @param[in] msgsize The maximum length of message which is sent or received through the handle.
+ * @return On success, the handle is returned. On failure, NULL is returned.
+ * @since TizenRT v3.0
+ */
+msg_port_handle_t *messaging_port_open(const char *port_name, msg_port_mode_t mode, int msgsize);
+/**
+ * @brief Send(unicast) message with noreply mode through the opened handle.
+ * @details @b #include <messaging/messaging.h>\n
+ * @param[in] handle The handle which is opened with MSG_PORT_SEND.
+ * @param[in] send_data The message to be sent. msglen should not be larger than msgsize of the handle.
+ * @return On success, OK is returned. On failure, ERROR is returned.
+ * @since TizenRT v3.0
+ */
+int messaging_port_send(msg_port_handle_t *handle, msg_send_data_t *send_data);
+/**
+ * @brief Send(unicast) message with sync mode through the opened handle.
+ * @details @b #include <messaging/messaging.h>\n
+ * Sender waits after sending message until receiving the reply.\n
+ * The reply port is kept in the per-task reply port cache until messaging_port_close is called.
+ * @param[in] handle The handle which is opened with MSG_PORT_SEND.
+ * @param[in] send_data The message to be sent. msglen should not be larger than msgsize of the handle.
+ * @param reply_buf A message buffer to receive the reply message
+ * @return On success, OK is returned. On failure, ERROR is returned.
+ * @since TizenRT v3.0
+ */
+int messaging_port_send_sync(msg_port_handle_t *handle, msg_send_data_t *send_data, msg_recv_buf_t *reply_buf);
+/**
+ * @brief Wait to receive unicast message through the opened handle.
+ * @details @b #include <messaging/messaging.h>\n
+ * @param[in] handle The handle which is opened with MSG_PORT_RECV.
+ * @param recv_buf
+ *		[out] buf         : The message buffer to receive the message\n
+ *		[in] buflen       : The length of message buffer\n
+ *		[out] sender_pid  : The pid who sends this message\n
+ * @return On success, Received message Type is returned. On failure, ERROR is returned.
+ * @since TizenRT v3.0
+ */
+int messaging_port_recv(msg_port_handle_t *handle, msg_recv_buf_t *recv_buf);
+/**
+ * @brief Close the handle which is opened by messaging_port_open.
+ * @details @b #include <messaging/messaging.h>\n
+ * @param[in] handle The handle to be closed.
+ * @return On success, OK is returned. On failure, ERROR is returned.
+ * @since TizenRT v3.0
+ */
+int messaging_port_close(msg_port_handle_t *handle);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
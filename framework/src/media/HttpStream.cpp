@@ -16,9 +16,18 @@
  *
  ******************************************************************/
 
+#include <tinyara/config.h>
 #include <curl/curl.h>
 #include <curl/easy.h>
 #include <debug.h>
+#ifdef CONFIG_HTTPSOURCE_ZEROCOPY
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <net/lwip/pbuf.h>
+#endif
 
 #include "HttpStream.h"
 
@@ -34,6 +43,52 @@ namespace stream {
 		}\
 	} while (0)
 
+#ifdef CONFIG_HTTPSOURCE_ZEROCOPY
+// Longest header line accepted from the server
+#define HTTP_HEADER_LINE_MAX 1024
+
+static const std::string HTTP_SCHEME = "http://";
+
+/*
+ * Split a plain http URL into the Host header and the request path.
+ * Other URLs, and URLs with credentials, are left to curl.
+ */
+static bool splitHttpUrl(const std::string &url, std::string &host, std::string &path)
+{
+	if (url.compare(0, HTTP_SCHEME.length(), HTTP_SCHEME) != 0) {
+		return false;
+	}
+
+	auto start = HTTP_SCHEME.length();
+	auto end = url.find_first_of("/?#", start);
+	host = url.substr(start, (end == std::string::npos) ? std::string::npos : end - start);
+	if (host.empty() || host.find('@') != std::string::npos) {
+		return false;
+	}
+
+	path = (end == std::string::npos) ? "" : url.substr(end, url.find('#', end) - end);
+	if (path.empty() || path[0] != '/') {
+		path = "/" + path;
+	}
+	return true;
+}
+
+static bool waitSocket(curl_socket_t sockfd, short events)
+{
+	struct pollfd pfd;
+	pfd.fd = sockfd;
+	pfd.events = events;
+	pfd.revents = 0;
+	while (poll(&pfd, 1, -1) < 0) {
+		if (errno != EINTR) {
+			meddbg("poll failed, errno %d\n", errno);
+			return false;
+		}
+	}
+	return true;
+}
+#endif
+
 int HttpStream::mInitializeCount = 0;
 
 std::shared_ptr<HttpStream> HttpStream::create()
@@ -48,7 +103,8 @@ std::shared_ptr<HttpStream> HttpStream::create()
 }
 
 HttpStream::HttpStream() :
-	mCurl(nullptr), mHttpHeaders(nullptr), mInitializeFlag(false)
+	mCurl(nullptr), mHttpHeaders(nullptr), mHeaderCallback(nullptr), mHeaderData(nullptr),
+	mWriteCallback(nullptr), mWriteData(nullptr), mInitializeFlag(false)
 {
 }
 
@@ -71,6 +127,8 @@ bool HttpStream::setHeaderCallback(CallbackFunc callback, void *userdata)
 {
 	SET_OPTION(mCurl, CURLOPT_HEADERFUNCTION, callback);
 	SET_OPTION(mCurl, CURLOPT_HEADERDATA, userdata);
+	mHeaderCallback = callback;
+	mHeaderData = userdata;
 	return true;
 }
 
@@ -78,6 +136,8 @@ bool HttpStream::setWriteCallback(CallbackFunc callback, void *userdata)
 {
 	SET_OPTION(mCurl, CURLOPT_WRITEFUNCTION, callback);
 	SET_OPTION(mCurl, CURLOPT_WRITEDATA, userdata);
+	mWriteCallback = callback;
+	mWriteData = userdata;
 	return true;
 }
 
@@ -151,8 +211,170 @@ bool HttpStream::perform()
 	return true;
 }
 
+#ifdef CONFIG_HTTPSOURCE_ZEROCOPY
+bool HttpStream::sendRequest(CURL *curl, curl_socket_t sockfd, const std::string &host, const std::string &path)
+{
+	// HTTP/1.0 keeps the body unchunked, and the server ends it by closing
+	std::string request = "GET " + path + " HTTP/1.0\r\nHost: " + host + "\r\n";
+	for (curl_slist *item = mHttpHeaders; item != nullptr; item = item->next) {
+		request += item->data;
+		request += "\r\n";
+	}
+	request += "\r\n";
+
+	size_t sent = 0;
+	while (sent < request.length()) {
+		size_t len = 0;
+		CURLcode result = curl_easy_send(curl, request.data() + sent, request.length() - sent, &len);
+		if (result == CURLE_AGAIN) {
+			if (!waitSocket(sockfd, POLLOUT)) {
+				return false;
+			}
+			continue;
+		}
+		if (result != CURLE_OK) {
+			meddbg("curl_easy_send failed, result %d - %s\n", result, curl_easy_strerror(result));
+			return false;
+		}
+		sent += len;
+	}
+
+	return true;
+}
+
+bool HttpStream::receiveResponse(curl_socket_t sockfd, bool &redirected)
+{
+	std::string line;
+	bool inHeader = true;
+	bool gotStatus = false;
+	bool failed = false;
+
+	// Header lines go to the header callback one by one, like curl does,
+	// and the body goes to the write callback straight from the pbufs.
+	// Nothing is delivered unless the status is 2xx.
+	auto deliver = [&](char *data, size_t size) -> bool {
+		while (inHeader && size > 0) {
+			auto eol = static_cast<char *>(memchr(data, '\n', size));
+			size_t len = (eol != nullptr) ? (size_t)(eol - data + 1) : size;
+			line.append(data, len);
+			data += len;
+			size -= len;
+			if (eol == nullptr) {
+				return line.length() <= HTTP_HEADER_LINE_MAX;
+			}
+			if (!gotStatus) {
+				int major = 0;
+				int minor = 0;
+				int status = 0;
+				if (sscanf(line.c_str(), "HTTP/%d.%d %d", &major, &minor, &status) != 3) {
+					meddbg("invalid status line\n");
+					failed = true;
+					return false;
+				}
+				if (status >= 300 && status < 400) {
+					redirected = true;
+					return false;
+				}
+				if (status < 200 || status >= 300) {
+					meddbg("http status %d\n", status);
+					failed = true;
+					return false;
+				}
+				gotStatus = true;
+			}
+			if (mHeaderCallback != nullptr && mHeaderCallback(&line[0], 1, line.length(), mHeaderData) != line.length()) {
+				return false;
+			}
+			inHeader = (line != "\r\n" && line != "\n");
+			line.clear();
+		}
+		if (size > 0 && mWriteCallback != nullptr) {
+			return mWriteCallback(data, 1, size, mWriteData) == size;
+		}
+		return true;
+	};
+
+	while (true) {
+		struct pbuf *chain;
+		int len = lwip_recv_pbuf(sockfd, &chain, MSG_DONTWAIT);
+		if (len == 0) {
+			return !inHeader;
+		}
+		if (len < 0) {
+			if (errno == EWOULDBLOCK || errno == EAGAIN) {
+				if (!waitSocket(sockfd, POLLIN)) {
+					return false;
+				}
+				continue;
+			}
+			meddbg("lwip_recv_pbuf failed, errno %d\n", errno);
+			return false;
+		}
+
+		bool ret = true;
+		for (struct pbuf *q = chain; q != nullptr && ret; q = q->next) {
+			ret = deliver(static_cast<char *>(q->payload), q->len);
+		}
+		lwip_pbuf_release(chain);
+		if (!ret) {
+			if (!redirected && !failed) {
+				medwdbg("transfer terminated by callback\n");
+			}
+			return false;
+		}
+	}
+}
+
+bool HttpStream::downloadZeroCopy(const std::string &host, const std::string &path, bool &redirected)
+{
+	// curl resolves and connects, the request and the response go over the
+	// socket. A copy of the handle is used, so CURLOPT_CONNECT_ONLY does not
+	// stay on mCurl and the connection is closed with the copy.
+	CURL *curl = curl_easy_duphandle(mCurl);
+	if (curl == nullptr) {
+		meddbg("curl_easy_duphandle failed\n");
+		return false;
+	}
+
+	bool ret = false;
+	curl_socket_t sockfd = CURL_SOCKET_BAD;
+	CURLcode result = curl_easy_setopt(curl, CURLOPT_CONNECT_ONLY, 1L);
+	if (result == CURLE_OK) {
+		result = curl_easy_perform(curl);
+	}
+	if (result != CURLE_OK) {
+		meddbg("curl_easy_perform failed, result %d - %s\n", result, curl_easy_strerror(result));
+	} else if (curl_easy_getinfo(curl, CURLINFO_ACTIVESOCKET, &sockfd) != CURLE_OK || sockfd == CURL_SOCKET_BAD) {
+		meddbg("Get socket failed!\n");
+	} else if (sendRequest(curl, sockfd, host, path)) {
+		ret = receiveResponse(sockfd, redirected);
+	}
+
+	curl_easy_cleanup(curl);
+	return ret;
+}
+#endif
+
 bool HttpStream::download(const std::string &url)
 {
+#ifdef CONFIG_HTTPSOURCE_ZEROCOPY
+	std::string host;
+	std::string path;
+	bool redirected = false;
+	if (splitHttpUrl(url, host, path)) {
+		bool ret = downloadZeroCopy(host, path, redirected);
+		if (!redirected) {
+			if (!ret) {
+				meddbg("http get failed!\n");
+			}
+			return ret;
+		}
+		// Nothing was delivered, curl follows the redirect
+		medvdbg("http get redirected, using curl\n");
+	}
+	SET_OPTION(mCurl, CURLOPT_FOLLOWLOCATION, redirected ? 1L : 0L);
+#endif
+
 	SET_OPTION(mCurl, CURLOPT_HTTPGET, 1L);
 
 	SET_OPTION(mCurl, CURLOPT_URL, url.c_str());
@@ -66,7 +66,7 @@ public:
 	bool setReadCallback(CallbackFunc callback, void *userdata);
 
 	/*
-	 * Sets the callback for uploading local data
+	 * Downloads url, the response goes to the header and write callbacks
 	 */
 	bool download(const std::string &url);
 
@@ -80,11 +80,21 @@ private:
 	bool init();
 	void cleanup();
 	bool perform();
+#ifdef CONFIG_HTTPSOURCE_ZEROCOPY
+	bool downloadZeroCopy(const std::string &host, const std::string &path, bool &redirected);
+	bool sendRequest(CURL *curl, curl_socket_t sockfd, const std::string &host, const std::string &path);
+	bool receiveResponse(curl_socket_t sockfd, bool &redirected);
+#endif
 
 	// curl handle
 	CURL *mCurl;
 	// http level headers
 	curl_slist *mHttpHeaders;
+	// callbacks, kept for the transfers done without curl
+	CallbackFunc mHeaderCallback;
+	void *mHeaderData;
+	CallbackFunc mWriteCallback;
+	void *mWriteData;
 
 	bool mInitializeFlag;
 	static int mInitializeCount;
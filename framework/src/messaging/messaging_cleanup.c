@@ -77,6 +77,9 @@ int messaging_cleanup(const char *port_name)
 		return ERROR;
 	}
 
+	/* Close the cached reply port which this task used for sync send. */
+	messaging_reply_port_release(port_name);
+
 	ret = FREE_MSG_RECEIVER(port_name);
 	if (ret != OK) {
 		return ERROR;
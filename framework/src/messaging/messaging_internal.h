@@ -17,6 +17,7 @@
  ****************************************************************************/
 #include <tinyara/compiler.h>
 #include <mqueue.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <messaging/messaging.h>
@@ -105,6 +106,17 @@ struct msg_port_info_s {
 };
 typedef struct msg_port_info_s msg_port_info_t;
 
+/**
+ * @brief The internal structure for the opened message port handle
+ */
+struct msg_port_handle_s {
+	msg_port_mode_t mode;
+	mqd_t mqdes;
+	int msgsize;
+	char *packet;
+	char port_name[MAX_PORT_NAME_SIZE];
+};
+
 /**
  * @brief Internal function for setting callback function to the messaging signal.
  */
@@ -125,6 +137,20 @@ int messaging_send_internal(const char *port_name, msg_send_type_t msg_type, msg
  * @brief Internal function for sending message packet which has header and message.
  */
 int messaging_send_packet(const char *port_name, msg_send_type_t msg_type, msg_send_data_t *send_data, msg_callback_info_t *cb_info);
+/**
+ * @brief Internal function for filling the header of message packet.
+ */
+void messaging_fill_header(char *packet, msg_send_type_t msg_type);
+/**
+ * @brief Internal function for waiting the reply of sync send.
+ */
+int messaging_sync_recv(const char *port_name, msg_recv_buf_t *reply_buf);
+/**
+ * @brief Internal functions for getting and giving back the cached reply port.
+ */
+mqd_t messaging_reply_port_get(const char *reply_portname, int msgsize, int *port_msgsize);
+void messaging_reply_port_put(const char *reply_portname, mqd_t mqdes, bool discard);
+void messaging_reply_port_release(const char *port_name);
 /**
  * @brief Internal function for receiving APIs.
  */
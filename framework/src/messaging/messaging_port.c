@@ -0,0 +1,299 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <debug.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <messaging/messaging.h>
+#include "messaging_internal.h"
+
+#define MSG_RECV_NOT_INIT (-1)
+/****************************************************************************
+ * private functions
+ ****************************************************************************/
+static mqd_t messaging_port_open_sender(const char *port_name, int packet_size)
+{
+	int ret;
+	int recv_idx;
+	int recv_cnt = 0;
+	int recv_arr[CONFIG_MESSAGING_RECV_LIST_SIZE];
+	char *private_portname;
+	struct mq_attr internal_attr;
+	mqd_t mqdes;
+
+	for (recv_idx = 0; recv_idx < CONFIG_MESSAGING_RECV_LIST_SIZE; recv_idx++) {
+		recv_arr[recv_idx] = MSG_RECV_NOT_INIT;
+	}
+
+	/* The handle is for unicast, so there should be only one receiver. */
+	ret = READ_MSG_RECEIVER(port_name, recv_arr, recv_cnt);
+	if (ret == ERROR || recv_arr[0] == MSG_RECV_NOT_INIT) {
+		msgdbg("[Messaging] port open fail : no receiver.\n");
+		return (mqd_t)ERROR;
+	}
+	if (recv_cnt > 1) {
+		msgdbg("[Messaging] port open fail : too many receivers(%d)are waiting.\n", recv_cnt);
+		return (mqd_t)ERROR;
+	}
+
+	MSG_ASPRINTF(&private_portname, "%s%d", port_name, recv_arr[0]);
+	if (private_portname == NULL) {
+		msgdbg("[Messaging] port open fail : out of memory for private portname.\n");
+		return (mqd_t)ERROR;
+	}
+
+	internal_attr.mq_maxmsg = CONFIG_MESSAGING_MAXMSG;
+	internal_attr.mq_msgsize = packet_size;
+	internal_attr.mq_flags = 0;
+
+	mqdes = mq_open(private_portname, O_WRONLY, 0666, &internal_attr);
+	if (mqdes == (mqd_t)ERROR) {
+		msgdbg("[Messaging] port open fail : open fail, errno %d.\n", errno);
+	}
+	MSG_FREE(private_portname);
+
+	return mqdes;
+}
+
+static mqd_t messaging_port_open_receiver(const char *port_name, int packet_size)
+{
+	int ret;
+	char *internal_portname;
+	struct mq_attr internal_attr;
+	mqd_t mqdes;
+
+	MSG_ASPRINTF(&internal_portname, "%s%d", port_name, getpid());
+	if (internal_portname == NULL) {
+		msgdbg("[Messaging] port open fail : out of memory for internal portname.\n");
+		return (mqd_t)ERROR;
+	}
+
+	internal_attr.mq_maxmsg = CONFIG_MESSAGING_MAXMSG;
+	internal_attr.mq_msgsize = packet_size;
+	internal_attr.mq_flags = 0;
+
+	mqdes = mq_open(internal_portname, O_RDONLY | O_CREAT, 0666, &internal_attr);
+	if (mqdes == (mqd_t)ERROR) {
+		msgdbg("[Messaging] port open fail : open fail, errno %d.\n", errno);
+		MSG_FREE(internal_portname);
+		return (mqd_t)ERROR;
+	}
+
+	/* Save the receivers information. It will be used by sender to check the receivers. */
+	ret = SAVE_MSG_RECEIVER(port_name);
+	if (ret != OK) {
+		mq_close(mqdes);
+		mq_unlink(internal_portname);
+		MSG_FREE(internal_portname);
+		return (mqd_t)ERROR;
+	}
+
+	MSG_FREE(internal_portname);
+	return mqdes;
+}
+
+static int messaging_port_send_packet(msg_port_handle_t *handle, msg_send_type_t msg_type, msg_send_data_t *send_data)
+{
+	int ret;
+
+	if (handle == NULL || handle->mode != MSG_PORT_SEND) {
+		msgdbg("[Messaging] port send fail : invalid handle.\n");
+		return ERROR;
+	}
+
+	if (send_data == NULL || send_data->msg == NULL || send_data->msglen <= 0 || send_data->msglen > handle->msgsize || send_data->priority < 0) {
+		msgdbg("[Messaging] port send fail : invalid param of send data.\n");
+		return ERROR;
+	}
+
+	messaging_fill_header(handle->packet, msg_type);
+	memcpy(handle->packet + MSG_HEADER_SIZE, send_data->msg, send_data->msglen);
+
+	ret = mq_send(handle->mqdes, handle->packet, MSG_HEADER_SIZE + send_data->msglen, send_data->priority);
+	if (ret != OK) {
+		msgdbg("[Messaging] port send fail : errno %d.\n", errno);
+		return ERROR;
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * public functions
+ ****************************************************************************/
+/****************************************************************************
+ * messaging_port_open
+ ****************************************************************************/
+msg_port_handle_t *messaging_port_open(const char *port_name, msg_port_mode_t mode, int msgsize)
+{
+	msg_port_handle_t *handle;
+	int packet_size;
+
+	if (port_name == NULL || strlen(port_name) >= MAX_PORT_NAME_SIZE || msgsize <= 0) {
+		msgdbg("[Messaging] port open fail : invalid param.\n");
+		return NULL;
+	}
+
+	if (mode != MSG_PORT_SEND && mode != MSG_PORT_RECV) {
+		msgdbg("[Messaging] port open fail : invalid mode %d.\n", mode);
+		return NULL;
+	}
+
+	packet_size = MSG_HEADER_SIZE + msgsize;
+
+	handle = (msg_port_handle_t *)MSG_ALLOC(sizeof(msg_port_handle_t));
+	if (handle == NULL) {
+		msgdbg("[Messaging] port open fail : out of memory for handle.\n");
+		return NULL;
+	}
+
+	/* The packet buffer is allocated once and reused for every send and receive. */
+	handle->packet = (char *)MSG_ALLOC(packet_size);
+	if (handle->packet == NULL) {
+		msgdbg("[Messaging] port open fail : out of memory for packet.\n");
+		MSG_FREE(handle);
+		return NULL;
+	}
+
+	if (mode == MSG_PORT_SEND) {
+		handle->mqdes = messaging_port_open_sender(port_name, packet_size);
+	} else {
+		handle->mqdes = messaging_port_open_receiver(port_name, packet_size);
+	}
+
+	if (handle->mqdes == (mqd_t)ERROR) {
+		MSG_FREE(handle->packet);
+		MSG_FREE(handle);
+		return NULL;
+	}
+
+	handle->mode = mode;
+	handle->msgsize = msgsize;
+	strncpy(handle->port_name, port_name, MAX_PORT_NAME_SIZE);
+
+	return handle;
+}
+
+/****************************************************************************
+ * messaging_port_send
+ ****************************************************************************/
+int messaging_port_send(msg_port_handle_t *handle, msg_send_data_t *send_data)
+{
+	return messaging_port_send_packet(handle, MSG_SEND_NOREPLY, send_data);
+}
+
+/****************************************************************************
+ * messaging_port_send_sync
+ ****************************************************************************/
+int messaging_port_send_sync(msg_port_handle_t *handle, msg_send_data_t *send_data, msg_recv_buf_t *reply_buf)
+{
+	int ret;
+
+	if (reply_buf == NULL || reply_buf->buf == NULL || reply_buf->buflen <= 0) {
+		msgdbg("[Messaging] port send sync fail : invalid param of reply buf\n");
+		return ERROR;
+	}
+
+	ret = messaging_port_send_packet(handle, MSG_SEND_SYNC, send_data);
+	if (ret != OK) {
+		return ERROR;
+	}
+
+	return messaging_sync_recv(handle->port_name, reply_buf);
+}
+
+/****************************************************************************
+ * messaging_port_recv
+ ****************************************************************************/
+int messaging_port_recv(msg_port_handle_t *handle, msg_recv_buf_t *recv_buf)
+{
+	int ret;
+	ssize_t recv_size;
+	int msg_type;
+	int copy_len;
+
+	if (handle == NULL || handle->mode != MSG_PORT_RECV) {
+		msgdbg("[Messaging] port recv fail : invalid handle.\n");
+		return ERROR;
+	}
+
+	if (recv_buf == NULL || recv_buf->buf == NULL || recv_buf->buflen <= 0) {
+		msgdbg("[Messaging] port recv fail : invalid param.\n");
+		return ERROR;
+	}
+
+	recv_size = mq_receive(handle->mqdes, handle->packet, MSG_HEADER_SIZE + handle->msgsize, 0);
+	if (recv_size < (ssize_t)MSG_HEADER_SIZE) {
+		msgdbg("[Messaging] port recv fail : errno %d, %s.\n", errno, handle->port_name);
+		return ERROR;
+	}
+
+	/* Do not copy more than the received message. */
+	copy_len = recv_size - MSG_HEADER_SIZE;
+	if (copy_len > recv_buf->buflen) {
+		copy_len = recv_buf->buflen;
+	}
+
+	ret = messaging_parse_packet(handle->packet, recv_buf->buf, copy_len, &recv_buf->sender_pid, &msg_type);
+	if (ret != OK) {
+		return ERROR;
+	}
+
+	return msg_type;
+}
+
+/****************************************************************************
+ * messaging_port_close
+ ****************************************************************************/
+int messaging_port_close(msg_port_handle_t *handle)
+{
+	int ret = OK;
+	char *internal_portname;
+
+	if (handle == NULL) {
+		msgdbg("[Messaging] port close fail : invalid handle.\n");
+		return ERROR;
+	}
+
+	mq_close(handle->mqdes);
+
+	if (handle->mode == MSG_PORT_RECV) {
+		ret = FREE_MSG_RECEIVER(handle->port_name);
+
+		MSG_ASPRINTF(&internal_portname, "%s%d", handle->port_name, getpid());
+		if (internal_portname != NULL) {
+			mq_unlink(internal_portname);
+			MSG_FREE(internal_portname);
+		}
+	} else {
+		messaging_reply_port_release(handle->port_name);
+	}
+
+	MSG_FREE(handle->packet);
+	MSG_FREE(handle);
+
+	return ret;
+}
@@ -0,0 +1,323 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <semaphore.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <messaging/messaging.h>
+#include "messaging_internal.h"
+
+#if CONFIG_MESSAGING_REPLY_PORT_CACHE_SIZE > 0
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+/* One cached reply port. The cache is shared by all tasks, but the message
+ * queue descriptor is only valid in the task group which opened it, so each
+ * entry belongs to the task which created it and only that task uses it.
+ */
+struct msg_reply_port_s {
+	char name[MAX_PORT_NAME_SIZE];
+	pid_t owner;
+	mqd_t mqdes;
+	int msgsize;
+	bool inuse;
+	uint32_t last_used;
+};
+typedef struct msg_reply_port_s msg_reply_port_t;
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+static msg_reply_port_t g_reply_port_cache[CONFIG_MESSAGING_REPLY_PORT_CACHE_SIZE];
+/* Tasks which registered messaging_reply_port_exit, 0 for a free slot */
+static pid_t g_reply_port_owners[CONFIG_MESSAGING_REPLY_PORT_CACHE_SIZE];
+static sem_t g_reply_port_sem = SEM_INITIALIZER(1);
+static uint32_t g_reply_port_stamp;
+
+/****************************************************************************
+ * private functions
+ ****************************************************************************/
+static void messaging_reply_port_lock(void)
+{
+	while (sem_wait(&g_reply_port_sem) != OK) {
+		ASSERT(errno == EINTR);
+	}
+}
+
+static void messaging_reply_port_unlock(void)
+{
+	sem_post(&g_reply_port_sem);
+}
+
+static void messaging_reply_port_drop(msg_reply_port_t *entry)
+{
+	mq_close(entry->mqdes);
+	mq_unlink(entry->name);
+	entry->name[0] = '\0';
+	entry->owner = 0;
+	entry->mqdes = (mqd_t)ERROR;
+	entry->msgsize = 0;
+	entry->inuse = false;
+}
+
+static msg_reply_port_t *messaging_reply_port_find(const char *reply_portname)
+{
+	int idx;
+	pid_t pid = getpid();
+
+	for (idx = 0; idx < CONFIG_MESSAGING_REPLY_PORT_CACHE_SIZE; idx++) {
+		if (g_reply_port_cache[idx].name[0] != '\0' && g_reply_port_cache[idx].owner == pid && strncmp(g_reply_port_cache[idx].name, reply_portname, MAX_PORT_NAME_SIZE) == 0) {
+			return &g_reply_port_cache[idx];
+		}
+	}
+	return NULL;
+}
+
+/* The entries of other tasks are never evicted, their descriptors cannot
+ * be closed by the calling task.
+ */
+static msg_reply_port_t *messaging_reply_port_victim(void)
+{
+	int idx;
+	pid_t pid = getpid();
+	msg_reply_port_t *victim = NULL;
+
+	for (idx = 0; idx < CONFIG_MESSAGING_REPLY_PORT_CACHE_SIZE; idx++) {
+		if (g_reply_port_cache[idx].name[0] == '\0') {
+			return &g_reply_port_cache[idx];
+		}
+		if (g_reply_port_cache[idx].inuse || g_reply_port_cache[idx].owner != pid) {
+			continue;
+		}
+		if (victim == NULL || (int32_t)(g_reply_port_cache[idx].last_used - victim->last_used) < 0) {
+			victim = &g_reply_port_cache[idx];
+		}
+	}
+	if (victim != NULL) {
+		messaging_reply_port_drop(victim);
+	}
+	return victim;
+}
+
+/* Called when the task group of a task which owns cached entries exits.
+ * The descriptors are still valid here, so they are closed and the port
+ * names are unlinked, and a later task with the same pid cannot find them.
+ */
+static void messaging_reply_port_exit(int status, void *arg)
+{
+	int idx;
+	pid_t pid = (pid_t)(intptr_t)arg;
+
+	messaging_reply_port_lock();
+	for (idx = 0; idx < CONFIG_MESSAGING_REPLY_PORT_CACHE_SIZE; idx++) {
+		if (g_reply_port_cache[idx].name[0] != '\0' && g_reply_port_cache[idx].owner == pid) {
+			messaging_reply_port_drop(&g_reply_port_cache[idx]);
+		}
+		if (g_reply_port_owners[idx] == pid) {
+			g_reply_port_owners[idx] = 0;
+		}
+	}
+	messaging_reply_port_unlock();
+}
+
+/* The calling task may own entries only after it registered the exit
+ * handler, which is done once per task.
+ */
+static bool messaging_reply_port_register(void)
+{
+	int idx;
+	int slot = -1;
+	pid_t pid = getpid();
+
+	for (idx = 0; idx < CONFIG_MESSAGING_REPLY_PORT_CACHE_SIZE; idx++) {
+		if (g_reply_port_owners[idx] == pid) {
+			return true;
+		}
+		if (g_reply_port_owners[idx] == 0 && slot < 0) {
+			slot = idx;
+		}
+	}
+	if (slot < 0 || on_exit(messaging_reply_port_exit, (void *)(intptr_t)pid) != OK) {
+		return false;
+	}
+	g_reply_port_owners[slot] = pid;
+	return true;
+}
+#endif
+
+static mqd_t messaging_reply_port_create(const char *reply_portname, int msgsize)
+{
+	struct mq_attr internal_attr;
+
+	internal_attr.mq_maxmsg = CONFIG_MESSAGING_MAXMSG;
+	internal_attr.mq_msgsize = msgsize;
+	internal_attr.mq_flags = 0;
+
+	return mq_open(reply_portname, O_RDONLY | O_CREAT, 0666, &internal_attr);
+}
+
+/****************************************************************************
+ * functions
+ ****************************************************************************/
+/****************************************************************************
+ * Name : messaging_reply_port_get
+ *
+ * Description:
+ *  Get the reply port of the calling task for port_name.
+ *  A cached port is reused if its message size is large enough, otherwise
+ *  a new port is opened and kept in the cache when there is a free slot.
+ *
+ * Input Parameters:
+ *  reply_portname : The reply port name ("port_name + pid + _r")
+ *  msgsize        : The packet size which the reply port should hold
+ *  port_msgsize   : [out] The real message size of returned port
+ *
+ * Return Value:
+ *  On success, the message queue descriptor is returned.
+ *  On failure, (mqd_t)ERROR is returned.
+ ****************************************************************************/
+mqd_t messaging_reply_port_get(const char *reply_portname, int msgsize, int *port_msgsize)
+{
+#if CONFIG_MESSAGING_REPLY_PORT_CACHE_SIZE > 0
+	mqd_t mqdes;
+	msg_reply_port_t *entry;
+
+	if (strlen(reply_portname) >= MAX_PORT_NAME_SIZE) {
+		goto uncached;
+	}
+
+	messaging_reply_port_lock();
+
+	entry = messaging_reply_port_find(reply_portname);
+	if (entry != NULL) {
+		if (entry->inuse) {
+			/* Same task uses the same reply port concurrently, it cannot be shared. */
+			messaging_reply_port_unlock();
+			goto uncached;
+		}
+		if (entry->msgsize >= msgsize) {
+			entry->inuse = true;
+			entry->last_used = ++g_reply_port_stamp;
+			*port_msgsize = entry->msgsize;
+			messaging_reply_port_unlock();
+			return entry->mqdes;
+		}
+		/* Too small for this reply, re-create it with the larger size. */
+		messaging_reply_port_drop(entry);
+	} else {
+		entry = NULL;
+		if (messaging_reply_port_register()) {
+			entry = messaging_reply_port_victim();
+		}
+		if (entry == NULL) {
+			messaging_reply_port_unlock();
+			goto uncached;
+		}
+	}
+
+	mqdes = messaging_reply_port_create(reply_portname, msgsize);
+	if (mqdes == (mqd_t)ERROR) {
+		messaging_reply_port_unlock();
+		return (mqd_t)ERROR;
+	}
+
+	strncpy(entry->name, reply_portname, MAX_PORT_NAME_SIZE);
+	entry->owner = getpid();
+	entry->mqdes = mqdes;
+	entry->msgsize = msgsize;
+	entry->inuse = true;
+	entry->last_used = ++g_reply_port_stamp;
+	*port_msgsize = msgsize;
+	messaging_reply_port_unlock();
+	return mqdes;
+
+uncached:
+#endif
+	*port_msgsize = msgsize;
+	return messaging_reply_port_create(reply_portname, msgsize);
+}
+
+/****************************************************************************
+ * Name : messaging_reply_port_put
+ *
+ * Description:
+ *  Give back the reply port which was taken by messaging_reply_port_get.
+ *  If discard is true or the port is not cached, the port is closed and
+ *  unlinked, so that a late reply cannot be delivered to the next request.
+ ****************************************************************************/
+void messaging_reply_port_put(const char *reply_portname, mqd_t mqdes, bool discard)
+{
+#if CONFIG_MESSAGING_REPLY_PORT_CACHE_SIZE > 0
+	msg_reply_port_t *entry;
+
+	messaging_reply_port_lock();
+	entry = messaging_reply_port_find(reply_portname);
+	if (entry != NULL && entry->mqdes == mqdes) {
+		if (discard) {
+			messaging_reply_port_drop(entry);
+		} else {
+			entry->inuse = false;
+		}
+		messaging_reply_port_unlock();
+		return;
+	}
+	messaging_reply_port_unlock();
+#endif
+	mq_close(mqdes);
+	mq_unlink(reply_portname);
+}
+
+/****************************************************************************
+ * Name : messaging_reply_port_release
+ *
+ * Description:
+ *  Close and unlink the cached reply port of the calling task for port_name.
+ ****************************************************************************/
+void messaging_reply_port_release(const char *port_name)
+{
+#if CONFIG_MESSAGING_REPLY_PORT_CACHE_SIZE > 0
+	char *reply_portname;
+	msg_reply_port_t *entry;
+
+	MSG_ASPRINTF(&reply_portname, "%s%d%s", port_name, getpid(), "_r");
+	if (reply_portname == NULL) {
+		return;
+	}
+
+	messaging_reply_port_lock();
+	entry = messaging_reply_port_find(reply_portname);
+	if (entry != NULL && !entry->inuse) {
+		messaging_reply_port_drop(entry);
+	}
+	messaging_reply_port_unlock();
+
+	MSG_FREE(reply_portname);
+#endif
+}
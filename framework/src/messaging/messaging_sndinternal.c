@@ -63,6 +63,9 @@ static int messaging_set_async_callback(const char *port_name, msg_recv_buf_t *r
 		return ERROR;
 	}
 
+	/* The async reply port is unlinked after one reply, so it should not be shared with the cached sync reply port. */
+	messaging_reply_port_release(port_name);
+
 	mqdes = mq_open(reply_portname, O_RDONLY | O_CREAT, 0666, &internal_attr);
 	if (mqdes == (mqd_t)ERROR) {
 		msgdbg("[Messaging] send fail : open fail, errno %d.\n", errno);
@@ -89,6 +92,44 @@ static int messaging_set_async_callback(const char *port_name, msg_recv_buf_t *r
 	}
 	return OK;
 }
+/****************************************************************************
+ * Name : messaging_fill_header
+ *
+ * Description:
+ *  This function fills the messaging header at the front of packet.
+ ****************************************************************************/
+void messaging_fill_header(char *packet, msg_send_type_t msg_type)
+{
+	uint32_t send_type;
+	uint32_t msg_offset;
+	uint32_t msg_version;
+
+	/* Send packet(version 1) is like below.
+	 * +--------------------------------------------------------------------------------------------------------+
+	 * | version(4bytes) | msg_offset(4bytes) | sender_pid(4bytes) | msg type(4bytes) | message(Max 65515bytes) |
+	 * +--------------------------------------------------------------------------------------------------------+
+	 */
+
+	/* Add data header for message version and msg offset. */
+	msg_version = messaging_get_version();
+	((messaging_packet_t *)packet)->version = msg_version;
+	msg_offset = MSG_HEADER_SIZE;
+	((messaging_packet_t *)packet)->offset = msg_offset;
+
+	/* Add data header for sender pid. */
+	((messaging_packet_t *)packet)->sender_pid = getpid();
+
+	/* Add data header for send type. */
+	if (msg_type == MSG_SEND_NOREPLY || msg_type == MSG_SEND_MULTI) {
+		send_type = MSG_REPLY_NO_REQUIRED;
+	} else if (msg_type == MSG_SEND_REPLY) {
+		send_type = MSG_SEND_REPLY;
+	} else {
+		send_type = MSG_REPLY_REQUIRED;
+	}
+	((messaging_packet_t *)packet)->msg_type = send_type;
+}
+
 /****************************************************************************
  * Name : messaging_send_packet
  * 
@@ -111,9 +152,6 @@ int messaging_send_packet(const char *port_name, msg_send_type_t msg_type, msg_s
 	struct mq_attr internal_attr;
 	char *send_packet;
 	int send_size;
-	uint32_t send_type;
-	uint32_t msg_offset;
-	uint32_t msg_version;
 
 	send_size = MSG_HEADER_SIZE + send_data->msglen;
 
@@ -139,33 +177,10 @@ int messaging_send_packet(const char *port_name, msg_send_type_t msg_type, msg_s
 		return ERROR;
 	}
 
-	/* Send packet(version 1) is like below.
-	 * +--------------------------------------------------------------------------------------------------------+
-	 * | version(4bytes) | msg_offset(4bytes) | sender_pid(4bytes) | msg type(4bytes) | message(Max 65515bytes) |
-	 * +--------------------------------------------------------------------------------------------------------+
-	 */
-
-	/* Add data header for message version and msg offset. */
-	msg_version = messaging_get_version();
-	((messaging_packet_t *)send_packet)->version = msg_version;
-	msg_offset = MSG_HEADER_SIZE;
-	((messaging_packet_t *)send_packet)->offset = msg_offset;
-
-	/* Add data header for sender pid. */
-	((messaging_packet_t *)send_packet)->sender_pid = getpid();
-
-	/* Add data header for send type. */
-	if (msg_type == MSG_SEND_NOREPLY || msg_type == MSG_SEND_MULTI) {
-		send_type = MSG_REPLY_NO_REQUIRED;
-	} else if (msg_type == MSG_SEND_REPLY) {
-		send_type = MSG_SEND_REPLY;
-	} else {
-		send_type = MSG_REPLY_REQUIRED;
-	}
-	((messaging_packet_t *)send_packet)->msg_type = send_type;
+	messaging_fill_header(send_packet, msg_type);
 
 	/* Copy the real send message. */
-	memcpy(send_packet + msg_offset, send_data->msg, send_data->msglen);
+	memcpy(send_packet + MSG_HEADER_SIZE, send_data->msg, send_data->msglen);
 
 	ret = mq_send(mqdes, (char *)send_packet, send_size, send_data->priority);
 	if (ret != OK) {
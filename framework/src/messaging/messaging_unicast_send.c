@@ -23,6 +23,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <mqueue.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <sys/types.h>
@@ -33,29 +34,32 @@
 /****************************************************************************
  * private functions
  ****************************************************************************/
-static int messaging_sync_recv(const char *port_name, msg_recv_buf_t *reply_buf)
+/****************************************************************************
+ * Name : messaging_sync_recv
+ *
+ * Description:
+ *  This function waits the reply through the reply port of port_name.
+ *  The reply port is taken from the per-task reply port cache, so that
+ *  repeated sync requests do not open and unlink a new mqueue every time.
+ ****************************************************************************/
+int messaging_sync_recv(const char *port_name, msg_recv_buf_t *reply_buf)
 {
 	int ret = OK;
 	mqd_t sync_mqdes;
 	char *sync_portname;
-	struct mq_attr internal_attr;
 	char *reply_data;
 	int reply_size;
 	int msg_type;
 
 	reply_size = reply_buf->buflen + MSG_HEADER_SIZE;
 
-	internal_attr.mq_maxmsg = CONFIG_MESSAGING_MAXMSG;
-	internal_attr.mq_msgsize = reply_size;
-	internal_attr.mq_flags = 0;
-
 	/* sender waits the reply with "port_name + sender_pid + _r". */
 	MSG_ASPRINTF(&sync_portname, "%s%d%s", port_name, getpid(), "_r");
 	if (sync_portname == NULL) {
 		msgdbg("message send fail : sync portname allocation fail.\n");
 		return ERROR;
 	}
-	sync_mqdes = mq_open(sync_portname, O_RDONLY | O_CREAT, 0666, &internal_attr);
+	sync_mqdes = messaging_reply_port_get(sync_portname, reply_size, &reply_size);
 	if (sync_mqdes == (mqd_t)ERROR) {
 		msgdbg("message send fail : sync open fail %d.\n", errno);
 		MSG_FREE(sync_portname);
@@ -65,8 +69,8 @@ static int messaging_sync_recv(const char *port_name, msg_recv_buf_t *reply_buf)
 	reply_data = (char *)MSG_ALLOC(reply_size);
 	if (reply_data == NULL) {
 		msgdbg("message send fail : out of memory for including header\n");
-		mq_close(sync_mqdes);
-		mq_unlink(sync_portname);
+		messaging_reply_port_put(sync_portname, sync_mqdes, true);
+		MSG_FREE(sync_portname);
 		return ERROR;
 	}
 
@@ -81,8 +85,8 @@ static int messaging_sync_recv(const char *port_name, msg_recv_buf_t *reply_buf)
 		}
 	}
 
-	mq_close(sync_mqdes);
-	mq_unlink(sync_portname);
+	/* A failed receive can leave a late reply behind, so do not cache the port in that case. */
+	messaging_reply_port_put(sync_portname, sync_mqdes, (ret != OK));
 	MSG_FREE(reply_data);
 	MSG_FREE(sync_portname);
 
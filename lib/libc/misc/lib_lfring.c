@@ -0,0 +1,278 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <tinyara/lfring.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Copy into the ring at the free-running position pos, splitting the copy
+ * in two at the end of the storage.
+ */
+
+static void lfring_copyin(FAR struct lfring_s *ring, uint32_t pos, FAR const uint8_t *src, size_t len)
+{
+	uint32_t off = pos & ring->mask;
+	size_t first = ring->size - off;
+
+	if (first > len) {
+		first = len;
+	}
+
+	memcpy(ring->buffer + off, src, first);
+	if (len > first) {
+		memcpy(ring->buffer, src + first, len - first);
+	}
+}
+
+static void lfring_copyout(FAR struct lfring_s *ring, uint32_t pos, FAR uint8_t *dest, size_t len)
+{
+	uint32_t off = pos & ring->mask;
+	size_t first = ring->size - off;
+
+	if (first > len) {
+		first = len;
+	}
+
+	memcpy(dest, ring->buffer + off, first);
+	if (len > first) {
+		memcpy(dest + first, ring->buffer, len - first);
+	}
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lfring_init
+ ****************************************************************************/
+
+int lfring_init(FAR struct lfring_s *ring, FAR void *buffer, size_t size, size_t recsize)
+{
+	DEBUGASSERT(ring && buffer);
+
+	if (size == 0 || (size & (size - 1)) != 0 || recsize > size || recsize > UINT16_MAX) {
+		return -EINVAL;
+	}
+
+	ring->buffer = (FAR uint8_t *)buffer;
+	ring->size = size;
+	ring->mask = size - 1;
+	ring->head = 0;
+	ring->tail = 0;
+	ring->recsize = recsize;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: lfring_reset
+ ****************************************************************************/
+
+void lfring_reset(FAR struct lfring_s *ring)
+{
+	ring->head = 0;
+	ring->tail = 0;
+}
+
+/****************************************************************************
+ * Name: lfring_write
+ ****************************************************************************/
+
+size_t lfring_write(FAR struct lfring_s *ring, FAR const void *data, size_t len)
+{
+	uint32_t head = ring->head;
+	size_t space = ring->size - (head - LFRING_LOAD(&ring->tail));
+
+	if (len > space) {
+		len = space;
+	}
+
+	if (len > 0) {
+		lfring_copyin(ring, head, (FAR const uint8_t *)data, len);
+		LFRING_STORE(&ring->head, head + len);
+	}
+
+	return len;
+}
+
+/****************************************************************************
+ * Name: lfring_peek
+ ****************************************************************************/
+
+size_t lfring_peek(FAR struct lfring_s *ring, FAR void *data, size_t len)
+{
+	uint32_t tail = ring->tail;
+	size_t used = LFRING_LOAD(&ring->head) - tail;
+
+	if (len > used) {
+		len = used;
+	}
+
+	if (len > 0) {
+		lfring_copyout(ring, tail, (FAR uint8_t *)data, len);
+	}
+
+	return len;
+}
+
+/****************************************************************************
+ * Name: lfring_read
+ ****************************************************************************/
+
+size_t lfring_read(FAR struct lfring_s *ring, FAR void *data, size_t len)
+{
+	len = lfring_peek(ring, data, len);
+	if (len > 0) {
+		LFRING_STORE(&ring->tail, ring->tail + len);
+	}
+
+	return len;
+}
+
+/****************************************************************************
+ * Name: lfring_skip
+ ****************************************************************************/
+
+size_t lfring_skip(FAR struct lfring_s *ring, size_t len)
+{
+	uint32_t tail = ring->tail;
+	size_t used = LFRING_LOAD(&ring->head) - tail;
+
+	if (len > used) {
+		len = used;
+	}
+
+	LFRING_STORE(&ring->tail, tail + len);
+	return len;
+}
+
+/****************************************************************************
+ * Name: lfring_write_reserve
+ ****************************************************************************/
+
+size_t lfring_write_reserve(FAR struct lfring_s *ring, FAR void **ptr)
+{
+	uint32_t head = ring->head;
+	uint32_t off = head & ring->mask;
+	size_t space = ring->size - (head - LFRING_LOAD(&ring->tail));
+
+	if (space > ring->size - off) {
+		space = ring->size - off;
+	}
+
+	*ptr = ring->buffer + off;
+	return space;
+}
+
+/****************************************************************************
+ * Name: lfring_write_commit
+ ****************************************************************************/
+
+void lfring_write_commit(FAR struct lfring_s *ring, size_t len)
+{
+	DEBUGASSERT(len <= lfring_space(ring));
+	LFRING_STORE(&ring->head, ring->head + len);
+}
+
+/****************************************************************************
+ * Name: lfring_read_peek
+ ****************************************************************************/
+
+size_t lfring_read_peek(FAR struct lfring_s *ring, FAR void **ptr)
+{
+	uint32_t tail = ring->tail;
+	uint32_t off = tail & ring->mask;
+	size_t used = LFRING_LOAD(&ring->head) - tail;
+
+	if (used > ring->size - off) {
+		used = ring->size - off;
+	}
+
+	*ptr = ring->buffer + off;
+	return used;
+}
+
+/****************************************************************************
+ * Name: lfring_read_commit
+ ****************************************************************************/
+
+void lfring_read_commit(FAR struct lfring_s *ring, size_t len)
+{
+	DEBUGASSERT(len <= lfring_used(ring));
+	LFRING_STORE(&ring->tail, ring->tail + len);
+}
+
+/****************************************************************************
+ * Name: lfring_put
+ ****************************************************************************/
+
+size_t lfring_put(FAR struct lfring_s *ring, FAR const void *recs, size_t nrecs)
+{
+	uint32_t head = ring->head;
+	size_t space = ring->size - (head - LFRING_LOAD(&ring->tail));
+
+	DEBUGASSERT(ring->recsize > 0);
+
+	if (nrecs > space / ring->recsize) {
+		nrecs = space / ring->recsize;
+	}
+
+	if (nrecs > 0) {
+		lfring_copyin(ring, head, (FAR const uint8_t *)recs, nrecs * ring->recsize);
+		LFRING_STORE(&ring->head, head + nrecs * ring->recsize);
+	}
+
+	return nrecs;
+}
+
+/****************************************************************************
+ * Name: lfring_get
+ ****************************************************************************/
+
+size_t lfring_get(FAR struct lfring_s *ring, FAR void *recs, size_t nrecs)
+{
+	uint32_t tail = ring->tail;
+	size_t used = LFRING_LOAD(&ring->head) - tail;
+
+	DEBUGASSERT(ring->recsize > 0);
+
+	if (nrecs > used / ring->recsize) {
+		nrecs = used / ring->recsize;
+	}
+
+	if (nrecs > 0) {
+		lfring_copyout(ring, tail, (FAR uint8_t *)recs, nrecs * ring->recsize);
+		LFRING_STORE(&ring->tail, tail + nrecs * ring->recsize);
+	}
+
+	return nrecs;
+}
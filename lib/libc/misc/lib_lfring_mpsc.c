@@ -0,0 +1,144 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/* Bounded multi-producer / single-consumer queue of fixed size records.
+ *
+ * Every slot carries a sequence number.  A producer claims a slot by moving
+ * head with compare-and-swap, copies its record and then publishes the slot
+ * by advancing the sequence.  The consumer only takes a slot whose sequence
+ * says it is published, so no producer ever waits for another one.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <tinyara/lfring.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LFRING_SLOT(r, pos)     ((r)->buffer + ((pos) & (r)->mask) * (r)->slotsize)
+#define LFRING_SLOTSEQ(slot)    ((FAR uint32_t *)(slot))
+#define LFRING_SLOTDATA(slot)   ((slot) + sizeof(uint32_t))
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lfring_mpsc_init
+ ****************************************************************************/
+
+int lfring_mpsc_init(FAR struct lfring_mpsc_s *ring, FAR void *buffer, size_t nrecs, size_t recsize)
+{
+	uint32_t pos;
+
+	DEBUGASSERT(ring && buffer);
+
+	if (nrecs == 0 || (nrecs & (nrecs - 1)) != 0 || recsize == 0 ||
+		LFRING_MPSC_SLOTSIZE(recsize) > UINT16_MAX || ((uintptr_t)buffer & 3) != 0) {
+		return -EINVAL;
+	}
+
+	ring->buffer = (FAR uint8_t *)buffer;
+	ring->mask = nrecs - 1;
+	ring->recsize = recsize;
+	ring->slotsize = LFRING_MPSC_SLOTSIZE(recsize);
+	ring->head = 0;
+	ring->tail = 0;
+
+	/* Slot n is free for the producer which claims position n */
+
+	for (pos = 0; pos < nrecs; pos++) {
+		*LFRING_SLOTSEQ(LFRING_SLOT(ring, pos)) = pos;
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: lfring_mpsc_put
+ ****************************************************************************/
+
+int lfring_mpsc_put(FAR struct lfring_mpsc_s *ring, FAR const void *rec)
+{
+	FAR uint8_t *slot;
+	uint32_t pos;
+	uint32_t seq;
+
+	pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+	for (;;) {
+		slot = LFRING_SLOT(ring, pos);
+		seq = LFRING_LOAD(LFRING_SLOTSEQ(slot));
+
+		if (seq == pos) {
+			/* The slot is free, try to claim it.  On failure pos is
+			 * reloaded with the current head.
+			 */
+
+			if (__atomic_compare_exchange_n(&ring->head, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+				break;
+			}
+		} else if ((int32_t)(seq - pos) < 0) {
+			/* The slot still holds the record of the previous lap */
+
+			return -ENOSPC;
+		} else {
+			/* Another producer claimed this position */
+
+			pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+		}
+	}
+
+	memcpy(LFRING_SLOTDATA(slot), rec, ring->recsize);
+	LFRING_STORE(LFRING_SLOTSEQ(slot), pos + 1);
+	return OK;
+}
+
+/****************************************************************************
+ * Name: lfring_mpsc_get
+ ****************************************************************************/
+
+int lfring_mpsc_get(FAR struct lfring_mpsc_s *ring, FAR void *rec)
+{
+	FAR uint8_t *slot;
+	uint32_t pos = ring->tail;
+
+	slot = LFRING_SLOT(ring, pos);
+	if (LFRING_LOAD(LFRING_SLOTSEQ(slot)) != pos + 1) {
+		return -EAGAIN;
+	}
+
+	memcpy(rec, LFRING_SLOTDATA(slot), ring->recsize);
+
+	/* Hand the slot to the producer of the next lap */
+
+	LFRING_STORE(LFRING_SLOTSEQ(slot), pos + ring->mask + 1);
+	ring->tail = pos + 1;
+	return OK;
+}
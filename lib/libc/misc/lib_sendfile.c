@@ -61,6 +61,9 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <errno.h>
+#ifdef CONFIG_NET_SENDFILE
+#include <tinyara/fs/fs.h>
+#endif
 
 #include "lib_internal.h"
 
@@ -128,9 +131,17 @@
  *   EINVAL - Bad input parameters.
  *   ENOMEM - Could not allocated an I/O buffer
  *
+ *   With CONFIG_NET_SENDFILE, this is lib_sendfile() and sendfile() in
+ *   fs/vfs/fs_sendfile.c calls it for anything but a file sent to a TCP
+ *   socket.
+ *
  ************************************************************************/
 
+#ifdef CONFIG_NET_SENDFILE
+ssize_t lib_sendfile(int outfd, int infd, off_t *offset, size_t count)
+#else
 ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
+#endif
 {
 	FAR uint8_t *iobuffer;
 	FAR uint8_t *wrbuffer;
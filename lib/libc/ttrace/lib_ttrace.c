@@ -25,6 +25,7 @@
 #include <string.h>
 #include <sys/ioctl.h>
 #include <sys/types.h>
+#include <tinyara/arch.h>
 #include <tinyara/clock.h>
 #include <tinyara/ttrace.h>
 #include <tinyara/sched.h>
@@ -32,9 +33,6 @@
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
-#define TTRACE_EVENT_TYPE_BEGIN    'b'
-#define TTRACE_EVENT_TYPE_END      'e'
-#define TTRACE_EVENT_TYPE_SCHED    's'
 
 /****************************************************************************
  * Private Type Declarations
@@ -64,6 +62,12 @@ int fd = -1;
 /****************************************************************************
  * Private Data
  ****************************************************************************/
+#ifdef CONFIG_TTRACE_USERBUF
+/* The buffer shared with the driver, in the flat build it is visible to
+ * every task.
+ */
+static struct ttrace_ubuf_s *g_ubuf;
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -72,6 +76,11 @@ static int is_fd_available(void)
 {
 	if (fd < 0) {
 		fd = open("/dev/ttrace", O_WRONLY);
+#ifdef CONFIG_TTRACE_USERBUF
+		if (fd >= 0) {
+			ioctl(fd, TTRACE_GET_UBUF, (unsigned long)&g_ubuf);
+		}
+#endif
 	}
 
 	return fd;
@@ -81,6 +90,12 @@ static bool is_tag_available(int tag)
 {
 	int ret;
 
+#ifdef CONFIG_TTRACE_USERBUF
+	if (g_ubuf != NULL) {
+		return (g_ubuf->tags & tag) != 0;
+	}
+#endif
+
 	ret = ioctl(fd, TTRACE_FUNC_TAG, tag);
 	if (!(ret & tag)) {
 		return false;
@@ -90,134 +105,151 @@ static bool is_tag_available(int tag)
 }
 
 #ifdef CONFIG_DEBUG_TTRACE
-static void show_packet(struct trace_packet *packet)
+static void show_event(struct trace_event *event)
 {
-	int uid;
-	int size;
-
-	if (packet->event_type == TTRACE_EVENT_TYPE_SCHED) {
-		ttdbg("[%06d:%06d] %03d: %c|prev_comm=%s prev_pid=%u prev_prio=%u prev_state=%u ==> next_comm=%s next_pid=%u next_prio=%u\r\n",
-			packet->ts.tv_sec, packet->ts.tv_usec,
-			packet->pid,
-			(char)packet->event_type,
-			packet->msg.sched_msg.prev_comm,
-			packet->msg.sched_msg.prev_pid,
-			packet->msg.sched_msg.prev_prio,
-			packet->msg.sched_msg.prev_state,
-			packet->msg.sched_msg.next_comm,
-			packet->msg.sched_msg.next_pid,
-			packet->msg.sched_msg.next_prio);
-		size = sizeof(struct trace_packet);
+	if (event->type == TTRACE_REC_SCHED) {
+		ttdbg("sched: prev_pid=%u prev_prio=%u prev_state=%u ==> next_pid=%u next_prio=%u\r\n",
+			event->u.sched.prev_pid,
+			event->u.sched.prev_prio,
+			event->u.sched.prev_state,
+			event->u.sched.next_pid,
+			event->u.sched.next_prio);
 	} else {
-		ttdbg("time: %06d.%06d\r\n", packet->ts.tv_sec, packet->ts.tv_usec);
-		ttdbg("event_type: %c, %d\r\n", packet->event_type, packet->event_type);
-		ttdbg("pid: %d\r\n", packet->pid);
-		ttdbg("codelen: %d\r\n", packet->codelen);
-
-		uid = (packet->codelen & TTRACE_CODE_UNIQUE) >> 7;
-		ttdbg("unique code? %d\r\n", uid);
-		if (uid == TRUE) {
-			ttdbg("uid: %d\r\n", (packet->codelen & ~TTRACE_CODE_UNIQUE));
-			size = sizeof(struct trace_packet) - TTRACE_MSG_BYTES;
-		} else {
-			ttdbg("message: %s\r\n", packet->msg.message);
-			size = sizeof(struct trace_packet);
+		ttdbg("type: %d, pid: %d\r\n", event->type, getpid());
+		if (event->type == TTRACE_REC_BEGIN_UID) {
+			ttdbg("uid: %d\r\n", event->uid);
+		} else if (event->type == TTRACE_REC_BEGIN) {
+			ttdbg("message: %s\r\n", event->u.message);
 		}
 	}
-
-	ttdbg("packet size: %d\r\n", size);
 }
 #endif
 
-static int send_packet_sched(struct trace_packet *packet)
+static int write_event(struct trace_event *event, size_t len)
 {
-	int ret = 0;
-	ret = write(fd, packet, sizeof(struct trace_packet));
-	return ret;
+#ifdef CONFIG_DEBUG_TTRACE
+	show_event(event);
+#endif
+	return write(fd, event, len);
 }
 
-static int create_packet_sched(struct trace_packet *packet, struct tcb_s *prev, struct tcb_s *next)
+#ifdef CONFIG_TTRACE_USERBUF
+/****************************************************************************
+ * Name: put_event
+ *
+ * Description:
+ *   Add the event to the user buffer without a system call.  The driver is
+ *   asked to collect the buffer only when it is half full.
+ *
+ ****************************************************************************/
+static int put_event(struct trace_event *event, size_t len)
 {
-	int ret = TTRACE_VALID;
-	int msg_len = sizeof(struct sched_message);
+	struct lfring_mpsc_s *ring = &g_ubuf->ring;
+	struct trace_urecord urec;
 
-	gettimeofday(&(packet->ts), NULL);
-	packet->event_type = TTRACE_EVENT_TYPE_SCHED;
-	packet->pid = getpid();
-	packet->codelen = TTRACE_CODE_VARIABLE | msg_len;
+#ifdef CONFIG_DEBUG_TTRACE
+	show_event(event);
+#endif
 
-	packet->msg.sched_msg.pad = -1;
+	urec.tick = clock_systimer();
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+	urec.raw = up_perf_gettime();
+#else
+	urec.raw = 0;
+#endif
+	urec.pid = getpid();
+	memcpy(&urec.event, event, len);
 
-	if (prev != NULL) {
-		memcpy(packet->msg.sched_msg.prev_comm, prev->name, TTRACE_COMM_BYTES);
-		packet->msg.sched_msg.prev_pid = prev->pid;
-		packet->msg.sched_msg.prev_prio = prev->sched_priority;
-		packet->msg.sched_msg.prev_state = prev->task_state;
-	} else {
-		memcpy(packet->msg.sched_msg.prev_comm, "Idle Task", TTRACE_COMM_BYTES);
-		packet->msg.sched_msg.prev_pid = 0;
-		packet->msg.sched_msg.prev_prio = 0;
-		packet->msg.sched_msg.prev_state = 3;
+	if (lfring_mpsc_put(ring, &urec) != OK) {
+		ioctl(fd, TTRACE_COLLECT, 0);
+		if (lfring_mpsc_put(ring, &urec) != OK) {
+			return 0;
+		}
 	}
 
-	if (next != NULL) {
-		memcpy(packet->msg.sched_msg.next_comm, next->name, TTRACE_COMM_BYTES);
-		packet->msg.sched_msg.next_pid = next->pid;
-		packet->msg.sched_msg.next_prio = next->sched_priority;
-	} else {
-		memcpy(packet->msg.sched_msg.next_comm, "Idle Task", TTRACE_COMM_BYTES);
-		packet->msg.sched_msg.next_pid = 0;
-		packet->msg.sched_msg.next_prio = 0;
+	if (LFRING_LOAD(&ring->head) - LFRING_LOAD(&ring->tail) > (ring->mask + 1) / 2) {
+		ioctl(fd, TTRACE_COLLECT, 0);
 	}
 
-	packet->msg.sched_msg.prev_comm[TTRACE_COMM_BYTES - 1] = '\0';
-	packet->msg.sched_msg.next_comm[TTRACE_COMM_BYTES - 1] = '\0';
+	return len;
+}
+#endif
 
-	return ret;
+static int send_event(struct trace_event *event, size_t len)
+{
+#ifdef CONFIG_TTRACE_USERBUF
+	if (g_ubuf != NULL) {
+		return put_event(event, len);
+	}
+#endif
+	return write_event(event, len);
 }
 
-static int send_packet(struct trace_packet *packet)
+/****************************************************************************
+ * Name: create_event_sched
+ *
+ * Description:
+ *   Only the pids are written, the driver keeps the task names aside.
+ *
+ ****************************************************************************/
+static size_t create_event_sched(struct trace_event *event, struct tcb_s *prev, struct tcb_s *next)
 {
-	int ret = 0;
+	event->type = TTRACE_REC_SCHED;
+	event->uid = 0;
 
-	if (packet->codelen & TTRACE_CODE_UNIQUE) {
-		ret = write(fd, packet, sizeof(struct trace_packet) - TTRACE_MSG_BYTES);
+	if (prev != NULL) {
+		event->u.sched.prev_pid = prev->pid;
+		event->u.sched.prev_prio = prev->sched_priority;
+		event->u.sched.prev_state = prev->task_state;
 	} else {
-		ret = write(fd, packet, sizeof(struct trace_packet));
+		event->u.sched.prev_pid = 0;
+		event->u.sched.prev_prio = 0;
+		event->u.sched.prev_state = 3;
 	}
 
-	return ret;
+	if (next != NULL) {
+		event->u.sched.next_pid = next->pid;
+		event->u.sched.next_prio = next->sched_priority;
+	} else {
+		event->u.sched.next_pid = 0;
+		event->u.sched.next_prio = 0;
+	}
+
+	return TTRACE_EVENT_HDRBYTES + sizeof(struct trace_sched_event);
 }
 
-static int create_packet(struct trace_packet *packet, char type, char *str, va_list valist)
+static size_t create_event(struct trace_event *event, char *str, va_list valist)
 {
-	int ret = TTRACE_VALID;
-	int msg_len = strlen(str);
-	int div = msg_len / TTRACE_BYTE_ALIGN;
-	msg_len = div * TTRACE_BYTE_ALIGN + TTRACE_BYTE_ALIGN;
-	if (msg_len > TTRACE_MSG_BYTES) {
-		msg_len = TTRACE_MSG_BYTES;
-	}
+	int msg_len;
 
-	gettimeofday(&(packet->ts), NULL);
-	packet->event_type = (int8_t)type;
-	packet->pid = getpid();
-	packet->codelen = TTRACE_CODE_VARIABLE | msg_len;
+	event->type = TTRACE_REC_BEGIN;
+	event->uid = 0;
 
-	vsnprintf(packet->msg.message, msg_len, str, valist);
+	/* Most trace points pass a plain name, which needs no formatting */
 
-	return ret;
+	if (strchr(str, '%') == NULL) {
+		strncpy(event->u.message, str, TTRACE_MSG_BYTES - 1);
+		event->u.message[TTRACE_MSG_BYTES - 1] = '\0';
+		msg_len = strlen(event->u.message);
+	} else {
+		msg_len = vsnprintf(event->u.message, TTRACE_MSG_BYTES, str, valist);
+	}
+
+	if (msg_len < 0) {
+		msg_len = 0;
+		event->u.message[0] = '\0';
+	} else if (msg_len > TTRACE_MSG_BYTES - 1) {
+		msg_len = TTRACE_MSG_BYTES - 1;
+	}
+
+	return TTRACE_EVENT_HDRBYTES + msg_len + 1;
 }
 
-static int create_packet_uid(struct trace_packet *packet, char type, int8_t uniqueid)
+static size_t create_event_uid(struct trace_event *event, uint8_t type, int8_t uniqueid)
 {
-	int ret = 0;
-	gettimeofday(&(packet->ts), NULL);
-	packet->event_type = type;
-	packet->pid = getpid();
-	packet->codelen = TTRACE_CODE_UNIQUE | uniqueid;
-
-	return ret;
+	event->type = type;
+	event->uid = (uint8_t)uniqueid;
+	return TTRACE_EVENT_HDRBYTES;
 }
 
 /****************************************************************************
@@ -225,27 +257,16 @@ static int create_packet_uid(struct trace_packet *packet, char type, int8_t uniq
  ****************************************************************************/
 int trace_sched(struct tcb_s *prev_tcb, struct tcb_s *next_tcb)
 {
-	int ret = TTRACE_VALID;
 	int tag = TTRACE_TAG_TASK;
-	struct trace_packet packet;
+	struct trace_event event;
+	size_t len;
 
 	if (is_fd_available() < 0 || !is_tag_available(tag)) {
 		return TTRACE_INVALID;
 	}
 
-	ret = create_packet_sched(&packet, prev_tcb, next_tcb);
-	if (ret == TTRACE_INVALID) {
-		assert(0);
-	}
-
-#ifdef CONFIG_DEBUG_TTRACE
-	show_packet(&packet);
-#endif
-
-	ret = send_packet_sched(&packet);
-
-	return ret;
-
+	len = create_event_sched(&event, prev_tcb, next_tcb);
+	return write_event(&event, len);
 }
 
 /****************************************************************************
@@ -259,8 +280,8 @@ int trace_sched(struct tcb_s *prev_tcb, struct tcb_s *next_tcb)
  ****************************************************************************/
 int trace_begin(int tag, char *str, ...)
 {
-	int ret = TTRACE_VALID;
-	struct trace_packet packet;
+	struct trace_event event;
+	size_t len;
 	va_list ap;
 
 	if (is_fd_available() < 0 || !is_tag_available(tag)) {
@@ -268,42 +289,23 @@ int trace_begin(int tag, char *str, ...)
 	}
 
 	va_start(ap, str);
-	ret = create_packet(&packet, TTRACE_EVENT_TYPE_BEGIN, str, ap);
+	len = create_event(&event, str, ap);
 	va_end(ap);
-	if (ret == TTRACE_INVALID) {
-		assert(0);
-	}
 
-#ifdef CONFIG_DEBUG_TTRACE
-	show_packet(&packet);
-#endif
-
-	ret = send_packet(&packet);
-
-	return ret;
+	return send_event(&event, len);
 }
 
 int trace_begin_uid(int tag, int8_t uniqueid)
 {
-	int ret = TTRACE_VALID;
-	struct trace_packet packet;
+	struct trace_event event;
+	size_t len;
 
 	if (is_fd_available() < 0 || !is_tag_available(tag)) {
 		return TTRACE_INVALID;
 	}
 
-	ret = create_packet_uid(&packet, TTRACE_EVENT_TYPE_BEGIN, uniqueid);
-	if (ret == TTRACE_INVALID) {
-		assert(0);
-	}
-
-#ifdef CONFIG_DEBUG_TTRACE
-	show_packet(&packet);
-#endif
-
-	ret = send_packet(&packet);
-
-	return ret;
+	len = create_event_uid(&event, TTRACE_REC_BEGIN_UID, uniqueid);
+	return send_event(&event, len);
 }
 
 /****************************************************************************
@@ -318,29 +320,18 @@ int trace_begin_uid(int tag, int8_t uniqueid)
 
 int trace_end(int tag)
 {
-	int ret = TTRACE_VALID;
-	struct trace_packet packet;
+	struct trace_event event;
+	size_t len;
 
 	if (is_fd_available() < 0 || !is_tag_available(tag)) {
 		return TTRACE_INVALID;
 	}
 
-	ret = create_packet_uid(&packet, TTRACE_EVENT_TYPE_END, 0);
-	if (ret == TTRACE_INVALID) {
-		assert(0);
-	}
-
-#ifdef CONFIG_DEBUG_TTRACE
-	show_packet(&packet);
-#endif
-
-	ret = send_packet(&packet);
-
-	return ret;
+	len = create_event_uid(&event, TTRACE_REC_END, 0);
+	return send_event(&event, len);
 }
 
 int trace_end_uid(int tag)
 {
 	return trace_end(tag);
 }
-
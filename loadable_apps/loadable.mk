@@ -30,8 +30,10 @@ LDLIBPATH += -L $(TINYARALIB)
 LIBGCC = "${shell "$(CC)" $(ARCHCFLAGS) -print-libgcc-file-name}"
 LDLIBS += $(LIBGCC)
 
+# An app can set COMPRESSION_TYPE before including this file to use
+# another compression type than CONFIG_COMPRESSION_TYPE
 ifeq ($(CONFIG_COMPRESSED_BINARY),y)
-COMPRESSION_TYPE = $(CONFIG_COMPRESSION_TYPE)
+COMPRESSION_TYPE ?= $(CONFIG_COMPRESSION_TYPE)
 BLOCK_SIZE = $(CONFIG_COMPRESSION_BLOCK_SIZE)
 else
 COMPRESSION_TYPE = 0
@@ -0,0 +1,103 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/arm/src/armv7-m/up_perf.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+
+#include <tinyara/arch.h>
+
+#include "up_arch.h"
+#include "nvic.h"
+#include "dwt.h"
+
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The counter frequency is measured against up_mdelay() */
+
+#define PERF_CALIBRATE_MSEC 10
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint32_t g_perf_freq;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_perf_init
+ *
+ * Description:
+ *   Enable the DWT cycle counter and measure its frequency.
+ *
+ ****************************************************************************/
+
+void up_perf_init(void)
+{
+	uint32_t start;
+
+	modifyreg32(NVIC_DEMCR, 0, NVIC_DEMCR_TRCENA);
+	putreg32(0, DWT_CYCCNT);
+	modifyreg32(DWT_CTRL, 0, DWT_CTRL_CYCCNTENA_Msk);
+
+	start = getreg32(DWT_CYCCNT);
+	up_mdelay(PERF_CALIBRATE_MSEC);
+	g_perf_freq = (getreg32(DWT_CYCCNT) - start) * (1000 / PERF_CALIBRATE_MSEC);
+}
+
+/****************************************************************************
+ * Name: up_perf_gettime
+ *
+ * Description:
+ *   Return the current value of the free-running DWT cycle counter.
+ *
+ ****************************************************************************/
+
+uint32_t up_perf_gettime(void)
+{
+	return getreg32(DWT_CYCCNT);
+}
+
+/****************************************************************************
+ * Name: up_perf_getfreq
+ *
+ * Description:
+ *   Return the frequency of the counter returned by up_perf_gettime().
+ *
+ ****************************************************************************/
+
+uint32_t up_perf_getfreq(void)
+{
+	return g_perf_freq;
+}
+
+#endif /* CONFIG_ARCH_HAVE_PERF_COUNTER */
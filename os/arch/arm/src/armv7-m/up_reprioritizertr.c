@@ -181,6 +181,7 @@ void up_reprioritize_rtr(struct tcb_s *tcb, uint8_t priority)
 				/* Save the task name which will be scheduled */
 				save_task_scheduling_status(rtcb);
 #endif
+				sched_switch_account(rtcb);
 				/* Restore the MPU registers in case we are switching to an application task */
 #ifdef CONFIG_ARMV7M_MPU
 				up_set_mpu_app_configuration(rtcb);
@@ -206,6 +207,7 @@ void up_reprioritize_rtr(struct tcb_s *tcb, uint8_t priority)
 				/* Save the task name which will be scheduled */
 				save_task_scheduling_status(nexttcb);
 #endif
+				sched_switch_account(nexttcb);
 				up_switchcontext(rtcb->xcp.regs, nexttcb->xcp.regs);
 
 				/* up_switchcontext forces a context switch to the task at the
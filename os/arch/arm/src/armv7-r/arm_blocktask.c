@@ -147,6 +147,7 @@ void up_block_task(struct tcb_s *tcb, tstate_t task_state)
 			/* Save the task name which will be scheduled */
 			save_task_scheduling_status(rtcb);
 #endif
+			sched_switch_account(rtcb);
 
 			/* Then switch contexts. */
 			up_restorestate(rtcb->xcp.regs);
@@ -168,6 +169,7 @@ void up_block_task(struct tcb_s *tcb, tstate_t task_state)
 			/* Save the task name which will be scheduled */
 			save_task_scheduling_status(rtcb);
 #endif
+			sched_switch_account(rtcb);
 
 			/* Then switch contexts */
 			up_fullcontextrestore(rtcb->xcp.regs);
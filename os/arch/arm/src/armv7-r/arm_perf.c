@@ -0,0 +1,135 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/arm/src/armv7-r/arm_perf.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+
+#include <tinyara/arch.h>
+
+#include "sctlr.h"
+
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The counter frequency is measured against up_mdelay() */
+
+#define PERF_CALIBRATE_MSEC 10
+
+/* PMCNTENSET bit of the cycle counter */
+
+#define PMCNTEN_C          (1 << 31)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint32_t g_perf_freq;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline void cp15_wrpmcntenset(unsigned int mask)
+{
+	__asm__ __volatile__
+	(
+		"\tmcr p15, 0, %0, c9, c12, 1\n"
+		:
+		: "r"(mask)
+		: "memory"
+	);
+}
+
+static inline unsigned int cp15_rdpmccntr(void)
+{
+	unsigned int ccntr;
+	__asm__ __volatile__
+	(
+		"\tmrc p15, 0, %0, c9, c13, 0\n"
+		: "=r"(ccntr)
+		:
+		: "memory"
+	);
+
+	return ccntr;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_perf_init
+ *
+ * Description:
+ *   Enable the PMU cycle counter (PMCCNTR) and measure its frequency.
+ *
+ ****************************************************************************/
+
+void up_perf_init(void)
+{
+	uint32_t start;
+
+	/* Enable the counters, reset the cycle counter and count every cycle */
+
+	cp15_wrpmcr((cp15_rdpmcr() | PCMR_E | PCMR_C) & ~PCMR_D);
+	cp15_wrpmcntenset(PMCNTEN_C);
+
+	start = cp15_rdpmccntr();
+	up_mdelay(PERF_CALIBRATE_MSEC);
+	g_perf_freq = (cp15_rdpmccntr() - start) * (1000 / PERF_CALIBRATE_MSEC);
+}
+
+/****************************************************************************
+ * Name: up_perf_gettime
+ *
+ * Description:
+ *   Return the current value of the free-running PMU cycle counter.
+ *
+ ****************************************************************************/
+
+uint32_t up_perf_gettime(void)
+{
+	return cp15_rdpmccntr();
+}
+
+/****************************************************************************
+ * Name: up_perf_getfreq
+ *
+ * Description:
+ *   Return the frequency of the counter returned by up_perf_gettime().
+ *
+ ****************************************************************************/
+
+uint32_t up_perf_getfreq(void)
+{
+	return g_perf_freq;
+}
+
+#endif /* CONFIG_ARCH_HAVE_PERF_COUNTER */
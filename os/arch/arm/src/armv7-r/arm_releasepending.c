@@ -116,6 +116,7 @@ void up_release_pending(void)
 			/* Save the task name which will be scheduled */
 			save_task_scheduling_status(rtcb);
 #endif
+			sched_switch_account(rtcb);
 
 			/* Then switch contexts.  Any necessary address environment
 			 * changes will be made when the interrupt returns.
@@ -140,6 +141,7 @@ void up_release_pending(void)
 			/* Save the task name which will be scheduled */
 			save_task_scheduling_status(rtcb);
 #endif
+			sched_switch_account(rtcb);
 
 			/* Then switch contexts */
 			up_fullcontextrestore(rtcb->xcp.regs);
@@ -168,6 +168,7 @@ void up_reprioritize_rtr(struct tcb_s *tcb, uint8_t priority)
 				/* Save the task name which will be scheduled */
 				save_task_scheduling_status(rtcb);
 #endif
+				sched_switch_account(rtcb);
 				up_restorestate(rtcb->xcp.regs);
 			}
 
@@ -188,6 +189,7 @@ void up_reprioritize_rtr(struct tcb_s *tcb, uint8_t priority)
 				/* Save the task name which will be scheduled */
 				save_task_scheduling_status(rtcb);
 #endif
+				sched_switch_account(rtcb);
 				up_fullcontextrestore(rtcb->xcp.regs);
 			}
 		}
@@ -191,6 +191,7 @@ void _exit(int status)
 	/*Save the task name which will be scheduled */
 	save_task_scheduling_status(tcb);
 #endif
+	sched_switch_account(tcb);
 
 	/* Then switch contexts */
 
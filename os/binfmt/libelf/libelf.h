@@ -388,13 +388,14 @@ void elf_cache_uninit(void);
  * Name: elf_cache_init
  *
  * Description:
- *   Initialize the cache blocks
+ *   Initialize the cache blocks.  'compress' is the decompressor context
+ *   of a compressed binary, NULL otherwise.
  *
  * Returned value:
  *   OK (0) on Success
  *   ERROR (-1) on Failure
  ****************************************************************************/
-int elf_cache_init(int filfd, uint16_t offset, off_t filelen, uint8_t compression_type);
+int elf_cache_init(int filfd, uint16_t offset, off_t filelen, uint8_t compression_type, FAR struct compress_s *compress);
 
 /****************************************************************************
  * Name: elf_cache_read
@@ -63,6 +63,9 @@ static unsigned int max_accessed_count;
 
 /* Compression Type of a file */
 static unsigned int elf_compress_type;
+
+/* Decompressor context of a compressed file */
+static FAR struct compress_s *elf_compress;
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -159,11 +162,12 @@ static off_t elf_cache_read_block(int filfd, uint16_t binary_header_size, FAR ui
 	}
 #ifdef CONFIG_COMPRESSED_BINARY
 	else {
-		if (elf_compress_type == CONFIG_COMPRESSION_TYPE) {
+		if (elf_compress_type <= COMPRESSION_TYPE_MAX) {
 			/* Read readsize bytes from offset from uncompressed file into user buffer */
-			nbytes = compress_read(filfd, binary_header_size, buf, readsize, rpos - binary_header_size);
+			nbytes = compress_read(elf_compress, buf, readsize, rpos - binary_header_size);
 		} else {
 			berr("No support for decompression of compression format %d of this binary\n", elf_compress_type);
+			return -ENOSYS;
 		}
 	}
 #endif
@@ -440,7 +444,7 @@ error_cache_read:
  *   OK (0) on Success
  *   Negative value on Failure
  ****************************************************************************/
-int elf_cache_init(int filfd, uint16_t offset, off_t filelen, uint8_t compression_type)
+int elf_cache_init(int filfd, uint16_t offset, off_t filelen, uint8_t compression_type, FAR struct compress_s *compress)
 {
 	int ret = OK;
 
@@ -452,6 +456,7 @@ int elf_cache_init(int filfd, uint16_t offset, off_t filelen, uint8_t compressio
 	file_len = filelen;
 	number_of_blocks = file_len / cache_blocks_size;
 	elf_compress_type = compression_type;
+	elf_compress = compress;
 
 	/* Set number of blocks to use for caching */
 	if (CONFIG_ELF_CACHE_BLOCKS_COUNT < (CUTOFF_RATIO_CACHE_BLOCKS) * (number_of_blocks)) {
@@ -157,15 +157,16 @@ int elf_read(FAR struct elf_loadinfo_s *loadinfo, FAR uint8_t *buffer, size_t re
 #endif
 		} else if (loadinfo->compression_type > COMPRESS_TYPE_NONE) {	/* Compressed binary */
 #ifdef CONFIG_COMPRESSED_BINARY
-			if (loadinfo->compression_type == CONFIG_COMPRESSION_TYPE) {
+			if (loadinfo->compression_type <= COMPRESSION_TYPE_MAX) {
 				/* Read readsize bytes from offset from uncompressed file into unser buffer */
 #if defined(CONFIG_ELF_CACHE_READ)
 				nbytes = elf_cache_read(loadinfo->filfd, loadinfo->offset, buffer, readsize, offset - loadinfo->offset);
 #else
-				nbytes = compress_read(loadinfo->filfd, loadinfo->offset, buffer, readsize, offset - loadinfo->offset);
+				nbytes = compress_read(loadinfo->compress, buffer, readsize, offset - loadinfo->offset);
 #endif
 			} else {
 				berr("No support for decompression of compression format %d of this binary\n", loadinfo->compression_type);
+				return -ENOSYS;
 			}
 #else
 			berr("No support for reading compressed binaries\n");
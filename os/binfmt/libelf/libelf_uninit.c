@@ -106,7 +106,8 @@ int elf_uninit(struct elf_loadinfo_s *loadinfo)
 	/* Free buffers used for decompression */
 	if (loadinfo->compression_type > COMPRESS_TYPE_NONE) {
 #ifdef CONFIG_COMPRESSED_BINARY
-		compress_uninit();
+		compress_uninit(loadinfo->compress);
+		loadinfo->compress = NULL;
 #else
 		berr("No support for reading compressed binary\n");
 		return ERROR;
@@ -28,19 +28,32 @@
 #include <debug.h>
 #include <errno.h>
 
+#include <tinyara/arch.h>
+#include <tinyara/clock.h>
+#include <tinyara/kmalloc.h>
 #include <tinyara/fs/fs.h>
 #include <tinyara/binfmt/compression/compress_read.h>
 
-#if CONFIG_COMPRESSION_TYPE == 1
+#ifdef CONFIG_COMPRESSION_LZMA_DECODER
 #include "lzma/LzmaLib.h"
 #endif
+#ifdef CONFIG_COMPRESSION_LZ4_DECODER
+#include "lz4/lz4.h"
+#endif
 
 /****************************************************************************
- * Private Declarations
+ * Pre-processor Definitions
  ****************************************************************************/
 
-struct s_header compression_header;
-struct s_buffer buffers;
+/* Time spent in compress_read, as precise as the platform allows */
+
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+#define COMPRESS_TIME_NOW()      up_perf_gettime()
+#define COMPRESS_TIME_USEC(t)    ((uint32_t)((uint64_t)(t) * 1000000 / up_perf_getfreq()))
+#else
+#define COMPRESS_TIME_NOW()      ((uint32_t)clock_systimer())
+#define COMPRESS_TIME_USEC(t)    ((uint32_t)TICK2USEC(t))
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -50,28 +63,47 @@ struct s_buffer buffers;
  * Name: compress_decompress_block
  *
  * Description:
- *   Decompress block in 'read_buffer' of readsize into 'out_buffer' of writesize
+ *   Decompress block in 'read_buffer' of 'size' bytes into 'out_buffer'.
+ *   'writesize' is the decompressed size of the block on input and the
+ *   number of bytes decompressed on output.
  *
  * Returned Value:
  *   Non-negative value on Success.
  *   Negative value on Failure.
  ****************************************************************************/
-static int compress_decompress_block(unsigned char *out_buffer, unsigned int *writesize, unsigned char *read_buffer, unsigned int *size, int index)
+static int compress_decompress_block(FAR struct compress_s *compress, unsigned char *out_buffer, size_t *writesize, unsigned char *read_buffer, size_t *size)
 {
 	int ret = ERROR;
+	size_t expected = *writesize;
 
-#if CONFIG_COMPRESSION_TYPE == 1
-	if (compression_header.compression_format == COMPRESSION_TYPE_LZMA) {
+#ifdef CONFIG_COMPRESSION_LZMA_DECODER
+	if (compress->header.compression_format == COMPRESSION_TYPE_LZMA) {
 		/* LZMA specific logic for decompression */
-		*writesize = compression_header.blocksize;
+		if (*size <= LZMA_PROPS_SIZE) {
+			bmdbg("Incorrect LZMA block size %d\n", *size);
+			return ERROR;
+		}
 		*size -= (LZMA_PROPS_SIZE);
 
 		ret = LzmaUncompress(&out_buffer[0], writesize, &read_buffer[LZMA_PROPS_SIZE], size, &read_buffer[0], LZMA_PROPS_SIZE);
 
-		if (ret == SZ_ERROR_FAIL) {
-			bmdbg("Failure to decompress with LZMAUncompress API\n");
-			ret = -ret;
+		if (ret != SZ_OK) {
+			bmdbg("Failure to decompress with LZMAUncompress API : %d\n", ret);
+			ret = ERROR;
+		} else if (*writesize != expected) {
+			bmdbg("Decompressed %d bytes instead of %d\n", *writesize, expected);
+			ret = ERROR;
+		}
+	}
+#endif
+#ifdef CONFIG_COMPRESSION_LZ4_DECODER
+	if (compress->header.compression_format == COMPRESSION_TYPE_LZ4) {
+		ret = lz4_decompress(read_buffer, *size, out_buffer, expected);
+		if (ret < 0 || ret != expected) {
+			bmdbg("Failure to decompress LZ4 block : %d\n", ret);
+			return ERROR;
 		}
+		*writesize = ret;
 	}
 #endif
 
@@ -79,24 +111,26 @@ static int compress_decompress_block(unsigned char *out_buffer, unsigned int *wr
 }
 
 /****************************************************************************
- * Name: compress_blocks_to_read
+ * Name: compress_max_block
  *
  * Description:
- *   Assign values to first_block, last_block and number of blocks to be read
- *   from compressed file in this particular call to compress_read
- *
- * Returned Value:
- *   None
+ *   Return the largest size of one compressed block of 'blocksize' bytes
+ *   for the compression format, 0 if the format is not supported.
  ****************************************************************************/
-static void compress_blocks_to_read(int *first_block, int *last_block, int *no_blocks, int offset, int readsize)
+static unsigned int compress_max_block(int format, unsigned int blocksize)
 {
-	int blocksize;
-
-	blocksize = compression_header.blocksize;
-
-	*first_block = offset / blocksize;
-	*last_block = (offset + readsize) / blocksize;
-	*no_blocks = *last_block - *first_block + 1;
+	switch (format) {
+#ifdef CONFIG_COMPRESSION_LZMA_DECODER
+	case COMPRESSION_TYPE_LZMA:
+		return blocksize + LZMA_PROPS_SIZE;
+#endif
+#ifdef CONFIG_COMPRESSION_LZ4_DECODER
+	case COMPRESSION_TYPE_LZ4:
+		return LZ4_COMPRESSBOUND(blocksize);
+#endif
+	default:
+		return 0;
+	}
 }
 
 /****************************************************************************
@@ -104,20 +138,22 @@ static void compress_blocks_to_read(int *first_block, int *last_block, int *no_b
  *
  * Description:
  *   Parses the header containing compression related info present in the
- *   compressed file and assigns values to compression_header members
+ *   compressed file and reads the offsets of all compressed blocks
  *
  * Returned value:
  *   OK (0) is Success
- *   ERROR (-1) on Failure
+ *   Negative value on Failure
  ****************************************************************************/
-static int compress_parse_header(int filfd, uint16_t offset)
+static int compress_parse_header(FAR struct compress_s *compress, uint16_t offset)
 {
+	FAR struct s_header *header = &compress->header;
 	off_t rpos;					/* Position returned by lseek */
+	size_t tablesize;
 	int nbytes;					/* Number of bytes read  */
 
 	/* Seek to the next read position */
 
-	rpos = lseek(filfd, offset, SEEK_SET);
+	rpos = lseek(compress->filfd, offset, SEEK_SET);
 	if (rpos != offset) {
 		int errval = get_errno();
 		bmdbg("ERROR : leek to offset %lu failed: %d\n", (unsigned long)offset, errval);
@@ -126,143 +162,159 @@ static int compress_parse_header(int filfd, uint16_t offset)
 
 	/* Read compression header data from the file data from offset */
 
-	nbytes = read(filfd, &compression_header, sizeof(struct s_header));
+	nbytes = read(compress->filfd, header, sizeof(struct s_header));
 	if (nbytes != sizeof(struct s_header)) {
 		bmdbg("Read for compression header from offset %lu failed\n", offset);
 		return ERROR;
 	}
 
-	bmvdbg("Compressed Binary Header info: size (%d), compression format (%d), blocksize (%d), No. sections (%d), Uncompressed binary size = %d\n", compression_header.size_header, compression_header.compression_format, compression_header.blocksize, compression_header.sections, compression_header.binary_size);
+	bmvdbg("Compressed Binary Header info: size (%d), compression format (%d), blocksize (%d), No. sections (%d), Uncompressed binary size = %d\n", header->size_header, header->compression_format, header->blocksize, header->sections, header->binary_size);
 
-	return OK;
-}
+	if (header->blocksize <= 0 || header->sections < 2 || header->size_header != sizeof(struct s_header) + header->sections * sizeof(int)) {
+		bmdbg("Invalid compression header\n");
+		return -EINVAL;
+	}
 
-/****************************************************************************
- * Name: compress_offset_block
- *
- * Description:
- *   Returns offset of 'block_number' block by reading it from compression header
- *
- * Returned Value:
- *   'block_offset' value (positive) on Success
- *   Negative value on Failure
- ****************************************************************************/
-static off_t compress_offset_block(int filfd, uint16_t binary_header_size, int block_number)
-{
-	off_t rpos;
-	off_t position;
-	off_t block_offset;
-	int nbytes;
+	if ((header->binary_size + header->blocksize - 1) / header->blocksize != header->sections - 1) {
+		bmdbg("Binary size %d does not match %d blocks\n", header->binary_size, header->sections - 1);
+		return -EINVAL;
+	}
 
-	/* Seek to offset in compression header that has offset value for 'block_number' block */
-	position = binary_header_size + sizeof(struct s_header) + block_number * sizeof(int);
+	/* The table of block offsets follows the header.  It is read once here
+	 * instead of seeking into it for every block.  The last entry is the
+	 * end of the last block.
+	 */
 
-	rpos = lseek(filfd, position, SEEK_SET);
-	if (rpos != position) {
-		int errval = get_errno();
-		bmdbg("Failed to seek to position %lu: %d\n", (unsigned long)position, errval);
-		return -errval;
+	tablesize = header->sections * sizeof(int);
+	compress->secoff = (FAR int *)kmm_malloc(tablesize);
+	if (compress->secoff == NULL) {
+		bmdbg("Failed to allocate the block offset table\n");
+		return -ENOMEM;
 	}
 
-	/* Read offset value into block_offset */
-	nbytes = read(filfd, &block_offset, sizeof(off_t));
-	if (nbytes != sizeof(off_t)) {
-		bmdbg("Read for block offset for block no. %d failed\n", block_number);
+	nbytes = read(compress->filfd, compress->secoff, tablesize);
+	if (nbytes != tablesize) {
+		bmdbg("Read for block offset table failed\n");
 		return ERROR;
 	}
 
-	return block_offset;
+	return OK;
 }
 
 /****************************************************************************
- * Name: compress_lseek_block
+ * Name: compress_read_block
  *
  * Description:
- *   Seek to start of "block_number" block in compressed blocks section
+ *   Read 'block_number' block from compressed blocks section into read_buffer
  *
  * Returned Value:
- *   Starting offset (positive) of 'block_number' block in binary on Success
+ *   Number of bytes read into read_buffer on Success
  *   Negative value on Failure
  ****************************************************************************/
-static off_t compress_lseek_block(int filfd, uint16_t binary_header_size, int block_number)
+static off_t compress_read_block(FAR struct compress_s *compress, int block_number)
 {
 	off_t rpos;
 	off_t actual_offset;
-	off_t block_offset;
+	ssize_t readsize;
+	ssize_t nbytes;
 
-	/* Calculate actual offset from start of file for start of 'block_number' block */
-	block_offset = compress_offset_block(filfd, binary_header_size, block_number);
-	if (block_offset < 0) {
-		bmdbg("Incorrect offset for block number %d\n", block_number);
-		return block_offset;
+	/* Find out size of 'block_number' block in compressed file. Assign to readsize */
+	readsize = compress->secoff[block_number + 1] - compress->secoff[block_number];
+	if (readsize <= 0 || readsize > compress->max_block) {
+		bmdbg("Incorrect readsize %d for block %d\n", readsize, block_number);
+		return ERROR;
 	}
-	actual_offset = binary_header_size + compression_header.size_header + block_offset;;
 
-	/* Seek to location of this block in compressed file */
-	rpos = lseek(filfd, actual_offset, SEEK_SET);
+	/* Seek to location of 'block_number' block in compressed file */
+	actual_offset = compress->binary_header_size + compress->header.size_header + compress->secoff[block_number];
+	rpos = lseek(compress->filfd, actual_offset, SEEK_SET);
 	if (rpos != actual_offset) {
 		int errval = get_errno();
 		bmdbg("Failed to seek to position %lu: %d\n", (unsigned long)actual_offset, errval);
 		return -errval;
 	}
 
-	return rpos;
+	/* Read 'block_number' block into read_buffer */
+	nbytes = read(compress->filfd, compress->read_buffer, readsize);
+	if (nbytes != readsize) {
+		bmdbg("Read for compressed block %d failed\n", block_number);
+		return ERROR;
+	}
+
+	compress->stats.bytes_in += nbytes;
+	return nbytes;
 }
 
 /****************************************************************************
- * Name: compress_read_block
+ * Name: compress_get_block
  *
  * Description:
- *   Read 'block_number' block from compressed blocks section into read_buffer
+ *   Return the cache entry which holds the decompressed 'block_number'
+ *   block.  A block which is not cached is decompressed into the least
+ *   recently used entry.
  *
  * Returned Value:
- *   Number of bytes read into read_buffer on Success
- *   Negative value on Failure
+ *   Pointer to the cache entry on Success
+ *   NULL on Failure
  ****************************************************************************/
-static off_t compress_read_block(int filfd, uint16_t binary_header_size, FAR uint8_t *buf, int block_number)
+static FAR struct compress_block_s *compress_get_block(FAR struct compress_s *compress, int block_number)
 {
-	off_t rpos;
-	size_t readsize;
-	ssize_t nbytes;
-	off_t current_block_offset;
-	off_t next_block_offset;
-
-	/* Find out size of 'block_number' block in compressed file. Assign to readsize */
-	next_block_offset = compress_offset_block(filfd, binary_header_size, block_number + 1);
-	if (next_block_offset < 0) {
-		bmdbg("Incorrect offset for block number %d\n", block_number + 1);
-		return ERROR;
+	FAR struct compress_block_s *victim = NULL;
+	FAR struct compress_block_s *entry;
+	size_t writesize;
+	size_t size;
+	off_t nbytes;
+	int ret;
+	int idx;
+
+	for (idx = 0; idx < CONFIG_COMPRESSION_CACHE_BLOCKS; idx++) {
+		entry = &compress->cache[idx];
+		if (entry->index == block_number) {
+			entry->last_used = ++compress->stamp;
+			compress->stats.hits++;
+			return entry;
+		}
+		if (victim == NULL || (int32_t)(entry->last_used - victim->last_used) < 0) {
+			victim = entry;
+		}
 	}
 
-	current_block_offset = compress_offset_block(filfd, binary_header_size, block_number);
-	if (current_block_offset < 0) {
-		bmdbg("Incorrect offset for block number %d\n", block_number);
-		return ERROR;
-	}
+	/* The victim is invalid until the block is decompressed successfully */
+	victim->index = -1;
 
-	readsize = next_block_offset - current_block_offset;
-	if (readsize < 0) {
-		bmdbg("Incorrect readsize %d for block, has to be positive\n", readsize);
-		return readsize;
+	nbytes = compress_read_block(compress, block_number);
+	if (nbytes < 0) {
+		bmdbg("Read for compressed block %d failed\n", block_number);
+		return NULL;
 	}
 
-	/* Seek to location of 'block_number' block in compressed file */
-	rpos = compress_lseek_block(filfd, binary_header_size, block_number);
-	if (rpos < 0) {
-		bmdbg("Failed to seek to offset of block number %d\n", block_number);
-		return rpos;
+	/* Decompress block in read_buffer directly into the cache entry.  Only
+	 * the last block can be shorter than blocksize.
+	 */
+	size = nbytes;
+	writesize = compress->header.binary_size - block_number * compress->header.blocksize;
+	if (writesize > compress->header.blocksize) {
+		writesize = compress->header.blocksize;
 	}
 
-	/* Read 'block_number' block into buf */
-	nbytes = read(filfd, buf, readsize);
-	if (nbytes != readsize) {
-		bmdbg("Read for compressed block %d failed\n", block_number);
-		return ERROR;
+	ret = compress_decompress_block(compress, victim->data, &writesize, compress->read_buffer, &size);
+	if (ret < 0) {
+		bmdbg("Failed to decompress %d block of this binary\n", block_number);
+		return NULL;
 	}
 
-	return nbytes;
+	victim->index = block_number;
+	victim->size = writesize;
+	victim->last_used = ++compress->stamp;
+	compress->stats.blocks++;
+	compress->stats.bytes_out += writesize;
+	return victim;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
 /****************************************************************************
  * Name: compress_read
  *
@@ -270,88 +322,64 @@ static off_t compress_read_block(int filfd, uint16_t binary_header_size, FAR uin
  *   Read bytes from the compressed file using 'offset' and 'readsize' info
  *   provided for uncompressed file.  The data is read into 'buffer'. Offset
  *   value here is offset from start of uncompressed binary (excluding binary
- *   header).
+ *   header).  Blocks which were decompressed recently are taken from the
+ *   cache of the context.
  *
  * Returned Value:
  *   Number of bytes read into buffer on Success
  *   Negative value on failure
  ****************************************************************************/
-int compress_read(int filfd, uint16_t binary_header_size, FAR uint8_t *buffer, size_t readsize, off_t offset)
+int compress_read(FAR struct compress_s *compress, FAR uint8_t *buffer, size_t readsize, off_t offset)
 {
-	int first_block;
-	int last_block;
-	int no_blocks;
+	FAR struct compress_block_s *entry;
+	int blocksize;
 	int index;
-	int ret;
-	int actual_offset;			/* Offset from start of uncompressed file */
+	int block_offset;			/* Offset of the first byte to copy in the block */
 	int block_size_to_write;	/* Size to write into buffer from decompressed block */
 	int buffer_index;
-	int blocksize;
-	unsigned int writesize;
-	unsigned int size;
-
-	/* Setting first block, end block and number of blocks to read and decompressed */
-	blocksize = compression_header.blocksize;
-	compress_blocks_to_read(&first_block, &last_block, &no_blocks, offset, readsize);
-	if (first_block < 0 || no_blocks < 0) {
-		bmdbg("Incorrect first_block, no_blocks info\n");
-		buffer_index = ERROR;
-		goto error_compress_read;
+	uint32_t start;
+
+	blocksize = compress->header.blocksize;
+	if (offset < 0 || offset >= compress->header.binary_size) {
+		bmdbg("Incorrect offset %ld\n", (long)offset);
+		return ERROR;
 	}
 
-	index = first_block;
+	/* Do not read beyond the end of the uncompressed file */
+	if (readsize > compress->header.binary_size - offset) {
+		readsize = compress->header.binary_size - offset;
+	}
+
+	start = COMPRESS_TIME_NOW();
 	buffer_index = 0;
-	/* Actual Offset in uncompressed file is same as Offset passed to this function */
-	actual_offset = offset;
-
-	/* Reading and decompressing blocks from first_block to last_block. Then writing to buffer. */
-	for (; index < first_block + no_blocks; index++) {
-		/* Read compressed 'index' block into read_buffer */
-		size = compress_read_block(filfd, binary_header_size, buffers.read_buffer, index);
-		if (size < 0) {
-			bmdbg("Read for compressed block %d failed\n", index);
-			buffer_index = size;
-			goto error_compress_read;
+
+	/* Copy from every block which overlaps the requested range */
+	while (buffer_index < readsize) {
+		index = (offset + buffer_index) / blocksize;
+		block_offset = (offset + buffer_index) - index * blocksize;
+
+		entry = compress_get_block(compress, index);
+		if (entry == NULL) {
+			buffer_index = ERROR;
+			break;
 		}
 
-		/* Decompress block in read_buffer to out_buffer */
-		ret = compress_decompress_block(buffers.out_buffer, &writesize, buffers.read_buffer, &size, index);
-		if (ret == ERROR) {
-			bmdbg("Failed to decompress %d block of this binary\n", index);
-			buffer_index = ret;
-			goto error_compress_read;
+		if (block_offset >= entry->size) {
+			bmdbg("Block %d is shorter than expected\n", index);
+			buffer_index = ERROR;
+			break;
 		}
 
-		if (index == first_block) {
-			/*
-			 * Read appropriate number of bytes to buffer from this block using readsize and offset info.
-			 * If start_offset + readsize < end_offset, write from start_offset to start_offset + readsize.
-			 * Otherwise, write from start_offset to end_offset into buffer.
-			 */
-			block_size_to_write = ((index + 1) * blocksize - 1 > actual_offset + readsize - 1 ? readsize : (index + 1) * blocksize - actual_offset);
-			memcpy(&buffer[buffer_index], &buffers.out_buffer[actual_offset - (index * blocksize)], block_size_to_write);
-			buffer_index += block_size_to_write;
-		} else if (index == last_block) {
-			/*
-			 * Read appropriate number of bytes to buffer from this block using readsize and offset info.
-			 * Calculate end_offset (Offset of last byte to write from this block).
-			 * Write from start_offset to end_offset from this block into buffer.
-			 */
-			block_size_to_write = actual_offset + readsize - (index * blocksize);
-			memcpy(&buffer[buffer_index], &buffers.out_buffer[0], block_size_to_write);
-			buffer_index += block_size_to_write;
-		} else {
-			/*
-			 * This is not the first or last block. This is intermediary block.
-			 * So, write entire block into buffer.
-			 */
-			block_size_to_write = blocksize;
-			memcpy(&buffer[buffer_index], &buffers.out_buffer[0], block_size_to_write);
-			buffer_index += block_size_to_write;
+		block_size_to_write = entry->size - block_offset;
+		if (block_size_to_write > readsize - buffer_index) {
+			block_size_to_write = readsize - buffer_index;
 		}
+
+		memcpy(&buffer[buffer_index], &entry->data[block_offset], block_size_to_write);
+		buffer_index += block_size_to_write;
 	}
 
-error_compress_read:
+	compress->stats.time_us += COMPRESS_TIME_USEC(COMPRESS_TIME_NOW() - start);
 	return buffer_index;
 }
 
@@ -359,35 +387,68 @@ error_compress_read:
  * Name: compress_init
  *
  * Description:
- *   Initialize the compression_header of type'struct s_header' for this file
+ *   Read the compression header of this binary and allocate its
+ *   decompressor context.  The context is returned in 'compress'.
  *
  * Returned value:
  *   OK (0) on Success
- *   ERROR (-1) on Failure
+ *   Negative value on Failure
  ****************************************************************************/
-int compress_init(int filfd, uint16_t offset, off_t *filelen)
+int compress_init(int filfd, uint16_t offset, off_t *filelen, FAR struct compress_s **compress)
 {
+	FAR struct compress_s *ctx;
 	int ret;
+	int idx;
+
+	ctx = (FAR struct compress_s *)kmm_zalloc(sizeof(struct compress_s));
+	if (ctx == NULL) {
+		bmdbg("Failed to allocate the decompressor context\n");
+		return -ENOMEM;
+	}
+
+	ctx->filfd = filfd;
+	ctx->binary_header_size = offset;
+	for (idx = 0; idx < CONFIG_COMPRESSION_CACHE_BLOCKS; idx++) {
+		ctx->cache[idx].index = -1;
+	}
 
 	/* Parsing compression header for compressed file */
-	ret = compress_parse_header(filfd, offset);
+	ret = compress_parse_header(ctx, offset);
 	if (ret != OK) {
 		bmdbg("Failed to parse compression header from file\n");
 		goto error_compress_init;
 	}
 
-	/* Assign file length as that of uncompressed file */
-	*filelen = compression_header.binary_size;
+	ctx->max_block = compress_max_block(ctx->header.compression_format, ctx->header.blocksize);
+	if (ctx->max_block == 0) {
+		bmdbg("No support for compression format %d\n", ctx->header.compression_format);
+		ret = -ENOSYS;
+		goto error_compress_init;
+	}
 
-#if CONFIG_COMPRESSION_TYPE == 1
-	/* Allocating memory for read and out buffer to be used for LZMA decompression */
-	if (compression_header.compression_format == COMPRESSION_TYPE_LZMA) {
-		buffers.read_buffer = (unsigned char *)kmm_malloc(compression_header.blocksize + 5);
-		buffers.out_buffer = (unsigned char *)kmm_malloc(compression_header.blocksize);
+	/* Allocating memory for read buffer and the cached blocks */
+	ret = -ENOMEM;
+	ctx->read_buffer = (unsigned char *)kmm_malloc(ctx->max_block);
+	if (ctx->read_buffer == NULL) {
+		bmdbg("Failed to allocate the read buffer\n");
+		goto error_compress_init;
 	}
-#endif
+
+	for (idx = 0; idx < CONFIG_COMPRESSION_CACHE_BLOCKS; idx++) {
+		ctx->cache[idx].data = (unsigned char *)kmm_malloc(ctx->header.blocksize);
+		if (ctx->cache[idx].data == NULL) {
+			bmdbg("Failed to allocate the block cache\n");
+			goto error_compress_init;
+		}
+	}
+
+	/* Assign file length as that of uncompressed file */
+	*filelen = ctx->header.binary_size;
+	*compress = ctx;
+	return OK;
 
 error_compress_init:
+	compress_uninit(ctx);
 	return ret;
 }
 
@@ -395,18 +456,34 @@ error_compress_init:
  * Name: compress_uninit
  *
  * Description:
- *   Release buffers initialized during compress_init
+ *   Release the context allocated by compress_init
  *
  * Returned Value:
  *   None
  ****************************************************************************/
-void compress_uninit(void)
+void compress_uninit(FAR struct compress_s *compress)
 {
-#if CONFIG_COMPRESSION_TYPE == 1
-	/* Freeing memory allocated to read_buffer and out_buffer for file decompression */
-	if (compression_header.compression_format == COMPRESSION_TYPE_LZMA) {
-		kmm_free(buffers.read_buffer);
-		kmm_free(buffers.out_buffer);
+	int idx;
+
+	if (compress == NULL) {
+		return;
 	}
-#endif
+
+	bmvdbg("Decompressed %u blocks, %u cache hits, %u bytes -> %u bytes in %u us\n", compress->stats.blocks, compress->stats.hits, compress->stats.bytes_in, compress->stats.bytes_out, compress->stats.time_us);
+
+	for (idx = 0; idx < CONFIG_COMPRESSION_CACHE_BLOCKS; idx++) {
+		if (compress->cache[idx].data != NULL) {
+			kmm_free(compress->cache[idx].data);
+		}
+	}
+
+	if (compress->read_buffer != NULL) {
+		kmm_free(compress->read_buffer);
+	}
+
+	if (compress->secoff != NULL) {
+		kmm_free(compress->secoff);
+	}
+
+	kmm_free(compress);
 }
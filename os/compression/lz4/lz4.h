@@ -0,0 +1,71 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __COMPRESSION_LZ4_LZ4_H
+#define __COMPRESSION_LZ4_LZ4_H
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The codec writes and reads the LZ4 block format: a sequence of a token,
+ * literals, a 16-bit match offset and a match length.  It has no frame and
+ * no checksum, the compression header of the binary describes the blocks.
+ */
+
+#define LZ4_MINMATCH         4	/* Shortest match */
+#define LZ4_LASTLITERALS     5	/* The last bytes of a block are literals */
+#define LZ4_MFLIMIT          12	/* No match starts in the last bytes */
+#define LZ4_MAX_DISTANCE     65535
+
+/* Worst case size of 'n' bytes which do not compress */
+
+#define LZ4_COMPRESSBOUND(n) ((n) + (n) / 255 + 16)
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lz4_compress
+ *
+ * Description:
+ *   Compress 'srclen' bytes of 'src' into 'dst' which can hold 'dstlen'
+ *   bytes.  LZ4_COMPRESSBOUND(srclen) bytes are always enough.
+ *
+ * Returned Value:
+ *   Size of the compressed data on Success
+ *   Negative value if 'dst' is too small
+ ****************************************************************************/
+int lz4_compress(const unsigned char *src, unsigned int srclen, unsigned char *dst, unsigned int dstlen);
+
+/****************************************************************************
+ * Name: lz4_decompress
+ *
+ * Description:
+ *   Decompress 'srclen' bytes of 'src' into 'dst' which can hold 'dstlen'
+ *   bytes.  Broken input never makes the decoder read or write outside of
+ *   the two buffers.
+ *
+ * Returned Value:
+ *   Size of the decompressed data on Success
+ *   Negative value if the input is broken or 'dst' is too small
+ ****************************************************************************/
+int lz4_decompress(const unsigned char *src, unsigned int srclen, unsigned char *dst, unsigned int dstlen);
+
+#endif							/* __COMPRESSION_LZ4_LZ4_H */
@@ -0,0 +1,121 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <string.h>
+
+#include "lz4.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lz4_decompress
+ *
+ * Description:
+ *   Decompress 'srclen' bytes of 'src' into 'dst' which can hold 'dstlen'
+ *   bytes.  Broken input never makes the decoder read or write outside of
+ *   the two buffers.
+ *
+ * Returned Value:
+ *   Size of the decompressed data on Success
+ *   Negative value if the input is broken or 'dst' is too small
+ ****************************************************************************/
+int lz4_decompress(const unsigned char *src, unsigned int srclen, unsigned char *dst, unsigned int dstlen)
+{
+	const unsigned char *ip = src;
+	const unsigned char *iend = src + srclen;
+	const unsigned char *match;
+	unsigned char *op = dst;
+	unsigned char *oend = dst + dstlen;
+	unsigned int token;
+	unsigned int length;
+	unsigned int offset;
+	unsigned int byte;
+
+	while (ip < iend) {
+		token = *ip++;
+
+		/* Literals, a length of 15 continues in the next bytes */
+		length = token >> 4;
+		if (length == 15) {
+			do {
+				if (ip >= iend) {
+					return -1;
+				}
+				byte = *ip++;
+				length += byte;
+			} while (byte == 255);
+		}
+
+		if (length > (unsigned int)(iend - ip) || length > (unsigned int)(oend - op)) {
+			return -1;
+		}
+
+		memcpy(op, ip, length);
+		op += length;
+		ip += length;
+
+		/* The last sequence has no match */
+		if (ip == iend) {
+			break;
+		}
+
+		if (iend - ip < 2) {
+			return -1;
+		}
+
+		offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if (offset == 0 || offset > (unsigned int)(op - dst)) {
+			return -1;
+		}
+
+		length = token & 15;
+		if (length == 15) {
+			do {
+				if (ip >= iend) {
+					return -1;
+				}
+				byte = *ip++;
+				length += byte;
+			} while (byte == 255);
+		}
+		length += LZ4_MINMATCH;
+
+		if (length > (unsigned int)(oend - op)) {
+			return -1;
+		}
+
+		/* A match can overlap the bytes it produces, copy those in order */
+		match = op - offset;
+		if (offset >= length) {
+			memcpy(op, match, length);
+			op += length;
+		} else {
+			while (length-- > 0) {
+				*op++ = *match++;
+			}
+		}
+	}
+
+	return op - dst;
+}
@@ -0,0 +1,186 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <stdint.h>
+#include <string.h>
+
+#include "lz4.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LZ4_HASH_BITS        12
+#define LZ4_HASH_SIZE        (1 << LZ4_HASH_BITS)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline uint32_t lz4_read32(const unsigned char *p)
+{
+	uint32_t val;
+
+	memcpy(&val, p, sizeof(val));
+	return val;
+}
+
+static inline unsigned int lz4_hash(uint32_t seq)
+{
+	return (seq * 2654435761U) >> (32 - LZ4_HASH_BITS);
+}
+
+/* Write a length which does not fit into the 4 bits of the token */
+
+static unsigned char *lz4_put_length(unsigned char *op, unsigned int length)
+{
+	while (length >= 255) {
+		*op++ = 255;
+		length -= 255;
+	}
+	*op++ = length;
+	return op;
+}
+
+/* Write one sequence: 'litlen' literals from 'literals' followed by a match
+ * of 'matchlen' bytes at 'offset', or literals only when matchlen is 0.
+ */
+
+static unsigned char *lz4_put_sequence(unsigned char *op, unsigned char *oend, const unsigned char *literals, unsigned int litlen, unsigned int offset, unsigned int matchlen)
+{
+	unsigned char *token;
+
+	/* Token, length bytes, literals, offset and match length bytes */
+	if ((unsigned int)(oend - op) < 1 + litlen / 255 + 1 + litlen + 2 + matchlen / 255 + 1) {
+		return NULL;
+	}
+
+	token = op++;
+	if (litlen >= 15) {
+		*token = 15 << 4;
+		op = lz4_put_length(op, litlen - 15);
+	} else {
+		*token = litlen << 4;
+	}
+
+	memcpy(op, literals, litlen);
+	op += litlen;
+
+	if (matchlen == 0) {
+		return op;
+	}
+
+	*op++ = offset & 0xff;
+	*op++ = offset >> 8;
+
+	matchlen -= LZ4_MINMATCH;
+	if (matchlen >= 15) {
+		*token |= 15;
+		op = lz4_put_length(op, matchlen - 15);
+	} else {
+		*token |= matchlen;
+	}
+
+	return op;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lz4_compress
+ *
+ * Description:
+ *   Compress 'srclen' bytes of 'src' into 'dst' which can hold 'dstlen'
+ *   bytes.  LZ4_COMPRESSBOUND(srclen) bytes are always enough.
+ *
+ * Returned Value:
+ *   Size of the compressed data on Success
+ *   Negative value if 'dst' is too small
+ ****************************************************************************/
+int lz4_compress(const unsigned char *src, unsigned int srclen, unsigned char *dst, unsigned int dstlen)
+{
+	uint32_t table[LZ4_HASH_SIZE];	/* Last position + 1 of each hash, 0 if none */
+	unsigned char *op = dst;
+	unsigned char *oend = dst + dstlen;
+	unsigned int anchor = 0;	/* First byte which is not written yet */
+	unsigned int ip = 0;
+	unsigned int ref;
+	unsigned int length;
+	unsigned int limit;
+	unsigned int misses = 0;
+	uint32_t seq;
+	unsigned int hash;
+
+	memset(table, 0, sizeof(table));
+
+	if (srclen > LZ4_MFLIMIT) {
+		limit = srclen - LZ4_MFLIMIT;
+
+		while (ip < limit) {
+			seq = lz4_read32(src + ip);
+			hash = lz4_hash(seq);
+			ref = table[hash];
+			table[hash] = ip + 1;
+
+			if (ref == 0 || ip - (ref - 1) > LZ4_MAX_DISTANCE || lz4_read32(src + ref - 1) != seq) {
+				/* Skip faster through data which does not compress */
+				ip += 1 + (misses++ >> 5);
+				continue;
+			}
+			ref--;
+			misses = 0;
+
+			/* Extend the match backwards into the pending literals */
+			while (ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1]) {
+				ip--;
+				ref--;
+			}
+
+			/* And forwards, the last bytes of the block stay literals */
+			length = LZ4_MINMATCH;
+			while (ip + length < srclen - LZ4_LASTLITERALS && src[ip + length] == src[ref + length]) {
+				length++;
+			}
+
+			op = lz4_put_sequence(op, oend, src + anchor, ip - anchor, ip - ref, length);
+			if (op == NULL) {
+				return -1;
+			}
+
+			ip += length;
+			anchor = ip;
+
+			/* Remember a position inside the match for the next search */
+			if (ip - 2 < limit) {
+				table[lz4_hash(lz4_read32(src + ip - 2))] = ip - 2 + 1;
+			}
+		}
+	}
+
+	op = lz4_put_sequence(op, oend, src + anchor, srclen - anchor, 0, 0);
+	if (op == NULL) {
+		return -1;
+	}
+
+	return op - dst;
+}
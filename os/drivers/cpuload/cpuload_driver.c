@@ -76,7 +76,9 @@ static int cpuload_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
 	int ret;
 	int ticks;
+	int index;
 	pid_t *result_addr;
+	struct cpuload_taskinfo_s *info;
 
 	ret = -EINVAL;
 
@@ -100,6 +102,23 @@ static int cpuload_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 			ret = OK;
 		}
 		break;
+	case CPULOADIOC_GETTASKINFO:
+		info = (struct cpuload_taskinfo_s *)arg;
+		if (info == NULL) {
+			break;
+		}
+		for (index = 0; index < SCHED_NCPULOAD; index++) {
+			ret = clock_cpuload(info->pid, index, &info->load[index]);
+			if (ret != OK) {
+				break;
+			}
+		}
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+		if (ret == OK) {
+			ret = sched_get_latency(info->pid, &info->latency);
+		}
+#endif
+		break;
 	default:
 		break;
 	}
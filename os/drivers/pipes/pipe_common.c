@@ -153,6 +153,113 @@ static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev, pollevent_t events
 #define pipecommon_pollnotify(dev, event)
 #endif
 
+/****************************************************************************
+ * Name: pipecommon_wakeup
+ *
+ * Description:
+ *   Wake up all the threads waiting on the read or write semaphore.
+ *
+ ****************************************************************************/
+
+static void pipecommon_wakeup(sem_t *sem)
+{
+	int sval;
+
+	while (sem_getvalue(sem, &sval) == 0 && sval < 0) {
+		sem_post(sem);
+	}
+}
+
+/****************************************************************************
+ * Name: pipecommon_notify_readers
+ *
+ * Description:
+ *   Wake up the readers and POLLIN waiters once the read watermark is
+ *   reached.  Below it they would only find too little data and sleep again.
+ *
+ ****************************************************************************/
+
+static void pipecommon_notify_readers(FAR struct pipe_dev_s *dev)
+{
+	if (lfring_used(&dev->d_ring) >= dev->d_rdwmark) {
+		pipecommon_wakeup(&dev->d_rdsem);
+		pipecommon_pollnotify(dev, POLLIN);
+	}
+}
+
+/****************************************************************************
+ * Name: pipecommon_notify_writers
+ *
+ * Description:
+ *   Wake up the writers and POLLOUT waiters once the write watermark is
+ *   reached, so that a writer blocked on a full pipe is not woken for each
+ *   small read.
+ *
+ ****************************************************************************/
+
+static void pipecommon_notify_writers(FAR struct pipe_dev_s *dev)
+{
+	if (lfring_space(&dev->d_ring) >= dev->d_wrwmark) {
+		pipecommon_wakeup(&dev->d_wrsem);
+		pipecommon_pollnotify(dev, POLLOUT);
+	}
+}
+
+/****************************************************************************
+ * Name: pipecommon_setsize
+ ****************************************************************************/
+
+static int pipecommon_setsize(FAR struct pipe_dev_s *dev, unsigned long size)
+{
+	FAR uint8_t *buffer;
+	uint32_t bufsize = 1;
+
+	if (size == 0 || size > CONFIG_DEV_PIPE_MAXSIZE) {
+		return -EINVAL;
+	}
+
+	while (bufsize < size) {
+		bufsize <<= 1;
+	}
+
+	if (bufsize > CONFIG_DEV_PIPE_MAXSIZE) {
+		return -EINVAL;
+	}
+
+	/* The data cannot be moved to the new buffer while it is being used */
+
+	if (!lfring_is_empty(&dev->d_ring)) {
+		return -EBUSY;
+	}
+
+	/* If the pipe is already open, replace its buffer now.  Otherwise the
+	 * new size is used when the buffer is allocated on open.
+	 */
+
+	if (dev->d_buffer != NULL && bufsize != dev->d_bufsize) {
+		buffer = (FAR uint8_t *)kmm_malloc(bufsize);
+		if (buffer == NULL) {
+			return -ENOMEM;
+		}
+
+		kmm_free(dev->d_buffer);
+		dev->d_buffer = buffer;
+		lfring_init(&dev->d_ring, dev->d_buffer, bufsize, 0);
+	}
+
+	dev->d_bufsize = bufsize;
+
+	if (dev->d_rdwmark > bufsize) {
+		dev->d_rdwmark = bufsize;
+	}
+
+	if (dev->d_wrwmark > bufsize) {
+		dev->d_wrwmark = bufsize;
+	}
+
+	return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -172,6 +279,9 @@ FAR struct pipe_dev_s *pipecommon_allocdev(void)
 		/* Initialize the private structure */
 
 		memset(dev, 0, sizeof(struct pipe_dev_s));
+		dev->d_bufsize = CONFIG_DEV_PIPE_SIZE;
+		dev->d_rdwmark = 1;
+		dev->d_wrwmark = 1;
 		sem_init(&dev->d_bfsem, 0, 1);
 		sem_init(&dev->d_rdsem, 0, 0);
 		sem_init(&dev->d_wrsem, 0, 0);
@@ -207,7 +317,6 @@ int pipecommon_open(FAR struct file *filep)
 {
 	struct inode *inode = filep->f_inode;
 	struct pipe_dev_s *dev = inode->i_private;
-	int sval;
 	int ret;
 
 	DEBUGASSERT(dev);
@@ -229,11 +338,12 @@ int pipecommon_open(FAR struct file *filep)
 	 */
 
 	if (dev->d_refs == 0 && dev->d_buffer == NULL) {
-		dev->d_buffer = (uint8_t *)kmm_malloc(CONFIG_DEV_PIPE_SIZE);
+		dev->d_buffer = (uint8_t *)kmm_malloc(dev->d_bufsize);
 		if (!dev->d_buffer) {
 			(void)sem_post(&dev->d_bfsem);
 			return -ENOMEM;
 		}
+		lfring_init(&dev->d_ring, dev->d_buffer, dev->d_bufsize, 0);
 	}
 
 	/* Increment the reference count on the pipe instance */
@@ -250,9 +360,7 @@ int pipecommon_open(FAR struct file *filep)
 		 */
 
 		if (dev->d_nwriters == 1) {
-			while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0) {
-				sem_post(&dev->d_rdsem);
-			}
+			pipecommon_wakeup(&dev->d_rdsem);
 		}
 	}
 
@@ -266,7 +374,7 @@ int pipecommon_open(FAR struct file *filep)
 
 	if ((filep->f_oflags & O_RDWR) == O_RDONLY &&	/* Read-only */
 		dev->d_nwriters < 1 &&	/* No writers on the pipe */
-		dev->d_wrndx == dev->d_rdndx) {	/* Buffer is empty */
+		lfring_is_empty(&dev->d_ring)) {	/* Buffer is empty */
 		/* NOTE: d_rdsem is normally used when the read logic waits for more
 		 * data to be written.  But until the first writer has opened the
 		 * pipe, the meaning is different: it is used prevent O_RDONLY open
@@ -304,7 +412,6 @@ int pipecommon_close(FAR struct file *filep)
 {
 	struct inode *inode = filep->f_inode;
 	struct pipe_dev_s *dev = inode->i_private;
-	int sval;
 #ifndef CONFIG_DISABLE_POLL
 	int i;
 #endif
@@ -348,9 +455,7 @@ int pipecommon_close(FAR struct file *filep)
 			 */
 
 			if (--dev->d_nwriters <= 0) {
-				while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0) {
-					sem_post(&dev->d_rdsem);
-				}
+				pipecommon_wakeup(&dev->d_rdsem);
 			}
 		}
 	}
@@ -361,7 +466,7 @@ int pipecommon_close(FAR struct file *filep)
 	 * obtained when the pipe is re-opened.
 	 */
 
-	else if (PIPE_IS_POLICY_0(dev->d_flags) || dev->d_wrndx == dev->d_rdndx) {
+	else if (PIPE_IS_POLICY_0(dev->d_flags) || lfring_is_empty(&dev->d_ring)) {
 		/* Policy 0 or the buffer is empty ... deallocate the buffer now. */
 
 		kmm_free(dev->d_buffer);
@@ -369,8 +474,7 @@ int pipecommon_close(FAR struct file *filep)
 
 		/* And reset all counts and indices */
 
-		dev->d_wrndx = 0;
-		dev->d_rdndx = 0;
+		lfring_reset(&dev->d_ring);
 		dev->d_refs = 0;
 		dev->d_nwriters = 0;
 
@@ -401,7 +505,7 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 	FAR uint8_t *start = (uint8_t *)buffer;
 #endif
 	ssize_t nread = 0;
-	int sval;
+	size_t nbytes;
 	int ret;
 
 	DEBUGASSERT(dev);
@@ -416,9 +520,15 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 		return ERROR;
 	}
 
-	/* If the pipe is empty, then wait for something to be written to it */
+	/* Wait until the read watermark is reached.  With no writer or with
+	 * O_NONBLOCK, return whatever is buffered.
+	 */
+
+	while ((nbytes = lfring_used(&dev->d_ring)) < dev->d_rdwmark) {
+		if (nbytes > 0 && ((filep->f_oflags & O_NONBLOCK) || dev->d_nwriters <= 0)) {
+			break;
+		}
 
-	while (dev->d_wrndx == dev->d_rdndx) {
 		/* If O_NONBLOCK was set, then return EGAIN */
 
 		if (filep->f_oflags & O_NONBLOCK) {
@@ -447,24 +557,11 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
 	/* Then return whatever is available in the pipe (which is at least one byte) */
 
-	nread = 0;
-	while (nread < len && dev->d_wrndx != dev->d_rdndx) {
-		*buffer++ = dev->d_buffer[dev->d_rdndx];
-		if (++dev->d_rdndx >= CONFIG_DEV_PIPE_SIZE) {
-			dev->d_rdndx = 0;
-		}
-		nread++;
-	}
+	nread = lfring_read(&dev->d_ring, buffer, len);
 
-	/* Notify all waiting writers that bytes have been removed from the buffer */
+	/* Notify the waiting writers and poll/select waiters that they can write */
 
-	while (sem_getvalue(&dev->d_wrsem, &sval) == 0 && sval < 0) {
-		sem_post(&dev->d_wrsem);
-	}
-
-	/* Notify all poll/select waiters that they can write to the FIFO */
-
-	pipecommon_pollnotify(dev, POLLOUT);
+	pipecommon_notify_writers(dev);
 
 	sem_post(&dev->d_bfsem);
 	pipe_dumpbuffer("From PIPE:", start, nread);
@@ -480,9 +577,6 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer, size_t
 	struct inode *inode = filep->f_inode;
 	struct pipe_dev_s *dev = inode->i_private;
 	ssize_t nwritten = 0;
-	ssize_t last;
-	int nxtwrndx;
-	int sval;
 
 	DEBUGASSERT(dev);
 	pipe_dumpbuffer("To PIPE:", (uint8_t *)buffer, len);
@@ -512,71 +606,43 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer, size_t
 
 	/* Loop until all of the bytes have been written */
 
-	last = 0;
 	for (;;) {
-		/* Calculate the write index AFTER the next byte is written */
-
-		nxtwrndx = dev->d_wrndx + 1;
-		if (nxtwrndx >= CONFIG_DEV_PIPE_SIZE) {
-			nxtwrndx = 0;
-		}
-
-		/* Would the next write overflow the circular buffer? */
+		/* Copy as much as fits in the ring */
 
-		if (nxtwrndx != dev->d_rdndx) {
-			/* No... copy the byte */
+		nwritten += lfring_write(&dev->d_ring, buffer + nwritten, len - nwritten);
 
-			dev->d_buffer[dev->d_wrndx] = *buffer++;
-			dev->d_wrndx = nxtwrndx;
-
-			/* Is the write complete? */
-
-			if (++nwritten >= len) {
-				/* Yes.. Notify all of the waiting readers that more data is available */
-
-				while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0) {
-					sem_post(&dev->d_rdsem);
-				}
-
-				/* Notify all poll/select waiters that they can write to the FIFO */
-
-				pipecommon_pollnotify(dev, POLLIN);
+		/* Notify the waiting readers and poll/select waiters that they can
+		 * read.  When the ring is full this always reaches the watermark.
+		 */
 
-				/* Return the number of bytes written */
+		pipecommon_notify_readers(dev);
 
-				sem_post(&dev->d_bfsem);
-				return len;
-			}
-		} else {
-			/* There is not enough room for the next byte. Was anything written in this pass? */
+		/* Is the write complete? */
 
-			if (last < nwritten) {
-				/* Yes.. Notify all of the waiting readers that more data is available */
+		if (nwritten >= len) {
+			/* Return the number of bytes written */
 
-				while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0) {
-					sem_post(&dev->d_rdsem);
-				}
-			}
-			last = nwritten;
+			sem_post(&dev->d_bfsem);
+			return len;
+		}
 
-			/* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
+		/* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
 
-			if (filep->f_oflags & O_NONBLOCK) {
-				if (nwritten == 0) {
-					nwritten = -EAGAIN;
-				}
-				sem_post(&dev->d_bfsem);
-				return nwritten;
+		if (filep->f_oflags & O_NONBLOCK) {
+			if (nwritten == 0) {
+				nwritten = -EAGAIN;
 			}
-
-			/* There is more to be written.. wait for data to be removed from the pipe */
-
-			sched_lock();
 			sem_post(&dev->d_bfsem);
-			pipecommon_semtake(&dev->d_wrsem);
-			sched_unlock();
-			pipecommon_semtake(&dev->d_bfsem);
+			return nwritten;
 		}
+
+		/* There is more to be written.. wait for data to be removed from the pipe */
+
+		sched_lock();
+		sem_post(&dev->d_bfsem);
+		pipecommon_semtake(&dev->d_wrsem);
+		sched_unlock();
+		pipecommon_semtake(&dev->d_bfsem);
 	}
 }
 
@@ -590,7 +656,7 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
 	FAR struct inode *inode = filep->f_inode;
 	FAR struct pipe_dev_s *dev = inode->i_private;
 	pollevent_t eventset;
-	pipe_ndx_t nbytes;
+	size_t nbytes;
 	int ret = OK;
 	int i;
 
@@ -628,22 +694,20 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
 		 * First, determine how many bytes are in the buffer
 		 */
 
-		if (dev->d_wrndx >= dev->d_rdndx) {
-			nbytes = dev->d_wrndx - dev->d_rdndx;
-		} else {
-			nbytes = (CONFIG_DEV_PIPE_SIZE - 1) + dev->d_wrndx - dev->d_rdndx;
-		}
+		nbytes = lfring_used(&dev->d_ring);
 
-		/* Notify the POLLOUT event if the pipe is not full */
+		/* Notify the POLLOUT event if the write watermark is reached */
 
 		eventset = 0;
-		if (nbytes < (CONFIG_DEV_PIPE_SIZE - 1)) {
+		if (lfring_space(&dev->d_ring) >= dev->d_wrwmark) {
 			eventset |= POLLOUT;
 		}
 
-		/* Notify the POLLIN event if the pipe is not empty */
+		/* Notify the POLLIN event if the read watermark is reached, or if
+		 * there is data left and no writer which could add more.
+		 */
 
-		if (nbytes > 0) {
+		if (nbytes >= dev->d_rdwmark || (nbytes > 0 && dev->d_nwriters <= 0)) {
 			eventset |= POLLIN;
 		}
 
@@ -683,20 +747,51 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
 	FAR struct inode *inode = filep->f_inode;
 	FAR struct pipe_dev_s *dev = inode->i_private;
+	int ret = OK;
 
-	/* Only one command supported */
+	pipecommon_semtake(&dev->d_bfsem);
 
-	if (cmd == PIPEIOC_POLICY) {
+	switch (cmd) {
+	case PIPEIOC_POLICY:
 		if (arg != 0) {
 			PIPE_POLICY_1(dev->d_flags);
 		} else {
 			PIPE_POLICY_0(dev->d_flags);
 		}
+		break;
+
+	case PIPEIOC_SETSIZE:
+		ret = pipecommon_setsize(dev, arg);
+		break;
+
+	case PIPEIOC_RDWMARK:
+		if (arg == 0 || arg > dev->d_bufsize) {
+			ret = -EINVAL;
+			break;
+		}
+		dev->d_rdwmark = arg;
 
-		return OK;
+		/* Readers may already have enough data for the new watermark */
+
+		pipecommon_notify_readers(dev);
+		break;
+
+	case PIPEIOC_WRWMARK:
+		if (arg == 0 || arg > dev->d_bufsize) {
+			ret = -EINVAL;
+			break;
+		}
+		dev->d_wrwmark = arg;
+		pipecommon_notify_writers(dev);
+		break;
+
+	default:
+		ret = -ENOTTY;
+		break;
 	}
 
-	return -ENOTTY;
+	sem_post(&dev->d_bfsem);
+	return ret;
 }
 
 /****************************************************************************
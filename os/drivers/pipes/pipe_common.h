@@ -64,6 +64,8 @@
 #include <stdbool.h>
 #include <poll.h>
 
+#include <tinyara/lfring.h>
+
 #ifndef CONFIG_DEV_PIPE_SIZE
 #define CONFIG_DEV_PIPE_SIZE 1024
 #endif
@@ -74,6 +76,18 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Largest buffer size which can be set with PIPEIOC_SETSIZE */
+
+#ifndef CONFIG_DEV_PIPE_MAXSIZE
+#define CONFIG_DEV_PIPE_MAXSIZE 65536
+#endif
+
+/* The pipe data is kept in a lock-free ring which needs a power of two size */
+
+#if (CONFIG_DEV_PIPE_SIZE & (CONFIG_DEV_PIPE_SIZE - 1)) != 0
+#error "CONFIG_DEV_PIPE_SIZE must be a power of two"
+#endif
+
 /* Maximum number of threads than can be waiting for POLL events */
 
 #ifndef CONFIG_DEV_PIPE_NPOLLWAITERS
@@ -101,16 +115,6 @@
  * Public Types
  ****************************************************************************/
 
-/* Make the buffer index as small as possible for the configured pipe size */
-
-#if CONFIG_DEV_PIPE_SIZE > 65535
-typedef uint32_t pipe_ndx_t;	/* 32-bit index */
-#elif CONFIG_DEV_PIPE_SIZE > 255
-typedef uint16_t pipe_ndx_t;	/* 16-bit index */
-#else
-typedef uint8_t pipe_ndx_t;		/*  8-bit index */
-#endif
-
 /* This structure represents the state of one pipe.  A reference to this
  * structure is retained in the i_private field of the inode whenthe pipe/fifo
  * device is registered.
@@ -120,8 +124,10 @@ struct pipe_dev_s {
 	sem_t d_bfsem;				/* Used to serialize access to d_buffer and indices */
 	sem_t d_rdsem;				/* Empty buffer - Reader waits for data write */
 	sem_t d_wrsem;				/* Full buffer - Writer waits for data read */
-	pipe_ndx_t d_wrndx;			/* Index in d_buffer to save next byte written */
-	pipe_ndx_t d_rdndx;			/* Index in d_buffer to return the next byte read */
+	struct lfring_s d_ring;		/* Ring of the buffered data in d_buffer */
+	uint32_t d_bufsize;			/* Size of d_buffer allocated on open */
+	uint32_t d_rdwmark;			/* Readers are woken with this many bytes buffered */
+	uint32_t d_wrwmark;			/* Writers are woken with this many bytes free */
 	uint8_t d_refs;				/* References counts on pipe (limited to 255) */
 	uint8_t d_nwriters;			/* Number of reference counts for write access */
 	uint8_t d_pipeno;			/* Pipe minor number */
@@ -15,7 +15,6 @@
  * language governing permissions and limitations under the License.
  *
  ****************************************************************************/
-
 /****************************************************************************
  * Included Files
  ****************************************************************************/
@@ -31,6 +30,7 @@
 #include <stdlib.h>
 #include <fcntl.h>
 #include <string.h>
+#include <unistd.h>
 #include <poll.h>
 #include <errno.h>
 #include <assert.h>
@@ -38,12 +38,21 @@
 
 #include <tinyara/fs/fs.h>
 #include <tinyara/kmalloc.h>
-#include <tinyara/fs/fs.h>
 #include <tinyara/arch.h>
-#include <tinyara/ringbuf.h>
+#include <tinyara/clock.h>
+#include <tinyara/sched.h>
+#include <tinyara/kthread.h>
+#include <tinyara/lfring.h>
+#include <tinyara/ttrace.h>
 
 #include <arch/irq.h>
 
+#ifdef CONFIG_TTRACE_STREAM_SINK_TCP
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -67,16 +76,63 @@
 
 #define NO_HOLDER               ((pid_t)-1)
 
+/* Number of string hash buckets, one more than the strings which can be
+ * interned.  It should be a power of two.
+ */
+
+#define TTRACE_STRHASH_SIZE     128
+
+/* Bytes read before the records: the header, string table and task table */
+
+#define TTRACE_PREFIX_BYTES(p)  (sizeof(struct ttrace_header_s) + (p)->strtab_len + sizeof(g_ttrace_tasks))
+
+/* lfring_mpsc_init() refuses a queue which is not a power of two records */
+
+#if defined(CONFIG_TTRACE_KERNEL) && (CONFIG_TTRACE_KERNEL_RECORDS < 2 || (CONFIG_TTRACE_KERNEL_RECORDS & (CONFIG_TTRACE_KERNEL_RECORDS - 1)) != 0)
+#error "CONFIG_TTRACE_KERNEL_RECORDS must be a power of two"
+#endif
+
+#if defined(CONFIG_TTRACE_USERBUF) && (CONFIG_TTRACE_USERBUF_RECORDS < 2 || (CONFIG_TTRACE_USERBUF_RECORDS & (CONFIG_TTRACE_USERBUF_RECORDS - 1)) != 0)
+#error "CONFIG_TTRACE_USERBUF_RECORDS must be a power of two"
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
 struct ttrace_dev_s {
-	uint16_t ttrace_head;      /* The head index (where data is added) */
-	size_t ttrace_bufsize;     /* Size of the trace buffer */
-	FAR char *ttrace_packets;  /* Trace packets buffer */
+	struct lfring_s ttrace_ring;  /* Ring of the trace records */
+	bool ttrace_overwritable;     /* Drop the oldest records when full */
+	uint32_t ttrace_dropped;      /* Number of records dropped by overwrite */
+	uint32_t ttrace_lost;         /* Number of records lost, the ring was full */
+
+	uint32_t ts_freq;             /* Timestamp frequency in Hz */
+	uint64_t ts_now;              /* Timestamp at ts_tick */
+	clock_t ts_tick;              /* System timer at the last timestamp */
+	uint32_t ts_raw;              /* Counter value at the last timestamp */
+	uint64_t ts_base;             /* Timestamp the oldest record delta is from */
+	uint64_t ts_last;             /* Timestamp of the newest record */
+
+	uint16_t nstrings;            /* Number of interned strings */
+	uint16_t strtab_len;          /* Used bytes of g_ttrace_strtab */
+	uint16_t strhash[TTRACE_STRHASH_SIZE];  /* String id by hash, 0 if empty */
+	uint16_t stroff[TTRACE_STRHASH_SIZE];   /* String table offset by id - 1 */
 };
 
+#ifdef CONFIG_TTRACE_STREAM
+struct ttrace_stream_s {
+	pid_t pid;                    /* Stream thread, -1 before it starts */
+	int fd;                       /* Sink, -1 if it is not open */
+	bool restart;                 /* Send the header and tables again */
+	bool tasks_dirty;             /* The task table has changed */
+	uint16_t task_next;           /* Next task table entry to send */
+	uint32_t str_sent;            /* Bytes of the string table sent */
+	uint64_t ts;                  /* Timestamp of the last record sent */
+	struct ttrace_stream_stats_s stats;
+	uint8_t buf[sizeof(struct ttrace_chunk_s) + CONFIG_TTRACE_STREAM_BATCH];
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -85,6 +141,16 @@ static ssize_t ttrace_read(FAR struct file *, FAR char *, size_t);
 static ssize_t ttrace_write(FAR struct file *, FAR const char *, size_t);
 static int ttrace_ioctl(FAR struct file *, int, unsigned long);
 
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_TTRACE_KERNEL
+/* Tags of the kernel tracepoints to record, 0 while not tracing */
+
+volatile uint32_t g_ttrace_ktags;
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -99,40 +165,882 @@ static const struct file_operations g_ttracefops = {
 };
 
 /* This is the pre-allocated buffer used for the T-trace */
-static struct ringbuf g_ringbuf = {
-	{0,},
-	CONFIG_TTRACE_BUFSIZE,
-	0,
-	0,
-	0
-};
+
+static uint8_t g_ttrace_buffer[CONFIG_TTRACE_BUFSIZE];
+
+/* Strings and task names referenced by id from the records.  They are kept
+ * aside from the ring so that dropping old records never loses them.
+ */
+
+static uint8_t g_ttrace_strtab[CONFIG_TTRACE_STRTAB_SIZE];
+static struct ttrace_task_s g_ttrace_tasks[CONFIG_MAX_TASKS];
+
+#ifdef CONFIG_TTRACE_USERBUF
+/* The user buffer, filled by the library without a system call */
+
+static struct ttrace_ubuf_s g_ttrace_ubuf;
+static uint32_t g_ttrace_ubuf_storage[LFRING_MPSC_BUFSIZE(CONFIG_TTRACE_USERBUF_RECORDS, sizeof(struct trace_urecord)) / sizeof(uint32_t)];
+#endif
+
+#ifdef CONFIG_TTRACE_KERNEL
+/* The events of the kernel tracepoints, queued from any context */
+
+static struct lfring_mpsc_s g_ttrace_kring;
+static uint32_t g_ttrace_kring_storage[LFRING_MPSC_BUFSIZE(CONFIG_TTRACE_KERNEL_RECORDS, sizeof(struct trace_urecord)) / sizeof(uint32_t)];
+#endif
 
 static uint32_t g_state = TTRACE_STATE_IDLE;
 static uint32_t g_selected_tag = 0;
 
-/* This is the device structure for the T-trace function. It
- * must be statically initialized because the T-trace ttrace_putc function
- * could be called before the driver initialization logic executes.
- */
+/* This is the device structure for the T-trace function. */
+
+static struct ttrace_dev_s g_sysdev;
 
-static struct ttrace_dev_s g_sysdev = {
-	0,                        /* ttrace_head */
-	CONFIG_TTRACE_BUFSIZE,    /* ttrace_bufsize */
-	g_ringbuf.buffer          /* ttrace_packets_buffer */
+#ifdef CONFIG_TTRACE_STREAM
+static struct ttrace_stream_s g_stream = {
+	.pid = -1,
+	.fd = -1,
 };
+#endif
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: ttrace_elapsed
+ *
+ * Description:
+ *   Return the time in ts_freq ticks between two readings of the counter
+ *   and the system timer.  The 32-bit counter may wrap more than once in
+ *   between, so the number of wraps is estimated from the system timer.
+ *
+ ****************************************************************************/
+
+static uint64_t ttrace_elapsed(FAR struct ttrace_dev_s *priv, uint32_t raw_from, clock_t tick_from, uint32_t raw_to, clock_t tick_to)
+{
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+	uint64_t delta = (uint32_t)(raw_to - raw_from);
+	uint64_t elapsed = (uint64_t)(tick_to - tick_from) * (priv->ts_freq / TICK_PER_SEC);
+
+	if (elapsed > delta) {
+		delta += (elapsed - delta + 0x80000000ULL) & ~0xffffffffULL;
+	}
+
+	return delta;
+#else
+	return TICK2USEC((uint64_t)(tick_to - tick_from));
+#endif
+}
+
+/****************************************************************************
+ * Name: ttrace_gettime
+ *
+ * Description:
+ *   Return the current timestamp in ts_freq ticks since the trace started.
+ *
+ ****************************************************************************/
+
+static uint64_t ttrace_gettime(FAR struct ttrace_dev_s *priv)
+{
+	clock_t tick = clock_systimer();
+	uint32_t raw = 0;
+
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+	raw = up_perf_gettime();
+#endif
+	priv->ts_now += ttrace_elapsed(priv, priv->ts_raw, priv->ts_tick, raw, tick);
+	priv->ts_raw = raw;
+	priv->ts_tick = tick;
+	return priv->ts_now;
+}
+
+/****************************************************************************
+ * Name: ttrace_reset
+ *
+ * Description:
+ *   Empty the ring and the side tables to start a new trace.
+ *
+ ****************************************************************************/
+
+static void ttrace_reset(FAR struct ttrace_dev_s *priv)
+{
+	lfring_reset(&priv->ttrace_ring);
+	priv->ttrace_dropped = 0;
+	priv->ttrace_lost = 0;
+
+	priv->ts_now = 0;
+	priv->ts_tick = clock_systimer();
+	priv->ts_raw = 0;
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+	priv->ts_raw = up_perf_gettime();
+#endif
+	priv->ts_base = 0;
+	priv->ts_last = 0;
+
+	priv->nstrings = 0;
+	priv->strtab_len = 0;
+	memset(priv->strhash, 0, sizeof(priv->strhash));
+	memset(g_ttrace_tasks, 0, sizeof(g_ttrace_tasks));
+}
+
+/****************************************************************************
+ * Name: ttrace_intern
+ *
+ * Description:
+ *   Return the id of the string, adding it to the string table if it is
+ *   new.  0 is returned if the table is full.
+ *
+ ****************************************************************************/
+
+static uint16_t ttrace_intern(FAR struct ttrace_dev_s *priv, FAR const char *str, size_t len)
+{
+	uint32_t hash = 2166136261u;
+	uint16_t id;
+	uint16_t off;
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		hash = (hash ^ (uint8_t)str[i]) * 16777619u;
+	}
+
+	for (i = hash & (TTRACE_STRHASH_SIZE - 1); (id = priv->strhash[i]) != 0; i = (i + 1) & (TTRACE_STRHASH_SIZE - 1)) {
+		off = priv->stroff[id - 1];
+		if (g_ttrace_strtab[off] == len && memcmp(&g_ttrace_strtab[off + 1], str, len) == 0) {
+			return id;
+		}
+	}
+
+	/* Keep one bucket empty so that the lookup above always terminates */
+
+	if (priv->nstrings >= TTRACE_STRHASH_SIZE - 1 || priv->strtab_len + 1 + len > CONFIG_TTRACE_STRTAB_SIZE) {
+		return 0;
+	}
+
+	off = priv->strtab_len;
+	g_ttrace_strtab[off] = (uint8_t)len;
+	memcpy(&g_ttrace_strtab[off + 1], str, len);
+	priv->strtab_len += 1 + len;
+
+	id = ++priv->nstrings;
+	priv->stroff[id - 1] = off;
+	priv->strhash[i] = id;
+	return id;
+}
+
+/****************************************************************************
+ * Name: ttrace_intern_task
+ *
+ * Description:
+ *   Make sure that the name of the task is in the task table.
+ *
+ ****************************************************************************/
+
+static void ttrace_intern_task(FAR struct ttrace_dev_s *priv, pid_t pid)
+{
+	FAR struct ttrace_task_s *task = &g_ttrace_tasks[PIDHASH(pid)];
+#if CONFIG_TASK_NAME_SIZE > 0
+	FAR struct tcb_s *tcb;
+#endif
+
+	if (task->pid == pid && task->strid != 0) {
+		return;
+	}
+
+	task->pid = pid;
+	task->strid = 0;
+#if CONFIG_TASK_NAME_SIZE > 0
+	tcb = sched_gettcb(pid);
+	if (tcb != NULL) {
+		task->strid = ttrace_intern(priv, tcb->name, strnlen(tcb->name, CONFIG_TASK_NAME_SIZE));
+	}
+#endif
+#ifdef CONFIG_TTRACE_STREAM
+	g_stream.tasks_dirty = true;
+#endif
+}
+
+/****************************************************************************
+ * Name: ttrace_encode
+ *
+ * Description:
+ *   Encode the event written by the library into a compact record.
+ *   Returns the size of the record or TTRACE_INVALID.
+ *
+ ****************************************************************************/
+
+static int ttrace_encode(FAR struct ttrace_dev_s *priv, FAR const struct trace_event *event, size_t len, pid_t pid, int64_t delta, FAR uint8_t *rec)
+{
+	FAR const struct trace_sched_event *sched = &event->u.sched;
+	size_t msglen;
+	uint16_t id;
+	int n;
+
+	rec[0] = event->type;
+	n = 1 + ttrace_put_varint(&rec[1], ttrace_zigzag(delta));
+
+	switch (event->type) {
+	case TTRACE_REC_BEGIN:
+		msglen = len - TTRACE_EVENT_HDRBYTES;
+		if (msglen > TTRACE_MSG_BYTES - 1) {
+			msglen = TTRACE_MSG_BYTES - 1;
+		}
+		msglen = strnlen(event->u.message, msglen);
+
+		n += ttrace_put_varint(&rec[n], pid);
+		id = ttrace_intern(priv, event->u.message, msglen);
+		if (id != 0) {
+			n += ttrace_put_varint(&rec[n], id);
+		} else {
+			rec[0] = TTRACE_REC_BEGIN_STR;
+			rec[n++] = (uint8_t)msglen;
+			memcpy(&rec[n], event->u.message, msglen);
+			n += msglen;
+		}
+		break;
+	case TTRACE_REC_BEGIN_UID:
+		n += ttrace_put_varint(&rec[n], pid);
+		rec[n++] = event->uid;
+		break;
+	case TTRACE_REC_END:
+		n += ttrace_put_varint(&rec[n], pid);
+		break;
+	case TTRACE_REC_SCHED:
+		if (len < TTRACE_EVENT_HDRBYTES + sizeof(struct trace_sched_event)) {
+			return TTRACE_INVALID;
+		}
+		ttrace_intern_task(priv, sched->prev_pid);
+		ttrace_intern_task(priv, sched->next_pid);
+
+		n += ttrace_put_varint(&rec[n], sched->prev_pid);
+		rec[n++] = sched->prev_prio;
+		rec[n++] = sched->prev_state;
+		n += ttrace_put_varint(&rec[n], sched->next_pid);
+		rec[n++] = sched->next_prio;
+		break;
+	case TTRACE_REC_KEVENT:
+		if (len < TTRACE_EVENT_HDRBYTES + sizeof(struct trace_kevent)) {
+			return TTRACE_INVALID;
+		}
+		n += ttrace_put_varint(&rec[n], pid);
+		rec[n++] = event->uid;
+		n += ttrace_put_varint(&rec[n], event->u.kevent.arg0);
+		n += ttrace_put_varint(&rec[n], event->u.kevent.arg1);
+		break;
+	default:
+		return TTRACE_INVALID;
+	}
+
+	return n;
+}
+
+/****************************************************************************
+ * Name: ttrace_record_size
+ *
+ * Description:
+ *   Return the size of the encoded record at buf and its timestamp delta,
+ *   or 0 if it is not a valid record.
+ *
+ ****************************************************************************/
+
+static int ttrace_record_size(FAR const uint8_t *buf, int len, FAR int64_t *delta)
+{
+	uint64_t val;
+	int n;
+	int ret;
+
+	if (len < 2 || (ret = ttrace_get_varint(&buf[1], len - 1, &val)) == 0) {
+		return 0;
+	}
+	*delta = ttrace_unzigzag(val);
+	n = 1 + ret;
+
+	/* Every record has a pid next */
+
+	if ((ret = ttrace_get_varint(&buf[n], len - n, &val)) == 0) {
+		return 0;
+	}
+	n += ret;
+
+	switch (buf[0]) {
+	case TTRACE_REC_BEGIN:
+		ret = ttrace_get_varint(&buf[n], len - n, &val);
+		return ret == 0 ? 0 : n + ret;
+	case TTRACE_REC_BEGIN_UID:
+		n += 1;
+		break;
+	case TTRACE_REC_END:
+		break;
+	case TTRACE_REC_SCHED:
+		n += 2;
+		if (n > len || (ret = ttrace_get_varint(&buf[n], len - n, &val)) == 0) {
+			return 0;
+		}
+		n += ret + 1;
+		break;
+	case TTRACE_REC_BEGIN_STR:
+		if (n >= len) {
+			return 0;
+		}
+		n += 1 + buf[n];
+		break;
+	case TTRACE_REC_KEVENT:
+		n += 1;
+		if (n > len || (ret = ttrace_get_varint(&buf[n], len - n, &val)) == 0) {
+			return 0;
+		}
+		n += ret;
+		ret = ttrace_get_varint(&buf[n], len - n, &val);
+		return ret == 0 ? 0 : n + ret;
+	default:
+		return 0;
+	}
+
+	return n <= len ? n : 0;
+}
+
+/****************************************************************************
+ * Name: ttrace_drop_record
+ *
+ * Description:
+ *   Remove the oldest record from the ring.  Records are dropped whole so
+ *   that the dump always starts at a record boundary, and the base
+ *   timestamp moves to the dropped record.
+ *
+ ****************************************************************************/
+
+static void ttrace_drop_record(FAR struct ttrace_dev_s *priv)
+{
+	uint8_t rec[TTRACE_REC_MAXBYTES];
+	int64_t delta;
+	int size;
+
+	size = lfring_peek(&priv->ttrace_ring, rec, sizeof(rec));
+	size = ttrace_record_size(rec, size, &delta);
+	if (size == 0) {
+		lfring_reset(&priv->ttrace_ring);
+		priv->ts_base = priv->ts_last;
+		return;
+	}
+
+	lfring_skip(&priv->ttrace_ring, size);
+	priv->ts_base += delta;
+	priv->ttrace_dropped++;
+}
+
+/****************************************************************************
+ * Name: ttrace_count_lost
+ *
+ * Description:
+ *   Count a lost record.  Kernel events are lost in interrupt handlers too,
+ *   so the counter is updated with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void ttrace_count_lost(FAR struct ttrace_dev_s *priv)
+{
+	irqstate_t flags;
+
+	flags = irqsave();
+	priv->ttrace_lost++;
+	irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: ttrace_store
+ *
+ * Description:
+ *   Encode the event and add it to the ring.  Returns TTRACE_VALID,
+ *   TTRACE_OVERFLOW if the ring is full and may not be overwritten, or
+ *   TTRACE_INVALID if the event is invalid.
+ *
+ ****************************************************************************/
+
+static int ttrace_store(FAR struct ttrace_dev_s *priv, FAR const struct trace_event *event, size_t len, pid_t pid, uint64_t ts)
+{
+	uint8_t rec[TTRACE_REC_MAXBYTES];
+	int size;
+
+	size = ttrace_encode(priv, event, len, pid, (int64_t)(ts - priv->ts_last), rec);
+	if (size < 0) {
+		return TTRACE_INVALID;
+	}
+
+	/* A record is stored whole or not at all */
+
+	if (lfring_space(&priv->ttrace_ring) < size) {
+		if (!priv->ttrace_overwritable) {
+			ttrace_count_lost(priv);
+			return TTRACE_OVERFLOW;
+		}
+
+		while (lfring_space(&priv->ttrace_ring) < size) {
+			ttrace_drop_record(priv);
+		}
+	}
+
+	lfring_write(&priv->ttrace_ring, rec, size);
+	priv->ts_last = ts;
+	return TTRACE_VALID;
+}
+
+#ifdef TTRACE_HAVE_URECORD
+/****************************************************************************
+ * Name: ttrace_collect_queue
+ *
+ * Description:
+ *   Move the queued records to the ring.  Their timestamps are converted
+ *   by their age relative to the current time.
+ *
+ ****************************************************************************/
+
+static void ttrace_collect_queue(FAR struct ttrace_dev_s *priv, FAR struct lfring_mpsc_s *queue)
+{
+	struct trace_urecord urec;
+	uint64_t now;
+	uint64_t age;
+
+	if (lfring_mpsc_get(queue, &urec) != OK) {
+		return;
+	}
+
+	now = ttrace_gettime(priv);
+	do {
+		age = ttrace_elapsed(priv, urec.raw, urec.tick, priv->ts_raw, priv->ts_tick);
+		if (age > now) {
+			age = now;
+		}
+
+		/* A record which does not fit is lost like a failed write() */
+
+		ttrace_store(priv, &urec.event, sizeof(struct trace_event), urec.pid, now - age);
+	} while (lfring_mpsc_get(queue, &urec) == OK);
+}
+
+/****************************************************************************
+ * Name: ttrace_collect
+ *
+ * Description:
+ *   Move the records of the user buffer and the kernel events to the ring.
+ *
+ ****************************************************************************/
+
+static void ttrace_collect(FAR struct ttrace_dev_s *priv)
+{
+#ifdef CONFIG_TTRACE_USERBUF
+	ttrace_collect_queue(priv, &g_ttrace_ubuf.ring);
+#endif
+#ifdef CONFIG_TTRACE_KERNEL
+	ttrace_collect_queue(priv, &g_ttrace_kring);
+#endif
+}
+
+/****************************************************************************
+ * Name: ttrace_discard
+ *
+ * Description:
+ *   Empty the queues, the records belong to an earlier trace.
+ *
+ ****************************************************************************/
+
+static void ttrace_discard(void)
+{
+	struct trace_urecord urec;
+
+#ifdef CONFIG_TTRACE_USERBUF
+	while (lfring_mpsc_get(&g_ttrace_ubuf.ring, &urec) == OK) {
+	}
+#endif
+#ifdef CONFIG_TTRACE_KERNEL
+	while (lfring_mpsc_get(&g_ttrace_kring, &urec) == OK) {
+	}
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: ttrace_set_tags
+ *
+ * Description:
+ *   Publish the tags which the user buffer and the kernel tracepoints
+ *   check before they queue a record, 0 while not tracing.
+ *
+ ****************************************************************************/
+
+static void ttrace_set_tags(uint32_t tags)
+{
+#ifdef CONFIG_TTRACE_USERBUF
+	g_ttrace_ubuf.tags = tags;
+#endif
+#ifdef CONFIG_TTRACE_KERNEL
+	g_ttrace_ktags = tags;
+#endif
+}
+
+/****************************************************************************
+ * Name: ttrace_make_header
+ *
+ * Description:
+ *   Fill the capture header, without string and task tables.
+ *
+ ****************************************************************************/
+
+static void ttrace_make_header(FAR struct ttrace_dev_s *priv, FAR struct ttrace_header_s *hdr, uint64_t ts_base)
+{
+	hdr->magic = TTRACE_MAGIC;
+	hdr->version = TTRACE_VERSION;
+	hdr->hdrlen = sizeof(struct ttrace_header_s);
+	hdr->ntasks = 0;
+	hdr->freq = priv->ts_freq;
+	hdr->ts_base_lo = (uint32_t)ts_base;
+	hdr->ts_base_hi = (uint32_t)(ts_base >> 32);
+	hdr->dropped = priv->ttrace_dropped;
+	hdr->strtab_len = 0;
+}
+
+/****************************************************************************
+ * Name: ttrace_copy_part
+ *
+ * Description:
+ *   Copy what is at offset pos of the capture from a part which starts at
+ *   *partpos, and advance *partpos past the part.
+ *
+ ****************************************************************************/
+
+static size_t ttrace_copy_part(FAR const void *part, size_t partlen, size_t *partpos, size_t pos, FAR char *buffer, size_t len)
+{
+	size_t start = *partpos;
+	size_t n;
+
+	*partpos += partlen;
+	if (pos >= start + partlen || len == 0) {
+		return 0;
+	}
+
+	n = start + partlen - pos;
+	if (n > len) {
+		n = len;
+	}
+	memcpy(buffer, (FAR const uint8_t *)part + (pos - start), n);
+	return n;
+}
+
+/****************************************************************************
+ * Name: ttrace_read_prefix
+ *
+ * Description:
+ *   Copy the part of the header, string table and task table which is at
+ *   offset pos of the capture.  Returns the number of bytes copied.
+ *
+ ****************************************************************************/
+
+static size_t ttrace_read_prefix(FAR struct ttrace_dev_s *priv, size_t pos, FAR char *buffer, size_t len)
+{
+	struct ttrace_header_s hdr;
+	size_t partpos = 0;
+	size_t nread = 0;
+
+	ttrace_make_header(priv, &hdr, priv->ts_base);
+	hdr.ntasks = CONFIG_MAX_TASKS;
+	hdr.strtab_len = priv->strtab_len;
+
+	nread += ttrace_copy_part(&hdr, sizeof(hdr), &partpos, pos + nread, buffer + nread, len - nread);
+	nread += ttrace_copy_part(g_ttrace_strtab, priv->strtab_len, &partpos, pos + nread, buffer + nread, len - nread);
+	nread += ttrace_copy_part(g_ttrace_tasks, sizeof(g_ttrace_tasks), &partpos, pos + nread, buffer + nread, len - nread);
+
+	return nread;
+}
+
+#ifdef CONFIG_TTRACE_STREAM
+/****************************************************************************
+ * Name: ttrace_stream_open
+ *
+ * Description:
+ *   Open the sink of the stream.  Everything which the host needs to decode
+ *   the following records is sent again after it is opened.
+ *
+ ****************************************************************************/
+
+static int ttrace_stream_open(void)
+{
+#ifdef CONFIG_TTRACE_STREAM_SINK_TCP
+	struct sockaddr_in addr;
+	int fd;
+
+	fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd < 0) {
+		return ERROR;
+	}
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(CONFIG_TTRACE_STREAM_PORT);
+	if (inet_pton(AF_INET, CONFIG_TTRACE_STREAM_HOST, &addr.sin_addr) != 1 || connect(fd, (FAR struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		close(fd);
+		return ERROR;
+	}
+#else
+	int fd;
+
+	fd = open(CONFIG_TTRACE_STREAM_PATH, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (fd < 0) {
+		return ERROR;
+	}
+#endif
+
+	sched_lock();
+	g_stream.fd = fd;
+	g_stream.restart = true;
+	sched_unlock();
+	return OK;
+}
+
+static void ttrace_stream_close(void)
+{
+	close(g_stream.fd);
+	g_stream.fd = -1;
+}
+
+/****************************************************************************
+ * Name: ttrace_stream_chunk
+ *
+ * Description:
+ *   Fill g_stream.buf with the next chunk to send.  Strings and tasks go
+ *   first, so that they are sent before the records which refer to them.
+ *   Records are sent whole, and their timestamps are followed so that the
+ *   header can be sent again in the middle of a trace.  Returns the size
+ *   of the chunk or 0 if there is nothing to send.
+ *
+ ****************************************************************************/
+
+static size_t ttrace_stream_chunk(FAR struct ttrace_dev_s *priv)
+{
+	FAR struct ttrace_chunk_s *chunk = (FAR struct ttrace_chunk_s *)g_stream.buf;
+	FAR uint8_t *payload = g_stream.buf + sizeof(struct ttrace_chunk_s);
+	FAR struct ttrace_task_s *task;
+	uint8_t rec[TTRACE_REC_MAXBYTES];
+	int64_t delta;
+	uint32_t used;
+	size_t len = 0;
+	int size;
+
+	sched_lock();
+
+	if (g_stream.restart) {
+		g_stream.restart = false;
+		g_stream.str_sent = 0;
+		g_stream.task_next = 0;
+		g_stream.tasks_dirty = true;
+
+		chunk->type = TTRACE_CHUNK_HEADER;
+		ttrace_make_header(priv, (FAR struct ttrace_header_s *)payload, g_stream.ts);
+		len = sizeof(struct ttrace_header_s);
+	} else if (priv->strtab_len > g_stream.str_sent) {
+		chunk->type = TTRACE_CHUNK_STRINGS;
+		len = priv->strtab_len - g_stream.str_sent;
+		if (len > CONFIG_TTRACE_STREAM_BATCH - sizeof(uint32_t)) {
+			len = CONFIG_TTRACE_STREAM_BATCH - sizeof(uint32_t);
+		}
+		memcpy(payload, &g_stream.str_sent, sizeof(uint32_t));
+		memcpy(payload + sizeof(uint32_t), &g_ttrace_strtab[g_stream.str_sent], len);
+		g_stream.str_sent += len;
+		len += sizeof(uint32_t);
+	} else if (g_stream.tasks_dirty) {
+		chunk->type = TTRACE_CHUNK_TASKS;
+		while (g_stream.task_next < CONFIG_MAX_TASKS && len + sizeof(struct ttrace_task_s) <= CONFIG_TTRACE_STREAM_BATCH) {
+			task = &g_ttrace_tasks[g_stream.task_next++];
+			if (task->strid != 0) {
+				memcpy(payload + len, task, sizeof(struct ttrace_task_s));
+				len += sizeof(struct ttrace_task_s);
+			}
+		}
+		if (g_stream.task_next == CONFIG_MAX_TASKS) {
+			g_stream.task_next = 0;
+			g_stream.tasks_dirty = false;
+		}
+	} else {
+#ifdef TTRACE_HAVE_URECORD
+		if (g_state == TTRACE_STATE_RUNNING) {
+			ttrace_collect(priv);
+		}
+#endif
+		used = lfring_used(&priv->ttrace_ring);
+		if (used > g_stream.stats.max_used) {
+			g_stream.stats.max_used = used;
+		}
+
+		chunk->type = TTRACE_CHUNK_RECORDS;
+		while (used > 0) {
+			size = lfring_peek(&priv->ttrace_ring, rec, sizeof(rec));
+			size = ttrace_record_size(rec, size, &delta);
+			if (size == 0 || len + size > CONFIG_TTRACE_STREAM_BATCH) {
+				break;
+			}
+			lfring_read(&priv->ttrace_ring, payload + len, size);
+			g_stream.ts += delta;
+			len += size;
+			used -= size;
+		}
+	}
+
+	g_stream.stats.lost = priv->ttrace_lost;
+	sched_unlock();
+
+	if (len == 0) {
+		return 0;
+	}
+
+	chunk->magic = TTRACE_STREAM_MAGIC;
+	chunk->reserved = 0;
+	chunk->len = (uint16_t)len;
+	return sizeof(struct ttrace_chunk_s) + len;
+}
+
+/****************************************************************************
+ * Name: ttrace_stream_send
+ *
+ * Description:
+ *   Write one chunk to the sink.  The sink is closed on an error and opened
+ *   again in the next interval.
+ *
+ ****************************************************************************/
+
+static int ttrace_stream_send(FAR const uint8_t *buf, size_t len)
+{
+	clock_t start = clock_systimer();
+	uint32_t elapsed;
+	ssize_t ret;
+
+	while (len > 0) {
+		ret = write(g_stream.fd, buf, len);
+		if (ret <= 0) {
+			if (ret < 0 && get_errno() == EINTR) {
+				continue;
+			}
+			g_stream.stats.errors++;
+			ttrace_stream_close();
+			return ERROR;
+		}
+		buf += ret;
+		len -= ret;
+		g_stream.stats.sent += ret;
+	}
+
+	elapsed = TICK2MSEC(clock_systimer() - start);
+	if (elapsed > g_stream.stats.max_write_ms) {
+		g_stream.stats.max_write_ms = elapsed;
+	}
+	return OK;
+}
+
+static int ttrace_stream_send_stats(void)
+{
+	struct {
+		struct ttrace_chunk_s chunk;
+		struct ttrace_stream_stats_s stats;
+	} msg;
+
+	msg.chunk.magic = TTRACE_STREAM_MAGIC;
+	msg.chunk.type = TTRACE_CHUNK_STATS;
+	msg.chunk.reserved = 0;
+	msg.chunk.len = sizeof(struct ttrace_stream_stats_s);
+
+	sched_lock();
+	msg.stats = g_stream.stats;
+	msg.stats.lost = g_sysdev.ttrace_lost;
+	sched_unlock();
+
+	return ttrace_stream_send((FAR const uint8_t *)&msg, sizeof(msg));
+}
+
+/****************************************************************************
+ * Name: ttrace_stream_thread
+ *
+ * Description:
+ *   Drain the ring to the sink every CONFIG_TTRACE_STREAM_INTERVAL ms while
+ *   tracing.  When the trace finishes, the rest of it and the statistics
+ *   are sent and the sink is closed.
+ *
+ ****************************************************************************/
+
+static int ttrace_stream_thread(int argc, char *argv[])
+{
+	FAR struct ttrace_dev_s *priv = &g_sysdev;
+	clock_t last_stats = clock_systimer();
+	bool running;
+	size_t len;
+
+	while (1) {
+		usleep(CONFIG_TTRACE_STREAM_INTERVAL * 1000);
+
+		running = (g_state == TTRACE_STATE_RUNNING);
+		if (g_stream.fd < 0 && (!running || ttrace_stream_open() != OK)) {
+			continue;
+		}
+
+		while ((len = ttrace_stream_chunk(priv)) > 0) {
+			if (ttrace_stream_send(g_stream.buf, len) != OK) {
+				break;
+			}
+		}
+
+		if (g_stream.fd < 0) {
+			continue;
+		}
+
+		if (!running) {
+			ttrace_stream_send_stats();
+			if (g_stream.fd >= 0) {
+				ttrace_stream_close();
+			}
+		} else if (clock_systimer() - last_stats >= SEC2TICK(1)) {
+			last_stats = clock_systimer();
+			ttrace_stream_send_stats();
+		}
+	}
+
+	return 0;
+}
+
+/****************************************************************************
+ * Name: ttrace_stream_start
+ *
+ * Description:
+ *   Start a new stream for the trace which has just started.
+ *
+ ****************************************************************************/
+
+static void ttrace_stream_start(void)
+{
+	sched_lock();
+	g_stream.ts = 0;
+	g_stream.restart = true;
+	memset(&g_stream.stats, 0, sizeof(g_stream.stats));
+	sched_unlock();
+
+	if (g_stream.pid < 0) {
+		g_stream.pid = kernel_thread("ttrace_stream", CONFIG_TTRACE_STREAM_PRIORITY, CONFIG_TTRACE_STREAM_STACKSIZE, ttrace_stream_thread, NULL);
+		if (g_stream.pid < 0) {
+			ttdbg("Failed to start the stream thread, errno %d\r\n", get_errno());
+		}
+	}
+}
+#endif
+
 /****************************************************************************
  * Name: ttrace_read
+ *
+ * Description:
+ *   Read the capture: the header and side tables first, then the records
+ *   which are removed from the ring.
+ *
  ****************************************************************************/
 
 static ssize_t ttrace_read(FAR struct file *filep, FAR char *buffer, size_t len)
 {
 	struct inode *inode = filep->f_inode;
 	struct ttrace_dev_s *priv = inode->i_private;
+	size_t nread = 0;
 
 	if (TTRACE_STATE_IDLE != g_state) {
 		return TTRACE_INVALID;
@@ -141,38 +1049,57 @@ static ssize_t ttrace_read(FAR struct file *filep, FAR char *buffer, size_t len)
 	DEBUGASSERT(priv);
 	sched_lock();
 
-	ttdbg("buffer: %p, ringbuf: %p\r\n", buffer, g_ringbuf.buffer);
-	ttdbg("ringbuf_index: %d\r\n", priv->ttrace_head);
-	ttdbg("ringbuf_is_overwritten: %d\r\n", g_ringbuf.is_overwritten);
-	ttdbg("ringbuf_is_overwritable: %d\r\n", g_ringbuf.is_overwritable);
-	ringbuf_read(buffer, len, &g_ringbuf);
-	priv->ttrace_head = g_ringbuf.index;
+	ttdbg("buffer: %p, used: %d, dropped: %d\r\n", buffer, lfring_used(&priv->ttrace_ring), priv->ttrace_dropped);
+
+	if (filep->f_pos < TTRACE_PREFIX_BYTES(priv)) {
+		nread = ttrace_read_prefix(priv, filep->f_pos, buffer, len);
+	}
+	nread += lfring_read(&priv->ttrace_ring, buffer + nread, len - nread);
+	filep->f_pos += nread;
 
 	sched_unlock();
-	return (ssize_t)len;
+	return (ssize_t)nread;
 }
 
 /****************************************************************************
  * Name: ttrace_write
+ *
+ * Description:
+ *   Store one struct trace_event as a compact record.
+ *
  ****************************************************************************/
 
 static ssize_t ttrace_write(FAR struct file *filep, FAR const char *buffer, size_t len)
 {
 	struct inode *inode = filep->f_inode;
 	struct ttrace_dev_s *priv = inode->i_private;
+	int ret;
 
 	if (TTRACE_STATE_RUNNING != g_state) {
 		return TTRACE_INVALID;
 	}
 
 	DEBUGASSERT(priv);
+
+	if (len < TTRACE_EVENT_HDRBYTES || len > sizeof(struct trace_event)) {
+		return TTRACE_INVALID;
+	}
+
 	sched_lock();
 
-	ringbuf_write(buffer, len, &g_ringbuf);
-	priv->ttrace_head = g_ringbuf.index;
+#ifdef TTRACE_HAVE_URECORD
+	/* Keep the queued records close to the time order of the trace */
+
+	ttrace_collect(priv);
+#endif
+	ret = ttrace_store(priv, (FAR const struct trace_event *)buffer, len, getpid(), ttrace_gettime(priv));
 
 	sched_unlock();
-	return (ssize_t)len;
+
+	if (ret == TTRACE_OVERFLOW) {
+		return 0;
+	}
+	return ret == TTRACE_VALID ? (ssize_t)len : ret;
 }
 
 /****************************************************************************
@@ -191,42 +1118,83 @@ static int ttrace_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 	switch (cmd) {
 	case TTRACE_START:
 		g_state = TTRACE_STATE_RUNNING;
-		priv->ttrace_head = 0;
+		ttrace_reset(priv);
+#ifdef TTRACE_HAVE_URECORD
+		ttrace_discard();
+#endif
+		ttrace_set_tags(g_selected_tag);
+#ifdef CONFIG_TTRACE_STREAM
+		sched_unlock();
+		ttrace_stream_start();
+		return ret;
+#else
 		break;
+#endif
 	case TTRACE_OVERWRITE:
-		g_ringbuf.is_overwritable = arg;
+#ifdef CONFIG_TTRACE_STREAM
+		/* The stream thread drains the buffer, records are never overwritten */
+		ttdbg("Overwrite is not used with the stream.\r\n");
+#else
+		priv->ttrace_overwritable = (arg != 0);
+#endif
 		break;
 	case TTRACE_FINISH:
+		ttrace_set_tags(0);
+#ifdef TTRACE_HAVE_URECORD
+		if (g_state == TTRACE_STATE_RUNNING) {
+			ttrace_collect(priv);
+		}
+#endif
 		g_selected_tag = 0;
 		g_state = TTRACE_STATE_IDLE;
 		break;
 	case TTRACE_INFO:
-		ttdbg("Available tags: apps libs lock ipc task\r\n");
+		ttdbg("Available tags: apps libs lock ipc task irq sem prio mq work heap\r\n");
 		ttdbg("State: %d\r\n", g_state);
 		ttdbg("Selected tags: %d\r\n", g_selected_tag);
-		ttdbg("Buffer index: %d\r\n", g_ringbuf.index);
-		ttdbg("Real Buffer size: %d\r\n", g_ringbuf.bufsize);
+		ttdbg("Used buffer size: %d\r\n", lfring_used(&priv->ttrace_ring));
+		ttdbg("Real Buffer size: %d\r\n", priv->ttrace_ring.size);
 		ttdbg("Given buffer size: %d\r\n", CONFIG_TTRACE_BUFSIZE);
-		ttdbg("Buffer is_overwritten: %d\r\n", g_ringbuf.is_overwritten);
-		ttdbg("Buffer is_overwritable: %d\r\n", g_ringbuf.is_overwritable);
+		ttdbg("Interned strings: %d (%d/%d bytes)\r\n", priv->nstrings, priv->strtab_len, CONFIG_TTRACE_STRTAB_SIZE);
+		ttdbg("Timestamp frequency: %u Hz\r\n", priv->ts_freq);
+		ttdbg("Dropped records: %d\r\n", priv->ttrace_dropped);
+		ttdbg("Lost records: %d\r\n", priv->ttrace_lost);
+#ifdef CONFIG_TTRACE_STREAM
+		ttdbg("Stream: %s, sent %u bytes, %u errors\r\n", g_stream.fd >= 0 ? "open" : "closed", g_stream.stats.sent, g_stream.stats.errors);
+		ttdbg("Stream: max used %u bytes, max write %u ms\r\n", g_stream.stats.max_used, g_stream.stats.max_write_ms);
+#endif
+		ttdbg("Buffer is_overwritable: %d\r\n", priv->ttrace_overwritable);
 		break;
 	case TTRACE_SELECTED_TAG:
 		g_selected_tag |= arg;
+		if (g_state == TTRACE_STATE_RUNNING) {
+			ttrace_set_tags(g_selected_tag);
+		}
 		break;
 	case TTRACE_FUNC_TAG:
 		ret = g_selected_tag;
 		break;
 	case TTRACE_SET_BUFSIZE:
-		g_ringbuf.bufsize = CONFIG_TTRACE_BUFSIZE - (CONFIG_TTRACE_BUFSIZE % arg);
+		/* Records are dropped whole on overwrite, so the buffer does not
+		 * need to be aligned to the record size.
+		 */
 		break;
 	case TTRACE_USED_BUFSIZE:
-		if (g_ringbuf.is_overwritten == 0) {
-			ret = priv->ttrace_head;
-		} else {
-			ret = CONFIG_TTRACE_BUFSIZE;
-		}
+		ret = TTRACE_PREFIX_BYTES(priv) + lfring_used(&priv->ttrace_ring);
 		ttdbg("used bufsize: %d\r\n", ret);
 		break;
+#ifdef CONFIG_TTRACE_USERBUF
+	case TTRACE_GET_UBUF:
+		*(FAR struct ttrace_ubuf_s **)arg = &g_ttrace_ubuf;
+		break;
+#endif
+#ifdef TTRACE_HAVE_URECORD
+	case TTRACE_COLLECT:
+		if (g_state == TTRACE_STATE_RUNNING) {
+			ttrace_collect(priv);
+		}
+		break;
+#endif
 	case TTRACE_BUFFER:
 		ttdbg("Resize of trace buffer is not supported yet.\r\n");
 		ttdbg("Trace buffer size should be defined by menuconfig.\r\n");
@@ -244,6 +1212,48 @@ static int ttrace_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_TTRACE_KERNEL
+/****************************************************************************
+ * Name: ttrace_kevent
+ *
+ * Description:
+ *   Queue an event of a kernel tracepoint.  It may be called from an
+ *   interrupt handler, so the event is only queued here.  The queue is
+ *   moved to the trace when it is half full, unless in an interrupt.
+ *
+ ****************************************************************************/
+
+void ttrace_kevent(uint8_t id, uint32_t arg0, uint32_t arg1)
+{
+	struct trace_urecord urec;
+
+	urec.tick = clock_systimer();
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+	urec.raw = up_perf_gettime();
+#else
+	urec.raw = 0;
+#endif
+	urec.pid = getpid();
+	urec.event.type = TTRACE_REC_KEVENT;
+	urec.event.uid = id;
+	urec.event.u.kevent.arg0 = arg0;
+	urec.event.u.kevent.arg1 = arg1;
+
+	if (lfring_mpsc_put(&g_ttrace_kring, &urec) != OK) {
+		ttrace_count_lost(&g_sysdev);
+		return;
+	}
+
+	if (!up_interrupt_context() && LFRING_LOAD(&g_ttrace_kring.head) - LFRING_LOAD(&g_ttrace_kring.tail) > (g_ttrace_kring.mask + 1) / 2) {
+		sched_lock();
+		if (g_state == TTRACE_STATE_RUNNING) {
+			ttrace_collect(&g_sysdev);
+		}
+		sched_unlock();
+	}
+}
+#endif
+
 /****************************************************************************
  * Name: ttrace_init
  *
@@ -255,6 +1265,44 @@ static int ttrace_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
 int ttrace_init(void)
 {
+	size_t size = 1;
+	int ret;
+
+	/* The ring needs a power of two size, use the largest one that fits */
+
+	while (size * 2 <= CONFIG_TTRACE_BUFSIZE) {
+		size *= 2;
+	}
+	lfring_init(&g_sysdev.ttrace_ring, g_ttrace_buffer, size, 0);
+
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+	up_perf_init();
+	g_sysdev.ts_freq = up_perf_getfreq();
+#else
+	g_sysdev.ts_freq = USEC_PER_SEC;
+#endif
+	ttrace_reset(&g_sysdev);
+
+	/* Without the device the tags stay 0 and nobody gets the user buffer,
+	 * so no trace point uses the queues.
+	 */
+
+#ifdef CONFIG_TTRACE_USERBUF
+	ret = lfring_mpsc_init(&g_ttrace_ubuf.ring, g_ttrace_ubuf_storage, CONFIG_TTRACE_USERBUF_RECORDS, sizeof(struct trace_urecord));
+	if (ret != OK) {
+		ttdbg("Failed to init the user buffer: %d\r\n", ret);
+		return ret;
+	}
+#endif
+#ifdef CONFIG_TTRACE_KERNEL
+
+	ret = lfring_mpsc_init(&g_ttrace_kring, g_ttrace_kring_storage, CONFIG_TTRACE_KERNEL_RECORDS, sizeof(struct trace_urecord));
+	if (ret != OK) {
+		ttdbg("Failed to init the kernel event queue: %d\r\n", ret);
+		return ret;
+	}
+#endif
+
 	/* Register the syslog character driver */
 	return register_driver(CONFIG_TTRACE_DEVPATH, &g_ttracefops, 0666, &g_sysdev);
 }
@@ -108,6 +108,7 @@ extern const struct procfs_operations power_procfsoperations;
 extern const struct procfs_operations cm_operations;
 extern const struct procfs_operations irqs_operations;
 extern const struct procfs_operations ereport_operations;
+extern const struct procfs_operations net_procfsoperations;
 
 /* And even worse, this one is specific to the STM32.  The solution to
  * this nasty couple would be to replace this hard-coded, ROM-able
@@ -165,6 +166,10 @@ static const struct procfs_entry_s g_procfsentries[] = {
 	{"ereport**", &ereport_operations},
 	{"ereport/*", &ereport_operations},
 #endif
+#if defined(CONFIG_NET_LWIP) && !defined(CONFIG_FS_PROCFS_EXCLUDE_NET)
+	{"net**", &net_procfsoperations},
+	{"net/*", &net_procfsoperations},
+#endif
 
 	{NULL, NULL}
 };
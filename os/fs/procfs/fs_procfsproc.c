@@ -121,6 +121,9 @@ enum proc_node_e {
 	PROC_CMDLINE,				/* Task command line */
 #ifdef CONFIG_SCHED_CPULOAD
 	PROC_LOADAVG,				/* Average CPU utilization */
+#endif
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+	PROC_LATENCY,				/* Wakeup-to-run latency histogram */
 #endif
 	PROC_STACK,					/* Task stack info */
 	PROC_GROUP,					/* Group directory */
@@ -168,6 +171,9 @@ static ssize_t proc_entry_cmdline(FAR struct proc_file_s *procfile, FAR struct t
 #ifdef CONFIG_SCHED_CPULOAD
 static ssize_t proc_entry_loadavg(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
 #endif
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+static ssize_t proc_entry_latency(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
+#endif
 static ssize_t proc_entry_stack(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
 static ssize_t proc_entry_groupstatus(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
 static ssize_t proc_entry_groupfd(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
@@ -240,6 +246,12 @@ static const struct proc_node_s g_loadavg = {
 };
 #endif
 
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+static const struct proc_node_s g_latency = {
+	"latency", "latency", (uint8_t)PROC_LATENCY, DTYPE_FILE	/* Wakeup-to-run latency histogram */
+};
+#endif
+
 static const struct proc_node_s g_stack = {
 	"stack", "stack", (uint8_t)PROC_STACK, DTYPE_FILE	/* Task stack info */
 };
@@ -264,6 +276,9 @@ static FAR const struct proc_node_s *const g_nodeinfo[] = {
 	&g_cmdline,					/* Task command line */
 #ifdef CONFIG_SCHED_CPULOAD
 	&g_loadavg,					/* Average CPU utilization */
+#endif
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+	&g_latency,					/* Wakeup-to-run latency histogram */
 #endif
 	&g_stack,					/* Task stack info */
 	&g_group,					/* Group directory */
@@ -281,6 +296,9 @@ static const struct proc_node_s *const g_level0info[] = {
 	&g_cmdline,					/* Task command line */
 #ifdef CONFIG_SCHED_CPULOAD
 	&g_loadavg,					/* Average CPU utilization */
+#endif
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+	&g_latency,					/* Wakeup-to-run latency histogram */
 #endif
 	&g_stack,					/* Task stack info */
 	&g_group,					/* Group directory */
@@ -694,6 +712,47 @@ static ssize_t proc_entry_loadavg(FAR struct proc_file_s *procfile, FAR struct t
 }
 #endif
 
+/****************************************************************************
+ * Name: proc_latency
+ ****************************************************************************/
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+static ssize_t proc_entry_latency(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset)
+{
+	size_t remaining;
+	size_t linesize;
+	size_t copysize;
+	size_t totalsize;
+	int bucket;
+
+	remaining = buflen;
+	totalsize = 0;
+
+	linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%u us\n", "Max:", tcb->latency.max);
+	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+	totalsize += copysize;
+	buffer += copysize;
+	remaining -= copysize;
+
+	/* Show one line per bucket, "<N us" is the upper bound of the bucket */
+
+	for (bucket = 0; bucket < CONFIG_SCHED_LATENCY_NBUCKETS && totalsize < buflen; bucket++) {
+		if (bucket < CONFIG_SCHED_LATENCY_NBUCKETS - 1) {
+			linesize = snprintf(procfile->line, STATUS_LINELEN, "<%-10u us %u\n", 1u << bucket, tcb->latency.count[bucket]);
+		} else {
+			linesize = snprintf(procfile->line, STATUS_LINELEN, ">=%-9u us %u\n", 1u << (bucket - 1), tcb->latency.count[bucket]);
+		}
+		copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+		totalsize += copysize;
+		buffer += copysize;
+		remaining -= copysize;
+	}
+
+	return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: proc_stack
  ****************************************************************************/
@@ -1117,6 +1176,11 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 	case PROC_LOADAVG:			/* Average CPU utilization */
 		ret = proc_entry_loadavg(procfile, tcb, buffer, buflen, filep->f_pos);
 		break;
+#endif
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+	case PROC_LATENCY:			/* Wakeup-to-run latency histogram */
+		ret = proc_entry_latency(procfile, tcb, buffer, buflen, filep->f_pos);
+		break;
 #endif
 	case PROC_STACK:			/* Task stack info */
 		ret = proc_entry_stack(procfile, tcb, buffer, buflen, filep->f_pos);
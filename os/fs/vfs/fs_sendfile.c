@@ -0,0 +1,82 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/vfs/fs_sendfile.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/sendfile.h>
+#include <errno.h>
+
+#include <tinyara/cancelpt.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/net/net.h>
+
+#ifdef CONFIG_NET_SENDFILE
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sendfile
+ *
+ * Description:
+ *   See include/sys/sendfile.h.  A file sent to a TCP socket does not go
+ *   through a user buffer, net_sendfile() sends it by reference.  Anything
+ *   else is copied with the read()/write() loop of lib_sendfile().
+ *
+ ****************************************************************************/
+
+ssize_t sendfile(int outfd, int infd, FAR off_t *offset, size_t count)
+{
+	FAR struct file *filep;
+	ssize_t ret;
+
+	if ((unsigned int)infd >= CONFIG_NFILE_DESCRIPTORS || (unsigned int)outfd < CONFIG_NFILE_DESCRIPTORS) {
+		return lib_sendfile(outfd, infd, offset, count);
+	}
+
+	/* sendfile() is a cancellation point */
+	(void)enter_cancellation_point();
+
+	filep = fs_getfilep(infd);
+	if (!filep) {
+		/* The errno value has already been set */
+
+		ret = ERROR;
+	} else {
+		ret = net_sendfile(outfd, filep, offset, count);
+		if (ret < 0 && get_errno() == ENOSYS) {
+			/* Not a TCP socket */
+
+			ret = lib_sendfile(outfd, infd, offset, count);
+		}
+	}
+
+	leave_cancellation_point();
+	return ret;
+}
+
+#endif							/* CONFIG_NET_SENDFILE */
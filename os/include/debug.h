@@ -142,21 +142,26 @@ int get_errno(void);
 /* C-99 style variadic macros are supported */
 
 #ifdef CONFIG_DEBUG
-/* Temporary LOGM macros to route all dbg messages.
- * Once LOGM is approved, each module should have its own index
+/* Index of the common dbg messages in logm.  Subsystem macros below pass
+ * their own index through the [ll][wv]dbg_idx() variants, so that logm can
+ * filter them per module before they are formatted.
  */
-#define LOGM_IDX (0)
+#define LOGM_IDX LOGM_UNKNOWN
 
 #ifdef CONFIG_DEBUG_ERROR
 #ifdef CONFIG_LOGM
 #define dbg(format, ...) \
 	logm(LOGM_NORMAL, LOGM_IDX, LOGM_ERR, EXTRA_FMT format EXTRA_ARG, ##__VA_ARGS__)
+#define dbg_idx(idx, format, ...) \
+	logm(LOGM_NORMAL, idx, LOGM_ERR, EXTRA_FMT format EXTRA_ARG, ##__VA_ARGS__)
 
 #define dbg_noarg(format, ...) \
 	logm(LOGM_NORMAL, LOGM_IDX, LOGM_ERR, format, ##__VA_ARGS__)
 
 #define lldbg(format, ...) \
 	logm(LOGM_LOWPUT, LOGM_IDX, LOGM_ERR, EXTRA_FMT format EXTRA_ARG, ##__VA_ARGS__)
+#define lldbg_idx(idx, format, ...) \
+	logm(LOGM_LOWPUT, idx, LOGM_ERR, EXTRA_FMT format EXTRA_ARG, ##__VA_ARGS__)
 
 #else
 /**
@@ -193,9 +198,13 @@ int get_errno(void);
 #ifdef CONFIG_LOGM
 #define wdbg(format, ...) \
 	logm(LOGM_NORMAL, LOGM_IDX, LOGM_WRN, EXTRA_FMT format EXTRA_ARG, ##__VA_ARGS__)
+#define wdbg_idx(idx, format, ...) \
+	logm(LOGM_NORMAL, idx, LOGM_WRN, EXTRA_FMT format EXTRA_ARG, ##__VA_ARGS__)
 
 #define llwdbg(format, ...) \
 	logm(LOGM_LOWPUT, LOGM_IDX, LOGM_WRN, EXTRA_FMT format EXTRA_ARG, ##__VA_ARGS__)
+#define llwdbg_idx(idx, format, ...) \
+	logm(LOGM_LOWPUT, idx, LOGM_WRN, EXTRA_FMT format EXTRA_ARG, ##__VA_ARGS__)
 
 #else
 /**
@@ -229,9 +238,13 @@ int get_errno(void);
 #ifdef CONFIG_LOGM
 #define vdbg(format, ...) \
 	logm(LOGM_NORMAL, LOGM_IDX, LOGM_INF, EXTRA_FMT format EXTRA_ARG, ##__VA_ARGS__)
+#define vdbg_idx(idx, format, ...) \
+	logm(LOGM_NORMAL, idx, LOGM_INF, EXTRA_FMT format EXTRA_ARG, ##__VA_ARGS__)
 
 #define llvdbg(format, ...) \
 	logm(LOGM_LOWPUT, LOGM_IDX, LOGM_INF, EXTRA_FMT format EXTRA_ARG, ##__VA_ARGS__)
+#define llvdbg_idx(idx, format, ...) \
+	logm(LOGM_LOWPUT, idx, LOGM_INF, EXTRA_FMT format EXTRA_ARG, ##__VA_ARGS__)
 
 #else
 /**
@@ -273,112 +286,133 @@ int get_errno(void);
 
 #endif							/* CONFIG_DEBUG */
 
+/* Without logm, the module index is ignored */
+
+#ifndef dbg_idx
+#define dbg_idx(idx, format, ...)    dbg(format, ##__VA_ARGS__)
+#endif
+#ifndef lldbg_idx
+#define lldbg_idx(idx, format, ...)  lldbg(format, ##__VA_ARGS__)
+#endif
+#ifndef wdbg_idx
+#define wdbg_idx(idx, format, ...)   wdbg(format, ##__VA_ARGS__)
+#endif
+#ifndef llwdbg_idx
+#define llwdbg_idx(idx, format, ...) llwdbg(format, ##__VA_ARGS__)
+#endif
+#ifndef vdbg_idx
+#define vdbg_idx(idx, format, ...)   vdbg(format, ##__VA_ARGS__)
+#endif
+#ifndef llvdbg_idx
+#define llvdbg_idx(idx, format, ...) llvdbg(format, ##__VA_ARGS__)
+#endif
+
 /****************************************/
 /*        Subsystem specific debug      */
 /****************************************/
 
 #ifdef CONFIG_DEBUG_AUDIO_ERROR
-#define auddbg(format, ...)    dbg(format, ##__VA_ARGS__)
-#define audlldbg(format, ...)  lldbg(format, ##__VA_ARGS__)
+#define auddbg(format, ...)    dbg_idx(LOGM_AUDIO, format, ##__VA_ARGS__)
+#define audlldbg(format, ...)  lldbg_idx(LOGM_AUDIO, format, ##__VA_ARGS__)
 #else
 #define auddbg(...)
 #define audlldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_AUDIO_WARN
-#define audwdbg(format, ...)    wdbg(format, ##__VA_ARGS__)
-#define audllwdbg(format, ...)  llwdbg(format, ##__VA_ARGS__)
+#define audwdbg(format, ...)    wdbg_idx(LOGM_AUDIO, format, ##__VA_ARGS__)
+#define audllwdbg(format, ...)  llwdbg_idx(LOGM_AUDIO, format, ##__VA_ARGS__)
 #else
 #define audwdbg(...)
 #define audllwdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_AUDIO_INFO
-#define audvdbg(format, ...)   vdbg(format, ##__VA_ARGS__)
-#define audllvdbg(format, ...) llvdbg(format, ##__VA_ARGS__)
+#define audvdbg(format, ...)   vdbg_idx(LOGM_AUDIO, format, ##__VA_ARGS__)
+#define audllvdbg(format, ...) llvdbg_idx(LOGM_AUDIO, format, ##__VA_ARGS__)
 #else
 #define audvdbg(...)
 #define audllvdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_BINFMT_ERROR
-#  define berr(format, ...)     dbg(format, ##__VA_ARGS__)
+#  define berr(format, ...)     dbg_idx(LOGM_BINARY, format, ##__VA_ARGS__)
 #else
 #  define berr(...)
 #endif
 
 #ifdef CONFIG_DEBUG_BINFMT_WARN
-#  define bwarn(format, ...)   wdbg(format, ##__VA_ARGS__)
+#  define bwarn(format, ...)   wdbg_idx(LOGM_BINARY, format, ##__VA_ARGS__)
 #else
 #  define bwarn(...)
 #endif
 
 #ifdef CONFIG_DEBUG_BINFMT_INFO
-#  define binfo(format, ...)   vdbg(format, ##__VA_ARGS__)
+#  define binfo(format, ...)   vdbg_idx(LOGM_BINARY, format, ##__VA_ARGS__)
 #else
 #  define binfo(...)
 #endif
 
 #ifdef CONFIG_DEBUG_BINMGR_ERROR
-#define bmdbg(format, ...)    dbg(format, ##__VA_ARGS__)
-#define bmlldbg(format, ...)  lldbg(format, ##__VA_ARGS__)
+#define bmdbg(format, ...)    dbg_idx(LOGM_BINARY, format, ##__VA_ARGS__)
+#define bmlldbg(format, ...)  lldbg_idx(LOGM_BINARY, format, ##__VA_ARGS__)
 #else
 #define bmdbg(...)
 #define bmlldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_BINMGR_INFO
-#define bmvdbg(format, ...)   vdbg(format, ##__VA_ARGS__)
-#define bmllvdbg(format, ...)  llvdbg(format, ##__VA_ARGS__)
+#define bmvdbg(format, ...)   vdbg_idx(LOGM_BINARY, format, ##__VA_ARGS__)
+#define bmllvdbg(format, ...)  llvdbg_idx(LOGM_BINARY, format, ##__VA_ARGS__)
 #else
 #define bmvdbg(...)
 #define bmllvdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_ERR_REPORT_ERROR
-#define nwerrdbg(format, ...)    dbg(format, ##__VA_ARGS__)
-#define nwerrlldbg(format, ...)  lldbg(format, ##__VA_ARGS__)
+#define nwerrdbg(format, ...)    dbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
+#define nwerrlldbg(format, ...)  lldbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
 #else
 #define nwerrdbg(...)
 #define nwerrlldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_ERR_REPORT_WARN
-#define nwerr_wdbg(format, ...)    wdbg(format, ##__VA_ARGS__)
-#define nwerr_llwdbg(format, ...)  llwdbg(format, ##__VA_ARGS__)
+#define nwerr_wdbg(format, ...)    wdbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
+#define nwerr_llwdbg(format, ...)  llwdbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
 #else
 #define nwerr_wdbg(...)
 #define nwerr_llwdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_ERR_REPORT_INFO
-#define nwerr_vdbg(format, ...)   vdbg(format, ##__VA_ARGS__)
-#define nwerr_llvdbg(format, ...) llvdbg(format, ##__VA_ARGS__)
+#define nwerr_vdbg(format, ...)   vdbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
+#define nwerr_llvdbg(format, ...) llvdbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
 #else
 #define nwerr_vdbg(...)
 #define nwerr_llvdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_FS_ERROR
-#define fdbg(format, ...)    dbg(format, ##__VA_ARGS__)
-#define flldbg(format, ...)  lldbg(format, ##__VA_ARGS__)
+#define fdbg(format, ...)    dbg_idx(LOGM_FS, format, ##__VA_ARGS__)
+#define flldbg(format, ...)  lldbg_idx(LOGM_FS, format, ##__VA_ARGS__)
 #else
 #define fdbg(...)
 #define flldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_FS_WARN
-#define fwdbg(format, ...)    wdbg(format, ##__VA_ARGS__)
-#define fllwdbg(format, ...)  llwdbg(format, ##__VA_ARGS__)
+#define fwdbg(format, ...)    wdbg_idx(LOGM_FS, format, ##__VA_ARGS__)
+#define fllwdbg(format, ...)  llwdbg_idx(LOGM_FS, format, ##__VA_ARGS__)
 #else
 #define fwdbg(...)
 #define fllwdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_FS_INFO
-#define fvdbg(format, ...)   vdbg(format, ##__VA_ARGS__)
+#define fvdbg(format, ...)   vdbg_idx(LOGM_FS, format, ##__VA_ARGS__)
 #define fsdbg(format, ...)   dbg_noarg(format, ##__VA_ARGS__)
-#define fllvdbg(format, ...) llvdbg(format, ##__VA_ARGS__)
+#define fllvdbg(format, ...) llvdbg_idx(LOGM_FS, format, ##__VA_ARGS__)
 #else
 #define fvdbg(...)
 #define fsdbg(format, ...)
@@ -386,24 +420,24 @@ int get_errno(void);
 #endif
 
 #ifdef CONFIG_DEBUG_LIB_ERROR
-#define ldbg(format, ...)    dbg(format, ##__VA_ARGS__)
-#define llldbg(format, ...)  lldbg(format, ##__VA_ARGS__)
+#define ldbg(format, ...)    dbg_idx(LOGM_LIB, format, ##__VA_ARGS__)
+#define llldbg(format, ...)  lldbg_idx(LOGM_LIB, format, ##__VA_ARGS__)
 #else
 #define ldbg(...)
 #define llldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_LIB_WARN
-#define lwdbg(format, ...)    wdbg(format, ##__VA_ARGS__)
-#define lllwdbg(format, ...)  llwdbg(format, ##__VA_ARGS__)
+#define lwdbg(format, ...)    wdbg_idx(LOGM_LIB, format, ##__VA_ARGS__)
+#define lllwdbg(format, ...)  llwdbg_idx(LOGM_LIB, format, ##__VA_ARGS__)
 #else
 #define lwdbg(...)
 #define lllwdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_LIB_INFO
-#define lvdbg(format, ...)   vdbg(format, ##__VA_ARGS__)
-#define lllvdbg(format, ...) llvdbg(format, ##__VA_ARGS__)
+#define lvdbg(format, ...)   vdbg_idx(LOGM_LIB, format, ##__VA_ARGS__)
+#define lllvdbg(format, ...) llvdbg_idx(LOGM_LIB, format, ##__VA_ARGS__)
 #else
 #define lvdbg(...)
 #define lllvdbg(...)
@@ -418,112 +452,112 @@ int get_errno(void);
 #endif
 
 #ifdef CONFIG_DEBUG_MM_ERROR
-#define mdbg(format, ...)    dbg(format, ##__VA_ARGS__)
-#define mlldbg(format, ...)  lldbg(format, ##__VA_ARGS__)
+#define mdbg(format, ...)    dbg_idx(LOGM_MM, format, ##__VA_ARGS__)
+#define mlldbg(format, ...)  lldbg_idx(LOGM_MM, format, ##__VA_ARGS__)
 #else
 #define mdbg(...)
 #define mlldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_MM_WARN
-#define mwdbg(format, ...)    wdbg(format, ##__VA_ARGS__)
-#define mllwdbg(format, ...)  llwdbg(format, ##__VA_ARGS__)
+#define mwdbg(format, ...)    wdbg_idx(LOGM_MM, format, ##__VA_ARGS__)
+#define mllwdbg(format, ...)  llwdbg_idx(LOGM_MM, format, ##__VA_ARGS__)
 #else
 #define mwdbg(...)
 #define mllwdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_MM_INFO
-#define mvdbg(format, ...)   vdbg(format, ##__VA_ARGS__)
-#define mllvdbg(format, ...) llvdbg(format, ##__VA_ARGS__)
+#define mvdbg(format, ...)   vdbg_idx(LOGM_MM, format, ##__VA_ARGS__)
+#define mllvdbg(format, ...) llvdbg_idx(LOGM_MM, format, ##__VA_ARGS__)
 #else
 #define mvdbg(...)
 #define mllvdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_NET_ERROR
-#define ndbg(format, ...)    dbg(format, ##__VA_ARGS__)
-#define nlldbg(format, ...)  lldbg(format, ##__VA_ARGS__)
+#define ndbg(format, ...)    dbg_idx(LOGM_NET, format, ##__VA_ARGS__)
+#define nlldbg(format, ...)  lldbg_idx(LOGM_NET, format, ##__VA_ARGS__)
 #else
 #define ndbg(...)
 #define nlldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_NET_WARN
-#define nwdbg(format, ...)    wdbg(format, ##__VA_ARGS__)
-#define nllwdbg(format, ...)  llwdbg(format, ##__VA_ARGS__)
+#define nwdbg(format, ...)    wdbg_idx(LOGM_NET, format, ##__VA_ARGS__)
+#define nllwdbg(format, ...)  llwdbg_idx(LOGM_NET, format, ##__VA_ARGS__)
 #else
 #define nwdbg(...)
 #define nllwdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_NET_INFO
-#define nvdbg(format, ...)   vdbg(format, ##__VA_ARGS__)
-#define nllvdbg(format, ...) llvdbg(format, ##__VA_ARGS__)
+#define nvdbg(format, ...)   vdbg_idx(LOGM_NET, format, ##__VA_ARGS__)
+#define nllvdbg(format, ...) llvdbg_idx(LOGM_NET, format, ##__VA_ARGS__)
 #else
 #define nvdbg(...)
 #define nllvdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_SCHED_ERROR
-#define sdbg(format, ...)    dbg(format, ##__VA_ARGS__)
-#define slldbg(format, ...)  lldbg(format, ##__VA_ARGS__)
+#define sdbg(format, ...)    dbg_idx(LOGM_SCHED, format, ##__VA_ARGS__)
+#define slldbg(format, ...)  lldbg_idx(LOGM_SCHED, format, ##__VA_ARGS__)
 #else
 #define sdbg(...)
 #define slldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_SCHED_WARN
-#define swdbg(format, ...)    wdbg(format, ##__VA_ARGS__)
-#define sllwdbg(format, ...)  llwdbg(format, ##__VA_ARGS__)
+#define swdbg(format, ...)    wdbg_idx(LOGM_SCHED, format, ##__VA_ARGS__)
+#define sllwdbg(format, ...)  llwdbg_idx(LOGM_SCHED, format, ##__VA_ARGS__)
 #else
 #define swdbg(...)
 #define sllwdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_SCHED_INFO
-#define svdbg(format, ...)   vdbg(format, ##__VA_ARGS__)
-#define sllvdbg(format, ...) llvdbg(format, ##__VA_ARGS__)
+#define svdbg(format, ...)   vdbg_idx(LOGM_SCHED, format, ##__VA_ARGS__)
+#define sllvdbg(format, ...) llvdbg_idx(LOGM_SCHED, format, ##__VA_ARGS__)
 #else
 #define svdbg(...)
 #define sllvdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_PM_ERROR
-#define pmdbg(format, ...)    dbg(format, ##__VA_ARGS__)
-#define pmlldbg(format, ...)  lldbg(format, ##__VA_ARGS__)
+#define pmdbg(format, ...)    dbg_idx(LOGM_PM, format, ##__VA_ARGS__)
+#define pmlldbg(format, ...)  lldbg_idx(LOGM_PM, format, ##__VA_ARGS__)
 #else
 #define pmdbg(...)
 #define pmlldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_PM_WARN
-#define pmwdbg(format, ...)    wdbg(format, ##__VA_ARGS__)
-#define pmllwdbg(format, ...)  llwdbg(format, ##__VA_ARGS__)
+#define pmwdbg(format, ...)    wdbg_idx(LOGM_PM, format, ##__VA_ARGS__)
+#define pmllwdbg(format, ...)  llwdbg_idx(LOGM_PM, format, ##__VA_ARGS__)
 #else
 #define pmwdbg(...)
 #define pmllwdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_PM_INFO
-#define pmvdbg(format, ...)   vdbg(format, ##__VA_ARGS__)
-#define pmllvdbg(format, ...) llvdbg(format, ##__VA_ARGS__)
+#define pmvdbg(format, ...)   vdbg_idx(LOGM_PM, format, ##__VA_ARGS__)
+#define pmllvdbg(format, ...) llvdbg_idx(LOGM_PM, format, ##__VA_ARGS__)
 #else
 #define pmvdbg(...)
 #define pmllvdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_SECURE_ELEMENT_ERROR
-#define sedbg(format, ...)     dbg(format, ##__VA_ARGS__)
-#define selldbg(format, ...)   lldbg(format, ##__VA_ARGS__)
+#define sedbg(format, ...)     dbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
+#define selldbg(format, ...)   lldbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
 #else
 #define sedbg(...)
 #define selldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_SECURE_ELEMENT_INFO
-#define sevdbg(format, ...)     vdbg(format, ##__VA_ARGS__)
-#define sellvdbg(format, ...)   llvdbg(format, ##__VA_ARGS__)
+#define sevdbg(format, ...)     vdbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
+#define sellvdbg(format, ...)   llvdbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
 #else
 #define sevdbg(...)
 #define sellvdbg(...)
@@ -534,16 +568,16 @@ int get_errno(void);
 /****************************************/
 
 #ifdef CONFIG_DEBUG_DM_ERROR
-#define dmdbg(format, ...)    dbg(format, ##__VA_ARGS__)
-#define dmlldbg(format, ...)  lldbg(format, ##__VA_ARGS__)
+#define dmdbg(format, ...)    dbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
+#define dmlldbg(format, ...)  lldbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
 #else
 #define dmdbg(...)
 #define dmlldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_DM_WARN
-#define dmwdbg(format, ...)    wdbg(format, ##__VA_ARGS__)
-#define dmllwdbg(format, ...)  llwdbg(format, ##__VA_ARGS__)
+#define dmwdbg(format, ...)    wdbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
+#define dmllwdbg(format, ...)  llwdbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
 #else
 #define dmwdbg(...)
 #define dmllwdbg(...)
@@ -558,40 +592,40 @@ int get_errno(void);
 #endif
 
 #ifdef CONFIG_DEBUG_EVENTLOOP_ERROR
-#define eldbg(format, ...)      dbg(format, ##__VA_ARGS__)
-#define ellldbg(format, ...)    lldbg(format, ##__VA_ARGS__)
+#define eldbg(format, ...)      dbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
+#define ellldbg(format, ...)    lldbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
 #else
 #define eldbg(...)
 #define ellldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_EVENTLOOP_INFO
-#define elvdbg(format, ...)     vdbg(format, ##__VA_ARGS__)
-#define elllvdbg(format, ...)   llvdbg(format, ##__VA_ARGS__)
+#define elvdbg(format, ...)     vdbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
+#define elllvdbg(format, ...)   llvdbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
 #else
 #define elvdbg(...)
 #define elllvdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_MEDIA_ERROR
-#define meddbg(format, ...)    dbg(format, ##__VA_ARGS__)
-#define medlldbg(format, ...)  lldbg(format, ##__VA_ARGS__)
+#define meddbg(format, ...)    dbg_idx(LOGM_MEDIA, format, ##__VA_ARGS__)
+#define medlldbg(format, ...)  lldbg_idx(LOGM_MEDIA, format, ##__VA_ARGS__)
 #else
 #define meddbg(...)
 #define medlldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_MEDIA_WARN
-#define medwdbg(format, ...)    wdbg(format, ##__VA_ARGS__)
-#define medllwdbg(format, ...)  llwdbg(format, ##__VA_ARGS__)
+#define medwdbg(format, ...)    wdbg_idx(LOGM_MEDIA, format, ##__VA_ARGS__)
+#define medllwdbg(format, ...)  llwdbg_idx(LOGM_MEDIA, format, ##__VA_ARGS__)
 #else
 #define medwdbg(...)
 #define medllwdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_MEDIA_INFO
-#define medvdbg(format, ...)    vdbg(format, ##__VA_ARGS__)
-#define medllvdbg(format, ...)  llvdbg(format, ##__VA_ARGS__)
+#define medvdbg(format, ...)    vdbg_idx(LOGM_MEDIA, format, ##__VA_ARGS__)
+#define medllvdbg(format, ...)  llvdbg_idx(LOGM_MEDIA, format, ##__VA_ARGS__)
 #else
 #define medvdbg(...)
 #define medllvdbg(...)
@@ -606,31 +640,31 @@ int get_errno(void);
 #endif
 
 #ifdef CONFIG_DEBUG_SECURITY_FRAMEWORK_ERROR
-#define sfdbg(format, ...)     dbg(format, ##__VA_ARGS__)
-#define sflldbg(format, ...)   lldbg(format, ##__VA_ARGS__)
+#define sfdbg(format, ...)     dbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
+#define sflldbg(format, ...)   lldbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
 #else
 #define sfdbg(...)
 #define sflldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_SECURITY_FRAMEWORK_INFO
-#define sfvdbg(format, ...)     vdbg(format, ##__VA_ARGS__)
-#define sfllvdbg(format, ...)   llvdbg(format, ##__VA_ARGS__)
+#define sfvdbg(format, ...)     vdbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
+#define sfllvdbg(format, ...)   llvdbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
 #else
 #define sfvdbg(...)
 #define sfllvdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_TASK_MANAGER_ERROR
-#define tmdbg(format, ...)      dbg(format, ##__VA_ARGS__)
-#define tmlldbg(format, ...)    lldbg(format, ##__VA_ARGS__)
+#define tmdbg(format, ...)      dbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
+#define tmlldbg(format, ...)    lldbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
 #else
 #define tmdbg(...)
 #define tmlldbg(...)
 #endif
 #ifdef CONFIG_DEBUG_TASK_MANAGER_INFO
-#define tmvdbg(format, ...)     vdbg(format, ##__VA_ARGS__)
-#define tmllvdbg(format, ...)   llvdbg(format, ##__VA_ARGS__)
+#define tmvdbg(format, ...)     vdbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
+#define tmllvdbg(format, ...)   llvdbg_idx(LOGM_FRAMEWORK, format, ##__VA_ARGS__)
 #else
 #define tmvdbg(...)
 #define tmllvdbg(...)
@@ -641,48 +675,48 @@ int get_errno(void);
 /******************************************/
 
 #ifdef CONFIG_DEBUG_DMA_ERROR
-#define dmadbg(format, ...)    dbg(format, ##__VA_ARGS__)
-#define dmalldbg(format, ...)  lldbg(format, ##__VA_ARGS__)
+#define dmadbg(format, ...)    dbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define dmalldbg(format, ...)  lldbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define dmadbg(...)
 #define dmalldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_DMA_WARN
-#define dmawdbg(format, ...)    wdbg(format, ##__VA_ARGS__)
-#define dmallwdbg(format, ...)  llwdbg(format, ##__VA_ARGS__)
+#define dmawdbg(format, ...)    wdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define dmallwdbg(format, ...)  llwdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define dmawdbg(...)
 #define dmallwdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_DMA_INFO
-#define dmavdbg(format, ...)   vdbg(format, ##__VA_ARGS__)
-#define dmallvdbg(format, ...) llvdbg(format, ##__VA_ARGS__)
+#define dmavdbg(format, ...)   vdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define dmallvdbg(format, ...) llvdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define dmavdbg(...)
 #define dmallvdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_PAGING_ERROR
-#define pgdbg(format, ...)    dbg(format, ##__VA_ARGS__)
-#define pglldbg(format, ...)  lldbg(format, ##__VA_ARGS__)
+#define pgdbg(format, ...)    dbg_idx(LOGM_MM, format, ##__VA_ARGS__)
+#define pglldbg(format, ...)  lldbg_idx(LOGM_MM, format, ##__VA_ARGS__)
 #else
 #define pgdbg(...)
 #define pglldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_PAGING_WARN
-#define pgwdbg(format, ...)    wdbg(format, ##__VA_ARGS__)
-#define pgllwdbg(format, ...)  llwdbg(format, ##__VA_ARGS__)
+#define pgwdbg(format, ...)    wdbg_idx(LOGM_MM, format, ##__VA_ARGS__)
+#define pgllwdbg(format, ...)  llwdbg_idx(LOGM_MM, format, ##__VA_ARGS__)
 #else
 #define pgwdbg(...)
 #define pgllwdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_PAGING_INFO
-#define pgvdbg(format, ...)   vdbg(format, ##__VA_ARGS__)
-#define pgllvdbg(format, ...) llvdbg(format, ##__VA_ARGS__)
+#define pgvdbg(format, ...)   vdbg_idx(LOGM_MM, format, ##__VA_ARGS__)
+#define pgllvdbg(format, ...) llvdbg_idx(LOGM_MM, format, ##__VA_ARGS__)
 #else
 #define pgvdbg(...)
 #define pgllvdbg(...)
@@ -693,240 +727,240 @@ int get_errno(void);
 /*************************************/
 
 #ifdef CONFIG_DEBUG_ANALOG_ERROR
-#define adbg(format, ...)    dbg(format, ##__VA_ARGS__)
-#define alldbg(format, ...)  lldbg(format, ##__VA_ARGS__)
+#define adbg(format, ...)    dbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define alldbg(format, ...)  lldbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define adbg(...)
 #define alldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_ANALOG_WARN
-#define awdbg(format, ...)    wdbg(format, ##__VA_ARGS__)
-#define allwdbg(format, ...)  llwdbg(format, ##__VA_ARGS__)
+#define awdbg(format, ...)    wdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define allwdbg(format, ...)  llwdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define awdbg(...)
 #define allwdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_ANALOG_INFO
-#define avdbg(format, ...)   vdbg(format, ##__VA_ARGS__)
-#define allvdbg(format, ...) llvdbg(format, ##__VA_ARGS__)
+#define avdbg(format, ...)   vdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define allvdbg(format, ...) llvdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define avdbg(...)
 #define allvdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_GRAPHICS_ERROR
-#define gdbg(format, ...)    dbg(format, ##__VA_ARGS__)
-#define glldbg(format, ...)  lldbg(format, ##__VA_ARGS__)
+#define gdbg(format, ...)    dbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define glldbg(format, ...)  lldbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define gdbg(...)
 #define glldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_GRAPHICS_WARN
-#define gwdbg(format, ...)    wdbg(format, ##__VA_ARGS__)
-#define gllwdbg(format, ...)  llwdbg(format, ##__VA_ARGS__)
+#define gwdbg(format, ...)    wdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define gllwdbg(format, ...)  llwdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define gwdbg(...)
 #define gllwdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_GRAPHICS_INFO
-#define gvdbg(format, ...)   vdbg(format, ##__VA_ARGS__)
-#define gllvdbg(format, ...) llvdbg(format, ##__VA_ARGS__)
+#define gvdbg(format, ...)   vdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define gllvdbg(format, ...) llvdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define gvdbg(...)
 #define gllvdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_I2C_ERROR
-#define i2cerr(format, ...)    dbg(format, ##__VA_ARGS__)
-#define i2clldbg(format, ...)  lldbg(format, ##__VA_ARGS__)
+#define i2cerr(format, ...)    dbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define i2clldbg(format, ...)  lldbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define i2cerr(...)
 #define i2clldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_I2C_WARN
-#define i2cwarn(format, ...)    wdbg(format, ##__VA_ARGS__)
-#define i2cllwdbg(format, ...)  llwdbg(format, ##__VA_ARGS__)
+#define i2cwarn(format, ...)    wdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define i2cllwdbg(format, ...)  llwdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define i2cwarn(...)
 #define i2cllwdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_I2C_INFO
-#define i2cinfo(format, ...)   vdbg(format, ##__VA_ARGS__)
-#define i2cllvdbg(format, ...) llvdbg(format, ##__VA_ARGS__)
+#define i2cinfo(format, ...)   vdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define i2cllvdbg(format, ...) llvdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define i2cinfo(...)
 #define i2cllvdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_I2S_ERROR
-#define i2serr(format, ...)    dbg(format, ##__VA_ARGS__)
-#define i2slldbg(format, ...)  lldbg(format, ##__VA_ARGS__)
+#define i2serr(format, ...)    dbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define i2slldbg(format, ...)  lldbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define i2serr(...)
 #define i2slldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_I2S_WARN
-#define i2swarn(format, ...)    wdbg(format, ##__VA_ARGS__)
-#define i2sllwdbg(format, ...)  llwdbg(format, ##__VA_ARGS__)
+#define i2swarn(format, ...)    wdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define i2sllwdbg(format, ...)  llwdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define i2swarn(...)
 #define i2sllwdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_I2S_INFO
-#define i2sinfo(format, ...)   vdbg(format, ##__VA_ARGS__)
-#define i2sllvdbg(format, ...) llvdbg(format, ##__VA_ARGS__)
+#define i2sinfo(format, ...)   vdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define i2sllvdbg(format, ...) llvdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define i2sinfo(...)
 #define i2sllvdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_INPUT_ERROR
-#define idbg(format, ...)    dbg(format, ##__VA_ARGS__)
-#define illdbg(format, ...)  lldbg(format, ##__VA_ARGS__)
+#define idbg(format, ...)    dbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define illdbg(format, ...)  lldbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define idbg(...)
 #define illdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_INPUT_WARN
-#define iwdbg(format, ...)    wdbg(format, ##__VA_ARGS__)
-#define illwdbg(format, ...)  llwdbg(format, ##__VA_ARGS__)
+#define iwdbg(format, ...)    wdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define illwdbg(format, ...)  llwdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define iwdbg(...)
 #define illwdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_INPUT_INFO
-#define ivdbg(format, ...)   vdbg(format, ##__VA_ARGS__)
-#define illvdbg(format, ...) llvdbg(format, ##__VA_ARGS__)
+#define ivdbg(format, ...)   vdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define illvdbg(format, ...) llvdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define ivdbg(...)
 #define illvdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_LCD_ERROR
-#define lcddbg(format, ...)    dbg(format, ##__VA_ARGS__)
-#define lcdlldbg(format, ...)  lldbg(format, ##__VA_ARGS__)
+#define lcddbg(format, ...)    dbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define lcdlldbg(format, ...)  lldbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define lcddbg(...)
 #define lcdlldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_LCD_WARN
-#define lcdwdbg(format, ...)    wdbg(format, ##__VA_ARGS__)
-#define lcdllwdbg(format, ...)  llwdbg(format, ##__VA_ARGS__)
+#define lcdwdbg(format, ...)    wdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define lcdllwdbg(format, ...)  llwdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define lcdwdbg(...)
 #define lcdllwdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_LCD_INFO
-#define lcdvdbg(format, ...)   vdbg(format, ##__VA_ARGS__)
-#define lcdllvdbg(format, ...) llvdbg(format, ##__VA_ARGS__)
+#define lcdvdbg(format, ...)   vdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define lcdllvdbg(format, ...) llvdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define lcdvdbg(...)
 #define lcdllvdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_LWNL80211_ERROR
-#define nldbg(format, ...)      dbg(format, ##__VA_ARGS__)
-#define nllldbg(format, ...)    lldbg(format, ##__VA_ARGS__)
+#define nldbg(format, ...)      dbg_idx(LOGM_NET, format, ##__VA_ARGS__)
+#define nllldbg(format, ...)    lldbg_idx(LOGM_NET, format, ##__VA_ARGS__)
 #else
 #define nldbg(...)
 #define nllldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_LWNL80211_INFO
-#define nlvdbg(format, ...)     vdbg(format, ##__VA_ARGS__)
-#define nlllvdbg(format, ...)   llvdbg(format, ##__VA_ARGS__)
+#define nlvdbg(format, ...)     vdbg_idx(LOGM_NET, format, ##__VA_ARGS__)
+#define nlllvdbg(format, ...)   llvdbg_idx(LOGM_NET, format, ##__VA_ARGS__)
 #else
 #define nlvdbg(...)
 #define nlllvdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_LWNL80211_VENDOR_DRV_ERROR
-#define vddbg(format, ...)      dbg(format, ##__VA_ARGS__)
-#define vdlldbg(format, ...)    lldbg(format, ##__VA_ARGS__)
+#define vddbg(format, ...)      dbg_idx(LOGM_NET, format, ##__VA_ARGS__)
+#define vdlldbg(format, ...)    lldbg_idx(LOGM_NET, format, ##__VA_ARGS__)
 #else
 #define vddbg(...)
 #define vdlldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_LWNL80211_VENDER_DRV_INFO
-#define vdvdbg(format, ...)     vdbg(format, ##__VA_ARGS__)
-#define vdllvdbg(format, ...)   llvdbg(format, ##__VA_ARGS__)
+#define vdvdbg(format, ...)     vdbg_idx(LOGM_NET, format, ##__VA_ARGS__)
+#define vdllvdbg(format, ...)   llvdbg_idx(LOGM_NET, format, ##__VA_ARGS__)
 #else
 #define vdvdbg(...)
 #define vdllvdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_SENSORS_ERROR
-#define sndbg(format, ...)    dbg(format, ##__VA_ARGS__)
-#define snlldbg(format, ...)  lldbg(format, ##__VA_ARGS__)
+#define sndbg(format, ...)    dbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define snlldbg(format, ...)  lldbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define sndbg(...)
 #define snlldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_SENSORS_WARN
-#define snwdbg(format, ...)    wdbg(format, ##__VA_ARGS__)
-#define snllwdbg(format, ...)  llwdbg(format, ##__VA_ARGS__)
+#define snwdbg(format, ...)    wdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define snllwdbg(format, ...)  llwdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define snwdbg(...)
 #define snllwdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_SENSORS_INFO
-#define snvdbg(format, ...)   vdbg(format, ##__VA_ARGS__)
-#define snllvdbg(format, ...) llvdbg(format, ##__VA_ARGS__)
+#define snvdbg(format, ...)   vdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define snllvdbg(format, ...) llvdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define snvdbg(...)
 #define snllvdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_SPI_ERROR
-#define spidbg(format, ...)    dbg(format, ##__VA_ARGS__)
-#define spilldbg(format, ...)  lldbg(format, ##__VA_ARGS__)
+#define spidbg(format, ...)    dbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define spilldbg(format, ...)  lldbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define spidbg(...)
 #define spilldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_SPI_WARN
-#define spiwdbg(format, ...)    wdbg(format, ##__VA_ARGS__)
-#define spillwdbg(format, ...)  llwdbg(format, ##__VA_ARGS__)
+#define spiwdbg(format, ...)    wdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define spillwdbg(format, ...)  llwdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define spiwdbg(...)
 #define spillwdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_SPI_INFO
-#define spivdbg(format, ...)   vdbg(format, ##__VA_ARGS__)
-#define spillvdbg(format, ...) llvdbg(format, ##__VA_ARGS__)
+#define spivdbg(format, ...)   vdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define spillvdbg(format, ...) llvdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define spivdbg(...)
 #define spillvdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_TIMER_ERROR
-#define tmrdbg(format, ...)    dbg(format, ##__VA_ARGS__)
-#define tmrlldbg(format, ...)  lldbg(format, ##__VA_ARGS__)
+#define tmrdbg(format, ...)    dbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define tmrlldbg(format, ...)  lldbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define tmrdbg(format, ...)
 #define tmrlldbg(format, ...)
 #endif
 
 #ifdef CONFIG_DEBUG_TIMER_INFO
-#define tmrvdbg(format, ...)    vdbg(format, ##__VA_ARGS__)
-#define tmrllvdbg(format, ...)  llvdbg(format, ##__VA_ARGS__)
+#define tmrvdbg(format, ...)    vdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define tmrllvdbg(format, ...)  llvdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define tmrvdbg(format, ...)
 #define tmrllvdbg(format, ...)
@@ -939,24 +973,24 @@ int get_errno(void);
 #endif
 
 #ifdef CONFIG_DEBUG_USB_ERROR
-#define udbg(format, ...)    dbg(format, ##__VA_ARGS__)
-#define ulldbg(format, ...)  lldbg(format, ##__VA_ARGS__)
+#define udbg(format, ...)    dbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define ulldbg(format, ...)  lldbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define udbg(...)
 #define ulldbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_USB_WARN
-#define uwdbg(format, ...)    wdbg(format, ##__VA_ARGS__)
-#define ullwdbg(format, ...)  llwdbg(format, ##__VA_ARGS__)
+#define uwdbg(format, ...)    wdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define ullwdbg(format, ...)  llwdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define uwdbg(...)
 #define ullwdbg(...)
 #endif
 
 #ifdef CONFIG_DEBUG_USB_INFO
-#define uvdbg(format, ...)   vdbg(format, ##__VA_ARGS__)
-#define ullvdbg(format, ...) llvdbg(format, ##__VA_ARGS__)
+#define uvdbg(format, ...)   vdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
+#define ullvdbg(format, ...) llvdbg_idx(LOGM_DRIVERS, format, ##__VA_ARGS__)
 #else
 #define uvdbg(...)
 #define ullvdbg(...)
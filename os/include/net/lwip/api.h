@@ -198,7 +198,11 @@ enum netconn_evt {
 	NETCONN_EVT_RCVMINUS,
 	NETCONN_EVT_SENDPLUS,
 	NETCONN_EVT_SENDMINUS,
-	NETCONN_EVT_ERROR
+	NETCONN_EVT_ERROR,
+#if LWIP_ZEROCOPY
+	/* new data was acknowledged, sent by a TCP netconn */
+	NETCONN_EVT_ACKED
+#endif
 };
 
 #if LWIP_IGMP || (LWIP_IPV6 && LWIP_IPV6_MLD)
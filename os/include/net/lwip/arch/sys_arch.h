@@ -43,13 +43,11 @@ struct sys_mbox {
 	u8_t is_valid;
 	u8_t id;
 	u32_t queue_size;
-	u32_t wait_send;
-	u32_t wait_fetch;
-	u32_t front;
-	u32_t rear;
+	volatile u32_t front;		/* Index of the oldest message */
+	volatile u32_t count;		/* Number of messages in the ring */
 	void *msgs[SYS_MBOX_MAXSIZE];
-	sys_sem_t mail;
-	sys_sem_t mutex;
+	sys_sem_t mail;				/* Counts the messages, fetchers wait on it */
+	struct sys_mbox_waiter *waiters;	/* Posters of a full mailbox, oldest first */
 };
 
 typedef struct sys_mbox sys_mbox_t;
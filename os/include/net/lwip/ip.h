@@ -86,6 +86,13 @@ extern "C" {
 #define IP_PCB_ADDRHINT
 #endif							/* LWIP_NETIF_HWADDRHINT */
 
+#if PBUF_POOL_RESERVE
+/* Priority of the traffic, see PBUF_POOL_RESERVE_PRIO */
+#define IP_PCB_PRIO ; u8_t so_prio
+#else
+#define IP_PCB_PRIO
+#endif							/* PBUF_POOL_RESERVE */
+
 /** This is the common part of all PCB types. It needs to be at the
    beginning of a PCB type definition. It is located here so that
    changes to this common part are made in one location instead of
@@ -101,7 +108,9 @@ extern "C" {
 		/* Time To Live */     \
 		u8_t ttl               \
 		/* link layer address resolution hint */ \
-		IP_PCB_ADDRHINT
+		IP_PCB_ADDRHINT \
+		/* traffic priority */ \
+		IP_PCB_PRIO
 
 struct ip_pcb {
 	/* Common members of all PCB types */
@@ -233,6 +242,16 @@ extern struct ip_globals ip_data;
 /** Resets an IP pcb option (SOF_* flags) */
 #define ip_reset_option(pcb, opt) ((pcb)->so_options &= ~(opt))
 
+#if PBUF_POOL_RESERVE
+/** Gets the priority of an IP pcb (0..7) */
+#define ip_get_prio(pcb)          ((pcb)->so_prio)
+/** Sets the priority of an IP pcb (0..7) */
+#define ip_set_prio(pcb, p)       ((pcb)->so_prio = (u8_t)(p))
+#else
+#define ip_get_prio(pcb)          0
+#define ip_set_prio(pcb, p)
+#endif							/* PBUF_POOL_RESERVE */
+
 #if LWIP_IPV4 && LWIP_IPV6
 /**
  * @ingroup ip
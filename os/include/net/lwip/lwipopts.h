@@ -279,6 +279,20 @@
 
 /* ---------- IP options ---------- */
 
+/* ---------- Checksum options ---------- */
+
+/* 32-bit word checksum, see inet_chksum.c */
+#define LWIP_CHKSUM_ALGORITHM           4
+
+#ifdef CONFIG_NET_LWIP_CHECKSUM_ON_COPY
+#define LWIP_CHECKSUM_ON_COPY           1
+#define LWIP_CHKSUM_COPY_ALGORITHM      2
+#else
+#define LWIP_CHECKSUM_ON_COPY           0
+#endif
+
+/* ---------- Checksum options ---------- */
+
 /* ---------- IPv6 options ---------- */
 #ifdef CONFIG_NET_IPv6
 #define LWIP_IPV6			CONFIG_NET_IPv6
@@ -432,6 +446,14 @@
 #define TCP_TIMESTAMPS	CONFIG_NET_TCP_TIMESTAMPS
 #endif
 
+#ifdef CONFIG_NET_TCP_SACK
+#define LWIP_TCP_SACK	1
+#endif
+
+#ifdef CONFIG_NET_TCP_PCB_STATS
+#define LWIP_TCP_PCB_STATS	1
+#endif
+
 #ifdef CONFIG_NET_TCP_KEEPALIVE
 #define LWIP_TCP_KEEPALIVE              CONFIG_NET_TCP_KEEPALIVE
 #endif
@@ -617,6 +639,18 @@
 #define PBUF_POOL_SIZE	CONFIG_NET_PBUF_POOL_SIZE
 #endif
 
+#ifdef CONFIG_NET_PBUF_POOL_RESERVE
+#define PBUF_POOL_RESERVE	CONFIG_NET_PBUF_POOL_RESERVE
+#endif
+
+#ifdef CONFIG_NET_PBUF_POOL_RESERVE_PRIO
+#define PBUF_POOL_RESERVE_PRIO	CONFIG_NET_PBUF_POOL_RESERVE_PRIO
+#endif
+
+#ifdef CONFIG_NET_TCP_OOSEQ_PRIO_MAX_PBUFS
+#define TCP_OOSEQ_PRIO_MAX_PBUFS	CONFIG_NET_TCP_OOSEQ_PRIO_MAX_PBUFS
+#endif
+
 /*---------- Interanl Memory Pool Sizes ----*/
 
 /* ---------- Raw Socket options ---------- */
@@ -644,6 +678,20 @@
 #define LWIP_SOCKET	CONFIG_NET_SOCKET
 #endif
 
+#ifdef CONFIG_NET_EPOLL
+#define LWIP_EPOLL                      1
+#else
+#define LWIP_EPOLL                      0
+#endif
+
+#ifdef CONFIG_NET_ZEROCOPY
+#define LWIP_ZEROCOPY                   1
+/* UDP data sent by reference completes when its pbuf is freed */
+#define LWIP_SUPPORT_CUSTOM_PBUF        1
+#else
+#define LWIP_ZEROCOPY                   0
+#endif
+
 #ifdef CONFIG_NET_SOCKET_OPTION_BROADCAST
 #define IP_SOF_BROADCAST                CONFIG_NET_SOCKET_OPTION_BROADCAST
 #endif
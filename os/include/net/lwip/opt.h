@@ -487,6 +487,29 @@
 #define PBUF_POOL_SIZE                  16
 #endif
 
+/**
+ * PBUF_POOL_RESERVE: the number of pbufs of the pbuf pool kept for
+ * connections of priority PBUF_POOL_RESERVE_PRIO or higher. The driver
+ * takes the pbufs before the packet is classified, so the reserve is kept
+ * by dropping the data of lower priority connections as soon as it would
+ * leave less than PBUF_POOL_RESERVE pbufs free. The priority of a pcb is
+ * set with ip_set_prio() or SO_PRIORITY. 0 disables the reserve.
+ * Not available with MEMP_MEM_MALLOC, where the pool has no fixed size.
+ */
+#ifndef PBUF_POOL_RESERVE
+#define PBUF_POOL_RESERVE               0
+#endif
+
+/**
+ * PBUF_POOL_RESERVE_PRIO: the lowest priority which may use the pbufs of
+ * PBUF_POOL_RESERVE. Priorities go from 0, the default of a new pcb, to
+ * 7, like SO_PRIORITY on other systems. The DNS and DHCP clients use this
+ * priority.
+ */
+#ifndef PBUF_POOL_RESERVE_PRIO
+#define PBUF_POOL_RESERVE_PRIO          6
+#endif
+
 /** MEMP_NUM_API_MSG: the number of concurrently active calls to various
  * socket, netconn, and tcpip functions
  */
@@ -1233,6 +1256,16 @@
 #define TCP_OOSEQ_MAX_PBUFS             0
 #endif
 
+/**
+ * TCP_OOSEQ_PRIO_MAX_PBUFS: The maximum number of pbufs queued on ooseq by a
+ * pcb below PBUF_POOL_RESERVE_PRIO, so that one of several low priority
+ * connections can not keep all of the pool which is not reserved.
+ * Only valid for TCP_QUEUE_OOSEQ==1 and PBUF_POOL_RESERVE > 0.
+ */
+#ifndef TCP_OOSEQ_PRIO_MAX_PBUFS
+#define TCP_OOSEQ_PRIO_MAX_PBUFS        ((PBUF_POOL_SIZE - PBUF_POOL_RESERVE) / 2)
+#endif
+
 /**
  * TCP_LISTEN_BACKLOG: Enable the backlog option for tcp listen pcb.
  */
@@ -1277,6 +1310,32 @@
 #define LWIP_TCP_TIMESTAMPS             0
 #endif
 
+/**
+ * LWIP_TCP_SACK==1: support selective acknowledgements (RFC 2018).
+ * SACK-permitted is offered in every SYN. When both ends agree, ACKs carry
+ * SACK blocks for the data on the ooseq queue (needs TCP_QUEUE_OOSEQ), and
+ * segments SACKed by the remote host are skipped during fast recovery.
+ */
+#ifndef LWIP_TCP_SACK
+#define LWIP_TCP_SACK                   0
+#endif
+
+/**
+ * LWIP_TCP_PCB_STATS==1: count the bytes received and acknowledged, the
+ * retransmissions and the duplicate ACKs of each tcp_pcb (pcb->stats).
+ */
+#ifndef LWIP_TCP_PCB_STATS
+#define LWIP_TCP_PCB_STATS              0
+#endif
+
+/**
+ * LWIP_TCP_MAX_SACK_NUM: The maximum number of SACK blocks sent in one ACK.
+ * At most 4 fit into the option space (3 together with timestamps).
+ */
+#ifndef LWIP_TCP_MAX_SACK_NUM
+#define LWIP_TCP_MAX_SACK_NUM           4
+#endif
+
 /**
  * TCP_WND_UPDATE_THRESHOLD: difference in window to trigger an
  * explicit window update
@@ -227,6 +227,21 @@ void pbuf_free_ooseq(void);
 #define PBUF_CHECK_FREE_OOSEQ()
 #endif							/* LWIP_TCP && TCP_QUEUE_OOSEQ && NO_SYS && PBUF_POOL_FREE_OOSEQ */
 
+#if PBUF_POOL_RESERVE
+/** Use of the pbuf pool and of PBUF_POOL_RESERVE */
+struct pbuf_pool_reserve_stats {
+	/** pool pbufs free now */
+	u16_t avail;
+	/** lowest number of pool pbufs free so far */
+	u16_t min_avail;
+	/** packets of low priority pcbs dropped to keep the reserve */
+	u32_t refused;
+};
+
+u8_t pbuf_pool_admit(const struct pbuf *p, u8_t prio);
+void pbuf_pool_reserve_stats(struct pbuf_pool_reserve_stats *stats);
+#endif							/* PBUF_POOL_RESERVE */
+
 /* Initializes the pbuf module. This call is empty for now, but may not be in future. */
 #define pbuf_init()
 
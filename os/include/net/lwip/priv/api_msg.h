@@ -204,6 +204,7 @@ void lwip_netconn_do_connect(void *m);
 void lwip_netconn_do_disconnect(void *m);
 void lwip_netconn_do_listen(void *m);
 void lwip_netconn_do_send(void *m);
+err_t lwip_netconn_send_netbuf(struct netconn *conn, struct netbuf *b);
 void lwip_netconn_do_recv(void *m);
 #if TCP_LISTEN_BACKLOG
 void lwip_netconn_do_accepted(void *m);
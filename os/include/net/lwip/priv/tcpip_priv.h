@@ -123,7 +123,9 @@ struct tcpip_api_call_data {
 };
 
 typedef err_t (*tcpip_api_call_fn)(struct tcpip_api_call_data * call);
-err_t tcpip_api_call(tcpip_api_call_fn fn, struct tcpip_api_call_data *call);
+err_t tcpip_api_call_with_block(tcpip_api_call_fn fn, struct tcpip_api_call_data *call, u8_t block);
+/** @see tcpip_api_call_with_block */
+#define tcpip_api_call(fn, call)  tcpip_api_call_with_block(fn, call, 1)
 
 enum tcpip_msg_type {
 	TCPIP_MSG_API,
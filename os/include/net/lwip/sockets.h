@@ -167,6 +167,8 @@ struct lwip_setgetsockopt_data {
 #endif /* IOV_MAX */
 
 struct msghdr;
+struct mmsghdr;
+struct timespec;
 
 /* struct msghdr->msg_flags bit field values */
 #define MSG_TRUNC   0x04
@@ -245,6 +247,7 @@ struct cmsghdr {
 #define SO_TYPE        0x1008	/* get socket type */
 #define SO_CONTIMEO    0x1009	/* Unimplemented: connect timeout */
 #define SO_NO_CHECK    0x100a	/* don't create UDP checksum */
+#define SO_PRIORITY    0x100b	/* traffic priority 0..7, see PBUF_POOL_RESERVE_PRIO */
 
 /*
  * Structure used for manipulating linger option.
@@ -287,6 +290,7 @@ struct linger {
 #define MSG_OOB        0x04		/* Unimplemented: Requests out-of-band data. The significance and semantics of out-of-band data are protocol-specific */
 #define MSG_DONTWAIT   0x08		/* Nonblocking i/o for this operation only */
 #define MSG_MORE       0x10		/* Sender will send more */
+#define MSG_WAITFORONE 0x20		/* recvmmsg(): only wait for the first message */
 
 /*
  * Options for level IPPROTO_IP
@@ -492,6 +496,8 @@ int lwip_read(int s, void *mem, size_t len);
 int lwip_recvfrom(int s, void *mem, size_t len, int flags, struct sockaddr *from, socklen_t * fromlen);
 int lwip_send(int s, const void *dataptr, size_t size, int flags);
 int lwip_sendmsg(int s, const struct msghdr *message, int flags);
+int lwip_sendmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags);
+int lwip_recvmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags, struct timespec *timeout);
 int lwip_sendto(int s, const void *dataptr, size_t size, int flags, const struct sockaddr *to, socklen_t tolen);
 int lwip_socket(int domain, int type, int protocol);
 int lwip_write(int s, const void *dataptr, size_t size);
@@ -501,6 +507,23 @@ int lwip_ioctl(int s, long cmd, void *argp);
 int lwip_fcntl(int s, int cmd, int val);
 
 int lwip_poll(int fd, struct pollfd *fds, bool setup);
+
+#if LWIP_EPOLL
+struct epoll_event;
+int lwip_epoll_create(int flags);
+int lwip_epoll_ctl(int epfd, int op, int fd, struct epoll_event *event);
+int lwip_epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout);
+#endif
+
+#if LWIP_ZEROCOPY
+struct pbuf;
+/** Called once the stack does not refer to the data given to lwip_send_ref(),
+ * err is 0 or the errno of a connection which was aborted */
+typedef void (*lwip_send_ref_done_fn)(void *arg, int err);
+int lwip_recv_pbuf(int s, struct pbuf **p, int flags);
+void lwip_pbuf_release(struct pbuf *p);
+int lwip_send_ref(int s, const void *data, size_t size, int flags, lwip_send_ref_done_fn done, void *arg);
+#endif
 #ifdef __cplusplus
 }
 #endif
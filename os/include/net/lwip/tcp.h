@@ -154,7 +154,7 @@ typedef u32_t tcpwnd_size_t;
 typedef u16_t tcpwnd_size_t;
 #endif
 
-#if LWIP_WND_SCALE || TCP_LISTEN_BACKLOG || LWIP_TCP_TIMESTAMPS
+#if LWIP_WND_SCALE || TCP_LISTEN_BACKLOG || LWIP_TCP_TIMESTAMPS || LWIP_TCP_SACK
 typedef u16_t tcpflags_t;
 #else
 typedef u8_t tcpflags_t;
@@ -203,6 +203,18 @@ struct tcp_pcb_listen {
 #endif							/* TCP_LISTEN_BACKLOG */
 };
 
+#if LWIP_TCP_PCB_STATS
+/** Counters of one connection, they wrap around */
+struct tcp_pcb_stats {
+	u32_t bytes_in;			/* data bytes received in order */
+	u32_t bytes_out;		/* sequence numbers acknowledged by the remote host */
+	u32_t rto;				/* retransmission timeouts */
+	u32_t rexmit;			/* segments retransmitted on duplicate ACKs or SACK */
+	u32_t dupacks;			/* duplicate ACKs received */
+	u32_t drops;			/* segments or ooseq tails dropped to bound memory */
+};
+#endif							/* LWIP_TCP_PCB_STATS */
+
 /** the TCP protocol control block */
 struct tcp_pcb {
 	/** common PCB members */
@@ -230,6 +242,9 @@ struct tcp_pcb {
 #endif
 #if LWIP_TCP_TIMESTAMPS
 #define TF_TIMESTAMP   0x0400U	/* Timestamp option enabled */
+#endif
+#if LWIP_TCP_SACK
+#define TF_SACK        0x0800U	/* SACK option enabled */
 #endif
 
 	/* the rest of the fields are in host byte order
@@ -262,6 +277,10 @@ struct tcp_pcb {
 	/* fast retransmit/recovery */
 	u8_t dupacks;
 	u32_t lastack;			/* Highest acknowledged seqno. */
+#if LWIP_TCP_SACK
+	u32_t sack_recover;		/* snd_nxt when fast recovery was entered */
+	u32_t rcv_sack_seq;		/* seqno of the last segment put on ooseq */
+#endif							/* LWIP_TCP_SACK */
 
 	/* congestion avoidance/control variables */
 	tcpwnd_size_t cwnd;
@@ -334,6 +353,10 @@ struct tcp_pcb {
 	u8_t snd_scale;
 	u8_t rcv_scale;
 #endif
+
+#if LWIP_TCP_PCB_STATS
+	struct tcp_pcb_stats stats;
+#endif							/* LWIP_TCP_PCB_STATS */
 };
 
 #if LWIP_EVENT_API
@@ -204,6 +204,15 @@
 #define _PTHREAD_MFLAGS_INCONSISTENT  (1 << 1)	/* Mutex is in an inconsistent state */
 #define _PTHREAD_MFLAGS_NRECOVERABLE  (1 << 2)	/* Inconsistent mutex has been unlocked */
 
+/*
+ * Values for struct pthread_mutex_s lockword (CONFIG_PTHREAD_MUTEX_FASTPATH).
+ * Zero means unlocked, otherwise the word holds the pid of the owner plus
+ * these bits.  These are non-standard and intended only for internal use
+ * within the OS.
+ */
+#define _PTHREAD_MFAST_WAITERS        (1 << 30)	/* Semaphore is in use, unlock through the slow path */
+#define _PTHREAD_MFAST_DISABLED       (1 << 29)	/* Fast path is not allowed for this mutex */
+
 /*
  * Maximum values of pthread key operation
  */
@@ -268,18 +277,32 @@ typedef pthread_startroutine_t pthread_func_t;
 #endif
 #endif
 
+/* Only the non-robust NORMAL mutex can be locked in the fast path */
+
+#if !defined(CONFIG_PTHREAD_MUTEX_FASTPATH)
+#define __PTHREAD_MUTEX_LOCKWORD_INIT
+#elif !defined(CONFIG_PTHREAD_MUTEX_UNSAFE) && !defined(CONFIG_PTHREAD_MUTEX_DEFAULT_UNSAFE)
+#define __PTHREAD_MUTEX_LOCKWORD_INIT , _PTHREAD_MFAST_DISABLED
+#else
+#define __PTHREAD_MUTEX_LOCKWORD_INIT , 0
+#endif
+
 #if defined(CONFIG_PTHREAD_MUTEX_TYPES) && !defined(CONFIG_PTHREAD_MUTEX_UNSAFE)
 #define PTHREAD_MUTEX_INITIALIZER {NULL, SEM_INITIALIZER(1), -1, \
 				   __PTHREAD_MUTEX_DEFAULT_FLAGS, \
-				   PTHREAD_MUTEX_DEFAULT, 0}
+				   PTHREAD_MUTEX_DEFAULT, 0 \
+				   __PTHREAD_MUTEX_LOCKWORD_INIT}
 #elif defined(CONFIG_PTHREAD_MUTEX_TYPES)
 #define PTHREAD_MUTEX_INITIALIZER {SEM_INITIALIZER(1), -1, \
-				   PTHREAD_MUTEX_DEFAULT, 0}
+				   PTHREAD_MUTEX_DEFAULT, 0 \
+				   __PTHREAD_MUTEX_LOCKWORD_INIT}
 #elif !defined(CONFIG_PTHREAD_MUTEX_UNSAFE)
 #define PTHREAD_MUTEX_INITIALIZER {NULL, SEM_INITIALIZER(1), -1,\
-				   __PTHREAD_MUTEX_DEFAULT_FLAGS}
+				   __PTHREAD_MUTEX_DEFAULT_FLAGS \
+				   __PTHREAD_MUTEX_LOCKWORD_INIT}
 #else
-#define PTHREAD_MUTEX_INITIALIZER {SEM_INITIALIZER(1), -1}
+#define PTHREAD_MUTEX_INITIALIZER {SEM_INITIALIZER(1), -1 \
+				   __PTHREAD_MUTEX_LOCKWORD_INIT}
 #endif
 
 #ifdef CONFIG_PTHREAD_CLEANUP
@@ -0,0 +1,145 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**
+ * @defgroup EPOLL_KERNEL EPOLL
+ * @brief Provides APIs for epoll
+ * @ingroup KERNEL
+ *
+ * @{
+ */
+
+/// @file sys/epoll.h
+/// @brief I/O event notification APIs for sockets
+
+#ifndef __INCLUDE_SYS_EPOLL_H
+#define __INCLUDE_SYS_EPOLL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <poll.h>
+
+#ifdef CONFIG_NET_EPOLL
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+/* Events.  The readiness bits have the same values as the poll() ones */
+
+#define EPOLLIN         POLLIN
+#define EPOLLOUT        POLLOUT
+#define EPOLLERR        POLLERR		/* Always reported, need not be requested */
+#define EPOLLHUP        POLLHUP		/* Not set by sockets, EOF is reported as EPOLLIN */
+#define EPOLLONESHOT    (1u << 30)	/* Disable the socket after one event */
+#define EPOLLET         (1u << 31)	/* Edge triggered */
+
+/* Operations of epoll_ctl() */
+
+#define EPOLL_CTL_ADD   1
+#define EPOLL_CTL_DEL   2
+#define EPOLL_CTL_MOD   3
+
+/* Flags of epoll_create1() */
+
+#define EPOLL_CLOEXEC   0x01		/* Accepted for compatibility, no effect */
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+typedef union epoll_data {
+	FAR void *ptr;
+	int fd;
+	uint32_t u32;
+} epoll_data_t;
+
+struct epoll_event {
+	uint32_t events;			/* Requested events, returned events */
+	epoll_data_t data;			/* Given back as is with the events */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/**
+ * @ingroup EPOLL_KERNEL
+ * @brief open an epoll descriptor
+ * @details @b #include <sys/epoll.h> \n
+ * SYSTEM CALL API \n
+ * The descriptor is released with close(). Only sockets can be watched.
+ * @param[in] flags 0 or EPOLL_CLOEXEC
+ * @return On success, the epoll descriptor is returned. On failure, -1 is returned and errno is set.
+ * @since TizenRT v3.0
+ */
+EXTERN int epoll_create1(int flags);
+
+/**
+ * @ingroup EPOLL_KERNEL
+ * @brief add, modify or remove a socket in the interest list of an epoll descriptor
+ * @details @b #include <sys/epoll.h> \n
+ * SYSTEM CALL API \n
+ * A socket is removed from all interest lists when it is closed.
+ * @param[in] epfd epoll descriptor
+ * @param[in] op EPOLL_CTL_ADD, EPOLL_CTL_MOD or EPOLL_CTL_DEL
+ * @param[in] fd socket descriptor
+ * @param[in] event events to watch and the user data, ignored for EPOLL_CTL_DEL
+ * @return On success, 0 is returned. On failure, -1 is returned and errno is set.
+ * @since TizenRT v3.0
+ */
+EXTERN int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *event);
+
+/**
+ * @ingroup EPOLL_KERNEL
+ * @brief wait for events on an epoll descriptor
+ * @details @b #include <sys/epoll.h> \n
+ * SYSTEM CALL API \n
+ * Only the sockets in the ready list are examined, so the cost does not
+ * depend on how many sockets are watched.
+ * @param[in] epfd epoll descriptor
+ * @param[out] events returned events
+ * @param[in] maxevents size of events, greater than zero
+ * @param[in] timeout milliseconds to wait, -1 waits forever and 0 does not block
+ * @return The number of ready sockets, 0 on timeout. On failure, -1 is returned and errno is set.
+ * @since TizenRT v3.0
+ */
+EXTERN int epoll_wait(int epfd, FAR struct epoll_event *events, int maxevents, int timeout);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif							/* CONFIG_NET_EPOLL */
+
+#endif							/* __INCLUDE_SYS_EPOLL_H */
+/**
+ * @} */
@@ -100,6 +100,11 @@ struct msghdr {
 	int msg_flags;                 /* flags on received message */
 };
 
+struct mmsghdr {
+	struct msghdr msg_hdr;         /* message header */
+	unsigned int msg_len;          /* bytes sent or received for the header */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -321,6 +326,41 @@ int getpeername(int s, struct sockaddr *name, socklen_t *namelen);
 ssize_t recvmsg(int sockfd, struct msghdr *msg, int flags);
 ssize_t sendmsg(int sockfd, struct msghdr *msg, int flags);
 
+/**
+* @brief  send multiple messages on a socket
+*
+* @details @b #include <sys/socket.h>\n
+* Linux API\n
+* The datagrams of a UDP or raw socket are handed to the stack in batches,
+* one tcpip thread transaction for each batch instead of each datagram.
+* @param[in] sockfd the file descriptor associated with the socket.
+* @param[inout] msgvec the messages to send, msg_len is set to the bytes sent for each one
+* @param[in] vlen the number of messages in msgvec
+* @param[in] flags the same as for sendmsg()
+* @return On success, the number of messages sent, which is less than vlen if a message could not be sent. On failure, -1 is returned.
+* @since TizenRT v2.1
+*/
+int sendmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen, int flags);
+
+/**
+* @brief  receive multiple messages from a UDP or raw socket
+*
+* @details @b #include <sys/socket.h>\n
+* Linux API\n
+* With MSG_WAITFORONE only the first message is waited for, the following
+* ones are taken as far as they have already arrived. The timeout is
+* checked after each message, so as on Linux it does not bound a blocking
+* receive.
+* @param[in] sockfd the file descriptor associated with the socket.
+* @param[inout] msgvec the messages to receive, msg_len is set to the bytes received for each one
+* @param[in] vlen the number of messages in msgvec
+* @param[in] flags the same as for recvmsg(), and MSG_WAITFORONE
+* @param[in] timeout null, or the time after which no more messages are waited for
+* @return On success, the number of messages received. On failure, -1 is returned.
+* @since TizenRT v2.1
+*/
+int recvmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen, int flags, struct timespec *timeout);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
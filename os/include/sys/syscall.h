@@ -461,7 +461,16 @@
 #define SYS_setsockopt                 (__SYS_network + 12)
 #define SYS_shutdown                   (__SYS_network + 13)
 #define SYS_socket                     (__SYS_network + 14)
-#define SYS_nnetsocket                 (__SYS_network + 15)
+#define SYS_recvmmsg                   (__SYS_network + 15)
+#define SYS_sendmmsg                   (__SYS_network + 16)
+#ifdef CONFIG_NET_EPOLL
+#define SYS_epoll_create1              (__SYS_network + 17)
+#define SYS_epoll_ctl                  (__SYS_network + 18)
+#define SYS_epoll_wait                 (__SYS_network + 19)
+#define SYS_nnetsocket                 (__SYS_network + 20)
+#else
+#define SYS_nnetsocket                 (__SYS_network + 17)
+#endif
 #else
 #define SYS_nnetsocket                 __SYS_network
 #endif
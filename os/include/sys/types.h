@@ -394,6 +394,9 @@ struct pthread_mutex_s {
 	uint8_t type;                   /* Type of the mutex.  See PTHREAD_MUTEX_* definitions */
 	int nlocks;                     /* The number of recursive locks held */
 #endif
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+	int lockword;                   /* Owner pid, changed atomically.  See _PTHREAD_MFAST_* */
+#endif
 };
 typedef struct pthread_mutex_s pthread_mutex_t;
 
@@ -1675,6 +1675,24 @@ char up_romgetc(FAR const char *ptr);
 void up_mdelay(unsigned int milliseconds);
 void up_udelay(useconds_t microseconds);
 
+/****************************************************************************
+ * Name: up_perf_init, up_perf_gettime and up_perf_getfreq
+ *
+ * Description:
+ *   Platform-specific logic provides a free-running 32-bit counter which is
+ *   used for precise time accounting in the scheduler.  up_perf_init()
+ *   enables the counter, up_perf_gettime() returns its current value and
+ *   up_perf_getfreq() returns its frequency in Hz.  The counter wraps
+ *   around, so only the difference of two values is meaningful.
+ *
+ ***************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+void up_perf_init(void);
+uint32_t up_perf_gettime(void);
+uint32_t up_perf_getfreq(void);
+#endif
+
 /****************************************************************************
  * Name: up_cxxinitialize
  *
@@ -22,20 +22,57 @@
 /****************************************************************************
  * Included Files
  ****************************************************************************/
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
 #include <tinyara/binfmt/compression/compression.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_COMPRESSED_BINARY
+
+#ifndef CONFIG_COMPRESSION_CACHE_BLOCKS
+#define CONFIG_COMPRESSION_CACHE_BLOCKS 4
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
-/* Struct for buffers to be used for read/decompression */
-struct s_buffer {
-	unsigned char *read_buffer;
-	unsigned char *out_buffer;
+/* Statistics of one compressed file, from compress_init to compress_uninit */
+struct compress_stats_s {
+	uint32_t blocks;			/* Blocks decompressed */
+	uint32_t hits;				/* Blocks found in the cache */
+	uint32_t bytes_in;			/* Compressed bytes read from the file */
+	uint32_t bytes_out;			/* Bytes decompressed */
+	uint32_t time_us;			/* Time spent in compress_read */
+};
+
+/* One decompressed block kept in the cache */
+struct compress_block_s {
+	int index;					/* Block number, -1 if the entry is empty */
+	unsigned int size;			/* Decompressed size of the block */
+	uint32_t last_used;			/* Stamp of the last access for LRU */
+	FAR unsigned char *data;
+};
+
+/* Decompressor context of one open compressed file.  Every loader has its
+ * own context, so binaries can be loaded concurrently.
+ */
+struct compress_s {
+	int filfd;					/* Descriptor of the compressed file */
+	uint16_t binary_header_size;	/* Offset of the compression header in the file */
+	struct s_header header;		/* Compression header */
+	FAR int *secoff;			/* Offsets of the compressed blocks */
+	FAR unsigned char *read_buffer;	/* Compressed data of one block */
+	unsigned int max_block;		/* Size of read_buffer */
+	uint32_t stamp;				/* Counter for last_used */
+	struct compress_block_s cache[CONFIG_COMPRESSION_CACHE_BLOCKS];
+	struct compress_stats_s stats;
 };
 
 /****************************************************************************
@@ -46,24 +83,25 @@ struct s_buffer {
  * Name: compress_uninit
  *
  * Description:
- *   Release buffers initialized during compress_init
+ *   Release the context allocated by compress_init
  *
  * Returned Value:
  *   None
  ****************************************************************************/
-void compress_uninit(void);
+void compress_uninit(FAR struct compress_s *compress);
 
 /****************************************************************************
  * Name: compress_init
  *
  * Description:
- *   Initialize the header 's_header' for this binary
+ *   Read the compression header of this binary and allocate its
+ *   decompressor context.  The context is returned in 'compress'.
  *
  * Returned value:
  *   OK (0) on Success
- *   ERROR (-1) on Failure
+ *   Negative value on Failure
  ****************************************************************************/
-int compress_init(int filfd, uint16_t offset, off_t *filelen);
+int compress_init(int filfd, uint16_t offset, off_t *filelen, FAR struct compress_s **compress);
 
 /****************************************************************************
  * Name: compress_read
@@ -78,6 +116,8 @@ int compress_init(int filfd, uint16_t offset, off_t *filelen);
  *   Number of bytes read into buffer on Success
  *   Negative value on failure
  ****************************************************************************/
-int compress_read(int filfd, uint16_t binary_header_size, FAR uint8_t *buffer, size_t readsize, off_t offset);
+int compress_read(FAR struct compress_s *compress, FAR uint8_t *buffer, size_t readsize, off_t offset);
+
+#endif							/* CONFIG_COMPRESSED_BINARY */
 
 #endif							/* __INCLUDE_COMPRESS_READ_H */
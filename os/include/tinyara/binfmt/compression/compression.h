@@ -34,7 +34,8 @@
 enum compression_formats {
 	COMPRESSION_TYPE_NONE = 0,
 	COMPRESSION_TYPE_LZMA,
-	COMPRESSION_TYPE_MAX = COMPRESSION_TYPE_LZMA,
+	COMPRESSION_TYPE_LZ4,
+	COMPRESSION_TYPE_MAX = COMPRESSION_TYPE_LZ4,
 };
 
 /* Compression header struct */
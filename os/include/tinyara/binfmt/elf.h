@@ -107,6 +107,8 @@
  * Public Types
  ****************************************************************************/
 
+struct compress_s;				/* Decompressor context, see compress_read.h */
+
 /* This struct provides a description of the currently loaded instantiation
  * of an ELF binary.
  */
@@ -167,6 +169,7 @@ struct elf_loadinfo_s {
 	int filfd;					/* Descriptor for the file being loaded */
 	uint16_t offset;             /* elf offset when binary header is included */
 	uint8_t compression_type;		/* Binary Compression type */
+	FAR struct compress_s *compress;	/* Decompressor of a compressed binary */
 };
 
 /****************************************************************************
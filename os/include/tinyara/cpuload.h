@@ -24,11 +24,30 @@
  ****************************************************************************/
 #include <tinyara/config.h>
 
+#include <sys/types.h>
+#include <tinyara/clock.h>
+#include <tinyara/sched.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 #define CPULOAD_DRVPATH     "/dev/cpuload"
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+/* Argument of CPULOADIOC_GETTASKINFO. The caller fills in pid and the driver
+ * returns the cpu load of every interval and, if enabled, the wakeup latency
+ * histogram of that task.
+ */
+struct cpuload_taskinfo_s {
+	pid_t pid;
+	struct cpuload_s load[SCHED_NCPULOAD];
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+	struct sched_latency_s latency;
+#endif
+};
+
 void cpuload_initialize(void);
 
 #ifdef __cplusplus
@@ -101,6 +101,7 @@
 #define _IOTBUSBASE     (0x2600)	/* iotbus ioctl commands */
 #define _FBIOCBASE      (0x2700)	/* Frame buffer character driver ioctl commands */
 #define _CPULOADBASE    (0x2800)	/* cpuload ioctl commands */
+#define _LOGMIOCBASE    (0x2900)	/* logm ioctl commands */
 #define _TESTIOCBASE    (0xfe00)	/* KERNEL TEST DRV module ioctl commands */
 
 
@@ -344,6 +345,24 @@
 											 *       (default)
 											 *     1=fre when empty
 											 * OUT: None */
+#define PIPEIOC_SETSIZE    _PIPEIOC(0x0002)	/* Set buffer size
+											 * IN: unsigned long integer
+											 *     size in bytes, rounded up
+											 *     to a power of two.  The
+											 *     pipe must be empty.
+											 * OUT: None */
+#define PIPEIOC_RDWMARK    _PIPEIOC(0x0003)	/* Set read watermark
+											 * IN: unsigned long integer
+											 *     readers and POLLIN wait
+											 *     until this many bytes are
+											 *     buffered (default 1)
+											 * OUT: None */
+#define PIPEIOC_WRWMARK    _PIPEIOC(0x0004)	/* Set write watermark
+											 * IN: unsigned long integer
+											 *     writers and POLLOUT wait
+											 *     until this many bytes are
+											 *     free (default 1)
+											 * OUT: None */
 /* RTC driver ioctl definitions *********************************************/
 /* (see include/tinyara/rtc.h */
 
@@ -423,6 +442,16 @@
 #define CPULOADIOC_START              _CPULOADIOC(0x0001)
 #define CPULOADIOC_STOP               _CPULOADIOC(0x0002)
 #define CPULOADIOC_GETVALUE           _CPULOADIOC(0x0003)
+#define CPULOADIOC_GETTASKINFO        _CPULOADIOC(0x0004)
+
+/* Logm driver ioctl definitions ************************/
+/* (see tinyara/logm.h) */
+
+#define _LOGMIOCVALID(c)   (_IOC_TYPE(c) == _LOGMIOCBASE)
+#define _LOGMIOC(nr)       _IOC(_LOGMIOCBASE, nr)
+
+#define LOGMIOC_SETMASK               _LOGMIOC(0x0001)
+#define LOGMIOC_GETMASK               _LOGMIOC(0x0002)
 
 /* Audio driver ioctl definitions *************************************/
 /* (see tinyara/audio/audio.h) */
@@ -0,0 +1,232 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**
+ * @defgroup LFRING_KERNEL LFRING
+ * @ingroup KERNEL
+ *
+ * @{
+ */
+
+///@file tinyara/lfring.h
+///@brief Lock-free ring buffer APIs
+
+#ifndef __INCLUDE_TINYARA_LFRING_H
+#define __INCLUDE_TINYARA_LFRING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The indices are free-running 32-bit counters.  The producer only writes
+ * head and the consumer only writes tail, so the ring needs no lock when
+ * there is one producer and one consumer.  The acquire/release accesses
+ * order the data copy against the index update.
+ */
+
+#define LFRING_LOAD(p)          __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define LFRING_STORE(p, v)      __atomic_store_n(p, v, __ATOMIC_RELEASE)
+
+/* Each slot of the multi-producer ring holds a sequence number followed by
+ * the record, rounded up to a word.
+ */
+
+#define LFRING_MPSC_SLOTSIZE(recsize)        (sizeof(uint32_t) + (((recsize) + 3) & ~3))
+#define LFRING_MPSC_BUFSIZE(nrecs, recsize)  ((nrecs) * LFRING_MPSC_SLOTSIZE(recsize))
+
+/****************************************************************************
+ * Public Type Declarations
+ ****************************************************************************/
+
+/* Single-producer / single-consumer ring, used as a byte stream or as a
+ * queue of fixed size records.
+ */
+
+struct lfring_s {
+	FAR uint8_t *buffer;		/* Ring storage */
+	uint32_t size;				/* Size of the storage, a power of two */
+	uint32_t mask;				/* size - 1 */
+	uint32_t head;				/* Free-running index, written by the producer */
+	uint32_t tail;				/* Free-running index, written by the consumer */
+	uint16_t recsize;			/* Size of one record, 0 for a byte stream */
+};
+
+/* Multi-producer / single-consumer queue of fixed size records */
+
+struct lfring_mpsc_s {
+	FAR uint8_t *buffer;		/* nrecs slots of LFRING_MPSC_SLOTSIZE(recsize) */
+	uint32_t mask;				/* nrecs - 1 */
+	uint16_t recsize;			/* Size of one record */
+	uint16_t slotsize;			/* Size of one slot */
+	uint32_t head;				/* Next slot to claim, shared by the producers */
+	uint32_t tail;				/* Next slot to read, written by the consumer */
+};
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/* The number of bytes which can be read */
+
+static inline size_t lfring_used(FAR struct lfring_s *ring)
+{
+	return LFRING_LOAD(&ring->head) - LFRING_LOAD(&ring->tail);
+}
+
+/* The number of bytes which can be written */
+
+static inline size_t lfring_space(FAR struct lfring_s *ring)
+{
+	return ring->size - lfring_used(ring);
+}
+
+static inline bool lfring_is_empty(FAR struct lfring_s *ring)
+{
+	return lfring_used(ring) == 0;
+}
+
+static inline bool lfring_is_full(FAR struct lfring_s *ring)
+{
+	return lfring_used(ring) == ring->size;
+}
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * @brief Initialize a single-producer / single-consumer ring
+ * @param[in] ring the ring to initialize
+ * @param[in] buffer the storage of the ring
+ * @param[in] size the size of buffer, must be a power of two
+ * @param[in] recsize the size of one record, or 0 for a byte stream
+ * @return OK on success, -EINVAL if the size is not a power of two
+ */
+int lfring_init(FAR struct lfring_s *ring, FAR void *buffer, size_t size, size_t recsize);
+
+/**
+ * @brief Discard all the data. Must not race with the producer or the consumer.
+ */
+void lfring_reset(FAR struct lfring_s *ring);
+
+/**
+ * @brief Copy up to len bytes into the ring (producer side)
+ * @return the number of bytes written, which is less than len if the ring is full
+ */
+size_t lfring_write(FAR struct lfring_s *ring, FAR const void *data, size_t len);
+
+/**
+ * @brief Copy up to len bytes out of the ring (consumer side)
+ * @return the number of bytes read
+ */
+size_t lfring_read(FAR struct lfring_s *ring, FAR void *data, size_t len);
+
+/**
+ * @brief Copy up to len bytes out of the ring without removing them (consumer side)
+ * @return the number of bytes copied
+ */
+size_t lfring_peek(FAR struct lfring_s *ring, FAR void *data, size_t len);
+
+/**
+ * @brief Drop up to len bytes from the ring (consumer side)
+ * @return the number of bytes dropped
+ */
+size_t lfring_skip(FAR struct lfring_s *ring, size_t len);
+
+/**
+ * @brief Get the contiguous free space at the head of the ring (producer side)
+ * @details The caller fills up to the returned number of bytes at *ptr and
+ *          then publishes them with lfring_write_commit(). Call it twice to
+ *          also get the part after the wraparound.
+ * @return the number of bytes which can be written at *ptr
+ */
+size_t lfring_write_reserve(FAR struct lfring_s *ring, FAR void **ptr);
+
+/**
+ * @brief Publish len bytes filled after lfring_write_reserve() (producer side)
+ */
+void lfring_write_commit(FAR struct lfring_s *ring, size_t len);
+
+/**
+ * @brief Get the contiguous data at the tail of the ring (consumer side)
+ * @return the number of bytes which can be read at *ptr
+ */
+size_t lfring_read_peek(FAR struct lfring_s *ring, FAR void **ptr);
+
+/**
+ * @brief Release len bytes consumed after lfring_read_peek() (consumer side)
+ */
+void lfring_read_commit(FAR struct lfring_s *ring, size_t len);
+
+/**
+ * @brief Copy up to nrecs whole records into the ring (producer side)
+ * @return the number of records written
+ */
+size_t lfring_put(FAR struct lfring_s *ring, FAR const void *recs, size_t nrecs);
+
+/**
+ * @brief Copy up to nrecs whole records out of the ring (consumer side)
+ * @return the number of records read
+ */
+size_t lfring_get(FAR struct lfring_s *ring, FAR void *recs, size_t nrecs);
+
+/**
+ * @brief Initialize a multi-producer / single-consumer record queue
+ * @param[in] ring the queue to initialize
+ * @param[in] buffer the storage, LFRING_MPSC_BUFSIZE(nrecs, recsize) bytes and word aligned
+ * @param[in] nrecs the number of records, must be a power of two
+ * @param[in] recsize the size of one record
+ * @return OK on success, -EINVAL on invalid parameters
+ */
+int lfring_mpsc_init(FAR struct lfring_mpsc_s *ring, FAR void *buffer, size_t nrecs, size_t recsize);
+
+/**
+ * @brief Add one record. Can be called from any task or interrupt handler.
+ * @details A producer never waits for another producer, so a task which
+ *          is preempted while it copies its record does not block an
+ *          interrupt handler which adds to the same queue.
+ * @return OK on success, -ENOSPC if the queue is full
+ */
+int lfring_mpsc_put(FAR struct lfring_mpsc_s *ring, FAR const void *rec);
+
+/**
+ * @brief Remove the oldest record (consumer side)
+ * @return OK on success, -EAGAIN if the queue is empty or the oldest record
+ *         is still being written
+ */
+int lfring_mpsc_get(FAR struct lfring_mpsc_s *ring, FAR void *rec);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif							/* __INCLUDE_TINYARA_LFRING_H */
+/** @} */
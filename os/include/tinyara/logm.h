@@ -27,8 +27,14 @@
 #define __OS_INCLUDE_TINYARA_LOGM_H
 
 #include <stdarg.h>
+#include <stdint.h>
+#include <sys/types.h>
 
 #define LOGM_DEF_PRIORITY (7)
+#define LOGM_DRVPATH "/dev/logm"
+
+/* Mask of the priorities from LOGM_EMR up to pri, like LOG_UPTO() */
+#define LOGM_UPTO(pri) ((uint8_t)((1 << ((pri) + 1)) - 1))
 /* Log priority levels in logm */
 
 enum logm_loglevel_e {
@@ -46,7 +52,10 @@ enum logm_loglevel_e {
 enum logm_param_type_e {
 	LOGM_BUFSIZE,
 	LOGM_INTERVAL,
-	LOGM_PRIORITY
+	LOGM_PRIORITY,
+	LOGM_DEFERRED,		/* 1 : defer formatting to the logm task */
+	LOGM_IRQOFF_MAX,	/* Longest interrupt disabled time (ns), set to reset */
+	LOGM_IRQOFF_AVG		/* Average interrupt disabled time (ns) */
 	/* This would grow later */
 };
 
@@ -58,8 +67,41 @@ enum logm_logflag_e {
 
 /* Log index means where messages are from */
 enum logm_logindex_e {
-	LOGM_UNKNOWN
-	/* Not supported yet. This would be updated later */
+	LOGM_UNKNOWN,	/* printf, syslog and common dbg */
+	LOGM_SCHED,
+	LOGM_MM,
+	LOGM_FS,
+	LOGM_NET,
+	LOGM_BINARY,	/* binfmt and binary manager */
+	LOGM_DRIVERS,
+	LOGM_AUDIO,
+	LOGM_MEDIA,
+	LOGM_PM,
+	LOGM_LIB,
+	LOGM_FRAMEWORK,
+	LOGM_INDEX_MAX
+};
+
+/**
+ * @brief Priorities enabled for a module, used with LOGMIOC_SETMASK and
+ * LOGMIOC_GETMASK of LOGM_DRVPATH
+ */
+struct logm_module_s {
+	int index;		/* enum logm_logindex_e */
+	uint8_t mask;		/* Bit n enables priority n, see LOGM_UPTO() */
+	uint32_t suppressed;	/* Messages dropped by the mask, get only */
+};
+
+/**
+ * @brief Destination of the messages flushed by the logm task
+ *
+ * write() is called from the logm task with a segment of formatted text.
+ * It returns the number of bytes written or a negative value on failure.
+ */
+struct logm_sink_s {
+	struct logm_sink_s *flink;	/* Used by logm */
+	const char *name;
+	ssize_t (*write)(struct logm_sink_s *sink, const char *buf, size_t len);
 };
 
 #undef EXTERN
@@ -91,6 +133,22 @@ int logm_set_values(enum logm_param_type_e type, int value);
  * @internal
  */
 int logm_get_values(enum logm_param_type_e type, int* value);
+/**
+ * @internal
+ */
+int logm_register_sink(struct logm_sink_s *sink);
+/**
+ * @internal
+ */
+int logm_unregister_sink(struct logm_sink_s *sink);
+/**
+ * @internal
+ */
+int logm_set_module(const struct logm_module_s *module);
+/**
+ * @internal
+ */
+int logm_get_module(struct logm_module_s *module);
 /**
  * @endcond
  */
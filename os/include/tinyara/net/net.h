@@ -107,6 +107,11 @@ typedef uint16_t socktimeo_t;
  * descriptor.
  */
 
+struct lwip_select_cb;
+struct lwip_epitem;
+struct lwip_epoll;
+struct lwip_zc_send;
+
 struct socket {
 	/** sockets currently are built on netconns, each socket has one netconn */
 	struct netconn *conn;
@@ -126,6 +131,18 @@ struct socket {
 	int err;
 	/** counter of how many threads are waiting for this socket using select */
 	int select_waiting;
+	/** tasks waiting for this socket in poll, so that an event only visits them */
+	struct lwip_select_cb *pollers;
+#ifdef CONFIG_NET_EPOLL
+	/** epoll instances which have this socket in their interest list */
+	struct lwip_epitem *epitems;
+	/** set if the descriptor is an epoll instance instead of a socket */
+	struct lwip_epoll *epoll;
+#endif
+#ifdef CONFIG_NET_ZEROCOPY
+	/** data sent by reference which TCP segments still refer to, oldest first */
+	struct lwip_zc_send *zc_sends;
+#endif
 };
 
 /* This defines a list of sockets indexed by the socket descriptor */
@@ -466,6 +483,30 @@ int net_clone(FAR struct socket *psock1, FAR struct socket *psock2);
 
 int net_vfcntl(int sockfd, int cmd, va_list ap);
 
+/****************************************************************************
+ * Function: net_sendfile
+ *
+ * Description:
+ *   Send a file to a TCP socket by reference, without the copies through a
+ *   user buffer.  Called by sendfile() when the output is a socket.
+ *
+ * Parameters:
+ *   outfd    Socket descriptor of a connected TCP socket
+ *   infile   The file to read
+ *   offset   Same as for sendfile()
+ *   count    The number of bytes to send
+ *
+ * Returned Value:
+ *   The number of bytes sent, or -1 with errno set.  ENOSYS means that the
+ *   socket is not a TCP socket.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE
+struct file;
+ssize_t net_sendfile(int outfd, FAR struct file *infile, FAR off_t *offset, size_t count);
+#endif
+
 /****************************************************************************
  * Function: netdev_foreach
  *
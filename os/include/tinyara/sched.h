@@ -508,6 +508,19 @@ struct task_group_s {
 #define IS_LOADED_MODULE(group)    (group->tg_bininfo != NULL)   /* Points loading data if it is loaded */
 #endif
 
+/* struct sched_latency_s ********************************************************/
+
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+/** @brief The wakeup-to-run latency histogram of a thread.  count[0] is the number
+ * of latencies below 1 usec, count[n] is the number of latencies from 2^(n-1) usec
+ * up to 2^n usec and the last bucket also counts all larger latencies.
+ */
+struct sched_latency_s {
+	uint32_t max;				/* Maximum latency in usec             */
+	uint32_t count[CONFIG_SCHED_LATENCY_NBUCKETS];
+};
+#endif
+
 /* struct tcb_s ******************************************************************/
 
 FAR struct wdog_s;				/* Forward reference                   */
@@ -627,6 +640,11 @@ struct tcb_s {
 #ifdef CONFIG_TASK_MONITOR
 	bool is_active;
 #endif
+
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+	uint32_t wakeup_time;		/* up_perf_gettime() when unblocked, 0 if not waiting */
+	struct sched_latency_s latency;	/* Wakeup-to-run latency histogram */
+#endif
 };
 
 /* struct task_tcb_s *************************************************************/
@@ -834,6 +852,10 @@ void sched_clear_cpuload_snapshot(void);
 void sched_get_cpuload_snapshot(pid_t *result_addr);
 #endif
 
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+int sched_get_latency(pid_t pid, FAR struct sched_latency_s *latency);
+#endif
+
 /********************************************************************************
  * Name: task_starthook
  *
@@ -39,8 +39,12 @@
 #include <stdarg.h>
 #include <stdbool.h>
 #include <debug.h>
+#include <stddef.h>
 #include <time.h>
 #include <sys/types.h>
+#if defined(CONFIG_TTRACE_USERBUF) || defined(CONFIG_TTRACE_KERNEL)
+#include <tinyara/lfring.h>
+#endif
 
 /****************************************************************************
  * Public Type Declarations
@@ -56,13 +60,11 @@
 #define TTRACE_BUFFER              'b'
 #define TTRACE_DUMP                'd'
 #define TTRACE_PRINT               'p'
-
-#define TTRACE_CODE_VARIABLE        0
-#define TTRACE_CODE_UNIQUE         (1 << 7)
+#define TTRACE_SAVE                'w'
+#define TTRACE_GET_UBUF            'm'
+#define TTRACE_COLLECT             'c'
 
 #define TTRACE_MSG_BYTES            32
-#define TTRACE_COMM_BYTES           12
-#define TTRACE_BYTE_ALIGN           4
 
 #define TTRACE_NODATA              -2
 #define TTRACE_INVALID             -1
@@ -75,33 +77,218 @@
 #define TTRACE_TAG_LOCK            (1 << 2)
 #define TTRACE_TAG_TASK            (1 << 3)
 #define TTRACE_TAG_IPC             (1 << 4)
+#define TTRACE_TAG_IRQ             (1 << 5)
+#define TTRACE_TAG_SEM             (1 << 6)
+#define TTRACE_TAG_PRIO            (1 << 7)
+#define TTRACE_TAG_MQ              (1 << 8)
+#define TTRACE_TAG_WORK            (1 << 9)
+#define TTRACE_TAG_HEAP            (1 << 10)
+
+/* A capture read from the T-trace device is a struct ttrace_header_s,
+ * followed by the string table (strtab_len bytes of <len><chars> entries,
+ * string id n is the n-th entry starting from 1), the task table (ntasks
+ * struct ttrace_task_s entries) and then the records.
+ *
+ * Every record starts with a type byte and a zigzag LEB128 varint holding
+ * the signed timestamp delta, in counter ticks, from the previous record
+ * (from ts_base for the first one).  The delta is negative when a record
+ * collected from the user buffer is older than the one before it.  Pids
+ * and string ids are unsigned LEB128 varints.
+ *
+ *   BEGIN     : pid, string id
+ *   BEGIN_UID : pid, uid(1B)
+ *   END       : pid
+ *   SCHED     : prev pid, prev prio(1B), prev state(1B), next pid, next prio(1B)
+ *   BEGIN_STR : pid, len(1B), chars (used when the string table is full)
+ *   KEVENT    : pid, event id(1B), arg0, arg1 (kernel tracepoints)
+ */
+#define TTRACE_MAGIC               0x43525454	/* "TTRC" */
+#define TTRACE_VERSION             2
+
+#define TTRACE_REC_BEGIN           1
+#define TTRACE_REC_BEGIN_UID       2
+#define TTRACE_REC_END             3
+#define TTRACE_REC_SCHED           4
+#define TTRACE_REC_BEGIN_STR       5
+#define TTRACE_REC_KEVENT          6
+
+/* Kernel events and their arguments, pid is the running task */
+
+#define TTRACE_KEV_IRQ_ENTER       1	/* irq */
+#define TTRACE_KEV_IRQ_EXIT        2	/* irq */
+#define TTRACE_KEV_SEM_BLOCK       3	/* sem, holder pid or 0 */
+#define TTRACE_KEV_SEM_WAKE        4	/* sem, woken pid */
+#define TTRACE_KEV_PRIO_BOOST      5	/* holder pid, new priority */
+#define TTRACE_KEV_PRIO_RESTORE    6	/* holder pid, new priority */
+#define TTRACE_KEV_MQ_SEND_BLOCK   7	/* msgq */
+#define TTRACE_KEV_MQ_RECV_BLOCK   8	/* msgq */
+#define TTRACE_KEV_MQ_WAKE         9	/* msgq, woken pid */
+#define TTRACE_KEV_WORK_START      10	/* worker */
+#define TTRACE_KEV_WORK_END        11	/* worker */
+#define TTRACE_KEV_MALLOC          12	/* address, size */
+#define TTRACE_KEV_FREE            13	/* address, size */
+
+/* Largest encoded record, a BEGIN_STR with a 64-bit delta */
+
+#define TTRACE_VARINT_MAXBYTES     10
+#define TTRACE_REC_MAXBYTES        (1 + TTRACE_VARINT_MAXBYTES + 5 + 1 + TTRACE_MSG_BYTES)
 
 /****************************************************************************
  * Public Variables
  ****************************************************************************/
-struct sched_message {          // total 32B
-	pid_t prev_pid;                     // 2B
-	uint8_t prev_prio;                  // 1B
-	uint8_t prev_state;                 // 1B
-	char prev_comm[TTRACE_COMM_BYTES];  // 12B
-	pid_t next_pid;                     // 2B
-	uint8_t next_prio;                  // 1B
-	int8_t pad;                         // 1B
-	char next_comm[TTRACE_COMM_BYTES];  // 12B
+struct ttrace_header_s {
+	uint32_t magic;            /* TTRACE_MAGIC */
+	uint8_t version;           /* TTRACE_VERSION */
+	uint8_t hdrlen;            /* sizeof(struct ttrace_header_s) */
+	uint16_t ntasks;           /* Entries in the task table */
+	uint32_t freq;             /* Timestamp counter frequency in Hz */
+	uint32_t ts_base_lo;       /* Timestamp the first record delta is from */
+	uint32_t ts_base_hi;
+	uint32_t dropped;          /* Records dropped by overwrite */
+	uint32_t strtab_len;       /* Bytes of the string table */
+};
+
+struct ttrace_task_s {
+	uint16_t pid;
+	uint16_t strid;            /* Task name, 0 if unknown */
+};
+
+/* With CONFIG_TTRACE_STREAM the capture is sent while tracing, as chunks
+ * of a struct ttrace_chunk_s followed by len bytes:
+ *
+ *   HEADER  : struct ttrace_header_s, ts_base is the timestamp of the
+ *             last record sent and the tables are empty
+ *   STRINGS : offset(4B) in the string table, then the new bytes of it
+ *   TASKS   : struct ttrace_task_s of the used task table entries
+ *   RECORDS : the next whole records
+ *   STATS   : struct ttrace_stream_stats_s
+ *
+ * The strings and tasks which records refer to are always sent before
+ * the records.  The header is sent again when the sink is opened again,
+ * followed by the whole string and task tables.
+ */
+#define TTRACE_STREAM_MAGIC        0x53525454	/* "TTRS" */
+
+#define TTRACE_CHUNK_HEADER        1
+#define TTRACE_CHUNK_STRINGS       2
+#define TTRACE_CHUNK_TASKS         3
+#define TTRACE_CHUNK_RECORDS       4
+#define TTRACE_CHUNK_STATS         5
+
+struct ttrace_chunk_s {
+	uint32_t magic;            /* TTRACE_STREAM_MAGIC */
+	uint8_t type;              /* TTRACE_CHUNK_xxx */
+	uint8_t reserved;
+	uint16_t len;              /* Bytes which follow */
 };
 
-union trace_message {              // total 32B
-	char message[TTRACE_MSG_BYTES];  // 32B, message(256b)
-	struct sched_message sched_msg;  // 32B
+struct ttrace_stream_stats_s {
+	uint32_t sent;             /* Bytes written to the sink */
+	uint32_t lost;             /* Records lost because the buffer was full */
+	uint32_t errors;           /* Failed writes to the sink */
+	uint32_t max_used;         /* Most bytes waiting in the buffer */
+	uint32_t max_write_ms;     /* Longest time one write to the sink took */
 };
 
-struct trace_packet {        // total 44 byte(message), 12byte(uid)
-	struct timeval ts;         // 8B, time_t(32b) + long(32b)
-	pid_t pid;                 // 2B, int16_t(16b)
-	char event_type;           // 1B, char(8b)
-	int8_t codelen;            // 1B, code(1b) + variable length(7b) or uid(7b)
-	union trace_message msg;   // 32B
+/* What trace_begin() and friends write to the T-trace device.  The driver
+ * timestamps it, interns the strings and stores the compact record.
+ */
+struct trace_sched_event {
+	pid_t prev_pid;
+	pid_t next_pid;
+	uint8_t prev_prio;
+	uint8_t prev_state;
+	uint8_t next_prio;
+};
+
+struct trace_kevent {
+	uint32_t arg0;
+	uint32_t arg1;
+};
+
+struct trace_event {
+	uint8_t type;              /* TTRACE_REC_xxx */
+	uint8_t uid;               /* Unique id of BEGIN_UID, event id of KEVENT */
+	union {
+		char message[TTRACE_MSG_BYTES];   /* NUL terminated string of BEGIN */
+		struct trace_sched_event sched;   /* SCHED */
+		struct trace_kevent kevent;       /* KEVENT */
+	} u;
+};
+
+#define TTRACE_EVENT_HDRBYTES      offsetof(struct trace_event, u)
+
+#if defined(CONFIG_TTRACE_USERBUF) || defined(CONFIG_TTRACE_KERNEL)
+/* An event queued with its time, for the driver to store later.  The user
+ * buffer and the kernel tracepoints queue them, and the driver moves them
+ * to the trace on TTRACE_COLLECT, when it stores a record of its own and
+ * when the trace finishes.
+ */
+#define TTRACE_HAVE_URECORD        1
+
+struct trace_urecord {
+	uint32_t raw;              /* up_perf_gettime(), if there is the counter */
+	uint32_t tick;             /* clock_systimer() */
+	pid_t pid;
+	struct trace_event event;
 };
+#endif
+
+#ifdef CONFIG_TTRACE_USERBUF
+/* The buffer which trace_begin() and trace_end() fill without a system
+ * call.
+ */
+struct ttrace_ubuf_s {
+	uint32_t tags;             /* Selected tags while tracing, 0 otherwise */
+	struct lfring_mpsc_s ring; /* Queue of struct trace_urecord */
+};
+#endif
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+/* Encode v as an unsigned LEB128 varint, return the number of bytes used */
+
+static inline int ttrace_put_varint(uint8_t *buf, uint64_t v)
+{
+	int n = 0;
+
+	while (v >= 0x80) {
+		buf[n++] = (uint8_t)(v | 0x80);
+		v >>= 7;
+	}
+	buf[n++] = (uint8_t)v;
+	return n;
+}
+
+/* Map a signed value to an unsigned one with a small magnitude kept small */
+
+static inline uint64_t ttrace_zigzag(int64_t v)
+{
+	return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static inline int64_t ttrace_unzigzag(uint64_t v)
+{
+	return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+/* Decode a varint from at most len bytes, return the bytes used or 0 */
+
+static inline int ttrace_get_varint(const uint8_t *buf, int len, uint64_t *v)
+{
+	uint64_t val = 0;
+	int n;
+
+	for (n = 0; n < len && n < TTRACE_VARINT_MAXBYTES; n++) {
+		val |= (uint64_t)(buf[n] & 0x7f) << (7 * n);
+		if ((buf[n] & 0x80) == 0) {
+			*v = val;
+			return n + 1;
+		}
+	}
+	return 0;
+}
 
 /****************************************************************************
  * Public Function Prototypes
@@ -174,6 +361,94 @@ int trace_sched(struct tcb_s *prev, struct tcb_s *next);
 #endif
 
 #endif /* CONFIG_TTRACE */
+
+/****************************************************************************
+ * Kernel Tracepoints
+ ****************************************************************************/
+/* Each category is compiled in by its CONFIG_TTRACE_KERNEL_xxx option and
+ * recorded only while its tag is selected.  A category which is compiled
+ * out costs nothing, one which is compiled in costs a load and a test
+ * while its tag is not selected.
+ */
+#if defined(CONFIG_TTRACE_KERNEL) && (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+extern volatile uint32_t g_ttrace_ktags;
+
+/**
+ * @brief records a kernel event, use the trace_xxx() macros below
+ * @details It can be called from interrupt handlers.
+ */
+void ttrace_kevent(uint8_t id, uint32_t arg0, uint32_t arg1);
+
+#define TTRACE_KEVENT(tag, id, arg0, arg1) \
+	do { \
+		if ((g_ttrace_ktags & (tag)) != 0) { \
+			ttrace_kevent(id, (uint32_t)(arg0), (uint32_t)(arg1)); \
+		} \
+	} while (0)
+#endif
+
+#if defined(TTRACE_KEVENT) && defined(CONFIG_TTRACE_KERNEL_IRQ)
+#define trace_irq_enter(irq)         TTRACE_KEVENT(TTRACE_TAG_IRQ, TTRACE_KEV_IRQ_ENTER, irq, 0)
+#define trace_irq_exit(irq)          TTRACE_KEVENT(TTRACE_TAG_IRQ, TTRACE_KEV_IRQ_EXIT, irq, 0)
+#else
+#define trace_irq_enter(irq)
+#define trace_irq_exit(irq)
+#endif
+
+#if defined(TTRACE_KEVENT) && defined(CONFIG_TTRACE_KERNEL_SEM)
+#define trace_sem_block(sem, holder) TTRACE_KEVENT(TTRACE_TAG_SEM, TTRACE_KEV_SEM_BLOCK, (uintptr_t)(sem), holder)
+#define trace_sem_wake(sem, pid)     TTRACE_KEVENT(TTRACE_TAG_SEM, TTRACE_KEV_SEM_WAKE, (uintptr_t)(sem), pid)
+#else
+#define trace_sem_block(sem, holder)
+#define trace_sem_wake(sem, pid)
+#endif
+
+#if defined(TTRACE_KEVENT) && defined(CONFIG_TTRACE_KERNEL_PRIO)
+#define trace_prio_boost(pid, prio)   TTRACE_KEVENT(TTRACE_TAG_PRIO, TTRACE_KEV_PRIO_BOOST, pid, prio)
+#define trace_prio_restore(pid, prio) TTRACE_KEVENT(TTRACE_TAG_PRIO, TTRACE_KEV_PRIO_RESTORE, pid, prio)
+#else
+#define trace_prio_boost(pid, prio)
+#define trace_prio_restore(pid, prio)
+#endif
+
+#if defined(TTRACE_KEVENT) && defined(CONFIG_TTRACE_KERNEL_MQUEUE)
+#define trace_mq_send_block(msgq)    TTRACE_KEVENT(TTRACE_TAG_MQ, TTRACE_KEV_MQ_SEND_BLOCK, (uintptr_t)(msgq), 0)
+#define trace_mq_recv_block(msgq)    TTRACE_KEVENT(TTRACE_TAG_MQ, TTRACE_KEV_MQ_RECV_BLOCK, (uintptr_t)(msgq), 0)
+#define trace_mq_wake(msgq, pid)     TTRACE_KEVENT(TTRACE_TAG_MQ, TTRACE_KEV_MQ_WAKE, (uintptr_t)(msgq), pid)
+#else
+#define trace_mq_send_block(msgq)
+#define trace_mq_recv_block(msgq)
+#define trace_mq_wake(msgq, pid)
+#endif
+
+#if defined(TTRACE_KEVENT) && defined(CONFIG_TTRACE_KERNEL_WQUEUE)
+#define trace_work_start(worker)     TTRACE_KEVENT(TTRACE_TAG_WORK, TTRACE_KEV_WORK_START, (uintptr_t)(worker), 0)
+#define trace_work_end(worker)       TTRACE_KEVENT(TTRACE_TAG_WORK, TTRACE_KEV_WORK_END, (uintptr_t)(worker), 0)
+#else
+#define trace_work_start(worker)
+#define trace_work_end(worker)
+#endif
+
+/* Only blocks of CONFIG_TTRACE_KERNEL_HEAP_THRESHOLD bytes or more */
+
+#if defined(TTRACE_KEVENT) && defined(CONFIG_TTRACE_KERNEL_HEAP)
+#define trace_malloc(mem, size) \
+	do { \
+		if ((size) >= CONFIG_TTRACE_KERNEL_HEAP_THRESHOLD) { \
+			TTRACE_KEVENT(TTRACE_TAG_HEAP, TTRACE_KEV_MALLOC, (uintptr_t)(mem), size); \
+		} \
+	} while (0)
+#define trace_free(mem, size) \
+	do { \
+		if ((size) >= CONFIG_TTRACE_KERNEL_HEAP_THRESHOLD) { \
+			TTRACE_KEVENT(TTRACE_TAG_HEAP, TTRACE_KEV_FREE, (uintptr_t)(mem), size); \
+		} \
+	} while (0)
+#else
+#define trace_malloc(mem, size)
+#define trace_free(mem, size)
+#endif
+
 #endif /* __INCLUDE_TINYARA_TTRACE_INTERNAL_H */
 /**
  * @}
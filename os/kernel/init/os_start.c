@@ -539,6 +539,12 @@ void os_start(void)
 
 	up_initialize();
 
+#ifdef CONFIG_SCHED_SWITCH_ACCOUNT
+	/* Start the time accounting at context switches */
+
+	sched_switch_initialize();
+#endif
+
 	/* Auto-mount Arch-independent File Sysytems */
 
 	fs_auto_mount();
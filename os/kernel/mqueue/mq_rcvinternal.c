@@ -208,6 +208,7 @@ FAR struct mqueue_msg_s *mq_waitreceive(mqd_t mqdes)
 			msgq->nwaitnotempty++;
 
 			set_errno(OK);
+			trace_mq_recv_block(msgq);
 			up_block_task(rtcb, TSTATE_WAIT_MQNOTEMPTY);
 
 			/* When we resume at this point, either (1) the message queue
@@ -318,6 +319,7 @@ ssize_t mq_doreceive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR char *ubuf
 
 		btcb->msgwaitq = NULL;
 		msgq->nwaitnotfull--;
+		trace_mq_wake(msgq, btcb->pid);
 		up_unblock_task(btcb);
 
 		irqrestore(saved_state);
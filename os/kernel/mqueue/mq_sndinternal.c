@@ -304,6 +304,7 @@ int mq_waitsend(mqd_t mqdes)
 				msgq->nwaitnotfull++;
 
 				set_errno(OK);
+				trace_mq_send_block(msgq);
 				up_block_task(rtcb, TSTATE_WAIT_MQNOTFULL);
 
 				/* When we resume at this point, either (1) the message queue
@@ -444,6 +445,7 @@ int mq_dosend(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR const char *msg,
 
 		btcb->msgwaitq = NULL;
 		msgq->nwaitnotempty--;
+		trace_mq_wake(msgq, btcb->pid);
 		up_unblock_task(btcb);
 	}
 
@@ -139,6 +139,25 @@ void pthread_mutex_inconsistent(FAR struct pthread_tcb_s *tcb);
 #define pthread_mutex_give(m)   pthread_sem_give(&(m)->sem)
 #endif
 
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+int pthread_mutex_fasttake(FAR struct pthread_mutex_s *mutex, bool intr);
+int pthread_mutex_fasttrytake(FAR struct pthread_mutex_s *mutex);
+int pthread_mutex_fastgive(FAR struct pthread_mutex_s *mutex);
+
+/* Claim or release an uncontended mutex without touching the semaphore */
+
+#define pthread_mutex_fastlock(m, pid) \
+	__atomic_compare_exchange_n(&(m)->lockword, &(int){0}, (pid), false, \
+				    __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)
+#define pthread_mutex_fastunlock(m, pid) \
+	__atomic_compare_exchange_n(&(m)->lockword, &(int){(pid)}, 0, false, \
+				    __ATOMIC_RELEASE, __ATOMIC_RELAXED)
+#else
+#define pthread_mutex_fasttake(m, i) pthread_mutex_take((m), (i))
+#define pthread_mutex_fasttrytake(m) pthread_mutex_trytake(m)
+#define pthread_mutex_fastgive(m)   pthread_mutex_give(m)
+#endif
+
 #if defined(CONFIG_CANCELLATION_POINTS) && !defined(CONFIG_PTHREAD_MUTEX_UNSAFE)
 uint16_t pthread_disable_cancel(void);
 void pthread_enable_cancel(uint16_t oldstate);
@@ -278,7 +278,7 @@ int pthread_cond_timedwait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex,
 					/* Give up the mutex */
 
 					mutex->pid = -1;
-					ret = pthread_mutex_give(mutex);
+					ret = pthread_mutex_fastgive(mutex);
 					if (ret != 0) {
 						/* Restore interrupts  (pre-emption will be enabled when
 						 * we fall through the if/then/else)
@@ -328,7 +328,7 @@ int pthread_cond_timedwait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex,
 					svdbg("Re-locking...\n");
 
 					oldstate = pthread_disable_cancel();
-					status = pthread_mutex_take(mutex, false);
+					status = pthread_mutex_fasttake(mutex, false);
 					pthread_enable_cancel(oldstate);
 
 					if (status == OK) {
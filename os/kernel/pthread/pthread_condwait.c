@@ -115,7 +115,7 @@ int pthread_cond_wait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex)
 
 		sched_lock();
 		mutex->pid = -1;
-		ret = pthread_mutex_give(mutex);
+		ret = pthread_mutex_fastgive(mutex);
 
 		/* Take the semaphore */
 
@@ -137,7 +137,7 @@ int pthread_cond_wait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex)
 		svdbg("Reacquire mutex...\n");
 
 		oldstate = pthread_disable_cancel();
-		status = pthread_mutex_take(mutex, false);
+		status = pthread_mutex_fasttake(mutex, false);
 		pthread_enable_cancel(oldstate);
 
 		if (ret == OK) {
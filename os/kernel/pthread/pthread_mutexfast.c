@@ -0,0 +1,207 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdbool.h>
+#include <unistd.h>
+#include <sched.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <tinyara/irq.h>
+#include <tinyara/sched.h>
+
+#include "sched/sched.h"
+#include "semaphore/semaphore.h"
+#include "pthread/pthread.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_mutex_fastconvert
+ *
+ * Description:
+ *   The mutex was locked in the fast path, so nobody holds its semaphore.
+ *   Take the semaphore on behalf of the owner so that a waiter blocks on it
+ *   and priority inheritance boosts the owner.  The owner then has to give
+ *   the semaphore back in pthread_mutex_fastgive().
+ *
+ * Parameters:
+ *   mutex - The mutex held in the fast path
+ *   owner - The pid of the owner
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   The scheduler is locked.
+ *
+ ****************************************************************************/
+
+static void pthread_mutex_fastconvert(FAR struct pthread_mutex_s *mutex, int owner)
+{
+	FAR struct tcb_s *otcb = sched_gettcb(owner);
+	irqstate_t flags;
+
+	flags = irqsave();
+
+	DEBUGASSERT(mutex->sem.semcount == 1);
+	mutex->sem.semcount = 0;
+
+	/* If the owner has exited, the mutex stays locked like a stalled mutex */
+
+	if (otcb != NULL) {
+		sem_addholder_tcb(otcb, &mutex->sem);
+#ifndef CONFIG_PTHREAD_MUTEX_UNSAFE
+		/* pthread_mutex_give() expects the mutex in the list of the owner */
+
+		mutex->flink = ((FAR struct pthread_tcb_s *)otcb)->mhead;
+		((FAR struct pthread_tcb_s *)otcb)->mhead = mutex;
+#endif
+	}
+
+	irqrestore(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_mutex_fasttake
+ *
+ * Description:
+ *   Take the mutex, waiting if necessary.  An unlocked mutex is claimed in
+ *   the lock word only.  Otherwise the contention is flagged in the lock
+ *   word and the caller waits on the semaphore.
+ *
+ * Parameters:
+ *  mutex - The mutex to be locked
+ *  intr  - false: ignore EINTR errors when locking; true treat EINTR as
+ *          other errors by returning the errno value
+ *
+ * Return Value:
+ *   0 on success or an errno value on failure.
+ *
+ ****************************************************************************/
+
+int pthread_mutex_fasttake(FAR struct pthread_mutex_s *mutex, bool intr)
+{
+	int mypid = (int)getpid();
+	int word;
+	int ret;
+
+	if ((mutex->lockword & _PTHREAD_MFAST_DISABLED) != 0) {
+		return pthread_mutex_take(mutex, intr);
+	}
+
+	if (pthread_mutex_fastlock(mutex, mypid)) {
+		return OK;
+	}
+
+	sched_lock();
+
+	/* From now on the owner has to unlock through pthread_mutex_fastgive() */
+
+	word = __atomic_fetch_or(&mutex->lockword, _PTHREAD_MFAST_WAITERS, __ATOMIC_ACQUIRE);
+	if (word != 0 && (word & _PTHREAD_MFAST_WAITERS) == 0) {
+		pthread_mutex_fastconvert(mutex, word);
+	}
+
+	ret = pthread_mutex_take(mutex, intr);
+	if (ret == OK) {
+		__atomic_store_n(&mutex->lockword, mypid | _PTHREAD_MFAST_WAITERS, __ATOMIC_RELAXED);
+	} else if (mutex->sem.semcount > 0) {
+		/* Nobody holds the mutex any more */
+
+		__atomic_store_n(&mutex->lockword, 0, __ATOMIC_RELEASE);
+	}
+
+	sched_unlock();
+	return ret;
+}
+
+/****************************************************************************
+ * Name: pthread_mutex_fasttrytake
+ *
+ * Description:
+ *   Try to take the mutex without waiting.
+ *
+ * Parameters:
+ *  mutex - The mutex to be locked
+ *
+ * Return Value:
+ *   0 on success or an errno value on failure.  EAGAIN means the mutex is
+ *   locked.
+ *
+ ****************************************************************************/
+
+int pthread_mutex_fasttrytake(FAR struct pthread_mutex_s *mutex)
+{
+	if ((mutex->lockword & _PTHREAD_MFAST_DISABLED) != 0) {
+		return pthread_mutex_trytake(mutex);
+	}
+
+	return pthread_mutex_fastlock(mutex, (int)getpid()) ? OK : EAGAIN;
+}
+
+/****************************************************************************
+ * Name: pthread_mutex_fastgive
+ *
+ * Description:
+ *   Release the mutex.  If other threads wait for the mutex, the lock word
+ *   keeps the waiters bit so that nobody can claim the mutex in the fast
+ *   path before the semaphore hands it to the next owner.
+ *
+ * Parameters:
+ *  mutex - The mutex to be unlocked
+ *
+ * Return Value:
+ *   0 on success or an errno value on failure.
+ *
+ ****************************************************************************/
+
+int pthread_mutex_fastgive(FAR struct pthread_mutex_s *mutex)
+{
+	int ret = OK;
+
+	if ((mutex->lockword & _PTHREAD_MFAST_DISABLED) != 0) {
+		return pthread_mutex_give(mutex);
+	}
+
+	sched_lock();
+
+	if ((mutex->lockword & _PTHREAD_MFAST_WAITERS) == 0) {
+		/* Locked in the fast path, the semaphore was never taken */
+
+		__atomic_store_n(&mutex->lockword, 0, __ATOMIC_RELEASE);
+	} else {
+		__atomic_store_n(&mutex->lockword, mutex->sem.semcount < 0 ? _PTHREAD_MFAST_WAITERS : 0, __ATOMIC_RELEASE);
+		ret = pthread_mutex_give(mutex);
+	}
+
+	sched_unlock();
+	return ret;
+}
@@ -177,6 +177,22 @@ int pthread_mutex_init(FAR pthread_mutex_t *mutex,
 
 		mutex->type = type;
 		mutex->nlocks = 0;
+#endif
+
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+		/* Only the non-robust NORMAL mutex can be locked in the fast path */
+
+		mutex->lockword = 0;
+#ifndef CONFIG_PTHREAD_MUTEX_UNSAFE
+		if (robust == PTHREAD_MUTEX_ROBUST) {
+			mutex->lockword = _PTHREAD_MFAST_DISABLED;
+		}
+#endif
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+		if (type != PTHREAD_MUTEX_NORMAL) {
+			mutex->lockword = _PTHREAD_MFAST_DISABLED;
+		}
+#endif
 #endif
 	}
 
@@ -150,6 +150,18 @@ int pthread_mutex_lock(FAR pthread_mutex_t *mutex)
 	svdbg("mutex=0x%p\n", mutex);
 	DEBUGASSERT(mutex != NULL);
 
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+	/* An uncontended mutex is claimed without locking the scheduler */
+
+	if (mutex != NULL && pthread_mutex_fastlock(mutex, mypid)) {
+		mutex->pid = mypid;
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+		mutex->nlocks = 1;
+#endif
+		return OK;
+	}
+#endif
+
 	if (mutex != NULL) {
 		/* Make sure the semaphore is stable while we make the following
 		 * checks.  This all needs to be one atomic action.
@@ -233,7 +245,7 @@ int pthread_mutex_lock(FAR pthread_mutex_t *mutex)
 			 * default mutex.
 			 */
 
-			ret = pthread_mutex_take(mutex, true);
+			ret = pthread_mutex_fasttake(mutex, true);
 
 			/* If we succussfully obtained the semaphore, then indicate
 			 * that we own it.
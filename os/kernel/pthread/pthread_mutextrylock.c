@@ -139,7 +139,7 @@ int pthread_mutex_trylock(FAR pthread_mutex_t *mutex)
 
 		/* Try to get the semaphore. */
 
-		status = pthread_mutex_trytake(mutex);
+		status = pthread_mutex_fasttrytake(mutex);
 		if (status == OK) {
 			/* If we successfully obtained the semaphore, then indicate
 			 * that we own it.
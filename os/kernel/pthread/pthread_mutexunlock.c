@@ -103,6 +103,14 @@ static inline bool pthread_mutex_islocked(FAR pthread_mutex_t *mutex)
 {
 	int semcount = mutex->sem.semcount;
 
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+	/* The semaphore is not taken while the mutex is held in the fast path */
+
+	if ((mutex->lockword & _PTHREAD_MFAST_DISABLED) == 0) {
+		return mutex->lockword != 0;
+	}
+#endif
+
 	/* The underlying semaphore should have a count less than 2:
 	*
 	*  1 == mutex is unlocked.
@@ -147,6 +155,9 @@ static inline bool pthread_mutex_islocked(FAR pthread_mutex_t *mutex)
 
 int pthread_mutex_unlock(FAR pthread_mutex_t *mutex)
 {
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+	int mypid = (int)getpid();
+#endif
 	int ret = EPERM;
 
 	svdbg("mutex=0x%p\n", mutex);
@@ -155,6 +166,27 @@ int pthread_mutex_unlock(FAR pthread_mutex_t *mutex)
 		return EINVAL;
 	}
 
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+	/* Nobody waits for a mutex which was locked in the fast path, so just
+	 * clear the lock word.  This fails if a waiter has set the waiters bit.
+	 */
+
+	if (mutex->lockword == mypid) {
+		mutex->pid = -1;
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+		mutex->nlocks = 0;
+#endif
+		if (pthread_mutex_fastunlock(mutex, mypid)) {
+			return OK;
+		}
+
+		mutex->pid = mypid;
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+		mutex->nlocks = 1;
+#endif
+	}
+#endif
+
 	/* Make sure the semaphore is stable while we make the following checks.
 	 * This all needs to be one atomic action.
 	 */
@@ -243,7 +275,7 @@ int pthread_mutex_unlock(FAR pthread_mutex_t *mutex)
 #ifdef CONFIG_PTHREAD_MUTEX_TYPES
 				mutex->nlocks = 0;
 #endif
-				ret = pthread_mutex_give(mutex);
+				ret = pthread_mutex_fastgive(mutex);
 			}
 	}
 
@@ -269,6 +269,25 @@ void sched_timer_reassess(void);
 void weak_function sched_process_cpuload(void);
 #endif
 void sched_clear_cpuload(pid_t pid);
+#ifdef CONFIG_SCHED_CPULOAD_PRECISE
+void sched_cpuload_initialize(void);
+void sched_cpuload_switch(FAR struct tcb_s *ntcb, uint32_t now);
+#endif
+#endif
+
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+void sched_latency_initialize(void);
+void sched_latency_switch(FAR struct tcb_s *ntcb, uint32_t now);
+#define sched_latency_wakeup(tcb) ((tcb)->wakeup_time = up_perf_gettime() | 1)
+#else
+#define sched_latency_wakeup(tcb)
+#endif
+
+#ifdef CONFIG_SCHED_SWITCH_ACCOUNT
+void sched_switch_initialize(void);
+void sched_switch_account(FAR struct tcb_s *ntcb);
+#else
+#define sched_switch_account(ntcb)
 #endif
 
 bool sched_verifytcb(FAR struct tcb_s *tcb);
@@ -61,6 +61,7 @@
 #include <stdint.h>
 
 #include <sys/types.h>
+#include <tinyara/arch.h>
 #include <tinyara/clock.h>
 #include <tinyara/sched.h>
 #include <tinyara/kmalloc.h>
@@ -77,7 +78,9 @@
  * of the sampling in ticks per second for the selected timer.
  */
 
-#ifdef CONFIG_SCHED_CPULOAD_EXTCLK
+#if defined(CONFIG_SCHED_CPULOAD_PRECISE)
+#define CPULOAD_TICKSPERSEC g_cpuload_unitspersec
+#elif defined(CONFIG_SCHED_CPULOAD_EXTCLK)
 #ifndef CONFIG_SCHED_CPULOAD_TICKSPERSEC
 #error CONFIG_SCHED_CPULOAD_TICKSPERSEC is not defined
 #endif
@@ -117,13 +120,157 @@ static int16_t g_cpusnap_head;
 static int16_t g_cpusnap_arr_size;
 static pid_t *g_cpusnap_arr;
 
+#ifdef CONFIG_SCHED_CPULOAD_PRECISE
+/* In the precise mode, the load is counted in units of 2^g_cpuload_shift
+ * counts of up_perf_gettime() so that the accumulators do not overflow
+ * with a fast counter.  g_cpuload_lasttime is the counter value up to
+ * which the time has been accounted to g_cpuload_running.
+ */
+
+static uint32_t g_cpuload_unitspersec;
+static uint8_t g_cpuload_shift;
+static uint32_t g_cpuload_lasttime;
+static pid_t g_cpuload_running;
+#endif
+
 /************************************************************************
  * Private Functions
  ************************************************************************/
 
+/************************************************************************
+ * Name: sched_cpuload_add
+ *
+ * Description:
+ *   Add count to the CPU load of the thread and to the total.  If the
+ *   total exceeds a time constant, then shift the accumulators.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ************************************************************************/
+
+static void sched_cpuload_add(pid_t pid, uint32_t count)
+{
+	int hash_index = PIDHASH(pid);
+	int cpuload_idx;
+	int i;
+
+	for (cpuload_idx = 0; cpuload_idx < SCHED_NCPULOAD; cpuload_idx++) {
+		g_pidhash[hash_index].ticks[cpuload_idx] += count;
+		g_cpuload_total[cpuload_idx] += count;
+
+		while (g_cpuload_total[cpuload_idx] > (g_cpuload_timeconstant[cpuload_idx] * CPULOAD_TICKSPERSEC)) {
+			uint32_t total = 0;
+
+			/* Divide the tick count for every task by two and recalculate the
+			 * total.
+			 */
+			for (i = 0; i < CONFIG_MAX_TASKS; i++) {
+				g_pidhash[i].ticks[cpuload_idx] >>= 1;
+				total += g_pidhash[i].ticks[cpuload_idx];
+			}
+
+			/* Save the new total. */
+
+			g_cpuload_total[cpuload_idx] = total;
+		}
+	}
+}
+
+#ifdef CONFIG_SCHED_CPULOAD_PRECISE
+/************************************************************************
+ * Name: sched_cpuload_account
+ *
+ * Description:
+ *   Account the time from the last accounting up to now to the thread
+ *   which has been running.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ************************************************************************/
+
+static void sched_cpuload_account(uint32_t now)
+{
+	uint32_t units;
+	int hash_index;
+
+	units = (now - g_cpuload_lasttime) >> g_cpuload_shift;
+	if (units == 0) {
+		return;
+	}
+
+	/* Keep the remainder for the next accounting */
+
+	g_cpuload_lasttime += units << g_cpuload_shift;
+
+	/* The thread may have exited already. Its time is dropped then. */
+
+	hash_index = PIDHASH(g_cpuload_running);
+	if (g_pidhash[hash_index].tcb && g_pidhash[hash_index].pid == g_cpuload_running) {
+		sched_cpuload_add(g_cpuload_running, units);
+	}
+}
+#endif
+
 /************************************************************************
  * Public Functions
  ************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_PRECISE
+/************************************************************************
+ * Name: sched_cpuload_initialize
+ *
+ * Description:
+ *   Start the precise CPU load accounting.  up_perf_init() should be
+ *   called before.
+ *
+ ************************************************************************/
+
+void sched_cpuload_initialize(void)
+{
+	uint32_t freq = up_perf_getfreq();
+
+	/* Count in units of about 1 usec at most */
+
+	g_cpuload_shift = 0;
+	while ((freq >> g_cpuload_shift) > 1000000) {
+		g_cpuload_shift++;
+	}
+
+	g_cpuload_unitspersec = freq >> g_cpuload_shift;
+	if (g_cpuload_unitspersec == 0) {
+		g_cpuload_unitspersec = 1;
+	}
+
+	g_cpuload_running = this_task()->pid;
+	g_cpuload_lasttime = up_perf_gettime();
+}
+
+/************************************************************************
+ * Name: sched_cpuload_switch
+ *
+ * Description:
+ *   Account the time of the thread which has been running and start
+ *   accounting for the next thread.  This is called on each context
+ *   switch.
+ *
+ * Inputs:
+ *   ntcb - The TCB of the thread which will run.
+ *   now  - The current value of up_perf_gettime().
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ************************************************************************/
+
+void sched_cpuload_switch(FAR struct tcb_s *ntcb, uint32_t now)
+{
+	sched_cpuload_account(now);
+	g_cpuload_running = ntcb->pid;
+}
+#endif
+
 int sched_start_cpuload_snapshot(int ticks)
 {
 	irqstate_t flags;
@@ -220,9 +367,6 @@ void sched_clear_cpuload(pid_t pid)
 void weak_function sched_process_cpuload(void)
 {
 	FAR struct tcb_s *rtcb = this_task();
-	int hash_index;
-	int i;
-	int cpuload_idx;
 
 	/* Increment the count on the currently executing thread
 	 *
@@ -239,31 +383,16 @@ void weak_function sched_process_cpuload(void)
 			g_cpusnap_head = 0;
 		}
 	}
-	hash_index = PIDHASH(rtcb->pid);
-
-	for (cpuload_idx = 0; cpuload_idx < SCHED_NCPULOAD; cpuload_idx++) {
-		g_pidhash[hash_index].ticks[cpuload_idx]++;
-
-		/* Increment tick count.  If the accumulated tick value exceed a time
-		 * constant, then shift the accumulators.
-		 */
-
-		if (++g_cpuload_total[cpuload_idx] > (g_cpuload_timeconstant[cpuload_idx] * CPULOAD_TICKSPERSEC)) {
-			uint32_t total = 0;
-
-			/* Divide the tick count for every task by two and recalculate the
-			 * total.
-			 */
-			for (i = 0; i < CONFIG_MAX_TASKS; i++) {
-				g_pidhash[i].ticks[cpuload_idx] >>= 1;
-				total += g_pidhash[i].ticks[cpuload_idx];
-			}
 
-			/* Save the new total. */
+#ifdef CONFIG_SCHED_CPULOAD_PRECISE
+	/* The time is accounted at context switches. Just bring the load of a
+	 * thread which runs for a long time up to date.
+	 */
 
-			g_cpuload_total[cpuload_idx] = total;
-		}
-	}
+	sched_cpuload_account(up_perf_gettime());
+#else
+	sched_cpuload_add(rtcb->pid, 1);
+#endif
 }
 #endif
 
@@ -301,6 +430,12 @@ int clock_cpuload(int pid, int index, FAR struct cpuload_s *cpuload)
 
 	flags = irqsave();
 
+#ifdef CONFIG_SCHED_CPULOAD_PRECISE
+	/* Account the time of the running thread up to now */
+
+	sched_cpuload_account(up_perf_gettime());
+#endif
+
 	/* Make sure that the entry is valid (TCB field is not NULL) and matches
 	 * the requested PID.  The first check is needed if the thread has exited.
 	 * The second check is needed for the case where the task associated with
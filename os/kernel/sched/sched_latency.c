@@ -0,0 +1,150 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/************************************************************************
+ * kernel/sched/sched_latency.c
+ ************************************************************************/
+
+/************************************************************************
+ * Included Files
+ ************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <errno.h>
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sys/types.h>
+#include <tinyara/arch.h>
+#include <tinyara/sched.h>
+#include <arch/irq.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+
+/************************************************************************
+ * Private Variables
+ ************************************************************************/
+
+/* usec = (counts * g_latency_usecmult) >> 32, which avoids a division
+ * in the context switch path.
+ */
+
+static uint32_t g_latency_usecmult;
+
+/************************************************************************
+ * Public Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name: sched_latency_initialize
+ *
+ * Description:
+ *   Prepare the conversion of up_perf_gettime() counts to usec.
+ *   up_perf_init() should be called before.
+ *
+ ************************************************************************/
+
+void sched_latency_initialize(void)
+{
+	uint32_t freq = up_perf_getfreq();
+
+	if (freq > 0) {
+		g_latency_usecmult = (uint32_t)(((uint64_t)1000000 << 32) / freq);
+	}
+}
+
+/************************************************************************
+ * Name: sched_latency_switch
+ *
+ * Description:
+ *   If the thread which will run was unblocked, record the time from
+ *   being unblocked to running now in its histogram.  This is called on
+ *   each context switch.
+ *
+ * Inputs:
+ *   ntcb - The TCB of the thread which will run.
+ *   now  - The current value of up_perf_gettime().
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ************************************************************************/
+
+void sched_latency_switch(FAR struct tcb_s *ntcb, uint32_t now)
+{
+	uint32_t usec;
+	int bucket;
+
+	if (ntcb->wakeup_time == 0) {
+		return;
+	}
+
+	usec = (uint32_t)(((uint64_t)(now - ntcb->wakeup_time) * g_latency_usecmult) >> 32);
+	ntcb->wakeup_time = 0;
+
+	/* Bucket N holds [2^(N-1), 2^N) usec and bucket 0 holds below 1 usec */
+
+	bucket = 0;
+	while (bucket < CONFIG_SCHED_LATENCY_NBUCKETS - 1 && (usec >> bucket) != 0) {
+		bucket++;
+	}
+
+	ntcb->latency.count[bucket]++;
+	if (usec > ntcb->latency.max) {
+		ntcb->latency.max = usec;
+	}
+}
+
+/************************************************************************
+ * Name: sched_get_latency
+ *
+ * Description:
+ *   Return the wakeup-to-run latency histogram of a thread.
+ *
+ * Inputs:
+ *   pid     - The task ID of the thread of interest.
+ *   latency - The location to return the histogram.
+ *
+ * Return Value:
+ *   OK (0) on success; -ESRCH if pid does not refer to a valid thread.
+ *
+ ************************************************************************/
+
+int sched_get_latency(pid_t pid, FAR struct sched_latency_s *latency)
+{
+	FAR struct tcb_s *tcb;
+	irqstate_t flags;
+	int ret = -ESRCH;
+
+	DEBUGASSERT(latency);
+
+	flags = irqsave();
+	tcb = sched_gettcb(pid);
+	if (tcb != NULL) {
+		memcpy(latency, &tcb->latency, sizeof(struct sched_latency_s));
+		ret = OK;
+	}
+	irqrestore(flags);
+
+	return ret;
+}
+
+#endif /* CONFIG_SCHED_LATENCY_HISTOGRAM */
@@ -59,6 +59,8 @@
 #include <queue.h>
 #include <assert.h>
 
+#include <tinyara/arch.h>
+
 #include "sched/sched.h"
 
 /************************************************************************
@@ -123,4 +125,8 @@ void sched_removeblocked(FAR struct tcb_s *btcb)
 	 */
 
 	btcb->task_state = TSTATE_TASK_INVALID;
+
+	/* Start measuring the wakeup-to-run latency */
+
+	sched_latency_wakeup(btcb);
 }
@@ -0,0 +1,90 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/************************************************************************
+ * kernel/sched/sched_switchaccount.c
+ ************************************************************************/
+
+/************************************************************************
+ * Included Files
+ ************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/sched.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_SWITCH_ACCOUNT
+
+/************************************************************************
+ * Public Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name: sched_switch_initialize
+ *
+ * Description:
+ *   Start the free-running counter and the time accounting at context
+ *   switches.  This is called once from os_start().
+ *
+ ************************************************************************/
+
+void sched_switch_initialize(void)
+{
+	up_perf_init();
+
+#ifdef CONFIG_SCHED_CPULOAD_PRECISE
+	sched_cpuload_initialize();
+#endif
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+	sched_latency_initialize();
+#endif
+}
+
+/************************************************************************
+ * Name: sched_switch_account
+ *
+ * Description:
+ *   This is called by the architecture-specific logic when the thread
+ *   ntcb is about to run, with the same timing as
+ *   save_task_scheduling_status().
+ *
+ * Inputs:
+ *   ntcb - The TCB of the thread which will run.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ************************************************************************/
+
+void sched_switch_account(FAR struct tcb_s *ntcb)
+{
+	uint32_t now = up_perf_gettime();
+
+#ifdef CONFIG_SCHED_CPULOAD_PRECISE
+	sched_cpuload_switch(ntcb, now);
+#endif
+#ifdef CONFIG_SCHED_LATENCY_HISTOGRAM
+	sched_latency_switch(ntcb, now);
+#endif
+}
+
+#endif /* CONFIG_SCHED_SWITCH_ACCOUNT */
@@ -61,6 +61,7 @@
 #include <assert.h>
 #include <debug.h>
 #include <tinyara/arch.h>
+#include <tinyara/ttrace.h>
 
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
@@ -330,6 +331,7 @@ static int sem_boostholderprio(FAR struct semholder_s *pholder, FAR sem_t *sem,
 			 * switch may occur during up_block_task() processing.
 			 */
 
+			trace_prio_boost(htcb->pid, rtcb->sched_priority);
 			(void)sched_setpriority(htcb, rtcb->sched_priority);
 		} else {
 			/* The new priority is above the base priority of the holder,
@@ -356,6 +358,7 @@ static int sem_boostholderprio(FAR struct semholder_s *pholder, FAR sem_t *sem,
 		 * will occur during up_block_task() processing.
 		 */
 
+		trace_prio_boost(htcb->pid, rtcb->sched_priority);
 		(void)sched_setpriority(htcb, rtcb->sched_priority);
 	}
 #endif
@@ -530,6 +533,7 @@ static int sem_restoreholderprio(FAR struct semholder_s *pholder, FAR sem_t *sem
 
 		sched_reprioritize(htcb, htcb->base_priority);
 #endif
+		trace_prio_restore(htcb->pid, htcb->sched_priority);
 	}
 
 	return 0;
@@ -1090,3 +1094,39 @@ int sem_nfreeholders(void)
 #endif
 }
 #endif
+
+/****************************************************************************
+ * Name: sem_holderpid
+ *
+ * Description:
+ *   Return the pid of a thread which holds a count of the semaphore, for
+ *   the trace of a thread which blocks on it.
+ *
+ * Parameters:
+ *   sem - A reference to the semaphore
+ *
+ * Return Value:
+ *   The pid of the first holder, 0 if there is none
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_TTRACE_KERNEL_SEM
+pid_t sem_holderpid(FAR sem_t *sem)
+{
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
+	FAR struct semholder_s *pholder;
+
+	for (pholder = sem->hhead; pholder; pholder = pholder->flink) {
+		if (pholder->htcb != NULL) {
+			return pholder->htcb->pid;
+		}
+	}
+	return 0;
+#else
+	return sem->holder.htcb != NULL ? sem->holder.htcb->pid : 0;
+#endif
+}
+#endif
@@ -62,6 +62,7 @@
 #include <sched.h>
 #include <tinyara/arch.h>
 #include <tinyara/sched.h>
+#include <tinyara/ttrace.h>
 
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
@@ -184,6 +185,7 @@ int sem_post(FAR sem_t *sem)
 #endif
 				/* Restart the waiting task. */
 
+				trace_sem_wake(sem, stcb->pid);
 				up_unblock_task(stcb);
 			}
 		}
@@ -62,6 +62,7 @@
 #include <assert.h>
 #include <tinyara/arch.h>
 #include <tinyara/cancelpt.h>
+#include <tinyara/ttrace.h>
 
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
@@ -183,6 +184,7 @@ int sem_wait(FAR sem_t *sem)
 			/* Handle the POSIX semaphore (but don't set the owner yet) */
 
 			sem->semcount--;
+			trace_sem_block(sem, sem_holderpid(sem));
 
 			/* Save the waited on semaphore in the TCB */
 
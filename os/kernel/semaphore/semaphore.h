@@ -122,6 +122,11 @@ void sem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem);
 #else
 #define sem_canceled(stcb, sem)
 #endif
+#ifdef CONFIG_TTRACE_KERNEL_SEM
+pid_t sem_holderpid(FAR sem_t *sem);
+#else
+#define sem_holderpid(sem) 0
+#endif
 #else
 #define sem_initholders()
 #define sem_destroyholder(sem)
@@ -131,6 +136,7 @@ void sem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem);
 #define sem_releaseholder(sem, htcb)
 #define sem_restorebaseprio(stcb, sem)
 #define sem_canceled(stcb, sem)
+#define sem_holderpid(sem) 0
 #endif
 
 #undef EXTERN
@@ -19,7 +19,9 @@
 #include <tinyara/config.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <string.h>
 #include <unistd.h>
+#include <semaphore.h>
 #ifdef CONFIG_ARCH_LOWPUTC
 #include <sched.h>
 #endif
@@ -36,6 +38,46 @@ int g_logm_head;
 int g_logm_tail;
 int g_logm_dropmsg_count;
 int g_logm_overflow_offset = -1;
+/* Priorities masked out per module, everything is enabled by default */
+uint8_t g_logm_modoff[LOGM_INDEX_MAX];
+uint32_t g_logm_suppressed[LOGM_INDEX_MAX];
+#ifdef CONFIG_LOGM_DEFERRED
+volatile bool g_logm_deferred = true;
+#endif
+#ifdef CONFIG_LOGM_STATS
+uint32_t g_logm_irqoff_max;
+uint32_t g_logm_irqoff_total;
+uint32_t g_logm_irqoff_count;
+#endif
+
+#ifdef CONFIG_LOGM_STATS
+#define LOGM_IRQOFF_START(t) ((t) = up_perf_gettime())
+#define LOGM_IRQOFF_END(t) logm_irqoff_account(up_perf_gettime() - (t))
+
+static void logm_irqoff_account(uint32_t elapsed)
+{
+	if (elapsed > g_logm_irqoff_max) {
+		g_logm_irqoff_max = elapsed;
+	}
+	g_logm_irqoff_total += elapsed;
+	g_logm_irqoff_count++;
+}
+#else
+#define LOGM_IRQOFF_START(t)
+#define LOGM_IRQOFF_END(t)
+#endif
+
+/* Called with interrupts disabled.  Returns true if the logm task has to be
+ * woken up because the buffer is filled over the drain threshold.
+ */
+static bool logm_drain_request(void)
+{
+	if (LOGM_DRAIN_NEEDED()) {
+		LOGM_STATUS_SET(LOGM_DRAIN_REQ);
+		return true;
+	}
+	return false;
+}
 
 static void logm_putc(FAR struct lib_outstream_s *this, int ch)
 {
@@ -53,15 +95,42 @@ static void logm_outstream(FAR struct lib_outstream_s *outstream)
 	outstream->nput = 0;
 }
 
+#ifdef CONFIG_LOGM_DEFERRED
+static void logm_copyin(int pos, FAR const char *data, int len)
+{
+	int first = logm_bufsize - pos;
+
+	if (first > len) {
+		first = len;
+	}
+	memcpy(&g_logm_rsvbuf[pos], data, first);
+	memcpy(g_logm_rsvbuf, data + first, len - first);
+}
+
+/* The buffer got full, drop messages until the logm task drains it */
+static void logm_overflow(void)
+{
+	LOGM_STATUS_SET(LOGM_BUFFER_OVERFLOW);
+	g_logm_dropmsg_count = 1;
+	g_logm_overflow_offset = g_logm_tail;
+}
+#endif
+
 #ifdef CONFIG_ARCH_LOWPUTC
 static void logm_flush(struct lib_outstream_s *stream)
 {
 	sched_lock();
 
+#ifdef CONFIG_LOGM_DEFERRED
+	while (g_logm_head != g_logm_tail) {
+		logm_drain_record(stream, NULL);
+	}
+#else
 	while (g_logm_head != g_logm_tail) {
 		stream->put(stream, g_logm_rsvbuf[g_logm_head]);
 		g_logm_head = (g_logm_head + 1) % logm_bufsize;
 	}
+#endif
 
 	if (LOGM_STATUS(LOGM_BUFFER_OVERFLOW)) {
 		LOGM_STATUS_CLEAR(LOGM_BUFFER_OVERFLOW);
@@ -74,46 +143,178 @@ static void logm_flush(struct lib_outstream_s *stream)
 }
 #endif
 
+#ifdef CONFIG_LOGM_DEFERRED
+/* Queue the record built by logm_deferred_capture() */
+static int logm_put_deferred(FAR char *rec, int len)
+{
+	irqstate_t flags;
+	int ret = 0;
+	bool wake;
+#ifdef CONFIG_LOGM_STATS
+	uint32_t start;
+#endif
+
+	flags = irqsave();
+	LOGM_IRQOFF_START(start);
+
+	if (LOGM_STATUS(LOGM_BUFFER_OVERFLOW)) {
+		g_logm_dropmsg_count++;
+	} else if (len > LOGM_FREE()) {
+		logm_overflow();
+	} else {
+		logm_copyin(g_logm_tail, rec, len);
+		g_logm_tail = (g_logm_tail + len) % logm_bufsize;
+		ret = len;
+	}
+	wake = logm_drain_request();
+
+	LOGM_IRQOFF_END(start);
+	irqrestore(flags);
+
+	if (wake) {
+		sem_post(&g_logm_drain_sem);
+	}
+
+	return ret;
+}
+
+/* Format the message into a text record directly in the buffer */
+static int logm_put_formatted(FAR struct logm_rec_s *hdr, const char *fmt, va_list ap)
+{
+	irqstate_t flags;
+	struct lib_outstream_s strm;
+	int ret = 0;
+	bool wake;
+#ifdef CONFIG_LOGM_STATS
+	uint32_t start;
+#endif
+
+	flags = irqsave();
+	LOGM_IRQOFF_START(start);
+
+	if (LOGM_STATUS(LOGM_BUFFER_OVERFLOW)) {
+		g_logm_dropmsg_count++;
+	} else if (LOGM_FREE() <= (int)sizeof(struct logm_rec_s)) {
+		logm_overflow();
+	} else {
+		/* The text follows the header, which is written once its length is known */
+		logm_outstream(&strm);
+		strm.nput = sizeof(struct logm_rec_s);
+		ret = lib_vsprintf(&strm, fmt, ap);
+
+		hdr->len = strm.nput;
+		hdr->fmt = NULL;
+		logm_copyin(g_logm_tail, (FAR const char *)hdr, sizeof(struct logm_rec_s));
+		g_logm_tail = (g_logm_tail + strm.nput) % logm_bufsize;
+
+		if ((g_logm_tail + 1) % logm_bufsize == g_logm_head) {
+			logm_overflow();
+		}
+	}
+	wake = logm_drain_request();
+
+	LOGM_IRQOFF_END(start);
+	irqrestore(flags);
+
+	if (wake) {
+		sem_post(&g_logm_drain_sem);
+	}
+
+	return ret;
+}
+#endif
+
 /* logm_internal hook for syslog & printfs */
 int logm_internal(int flag, int indx, int priority, const char *fmt, va_list ap)
 {
-	irqstate_t flags;
 	int ret = 0;
+#if !defined(CONFIG_LOGM_DEFERRED) || defined(CONFIG_ARCH_LOWPUTC)
 	struct lib_outstream_s strm;
+#endif
+#ifndef CONFIG_LOGM_DEFERRED
+	irqstate_t flags;
+	bool wake;
 #ifdef CONFIG_LOGM_TIMESTAMP
 	struct timespec ts;
 #endif
+#ifdef CONFIG_LOGM_STATS
+	uint32_t start;
+#endif
+#endif
+
+	if (LOGM_FILTERED(indx, priority)) {
+		g_logm_suppressed[indx]++;
+		return 0;
+	}
 
 	if (LOGM_STATUS(LOGM_READY) && !LOGM_STATUS(LOGM_BUFFER_RESIZE_REQ) \
 		&& flag == LOGM_NORMAL && !up_interrupt_context()) {
+#ifdef CONFIG_LOGM_DEFERRED
+		union {
+			struct logm_rec_s hdr;
+			char buf[LOGM_RECORD_SIZE];
+		} rec;
+		va_list ap2;
+		int len = ERROR;
+
+#ifdef CONFIG_LOGM_TIMESTAMP
+		if (clock_systimespec(&rec.hdr.ts) != OK) {
+			rec.hdr.ts.tv_sec = 0;
+			rec.hdr.ts.tv_nsec = 0;
+		}
+#endif
+
+		/* Capture the arguments without disabling interrupts.  Fall back to
+		 * formatting now if the message cannot be deferred.
+		 */
+		if (g_logm_deferred) {
+			va_copy(ap2, ap);
+			len = logm_deferred_capture(fmt, ap2, rec.buf + sizeof(struct logm_rec_s), LOGM_RECORD_SIZE - sizeof(struct logm_rec_s));
+			va_end(ap2);
+		}
+
+		if (len >= 0) {
+			rec.hdr.len = sizeof(struct logm_rec_s) + len;
+			rec.hdr.fmt = fmt;
+			return logm_put_deferred(rec.buf, rec.hdr.len);
+		}
 
+		return logm_put_formatted(&rec.hdr, fmt, ap);
+#else
 		flags = irqsave();
+		LOGM_IRQOFF_START(start);
 
 		if (LOGM_STATUS(LOGM_BUFFER_OVERFLOW)) {
 			g_logm_dropmsg_count++;
-			irqrestore(flags);
-			return 0;
-		}
-
-		/*  Initializes a stream for use with logm buffer */
-		logm_outstream(&strm);
+		} else {
+			/*  Initializes a stream for use with logm buffer */
+			logm_outstream(&strm);
 
 #ifdef CONFIG_LOGM_TIMESTAMP
-		/* Get the current time and prepend timestamp to message */
-		if (clock_systimespec(&ts) == OK) {
-			(void)lib_sprintf((FAR struct lib_outstream_s *)&strm, "[%4d.%4d] ", ts.tv_sec, ts.tv_nsec / 100000);
-		}
+			/* Get the current time and prepend timestamp to message */
+			if (clock_systimespec(&ts) == OK) {
+				(void)lib_sprintf((FAR struct lib_outstream_s *)&strm, "[%4d.%4d] ", ts.tv_sec, ts.tv_nsec / 100000);
+			}
 #endif
-		ret = lib_vsprintf(&strm, fmt, ap);
+			ret = lib_vsprintf(&strm, fmt, ap);
 
-		g_logm_tail = (g_logm_tail + ret) % logm_bufsize;
+			g_logm_tail = (g_logm_tail + ret) % logm_bufsize;
 
-		if ((g_logm_tail + 1) % logm_bufsize == g_logm_head) {
-			LOGM_STATUS_SET(LOGM_BUFFER_OVERFLOW);
-			g_logm_dropmsg_count = 1;
-			g_logm_overflow_offset = g_logm_tail;
+			if ((g_logm_tail + 1) % logm_bufsize == g_logm_head) {
+				LOGM_STATUS_SET(LOGM_BUFFER_OVERFLOW);
+				g_logm_dropmsg_count = 1;
+				g_logm_overflow_offset = g_logm_tail;
+			}
 		}
+		wake = logm_drain_request();
+
+		LOGM_IRQOFF_END(start);
 		irqrestore(flags);
+
+		if (wake) {
+			sem_post(&g_logm_drain_sem);
+		}
+#endif
 	} else {
 		/* Low Output: Sytem is not yet completely ready or this is called from interrupt handler */
 #ifdef CONFIG_ARCH_LOWPUTC
@@ -19,7 +19,14 @@
 #define __OS_LOGM_LOGM_H
 
 #include <tinyara/config.h>
+#include <stdarg.h>
 #include <stdint.h>
+#include <stdbool.h>
+#include <semaphore.h>
+#ifdef CONFIG_LOGM_TIMESTAMP
+#include <time.h>
+#endif
+#include <tinyara/streams.h>
 
 /****************************************************************************
  * Preprocessor Definitions
@@ -43,19 +50,65 @@
 #define BIT(x) (1 << (x))
 #endif
 
+#ifdef CONFIG_LOGM_DRAIN_THRESHOLD
+#define LOGM_DRAIN_THRESHOLD CONFIG_LOGM_DRAIN_THRESHOLD
+#else
+#define LOGM_DRAIN_THRESHOLD (50)
+#endif
+
+#define LOGM_SINK_BUFSIZE (128)
+
 #define LOGM_READY BIT(0)
 #define LOGM_BUFFER_RESIZE_REQ BIT(1)
 #define LOGM_BUFFER_OVERFLOW BIT(2)
+#define LOGM_DRAIN_REQ BIT(3)
 
 #define LOGM_STATUS(a) (logm_status & (a))
 #define LOGM_STATUS_SET(a) (logm_status |= (a))
 #define LOGM_STATUS_CLEAR(a) (logm_status &= ~(a))
 
+#define LOGM_USED() ((g_logm_tail - g_logm_head + logm_bufsize) % logm_bufsize)
+#define LOGM_FREE() (logm_bufsize - LOGM_USED() - 1)
+
+/* Messages of a module are dropped before formatting if their priority is
+ * masked out.  Priorities beyond LOGM_DBG are never filtered.
+ */
+#define LOGM_FILTERED(indx, pri) ((unsigned)(indx) < LOGM_INDEX_MAX && \
+	(unsigned)(pri) <= LOGM_DBG && (g_logm_modoff[indx] & (1 << (pri))))
+
+/* The logm task has to be woken up once the buffer is filled over the threshold */
+#define LOGM_DRAIN_NEEDED() (!LOGM_STATUS(LOGM_DRAIN_REQ) && \
+	LOGM_USED() * 100 >= logm_bufsize * LOGM_DRAIN_THRESHOLD)
+
+#ifdef CONFIG_LOGM_DEFERRED
+#define LOGM_RECORD_SIZE CONFIG_LOGM_DEFERRED_RECSIZE
+#endif
+
 /****************************************************************************
  * Private Declarations
  ****************************************************************************/
 
-/* Structure for a single debug message */
+#ifdef CONFIG_LOGM_DEFERRED
+/* With CONFIG_LOGM_DEFERRED, the buffer holds records instead of plain text.
+ * The header is followed either by the formatted text (fmt == NULL) or by
+ * the arguments for fmt as captured by logm_deferred_capture().
+ */
+
+struct logm_rec_s {
+	uint32_t len;			/* Length of the record including this header */
+	FAR const char *fmt;		/* Format string or NULL for formatted text */
+#ifdef CONFIG_LOGM_TIMESTAMP
+	struct timespec ts;		/* Time at which the message was logged */
+#endif
+};
+#endif
+
+/* Output stream which collects formatted text for the sinks */
+struct logm_sinkstream_s {
+	struct lib_outstream_s public;
+	int len;
+	char buf[LOGM_SINK_BUFSIZE];
+};
 
 #undef EXTERN
 #if defined(__cplusplus)
@@ -74,12 +127,37 @@ EXTERN int logm_bufsize;
 EXTERN uint8_t logm_status;
 EXTERN volatile int new_logm_bufsize;
 EXTERN volatile int logm_print_interval;
+EXTERN sem_t g_logm_drain_sem;
+EXTERN uint8_t g_logm_modoff[LOGM_INDEX_MAX];
+EXTERN uint32_t g_logm_suppressed[LOGM_INDEX_MAX];
+#ifdef CONFIG_LOGM_DEFERRED
+EXTERN volatile bool g_logm_deferred;
+#endif
+#ifdef CONFIG_LOGM_STATS
+EXTERN uint32_t g_logm_irqoff_max;
+EXTERN uint32_t g_logm_irqoff_total;
+EXTERN uint32_t g_logm_irqoff_count;
+#endif
 
 /************************************************************************************
  * Private Function Prototypes
  ************************************************************************************/
 int logm_task(int argc, char *argv[]);
 void logm_register_tashcmds(void);
+void logm_drv_register(void);
+void logm_sink_initialize(void);
+void logm_sink_write(FAR const char *buf, size_t len);
+void logm_sinkstream(FAR struct logm_sinkstream_s *strm);
+void logm_sinkstream_flush(FAR struct logm_sinkstream_s *strm);
+#ifdef CONFIG_LOGM_SINK_FLASH
+void logm_flash_initialize(void);
+int logm_flash_dump(void);
+#endif
+#ifdef CONFIG_LOGM_DEFERRED
+void logm_drain_record(FAR struct lib_outstream_s *strm, CODE void (*write)(FAR const char *buf, size_t len));
+int logm_deferred_capture(FAR const char *fmt, va_list ap, FAR char *args, int argslen);
+void logm_deferred_format(FAR struct lib_outstream_s *strm, FAR const char *fmt, FAR const char *args, int argslen);
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
@@ -0,0 +1,373 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <tinyara/streams.h>
+#include "logm.h"
+
+/* Only the format strings in .text/.rodata live long enough to be formatted
+ * later.  The linker script provides these symbols.
+ */
+extern uint32_t _stext;
+extern uint32_t _etext;
+
+#define LOGM_SPEC_MAX 16
+
+/* Type of the argument of a conversion */
+enum logm_argtype_e {
+	LOGM_ARG_NONE,			/* %% */
+	LOGM_ARG_INT,
+	LOGM_ARG_LONG,
+	LOGM_ARG_LLONG,
+	LOGM_ARG_SIZE,
+	LOGM_ARG_PTR,
+	LOGM_ARG_STR,
+	LOGM_ARG_DOUBLE,
+	LOGM_ARG_INVALID		/* %n, long double or unknown */
+};
+
+struct logm_spec_s {
+	uint8_t type;			/* See enum logm_argtype_e */
+	uint8_t nstar;			/* Number of '*' width and precision arguments */
+};
+
+/* Parse the conversion at fmt, which points to '%', and return the
+ * character following it.
+ */
+static FAR const char *logm_parse_spec(FAR const char *fmt, FAR struct logm_spec_s *spec)
+{
+	int lflag = 0;
+	bool zflag = false;
+	bool ldouble = false;
+
+	spec->type = LOGM_ARG_INVALID;
+	spec->nstar = 0;
+
+	fmt++;
+	if (*fmt == '%') {
+		spec->type = LOGM_ARG_NONE;
+		return fmt + 1;
+	}
+
+	while (*fmt != '\0' && strchr("-+ #0", *fmt) != NULL) {
+		fmt++;
+	}
+
+	if (*fmt == '*') {
+		spec->nstar++;
+		fmt++;
+	}
+	while (*fmt >= '0' && *fmt <= '9') {
+		fmt++;
+	}
+
+	if (*fmt == '.') {
+		fmt++;
+		if (*fmt == '*') {
+			spec->nstar++;
+			fmt++;
+		}
+		while (*fmt >= '0' && *fmt <= '9') {
+			fmt++;
+		}
+	}
+
+	for (;; fmt++) {
+		if (*fmt == 'h') {
+			continue;
+		} else if (*fmt == 'l') {
+			lflag++;
+		} else if (*fmt == 'j' || *fmt == 'q') {
+			lflag = 2;
+		} else if (*fmt == 'z' || *fmt == 't') {
+			zflag = true;
+		} else if (*fmt == 'L') {
+			ldouble = true;
+		} else {
+			break;
+		}
+	}
+
+	switch (*fmt) {
+	case 'd':
+	case 'i':
+	case 'u':
+	case 'x':
+	case 'X':
+	case 'o':
+	case 'b':
+	case 'c':
+		if (zflag) {
+			spec->type = LOGM_ARG_SIZE;
+		} else if (lflag >= 2) {
+			spec->type = LOGM_ARG_LLONG;
+		} else if (lflag == 1) {
+			spec->type = LOGM_ARG_LONG;
+		} else {
+			spec->type = LOGM_ARG_INT;
+		}
+		break;
+	case 'p':
+		spec->type = LOGM_ARG_PTR;
+		break;
+	case 's':
+		spec->type = LOGM_ARG_STR;
+		break;
+	case 'e':
+	case 'E':
+	case 'f':
+	case 'F':
+	case 'g':
+	case 'G':
+		if (!ldouble) {
+			spec->type = LOGM_ARG_DOUBLE;
+		}
+		break;
+	default:
+		return fmt;
+	}
+
+	return fmt + 1;
+}
+
+static int logm_arg_size(uint8_t type)
+{
+	switch (type) {
+	case LOGM_ARG_INT:
+		return sizeof(int);
+	case LOGM_ARG_LONG:
+		return sizeof(long);
+	case LOGM_ARG_LLONG:
+		return sizeof(long long);
+	case LOGM_ARG_SIZE:
+		return sizeof(size_t);
+	case LOGM_ARG_PTR:
+		return sizeof(void *);
+	case LOGM_ARG_DOUBLE:
+		return sizeof(double);
+	default:
+		return 0;
+	}
+}
+
+/****************************************************************************
+ * Name: logm_deferred_capture
+ *
+ * Description:
+ *   Store the arguments of fmt in args.  Integers, pointers and doubles are
+ *   copied in their native size, strings are copied with their terminating
+ *   NUL and truncated if they do not fit.
+ *
+ * Return Value:
+ *   The number of bytes stored in args or ERROR if the message has to be
+ *   formatted immediately.
+ ****************************************************************************/
+int logm_deferred_capture(FAR const char *fmt, va_list ap, FAR char *args, int argslen)
+{
+	struct logm_spec_s spec;
+	FAR const char *start;
+	FAR const char *str;
+	int pos = 0;
+	int size;
+	int star;
+	union {
+		int i;
+		long l;
+		long long ll;
+		size_t z;
+		FAR void *p;
+		double d;
+	} val;
+
+	if ((uintptr_t)fmt < (uintptr_t)&_stext || (uintptr_t)fmt >= (uintptr_t)&_etext) {
+		return ERROR;
+	}
+
+	while ((start = strchr(fmt, '%')) != NULL) {
+		fmt = logm_parse_spec(start, &spec);
+		if (spec.type == LOGM_ARG_INVALID || fmt - start >= LOGM_SPEC_MAX) {
+			return ERROR;
+		}
+
+		if (pos + spec.nstar * (int)sizeof(int) > argslen) {
+			return ERROR;
+		}
+		while (spec.nstar-- > 0) {
+			star = va_arg(ap, int);
+			memcpy(&args[pos], &star, sizeof(int));
+			pos += sizeof(int);
+		}
+
+		switch (spec.type) {
+		case LOGM_ARG_INT:
+			val.i = va_arg(ap, int);
+			break;
+		case LOGM_ARG_LONG:
+			val.l = va_arg(ap, long);
+			break;
+		case LOGM_ARG_LLONG:
+			val.ll = va_arg(ap, long long);
+			break;
+		case LOGM_ARG_SIZE:
+			val.z = va_arg(ap, size_t);
+			break;
+		case LOGM_ARG_PTR:
+			val.p = va_arg(ap, FAR void *);
+			break;
+		case LOGM_ARG_DOUBLE:
+			val.d = va_arg(ap, double);
+			break;
+		case LOGM_ARG_STR:
+			str = va_arg(ap, FAR const char *);
+			if (str == NULL) {
+				str = "(null)";
+			}
+			if (pos >= argslen) {
+				return ERROR;
+			}
+			size = strnlen(str, argslen - pos - 1);
+			memcpy(&args[pos], str, size);
+			args[pos + size] = '\0';
+			pos += size + 1;
+			continue;
+		default:
+			continue;
+		}
+
+		size = logm_arg_size(spec.type);
+		if (pos + size > argslen) {
+			return ERROR;
+		}
+		memcpy(&args[pos], &val, size);
+		pos += size;
+	}
+
+	return pos;
+}
+
+/****************************************************************************
+ * Name: logm_deferred_format
+ *
+ * Description:
+ *   Format a message from the arguments stored by logm_deferred_capture().
+ *   Each conversion is formatted separately with lib_sprintf().
+ ****************************************************************************/
+void logm_deferred_format(FAR struct lib_outstream_s *strm, FAR const char *fmt, FAR const char *args, int argslen)
+{
+	struct logm_spec_s spec;
+	FAR const char *start;
+	char cvt[LOGM_SPEC_MAX];
+	int star[2];
+	int pos = 0;
+	int size;
+	int nstar;
+	union {
+		int i;
+		long l;
+		long long ll;
+		size_t z;
+		FAR void *p;
+		double d;
+	} val;
+
+	while (*fmt != '\0') {
+		if (*fmt != '%') {
+			strm->put(strm, *fmt++);
+			continue;
+		}
+
+		start = fmt;
+		fmt = logm_parse_spec(fmt, &spec);
+		if (spec.type == LOGM_ARG_NONE) {
+			strm->put(strm, '%');
+			continue;
+		}
+
+		size = fmt - start;
+		if (size >= LOGM_SPEC_MAX) {
+			return;
+		}
+		memcpy(cvt, start, size);
+		cvt[size] = '\0';
+
+		for (nstar = 0; nstar < spec.nstar; nstar++) {
+			if (pos + (int)sizeof(int) > argslen) {
+				return;
+			}
+			memcpy(&star[nstar], &args[pos], sizeof(int));
+			pos += sizeof(int);
+		}
+
+		if (spec.type == LOGM_ARG_STR) {
+			if (pos >= argslen) {
+				return;
+			}
+			val.p = (FAR void *)&args[pos];
+			pos += strnlen(&args[pos], argslen - pos) + 1;
+		} else {
+			size = logm_arg_size(spec.type);
+			if (pos + size > argslen) {
+				return;
+			}
+			memcpy(&val, &args[pos], size);
+			pos += size;
+		}
+
+		/* Width and precision arguments come first */
+
+#define LOGM_SPRINTF(v) \
+		do { \
+			if (nstar == 2) { \
+				lib_sprintf(strm, cvt, star[0], star[1], v); \
+			} else if (nstar == 1) { \
+				lib_sprintf(strm, cvt, star[0], v); \
+			} else { \
+				lib_sprintf(strm, cvt, v); \
+			} \
+		} while (0)
+
+		switch (spec.type) {
+		case LOGM_ARG_INT:
+			LOGM_SPRINTF(val.i);
+			break;
+		case LOGM_ARG_LONG:
+			LOGM_SPRINTF(val.l);
+			break;
+		case LOGM_ARG_LLONG:
+			LOGM_SPRINTF(val.ll);
+			break;
+		case LOGM_ARG_SIZE:
+			LOGM_SPRINTF(val.z);
+			break;
+		case LOGM_ARG_PTR:
+		case LOGM_ARG_STR:
+			LOGM_SPRINTF(val.p);
+			break;
+		case LOGM_ARG_DOUBLE:
+			LOGM_SPRINTF(val.d);
+			break;
+		default:
+			break;
+		}
+#undef LOGM_SPRINTF
+	}
+}
@@ -0,0 +1,57 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/ioctl.h>
+#include <tinyara/logm.h>
+#include "logm.h"
+
+static int logm_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
+
+static const struct file_operations logm_fops = {
+	0,							/* open */
+	0,							/* close */
+	0,							/* read */
+	0,							/* write */
+	0,							/* seek */
+	logm_ioctl					/* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+	, 0							/* poll */
+#endif
+};
+
+static int logm_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+	switch (cmd) {
+	case LOGMIOC_SETMASK:
+		return logm_set_module((FAR const struct logm_module_s *)arg);
+	case LOGMIOC_GETMASK:
+		return logm_get_module((FAR struct logm_module_s *)arg);
+	default:
+		return -ENOTTY;
+	}
+}
+
+/* Register LOGM_DRVPATH which lets user tasks change the module masks */
+void logm_drv_register(void)
+{
+	(void)register_driver(LOGM_DRVPATH, &logm_fops, 0666, NULL);
+}
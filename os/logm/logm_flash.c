@@ -0,0 +1,403 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <assert.h>
+#include <crc32.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <semaphore.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <tinyara/clock.h>
+#include <tinyara/kthread.h>
+#include <tinyara/logm.h>
+#include <tinyara/semaphore.h>
+#ifdef CONFIG_LOGM_FLASH_LZMA
+#include "LzmaLib.h"
+#endif
+#include "logm.h"
+
+#define LOGM_FLASH_MAGIC 0x4d474f4c	/* "LOGM" */
+#define LOGM_FLASH_COMPRESSED 0x0001
+
+#define LOGM_FLASH_NSEGMENTS CONFIG_LOGM_FLASH_NSEGMENTS
+#define LOGM_FLASH_PAYLOAD (CONFIG_LOGM_FLASH_BLOCKSIZE - sizeof(struct logm_flash_blk_s))
+#define LOGM_FLASH_PATHLEN (sizeof(CONFIG_LOGM_FLASH_PATH) + 16)
+
+#ifdef CONFIG_LOGM_FLASH_LZMA
+#define LOGM_FLASH_LZMA_LEVEL 1
+#define LOGM_FLASH_LZMA_DICTSIZE (1 << 12)
+#endif
+
+/* Header of a block in a segment file.  A block counts only if its magic
+ * and crc match, so a block torn by a reset is the tail of the segment.
+ */
+struct logm_flash_blk_s {
+	uint32_t magic;
+	uint32_t seq;				/* Increases by one for every block */
+	uint16_t flags;
+	uint16_t len;				/* Length of the payload after the header */
+	uint32_t crc;				/* crc32 of the payload */
+};
+
+/* A block being collected in RAM, laid out as it is written */
+struct logm_flash_buf_s {
+	struct logm_flash_blk_s hdr;
+	char data[LOGM_FLASH_PAYLOAD];
+	int len;
+};
+
+/* Shared with the logm task, protected by g_flash_lock */
+static struct logm_flash_buf_s g_flash_buf[2];
+static int g_flash_fill;		/* Index of the buffer being filled */
+static bool g_flash_pending;	/* The other buffer waits for the writer */
+static int g_flash_dropped;		/* Bytes dropped while the writer was behind */
+static sem_t g_flash_lock = SEM_INITIALIZER(1);
+static sem_t g_flash_sem;
+
+/* Used only by the writer thread */
+static int g_flash_fd = -1;
+static int g_flash_seg;
+static int g_flash_segsize;
+static uint32_t g_flash_seq;
+#ifdef CONFIG_LOGM_FLASH_LZMA
+static struct logm_flash_buf_s g_flash_zbuf;
+#endif
+
+static void logm_flash_lock(void)
+{
+	while (sem_wait(&g_flash_lock) != OK) {
+		DEBUGASSERT(get_errno() == EINTR);
+	}
+}
+
+static void logm_flash_unlock(void)
+{
+	sem_post(&g_flash_lock);
+}
+
+static void logm_flash_path(FAR char *path, int seg)
+{
+	snprintf(path, LOGM_FLASH_PATHLEN, "%s/logm%d.log", CONFIG_LOGM_FLASH_PATH, seg);
+}
+
+/* Find the segment holding the newest block.  Returns -1 if there is none. */
+static int logm_flash_scan(FAR uint32_t *lastseq)
+{
+	char path[LOGM_FLASH_PATHLEN];
+	struct logm_flash_blk_s blk;
+	int newest = -1;
+	int seg;
+	int fd;
+
+	for (seg = 0; seg < LOGM_FLASH_NSEGMENTS; seg++) {
+		logm_flash_path(path, seg);
+		fd = open(path, O_RDONLY);
+		if (fd < 0) {
+			continue;
+		}
+
+		while (read(fd, &blk, sizeof(blk)) == sizeof(blk) && blk.magic == LOGM_FLASH_MAGIC) {
+			if (newest < 0 || (int32_t)(blk.seq - *lastseq) > 0) {
+				newest = seg;
+				*lastseq = blk.seq;
+			}
+			if (lseek(fd, blk.len, SEEK_CUR) < 0) {
+				break;
+			}
+		}
+		close(fd);
+	}
+
+	return newest;
+}
+
+/* Truncate the segment and append the following blocks to it */
+static int logm_flash_rotate(int seg)
+{
+	char path[LOGM_FLASH_PATHLEN];
+
+	if (g_flash_fd >= 0) {
+		close(g_flash_fd);
+	}
+
+	logm_flash_path(path, seg);
+	g_flash_fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (g_flash_fd < 0) {
+		return ERROR;
+	}
+
+	g_flash_seg = seg;
+	g_flash_segsize = 0;
+	return OK;
+}
+
+/* Every boot starts a new segment after the newest one */
+static int logm_flash_open(void)
+{
+	uint32_t lastseq = 0;
+	int newest;
+
+	(void)mkdir(CONFIG_LOGM_FLASH_PATH, 0777);
+
+	newest = logm_flash_scan(&lastseq);
+	if (newest < 0) {
+		g_flash_seq = 0;
+		return logm_flash_rotate(0);
+	}
+
+	g_flash_seq = lastseq + 1;
+	return logm_flash_rotate((newest + 1) % LOGM_FLASH_NSEGMENTS);
+}
+
+static int logm_flash_write(FAR struct logm_flash_buf_s *buf)
+{
+	FAR struct logm_flash_blk_s *blk = &buf->hdr;
+	ssize_t size;
+#ifdef CONFIG_LOGM_FLASH_LZMA
+	size_t zlen = LOGM_FLASH_PAYLOAD - LZMA_PROPS_SIZE;
+	size_t propslen = LZMA_PROPS_SIZE;
+#endif
+
+	if (g_flash_fd < 0 && logm_flash_open() != OK) {
+		/* The file system is not mounted yet, keep the block and retry later */
+		return ERROR;
+	}
+
+	blk->flags = 0;
+	blk->len = buf->len;
+#ifdef CONFIG_LOGM_FLASH_LZMA
+	/* The properties are stored in front of the compressed data.  Keep the
+	 * text as it is if it does not get smaller.
+	 */
+	if (LzmaCompress((FAR unsigned char *)g_flash_zbuf.data + LZMA_PROPS_SIZE, &zlen, (FAR const unsigned char *)buf->data, buf->len, (FAR unsigned char *)g_flash_zbuf.data, &propslen, LOGM_FLASH_LZMA_LEVEL, LOGM_FLASH_LZMA_DICTSIZE, 3, 0, 2, 32, 1) == SZ_OK && LZMA_PROPS_SIZE + zlen < buf->len) {
+		blk = &g_flash_zbuf.hdr;
+		blk->flags = LOGM_FLASH_COMPRESSED;
+		blk->len = LZMA_PROPS_SIZE + zlen;
+	}
+#endif
+	blk->magic = LOGM_FLASH_MAGIC;
+	blk->seq = g_flash_seq;
+	blk->crc = crc32((FAR const uint8_t *)(blk + 1), blk->len);
+	size = sizeof(struct logm_flash_blk_s) + blk->len;
+
+	if (g_flash_segsize > 0 && g_flash_segsize + size > CONFIG_LOGM_FLASH_SEGSIZE) {
+		if (logm_flash_rotate((g_flash_seg + 1) % LOGM_FLASH_NSEGMENTS) != OK) {
+			return ERROR;
+		}
+	}
+
+	/* The whole block goes down in one write */
+	if (write(g_flash_fd, blk, size) != size) {
+		/* Start over with a fresh segment next time */
+		close(g_flash_fd);
+		g_flash_fd = -1;
+		return ERROR;
+	}
+	(void)fsync(g_flash_fd);
+
+	g_flash_segsize += size;
+	g_flash_seq++;
+	return OK;
+}
+
+/* Hand the buffer being filled to the writer.  Called with the lock held. */
+static void logm_flash_swap(void)
+{
+	FAR struct logm_flash_buf_s *buf;
+
+	g_flash_pending = true;
+	g_flash_fill ^= 1;
+
+	buf = &g_flash_buf[g_flash_fill];
+	buf->len = 0;
+	if (g_flash_dropped > 0) {
+		buf->len = snprintf(buf->data, LOGM_FLASH_PAYLOAD, "\n[LOGM FLASH] %d bytes are dropped\n", g_flash_dropped);
+		g_flash_dropped = 0;
+	}
+
+	sem_post(&g_flash_sem);
+}
+
+static int logm_flash_thread(int argc, char *argv[])
+{
+	FAR struct logm_flash_buf_s *buf;
+	bool timeout;
+
+	while (1) {
+		timeout = sem_tickwait(&g_flash_sem, clock_systimer(), SEC2TICK(CONFIG_LOGM_FLASH_INTERVAL)) != OK;
+
+		logm_flash_lock();
+		if (timeout && !g_flash_pending && g_flash_buf[g_flash_fill].len > 0) {
+			/* Write out a partial block to bound the loss on a reset */
+			logm_flash_swap();
+		}
+		buf = g_flash_pending ? &g_flash_buf[g_flash_fill ^ 1] : NULL;
+		logm_flash_unlock();
+
+		if (buf == NULL || logm_flash_write(buf) != OK) {
+			continue;
+		}
+
+		logm_flash_lock();
+		g_flash_pending = false;
+		if (g_flash_buf[g_flash_fill].len == LOGM_FLASH_PAYLOAD) {
+			logm_flash_swap();
+		}
+		logm_flash_unlock();
+	}
+
+	return 0;
+}
+
+/* Called by the logm task.  This never waits for the flash. */
+static ssize_t logm_flash_sink_write(FAR struct logm_sink_s *sink, FAR const char *buf, size_t len)
+{
+	FAR struct logm_flash_buf_s *fill;
+	size_t remain = len;
+	size_t n;
+
+	logm_flash_lock();
+	while (remain > 0) {
+		fill = &g_flash_buf[g_flash_fill];
+		if (fill->len == LOGM_FLASH_PAYLOAD) {
+			if (g_flash_pending) {
+				g_flash_dropped += remain;
+				break;
+			}
+			logm_flash_swap();
+			continue;
+		}
+
+		n = LOGM_FLASH_PAYLOAD - fill->len;
+		if (n > remain) {
+			n = remain;
+		}
+		memcpy(fill->data + fill->len, buf, n);
+		fill->len += n;
+		buf += n;
+		remain -= n;
+	}
+
+	if (g_flash_buf[g_flash_fill].len == LOGM_FLASH_PAYLOAD && !g_flash_pending) {
+		logm_flash_swap();
+	}
+	logm_flash_unlock();
+
+	return len;
+}
+
+static struct logm_sink_s g_logm_flash = {
+	NULL, "flash", logm_flash_sink_write
+};
+
+void logm_flash_initialize(void)
+{
+	int pid;
+
+	sem_init(&g_flash_sem, 0, 0);
+	sem_setprotocol(&g_flash_sem, SEM_PRIO_NONE);
+
+	pid = kernel_thread("logm_flash", CONFIG_LOGM_FLASH_PRIORITY, CONFIG_LOGM_FLASH_STACKSIZE, logm_flash_thread, NULL);
+	if (pid < 0) {
+		return;
+	}
+
+	(void)logm_register_sink(&g_logm_flash);
+}
+
+/* Print the saved messages to stdout, oldest segment first */
+int logm_flash_dump(void)
+{
+	char path[LOGM_FLASH_PATHLEN];
+	struct logm_flash_blk_s blk;
+	FAR char *data;
+	uint32_t lastseq = 0;
+	int newest;
+	int seg;
+	int fd;
+	int i;
+#ifdef CONFIG_LOGM_FLASH_LZMA
+	FAR char *text;
+	size_t textlen;
+	SizeT srclen;
+#endif
+
+	newest = logm_flash_scan(&lastseq);
+	if (newest < 0) {
+		return -ENOENT;
+	}
+
+	data = (FAR char *)malloc(LOGM_FLASH_PAYLOAD);
+	if (data == NULL) {
+		return -ENOMEM;
+	}
+#ifdef CONFIG_LOGM_FLASH_LZMA
+	text = (FAR char *)malloc(LOGM_FLASH_PAYLOAD);
+	if (text == NULL) {
+		free(data);
+		return -ENOMEM;
+	}
+#endif
+
+	for (i = 1; i <= LOGM_FLASH_NSEGMENTS; i++) {
+		seg = (newest + i) % LOGM_FLASH_NSEGMENTS;
+		logm_flash_path(path, seg);
+		fd = open(path, O_RDONLY);
+		if (fd < 0) {
+			continue;
+		}
+
+		while (read(fd, &blk, sizeof(blk)) == sizeof(blk)) {
+			if (blk.magic != LOGM_FLASH_MAGIC || blk.len > LOGM_FLASH_PAYLOAD) {
+				break;
+			}
+			if (read(fd, data, blk.len) != blk.len || crc32((FAR const uint8_t *)data, blk.len) != blk.crc) {
+				/* Torn by a reset while it was written */
+				break;
+			}
+#ifdef CONFIG_LOGM_FLASH_LZMA
+			if (blk.flags & LOGM_FLASH_COMPRESSED) {
+				textlen = LOGM_FLASH_PAYLOAD;
+				srclen = blk.len - LZMA_PROPS_SIZE;
+				if (LzmaUncompress((FAR unsigned char *)text, &textlen, (FAR const unsigned char *)data + LZMA_PROPS_SIZE, &srclen, (FAR const unsigned char *)data, LZMA_PROPS_SIZE) != SZ_OK) {
+					break;
+				}
+				fwrite(text, 1, textlen, stdout);
+				continue;
+			}
+#endif
+			fwrite(data, 1, blk.len, stdout);
+		}
+		close(fd);
+	}
+	fflush(stdout);
+
+#ifdef CONFIG_LOGM_FLASH_LZMA
+	free(text);
+#endif
+	free(data);
+	return OK;
+}
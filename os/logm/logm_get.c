@@ -15,9 +15,22 @@
  * language governing permissions and limitations under the License.
  *
  ****************************************************************************/
+#include <tinyara/config.h>
+#include <errno.h>
+#include <stdint.h>
 #include <tinyara/logm.h>
+#ifdef CONFIG_LOGM_STATS
+#include <tinyara/arch.h>
+#endif
 #include "logm.h"
 
+#ifdef CONFIG_LOGM_STATS
+static int logm_perf_to_ns(uint32_t cycles)
+{
+	return (int)((uint64_t)cycles * 1000000000 / up_perf_getfreq());
+}
+#endif
+
 /* This will be moved to upper layer or changed for protected build  */
 /* Refer logm_param_type_e for getparam values */
 int logm_get_values(enum logm_param_type_e type, int *value)
@@ -29,9 +42,42 @@ int logm_get_values(enum logm_param_type_e type, int *value)
 	case LOGM_INTERVAL:
 		*value = (int)(logm_print_interval / 1000);
 		break;
+	case LOGM_DEFERRED:
+#ifdef CONFIG_LOGM_DEFERRED
+		*value = g_logm_deferred ? 1 : 0;
+#else
+		*value = 0;
+#endif
+		break;
+	case LOGM_IRQOFF_MAX:
+#ifdef CONFIG_LOGM_STATS
+		*value = logm_perf_to_ns(g_logm_irqoff_max);
+#else
+		*value = 0;
+#endif
+		break;
+	case LOGM_IRQOFF_AVG:
+#ifdef CONFIG_LOGM_STATS
+		*value = g_logm_irqoff_count ? logm_perf_to_ns(g_logm_irqoff_total / g_logm_irqoff_count) : 0;
+#else
+		*value = 0;
+#endif
+		break;
 	default:
 		break;
 	}
 
 	return 0;					// for now, to keep compiler happy
 }
+
+/* Get the priorities enabled for a module and its suppressed messages */
+int logm_get_module(FAR struct logm_module_s *module)
+{
+	if (module == NULL || (unsigned)module->index >= LOGM_INDEX_MAX) {
+		return -EINVAL;
+	}
+
+	module->mask = ~g_logm_modoff[module->index];
+	module->suppressed = g_logm_suppressed[module->index];
+	return OK;
+}
@@ -19,10 +19,14 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <semaphore.h>
 #include <sys/types.h>
 #include <arch/irq.h>
 #include <tinyara/logm.h>
 #include <tinyara/config.h>
+#include <tinyara/clock.h>
+#include <tinyara/semaphore.h>
+#include <tinyara/streams.h>
 #include "logm.h"
 #ifdef CONFIG_LOGM_TEST
 #include "logm_test.h"
@@ -32,6 +36,10 @@ uint8_t logm_status;
 int logm_bufsize = LOGM_BUFFER_SIZE;
 char * g_logm_rsvbuf = NULL;
 volatile int logm_print_interval = LOGM_PRINT_INTERVAL * 1000;
+sem_t g_logm_drain_sem;
+#ifdef CONFIG_LOGM_DEFERRED
+static struct logm_sinkstream_s g_logm_strm;
+#endif
 
 static int logm_change_bufsize(int buflen)
 {
@@ -62,10 +70,129 @@ static int logm_change_bufsize(int buflen)
 	return OK;
 }
 
+#ifdef CONFIG_LOGM_DEFERRED
+static void logm_copyout(int pos, FAR char *data, int len)
+{
+	int first = logm_bufsize - pos;
+
+	if (first > len) {
+		first = len;
+	}
+	memcpy(data, &g_logm_rsvbuf[pos], first);
+	memcpy(data + first, g_logm_rsvbuf, len - first);
+}
+
+/* Remove the oldest record from the buffer and write it out to strm.  If
+ * write is given, already formatted text is passed to it in at most two
+ * segments instead of going through strm character by character.
+ */
+void logm_drain_record(FAR struct lib_outstream_s *strm, CODE void (*write)(FAR const char *buf, size_t len))
+{
+	struct logm_rec_s hdr;
+	char args[LOGM_RECORD_SIZE];
+	int pos;
+	int len;
+	int first;
+
+	logm_copyout(g_logm_head, (FAR char *)&hdr, sizeof(struct logm_rec_s));
+	pos = (g_logm_head + sizeof(struct logm_rec_s)) % logm_bufsize;
+	len = hdr.len - sizeof(struct logm_rec_s);
+
+#ifdef CONFIG_LOGM_TIMESTAMP
+	(void)lib_sprintf(strm, "[%4d.%4d] ", hdr.ts.tv_sec, hdr.ts.tv_nsec / 100000);
+#endif
+
+	if (hdr.fmt == NULL && write != NULL) {
+		/* Already formatted text, split only where it wraps around */
+		first = logm_bufsize - pos;
+		if (first > len) {
+			first = len;
+		}
+		write(&g_logm_rsvbuf[pos], first);
+		if (len > first) {
+			write(g_logm_rsvbuf, len - first);
+		}
+	} else if (hdr.fmt == NULL) {
+		/* Already formatted text */
+		while (len-- > 0) {
+			strm->put(strm, g_logm_rsvbuf[pos]);
+			pos = (pos + 1) % logm_bufsize;
+		}
+	} else {
+		/* Copy the arguments out first, the record may wrap around */
+		logm_copyout(pos, args, len);
+		logm_deferred_format(strm, hdr.fmt, args, len);
+	}
+
+	g_logm_head = (g_logm_head + hdr.len) % logm_bufsize;
+	if (LOGM_STATUS(LOGM_BUFFER_OVERFLOW)) {
+		LOGM_STATUS_CLEAR(LOGM_BUFFER_OVERFLOW);
+	}
+	if (g_logm_overflow_offset >= 0 && g_logm_overflow_offset == g_logm_head) {
+		(void)lib_sprintf(strm, "\n[LOGM BUFFER OVERFLOW] %d messages are dropped\n", g_logm_dropmsg_count);
+		g_logm_overflow_offset = -1;
+	}
+}
+
+static void logm_write_segment(FAR const char *buf, size_t len)
+{
+	/* Keep the order with the text buffered in the stream */
+	logm_sinkstream_flush(&g_logm_strm);
+	logm_sink_write(buf, len);
+}
+
+static void logm_drain(void)
+{
+	while (g_logm_head != g_logm_tail) {
+		logm_drain_record(&g_logm_strm.public, logm_write_segment);
+	}
+	logm_sinkstream_flush(&g_logm_strm);
+}
+#else
+/* Hand the text between head and tail to the sinks in contiguous segments,
+ * two per wrap of the buffer plus one more at the overflow point.
+ */
+static void logm_drain(void)
+{
+	char msg[64];
+	int tail;
+	int end;
+	int len;
+
+	while (g_logm_head != (tail = g_logm_tail)) {
+		end = (tail < g_logm_head) ? logm_bufsize : tail;
+		if (g_logm_overflow_offset > g_logm_head && g_logm_overflow_offset < end) {
+			end = g_logm_overflow_offset;
+		}
+
+		logm_sink_write(&g_logm_rsvbuf[g_logm_head], end - g_logm_head);
+		g_logm_head = end % logm_bufsize;
+
+		if (LOGM_STATUS(LOGM_BUFFER_OVERFLOW)) {
+			LOGM_STATUS_CLEAR(LOGM_BUFFER_OVERFLOW);
+		}
+		if (g_logm_overflow_offset >= 0 && g_logm_overflow_offset == g_logm_head) {
+			len = snprintf(msg, sizeof(msg), "\n[LOGM BUFFER OVERFLOW] %d messages are dropped\n", g_logm_dropmsg_count);
+			logm_sink_write(msg, len);
+			g_logm_overflow_offset = -1;
+		}
+	}
+}
+#endif
+
 int logm_task(int argc, char *argv[])
 {
 	irqstate_t flags;
 
+#ifdef CONFIG_LOGM_DEFERRED
+	logm_sinkstream(&g_logm_strm);
+#endif
+	logm_sink_initialize();
+
+	/* The semaphore is used for signaling, no priority inheritance */
+	sem_init(&g_logm_drain_sem, 0, 0);
+	sem_setprotocol(&g_logm_drain_sem, SEM_PRIO_NONE);
+
 	g_logm_rsvbuf = (char *)malloc(logm_bufsize);
 	memset(g_logm_rsvbuf, 0, logm_bufsize);
 
@@ -77,17 +204,12 @@ int logm_task(int argc, char *argv[])
 #endif
 
 	while (1) {
-		while (g_logm_head != g_logm_tail) {
-			fputc(g_logm_rsvbuf[g_logm_head], stdout);
-			g_logm_head = (g_logm_head + 1) % logm_bufsize;
-			if (LOGM_STATUS(LOGM_BUFFER_OVERFLOW)) {
-				LOGM_STATUS_CLEAR(LOGM_BUFFER_OVERFLOW);
-			}
-			if (g_logm_overflow_offset >= 0 && g_logm_overflow_offset == g_logm_head) {
-				fprintf(stdout, "\n[LOGM BUFFER OVERFLOW] %d messages are dropped\n", g_logm_dropmsg_count);
-				g_logm_overflow_offset = -1;
-			}
-		}
+		/* Writers posting from now on will wake us up again */
+		flags = irqsave();
+		LOGM_STATUS_CLEAR(LOGM_DRAIN_REQ);
+		irqrestore(flags);
+
+		logm_drain();
 
 		if (LOGM_STATUS(LOGM_BUFFER_RESIZE_REQ)) {
 			flags = irqsave();
@@ -96,7 +218,9 @@ int logm_task(int argc, char *argv[])
 			}
 			irqrestore(flags);
 		}
-		usleep(logm_print_interval);
+
+		/* Sleep until the buffer fills over the threshold or the interval expires */
+		(void)sem_tickwait(&g_logm_drain_sem, clock_systimer(), USEC2TICK(logm_print_interval));
 	}
 	return 0;					// Just to make compiler happy
 }
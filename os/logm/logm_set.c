@@ -15,6 +15,8 @@
  * language governing permissions and limitations under the License.
  *
  ****************************************************************************/
+#include <tinyara/config.h>
+#include <errno.h>
 #include <tinyara/logm.h>
 #include "logm.h"
 
@@ -32,9 +34,33 @@ int logm_set_values(enum logm_param_type_e type, int value)
 	case LOGM_INTERVAL:
 		logm_print_interval = value * 1000;
 		break;
+#ifdef CONFIG_LOGM_DEFERRED
+	case LOGM_DEFERRED:
+		g_logm_deferred = (value != 0);
+		break;
+#endif
+#ifdef CONFIG_LOGM_STATS
+	case LOGM_IRQOFF_MAX:
+		/* Any value restarts the measurement */
+		g_logm_irqoff_max = 0;
+		g_logm_irqoff_total = 0;
+		g_logm_irqoff_count = 0;
+		break;
+#endif
 	default:
 		break;
 	}
 
 	return 0;					// for now, to keep compiler happy
 }
+
+/* Set the priorities enabled for a module */
+int logm_set_module(FAR const struct logm_module_s *module)
+{
+	if (module == NULL || (unsigned)module->index >= LOGM_INDEX_MAX) {
+		return -EINVAL;
+	}
+
+	g_logm_modoff[module->index] = ~module->mask;
+	return OK;
+}
@@ -0,0 +1,207 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <semaphore.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <tinyara/logm.h>
+#include <tinyara/streams.h>
+#ifdef CONFIG_LOGM_SINK_RAMLOG
+#include <tinyara/syslog/ramlog.h>
+#endif
+#include "logm.h"
+
+#if defined(CONFIG_LOGM_SINK_RAMLOG) && defined(CONFIG_SYSLOG_DEVPATH)
+#define LOGM_RAMLOG_PATH CONFIG_SYSLOG_DEVPATH
+#else
+#define LOGM_RAMLOG_PATH "/dev/ramlog"
+#endif
+
+/* A sink which writes to a file or a character device, opened on first use */
+struct logm_pathsink_s {
+	struct logm_sink_s public;
+	FAR const char *path;
+	int fd;
+};
+
+static FAR struct logm_sink_s *g_logm_sinks;
+static sem_t g_logm_sink_sem = SEM_INITIALIZER(1);
+
+static void logm_sink_lock(void)
+{
+	while (sem_wait(&g_logm_sink_sem) != OK) {
+		DEBUGASSERT(get_errno() == EINTR);
+	}
+}
+
+static void logm_sink_unlock(void)
+{
+	sem_post(&g_logm_sink_sem);
+}
+
+#ifdef CONFIG_LOGM_SINK_CONSOLE
+static ssize_t logm_console_write(FAR struct logm_sink_s *sink, FAR const char *buf, size_t len)
+{
+	/* Bypass the stdout stream, the text is already buffered by logm */
+	return write(1, buf, len);
+}
+
+static struct logm_sink_s g_logm_console = {
+	NULL, "console", logm_console_write
+};
+#endif
+
+#if defined(CONFIG_LOGM_SINK_RAMLOG) || defined(CONFIG_LOGM_SINK_FILE)
+static ssize_t logm_path_write(FAR struct logm_sink_s *sink, FAR const char *buf, size_t len)
+{
+	FAR struct logm_pathsink_s *psink = (FAR struct logm_pathsink_s *)sink;
+
+	if (psink->fd < 0) {
+		/* The file system may not be mounted yet, try again next time */
+		psink->fd = open(psink->path, O_WRONLY | O_CREAT | O_APPEND, 0666);
+		if (psink->fd < 0) {
+			return ERROR;
+		}
+	}
+
+	return write(psink->fd, buf, len);
+}
+#endif
+
+#ifdef CONFIG_LOGM_SINK_RAMLOG
+static struct logm_pathsink_s g_logm_ramlog = {
+	{NULL, "ramlog", logm_path_write}, LOGM_RAMLOG_PATH, -1
+};
+#endif
+
+#ifdef CONFIG_LOGM_SINK_FILE
+static struct logm_pathsink_s g_logm_file = {
+	{NULL, "file", logm_path_write}, CONFIG_LOGM_SINK_FILE_PATH, -1
+};
+#endif
+
+static void logm_sinkstream_putc(FAR struct lib_outstream_s *this, int ch)
+{
+	FAR struct logm_sinkstream_s *strm = (FAR struct logm_sinkstream_s *)this;
+
+	strm->buf[strm->len++] = ch;
+	this->nput++;
+	if (strm->len == LOGM_SINK_BUFSIZE) {
+		logm_sinkstream_flush(strm);
+	}
+}
+
+int logm_register_sink(FAR struct logm_sink_s *sink)
+{
+	FAR struct logm_sink_s *curr;
+
+	if (sink == NULL || sink->write == NULL) {
+		return -EINVAL;
+	}
+
+	logm_sink_lock();
+	for (curr = g_logm_sinks; curr != NULL; curr = curr->flink) {
+		if (curr == sink) {
+			logm_sink_unlock();
+			return -EEXIST;
+		}
+	}
+	sink->flink = g_logm_sinks;
+	g_logm_sinks = sink;
+	logm_sink_unlock();
+
+	return OK;
+}
+
+int logm_unregister_sink(FAR struct logm_sink_s *sink)
+{
+	FAR struct logm_sink_s **prev;
+
+	logm_sink_lock();
+	for (prev = &g_logm_sinks; *prev != NULL; prev = &(*prev)->flink) {
+		if (*prev == sink) {
+			*prev = sink->flink;
+			sink->flink = NULL;
+			logm_sink_unlock();
+			return OK;
+		}
+	}
+	logm_sink_unlock();
+
+	return -ENOENT;
+}
+
+/* Register the sinks selected in the configuration */
+void logm_sink_initialize(void)
+{
+#ifdef CONFIG_LOGM_SINK_FLASH
+	logm_flash_initialize();
+#endif
+#ifdef CONFIG_LOGM_SINK_FILE
+	(void)logm_register_sink(&g_logm_file.public);
+#endif
+#ifdef CONFIG_LOGM_SINK_RAMLOG
+	(void)logm_register_sink(&g_logm_ramlog.public);
+#endif
+#ifdef CONFIG_LOGM_SINK_CONSOLE
+	(void)logm_register_sink(&g_logm_console);
+#endif
+}
+
+/* Hand a segment of text to every sink */
+void logm_sink_write(FAR const char *buf, size_t len)
+{
+	FAR struct logm_sink_s *sink;
+	ssize_t nwritten;
+	size_t remain;
+
+	logm_sink_lock();
+	for (sink = g_logm_sinks; sink != NULL; sink = sink->flink) {
+		for (remain = len; remain > 0; remain -= nwritten) {
+			nwritten = sink->write(sink, buf + len - remain, remain);
+			if (nwritten <= 0) {
+				/* Drop the rest for this sink rather than blocking the others */
+				break;
+			}
+		}
+	}
+	logm_sink_unlock();
+}
+
+/* Initialize a stream which buffers formatted text for the sinks */
+void logm_sinkstream(FAR struct logm_sinkstream_s *strm)
+{
+	strm->public.put = logm_sinkstream_putc;
+#ifdef CONFIG_STDIO_LINEBUFFER
+	strm->public.flush = lib_noflush;
+#endif
+	strm->public.nput = 0;
+	strm->len = 0;
+}
+
+void logm_sinkstream_flush(FAR struct logm_sinkstream_s *strm)
+{
+	if (strm->len > 0) {
+		logm_sink_write(strm->buf, strm->len);
+		strm->len = 0;
+	}
+}
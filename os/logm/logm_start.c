@@ -28,6 +28,8 @@ void logm_start(void)
 		return;
 	}
 
+	logm_drv_register();
+
 #ifdef CONFIG_TASH
 	/* Register tash commands for logm */
 	logm_register_tashcmds();
@@ -25,6 +25,11 @@
 
 static int logm_tash(int argc, char **args);
 
+static const char *g_logm_modnames[LOGM_INDEX_MAX] = {
+	"unknown", "sched", "mm", "fs", "net", "binary",
+	"drivers", "audio", "media", "pm", "lib", "framework"
+};
+
 const static tash_cmdlist_t logm_tashmds[] = {
 	{"logm", logm_tash, TASH_EXECMD_SYNC},
 	{NULL, NULL, 0}
@@ -38,20 +43,73 @@ void logm_register_tashcmds(void)
 static void logm_usage(void)
 {
 	fprintf(stdout, "[LOGM USAGE]\n");
-	fprintf(stdout, "usage: logm [-b <BUFSIZE>] [-i <TIME>]\n");
+	fprintf(stdout, "usage: logm [-b <BUFSIZE>] [-i <TIME>] [-d <0|1>] [-r] [-f] [-l <MODULE:LEVEL>]\n");
 
 	fprintf(stdout, "options:\n");
 	fprintf(stdout, "    -b BUFSIZE\n");
 	fprintf(stdout, "        Set logm buffer size (bytes)\n");
 	fprintf(stdout, "    -i TIME\n");
 	fprintf(stdout, "        Set buffer flusing interval (ms)\n");
+	fprintf(stdout, "    -l MODULE:LEVEL\n");
+	fprintf(stdout, "        Drop messages of MODULE less important than LEVEL (0-7),\n");
+	fprintf(stdout, "        before they are formatted. \"all\" selects every module.\n");
+#ifdef CONFIG_LOGM_DEFERRED
+	fprintf(stdout, "    -d 0|1\n");
+	fprintf(stdout, "        Format messages immediately (0) or in the logm task (1)\n");
+#endif
+#ifdef CONFIG_LOGM_STATS
+	fprintf(stdout, "    -r\n");
+	fprintf(stdout, "        Reset interrupt disabled time statistics\n");
+#endif
+#ifdef CONFIG_LOGM_SINK_FLASH
+	fprintf(stdout, "    -f\n");
+	fprintf(stdout, "        Print the messages saved in the flash\n");
+#endif
+
+}
+
+static int logm_set_level(char *arg)
+{
+	struct logm_module_s module;
+	char *level;
+	int index;
+	int ret = ERROR;
 
+	level = strchr(arg, ':');
+	if (level == NULL) {
+		return ERROR;
+	}
+	*level++ = '\0';
+
+	module.mask = LOGM_UPTO(atoi(level));
+	for (index = 0; index < LOGM_INDEX_MAX; index++) {
+		if (strcmp(arg, "all") == 0 || strcmp(arg, g_logm_modnames[index]) == 0) {
+			module.index = index;
+			ret = logm_set_module(&module);
+		}
+	}
+
+	return ret;
+}
+
+static void logm_modules_info(void)
+{
+	struct logm_module_s module;
+
+	fprintf(stdout, "  %-10s %6s %10s\n", "Module", "Mask", "Suppressed");
+	for (module.index = 0; module.index < LOGM_INDEX_MAX; module.index++) {
+		logm_get_module(&module);
+		fprintf(stdout, "  %-10s   0x%02x %10u\n", g_logm_modnames[module.index], module.mask, module.suppressed);
+	}
 }
 
 static void logm_info(void)
 {
 	int bufsize;
 	int interval;
+#if defined(CONFIG_LOGM_DEFERRED) || defined(CONFIG_LOGM_STATS)
+	int value;
+#endif
 
 	logm_get_values(LOGM_BUFSIZE, &bufsize);
 	logm_get_values(LOGM_INTERVAL, &interval);
@@ -59,6 +117,17 @@ static void logm_info(void)
 	fprintf(stdout, "[LOGM CONFIGURATIONS]\n");
 	fprintf(stdout, "  Buffer size : %d (bytes)\n", bufsize);
 	fprintf(stdout, "  Flusing interval : %d (ms)\n", interval);
+#ifdef CONFIG_LOGM_DEFERRED
+	logm_get_values(LOGM_DEFERRED, &value);
+	fprintf(stdout, "  Deferred formatting : %s\n", value ? "on" : "off");
+#endif
+#ifdef CONFIG_LOGM_STATS
+	logm_get_values(LOGM_IRQOFF_MAX, &value);
+	fprintf(stdout, "  IRQ disabled time : max %d (ns)", value);
+	logm_get_values(LOGM_IRQOFF_AVG, &value);
+	fprintf(stdout, ", avg %d (ns)\n", value);
+#endif
+	logm_modules_info();
 }
 
 static int logm_tash(int argc, char **args)
@@ -82,8 +151,12 @@ static int logm_tash(int argc, char **args)
 	/*
 	 * -b [bufsize] : set buffer size (bytes)
 	 * -i [time] : set buffer flushing interval (ms)
+	 * -d [0|1] : format messages immediately or in the logm task
+	 * -r : reset interrupt disabled time statistics
+	 * -f : print the messages saved in the flash
+	 * -l [module:level] : drop messages of module less important than level
 	 */
-	while ((opt = getopt(argc, args, "b:i:")) != -1) {
+	while ((opt = getopt(argc, args, "b:i:d:rfl:")) != -1) {
 		switch (opt) {
 		case 'b':
 			/* TASH>> logm -b 10240 */
@@ -100,6 +173,35 @@ static int logm_tash(int argc, char **args)
 				logm_set_values(LOGM_INTERVAL, atoi(optarg));
 			}
 			break;
+		case 'd':
+			/* TASH>> logm -d 1 */
+			/* format messages in the logm task */
+			if (optarg != NULL) {
+				logm_set_values(LOGM_DEFERRED, atoi(optarg));
+			}
+			break;
+		case 'r':
+			/* TASH>> logm -r */
+			/* restart measuring interrupt disabled time */
+			logm_set_values(LOGM_IRQOFF_MAX, 0);
+			break;
+#ifdef CONFIG_LOGM_SINK_FLASH
+		case 'f':
+			/* TASH>> logm -f */
+			/* print the messages saved before the last reset */
+			if (logm_flash_dump() != OK) {
+				fprintf(stdout, "No saved messages\n");
+			}
+			break;
+#endif
+		case 'l':
+			/* TASH>> logm -l net:3 */
+			/* keep only errors and more important messages of network */
+			if (optarg == NULL || logm_set_level(optarg) != OK) {
+				logm_usage();
+				return 0;
+			}
+			break;
 		default:
 			logm_usage();
 			return 0;
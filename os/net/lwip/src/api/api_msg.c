@@ -370,6 +370,10 @@ static err_t sent_tcp(void *arg, struct tcp_pcb *pcb, u16_t len)
 			conn->flags &= ~NETCONN_FLAG_CHECK_WRITESPACE;
 			API_EVENT(conn, NETCONN_EVT_SENDPLUS, len);
 		}
+#if LWIP_ZEROCOPY
+		/* acknowledged segments are freed, data sent by reference may be done */
+		API_EVENT(conn, NETCONN_EVT_ACKED, len);
+#endif
 	}
 
 	return ERR_OK;
@@ -1361,52 +1365,69 @@ void lwip_netconn_do_listen(void *m)
 #endif							/* LWIP_TCP */
 
 /**
- * Send some data on a RAW or UDP pcb contained in a netconn
- * Called from netconn_send
+ * Send a netbuf on a RAW or UDP pcb contained in a netconn.
+ * Must be called from the tcpip thread, used by lwip_netconn_do_send and
+ * by lwip_sendmmsg for a batch of datagrams.
  *
- * @param m the api_msg_msg pointing to the connection
+ * @param conn the netconn to send on
+ * @param b the netbuf to send
+ * @return ERR_OK if the datagram was sent, another err_t if not
  */
-void lwip_netconn_do_send(void *m)
+err_t lwip_netconn_send_netbuf(struct netconn *conn, struct netbuf *b)
 {
-	struct api_msg *msg = (struct api_msg *)m;
+	err_t err;
 
-	if (ERR_IS_FATAL(msg->conn->last_err)) {
-		msg->err = msg->conn->last_err;
-	} else {
-		msg->err = ERR_CONN;
-		if (msg->conn->pcb.tcp != NULL) {
-			switch (NETCONNTYPE_GROUP(msg->conn->type)) {
+	if (ERR_IS_FATAL(conn->last_err)) {
+		return conn->last_err;
+	}
+
+	err = ERR_CONN;
+	if (conn->pcb.tcp != NULL) {
+		switch (NETCONNTYPE_GROUP(conn->type)) {
 #if LWIP_RAW
-			case NETCONN_RAW:
-				if (ip_addr_isany(&msg->msg.b->addr) || IP_IS_ANY_TYPE_VAL(msg->msg.b->addr)) {
-					msg->err = raw_send(msg->conn->pcb.raw, msg->msg.b->p);
-				} else {
-					msg->err = raw_sendto(msg->conn->pcb.raw, msg->msg.b->p, &msg->msg.b->addr);
-				}
-				break;
+		case NETCONN_RAW:
+			if (ip_addr_isany(&b->addr) || IP_IS_ANY_TYPE_VAL(b->addr)) {
+				err = raw_send(conn->pcb.raw, b->p);
+			} else {
+				err = raw_sendto(conn->pcb.raw, b->p, &b->addr);
+			}
+			break;
 #endif
 #if LWIP_UDP
-			case NETCONN_UDP:
+		case NETCONN_UDP:
 #if LWIP_CHECKSUM_ON_COPY
-				if (ip_addr_isany(&msg->msg.b->addr) || IP_IS_ANY_TYPE_VAL(msg->msg.b->addr)) {
-					msg->err = udp_send_chksum(msg->conn->pcb.udp, msg->msg.b->p, msg->msg.b->flags & NETBUF_FLAG_CHKSUM, msg->msg.b->toport_chksum);
-				} else {
-					msg->err = udp_sendto_chksum(msg->conn->pcb.udp, msg->msg.b->p, &msg->msg.b->addr, msg->msg.b->port, msg->msg.b->flags & NETBUF_FLAG_CHKSUM, msg->msg.b->toport_chksum);
-				}
+			if (ip_addr_isany(&b->addr) || IP_IS_ANY_TYPE_VAL(b->addr)) {
+				err = udp_send_chksum(conn->pcb.udp, b->p, b->flags & NETBUF_FLAG_CHKSUM, b->toport_chksum);
+			} else {
+				err = udp_sendto_chksum(conn->pcb.udp, b->p, &b->addr, b->port, b->flags & NETBUF_FLAG_CHKSUM, b->toport_chksum);
+			}
 #else							/* LWIP_CHECKSUM_ON_COPY */
-				if (ip_addr_isany_val(msg->msg.b->addr) || IP_IS_ANY_TYPE_VAL(msg->msg.b->addr)) {
-					msg->err = udp_send(msg->conn->pcb.udp, msg->msg.b->p);
-				} else {
-					msg->err = udp_sendto(msg->conn->pcb.udp, msg->msg.b->p, &msg->msg.b->addr, msg->msg.b->port);
-				}
+			if (ip_addr_isany_val(b->addr) || IP_IS_ANY_TYPE_VAL(b->addr)) {
+				err = udp_send(conn->pcb.udp, b->p);
+			} else {
+				err = udp_sendto(conn->pcb.udp, b->p, &b->addr, b->port);
+			}
 #endif							/* LWIP_CHECKSUM_ON_COPY */
-				break;
+			break;
 #endif							/* LWIP_UDP */
-			default:
-				break;
-			}
+		default:
+			break;
 		}
 	}
+	return err;
+}
+
+/**
+ * Send some data on a RAW or UDP pcb contained in a netconn
+ * Called from netconn_send
+ *
+ * @param m the api_msg_msg pointing to the connection
+ */
+void lwip_netconn_do_send(void *m)
+{
+	struct api_msg *msg = (struct api_msg *)m;
+
+	msg->err = lwip_netconn_send_netbuf(msg->conn, msg->msg.b);
 	TCPIP_APIMSG_ACK(msg);
 }
 
@@ -60,6 +60,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <unistd.h>
 #include <netinet/in.h>
 #include <net/if.h>
 #include <net/lwip/netif.h>
@@ -92,6 +93,7 @@
 #include <net/lwip/tcpip.h>
 #include <net/lwip/udp.h>
 #include <net/lwip/priv/tcpip_priv.h>
+#include <net/lwip/priv/api_msg.h>
 #include <net/lwip/ip_addr.h>
 
 #if LWIP_CHECKSUM_ON_COPY
@@ -102,6 +104,14 @@
 #include <tinyara/clock.h>
 #endif
 
+#if LWIP_EPOLL
+#include <sys/epoll.h>
+#endif
+
+#if LWIP_ZEROCOPY
+#include <net/lwip/priv/tcp_priv.h>
+#endif
+
 /* If the netconn API is not required publicly, then we include the necessary
    files here to get the implementation */
 #if !LWIP_NETCONN
@@ -281,8 +291,6 @@ struct lwip_select_cb {
 	sys_sem_t *poll_sem;
 	/** Pointer to event-set of requested poll events */
 	pollevent_t events;
-	/** socket descriptor value */
-	int sfd;
 	/** semaphore to wake up a task waiting for select */
 	SELECT_SEM_T sem;
 #endif
@@ -290,6 +298,45 @@ struct lwip_select_cb {
 	int sem_signalled;
 };
 
+#if LWIP_EPOLL
+/** One socket in the interest list of an epoll instance */
+struct lwip_epitem {
+	/** Next item watching the same socket */
+	struct lwip_epitem *sock_next;
+	/** Next and previous item of the same epoll instance */
+	struct lwip_epitem *ep_next;
+	struct lwip_epitem *ep_prev;
+	/** Next item in the ready list of the epoll instance */
+	struct lwip_epitem *rdy_next;
+	/** The epoll instance and the watched socket */
+	struct lwip_epoll *ep;
+	struct socket *sock;
+	/** Requested events and user data, events is 0 after an EPOLLONESHOT event */
+	struct epoll_event event;
+	/** 1 while the item is in the ready list */
+	u8_t ready;
+};
+
+/** An epoll instance, it takes the socket slot of its descriptor */
+struct lwip_epoll {
+	/** All the items of the interest list */
+	struct lwip_epitem *items;
+	/** Items which became ready since the last epoll_wait */
+	struct lwip_epitem *rdy_head;
+	struct lwip_epitem *rdy_tail;
+	/** Semaphore to wake up the tasks waiting in epoll_wait */
+	sys_sem_t sem;
+	/** Number of tasks waiting in epoll_wait */
+	int waiting;
+	/** Set when the descriptor was closed while tasks were waiting */
+	u8_t closed;
+};
+
+#define SOCK_IS_EPOLL(sock) ((sock)->epoll != NULL)
+#else
+#define SOCK_IS_EPOLL(sock) 0
+#endif							/* LWIP_EPOLL */
+
 /** A struct sockaddr replacement that has the same alignment as sockaddr_in/
  *  sockaddr_in6 if instantiated.
  */
@@ -329,11 +376,13 @@ static void lwip_socket_drop_registered_memberships(int s);
 
 /** The global array of available sockets */
 static struct socket sockets[NUM_SOCKETS];
+#if LWIP_SELECT
 /** The global list of tasks waiting for select */
 static struct lwip_select_cb *select_cb_list;
 /** This counter is increased from lwip_select when the list is chagned
     and checked in event_callback to see if it has changed. */
 static volatile int select_cb_ctr;
+#endif
 
 #if LWIP_SOCKET_SET_ERRNO
 #ifdef ERRNO
@@ -358,6 +407,13 @@ static volatile int select_cb_ctr;
 
 /* Forward delcaration of some functions */
 static void event_callback(struct netconn *conn, enum netconn_evt evt, u16_t len);
+#if LWIP_EPOLL
+static void lwip_epoll_forget(struct socket *sock);
+static int lwip_epoll_close(int s);
+#endif
+#if LWIP_ZEROCOPY && LWIP_TCP
+static void lwip_zc_drain(struct socket *sock);
+#endif
 #if !LWIP_TCPIP_CORE_LOCKING
 static void lwip_getsockopt_callback(void *arg);
 static void lwip_setsockopt_callback(void *arg);
@@ -559,7 +615,7 @@ int alloc_socket(struct netconn *newconn, int accepted)
 	for (i = 0; i < NUM_SOCKETS; ++i) {
 		/* Protect socket array */
 		SYS_ARCH_PROTECT(lev);
-		if (!sockets[i].conn && (sockets[i].select_waiting == 0)) {
+		if (!sockets[i].conn && (sockets[i].select_waiting == 0) && !SOCK_IS_EPOLL(&sockets[i])) {
 			newconn->pid = getpid();
 			sockets[i].conn = newconn;
 			/* The socket is not yet known to anyone, so no need to protect
@@ -595,6 +651,11 @@ void free_socket(struct socket *sock, int is_tcp)
 	sock->lastoffset = 0;
 	sock->err = 0;
 
+#if LWIP_EPOLL
+	/* a closed socket leaves all interest lists */
+	lwip_epoll_forget(sock);
+#endif
+
 	/* Protect socket array */
 	SYS_ARCH_SET(sock->conn, NULL);
 	/* don't use 'sock' after this line, as another task might have allocated it */
@@ -758,6 +819,12 @@ int lwip_close(int s)
 
 	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_close(%d)\n", s));
 
+#if LWIP_EPOLL
+	if (lwip_epoll_close(s) == 0) {
+		return 0;
+	}
+#endif
+
 	sock = get_socket(s);
 	if (!sock) {
 		return -1;
@@ -787,6 +854,13 @@ int lwip_sock_close(struct socket *sock)
 		LWIP_ASSERT("sock->lastdata == NULL", sock->lastdata == NULL);
 	}
 
+#if LWIP_ZEROCOPY && LWIP_TCP
+	/* the segments must not outlive the data they refer to */
+	if (is_tcp) {
+		lwip_zc_drain(sock);
+	}
+#endif
+
 	err = netconn_delete(sock->conn);
 	if (err != ERR_OK) {
 		sock_set_errno(sock, err_to_errno(err));
@@ -1063,6 +1137,104 @@ int lwip_recv(int s, void *mem, size_t len, int flags)
 	return lwip_recvfrom(s, mem, len, flags, NULL, NULL);
 }
 
+#if LWIP_ZEROCOPY
+/**
+ * Receive data without copying it: the received pbuf chain is lent to the
+ * caller, which gives it back with lwip_pbuf_release(). For TCP, the window
+ * is opened when the chain is taken, so a lent chain should be released
+ * soon, it holds memory of the stack. A datagram is returned whole.
+ *
+ * @param s the socket
+ * @param p the received chain is stored here
+ * @param flags MSG_DONTWAIT, MSG_PEEK is not supported
+ * @return number of bytes in the chain, 0 at the end of the stream, -1 on error
+ */
+int lwip_recv_pbuf(int s, struct pbuf **p, int flags)
+{
+	struct socket *sock;
+	void *buf;
+	struct pbuf *q;
+	struct pbuf *next;
+	u16_t off;
+	err_t err;
+
+	sock = get_socket(s);
+	if (!sock) {
+		return -1;
+	}
+
+	if (p == NULL || (flags & MSG_PEEK) != 0) {
+		sock_set_errno(sock, EINVAL);
+		return -1;
+	}
+	*p = NULL;
+
+	if (sock->lastdata) {
+		/* lend what is left from the last recv operation */
+		buf = sock->lastdata;
+		off = sock->lastoffset;
+		sock->lastdata = NULL;
+		sock->lastoffset = 0;
+	} else {
+		if (((flags & MSG_DONTWAIT) || netconn_is_nonblocking(sock->conn)) && (sock->rcvevent <= 0)) {
+			set_errno(EWOULDBLOCK);
+			return -1;
+		}
+
+		if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+			err = netconn_recv_tcp_pbuf(sock->conn, (struct pbuf **)&buf);
+		} else {
+			err = netconn_recv(sock->conn, (struct netbuf **)&buf);
+		}
+		if (err != ERR_OK) {
+			sock_set_errno(sock, err_to_errno(err));
+			if (err == ERR_CLSD) {
+				/* Normal operation, peer ended */
+				sock->conn->last_err = ERR_OK;
+				return 0;
+			}
+			return -1;
+		}
+		off = 0;
+	}
+
+	if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+		q = (struct pbuf *)buf;
+	} else {
+		/* keep the pbuf, drop the netbuf around it */
+		q = ((struct netbuf *)buf)->p;
+		pbuf_ref(q);
+		netbuf_delete((struct netbuf *)buf);
+	}
+
+	/* drop the part which was read already */
+	while (off >= q->len) {
+		off -= q->len;
+		next = q->next;
+		pbuf_ref(next);
+		pbuf_free(q);
+		q = next;
+	}
+	if (off > 0) {
+		pbuf_header(q, -(s16_t)off);
+	}
+
+	*p = q;
+	sock_set_errno(sock, 0);
+	return q->tot_len;
+}
+
+/**
+ * Give back a pbuf chain lent by lwip_recv_pbuf().
+ */
+void lwip_pbuf_release(struct pbuf *p)
+{
+	if (p != NULL) {
+		pbuf_free(p);
+	}
+}
+#endif							/* LWIP_ZEROCOPY */
+
 int lwip_send(int s, const void *data, size_t size, int flags)
 {
 	struct socket *sock;
@@ -1332,157 +1504,740 @@ int lwip_sendto(int s, const void *data, size_t size, int flags, const struct so
 	return (err == ERR_OK ? short_size : -1);
 }
 
-int lwip_socket(int domain, int type, int protocol)
-{
-	struct netconn *conn;
-	int i;
+#if LWIP_UDP || LWIP_RAW
+/** Datagrams lwip_sendmmsg() hands to the tcpip thread in one call, the
+ * netbufs of a batch are on the stack of the caller */
+#ifndef LWIP_SENDMMSG_BATCH
+#define LWIP_SENDMMSG_BATCH 8
+#endif
 
-	LWIP_UNUSED_ARG(domain);
+struct lwip_sendmmsg_call {
+	struct tcpip_api_call_data call;
+	struct netconn *conn;
+	struct netbuf *bufs;
+	int count;
+	/** datagrams sent, the next one failed if sent < count */
+	int sent;
+};
 
-	/* create a netconn */
-	switch (type) {
-	case SOCK_RAW:
-		conn = netconn_new_with_proto_and_callback(DOMAIN_TO_NETCONN_TYPE(domain, NETCONN_RAW), (u8_t) protocol, event_callback);
-		LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_socket(%s, SOCK_RAW, %d) = ", domain == PF_INET ? "PF_INET" : "UNKNOWN", protocol));
-		break;
-	case SOCK_DGRAM:
-		conn = netconn_new_with_callback(DOMAIN_TO_NETCONN_TYPE(domain, ((protocol == IPPROTO_UDPLITE) ? NETCONN_UDPLITE : NETCONN_UDP)), event_callback);
-		LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_socket(%s, SOCK_DGRAM, %d) = ", domain == PF_INET ? "PF_INET" : "UNKNOWN", protocol));
-		break;
-	case SOCK_STREAM:
-		conn = netconn_new_with_callback(DOMAIN_TO_NETCONN_TYPE(domain, NETCONN_TCP), event_callback);
-		LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_socket(%s, SOCK_STREAM, %d) = ", domain == PF_INET ? "PF_INET" : "UNKNOWN", protocol));
-		break;
-	default:
-		LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_socket(%d, %d/UNKNOWN, %d) = -1\n", domain, type, protocol));
-		set_errno(EINVAL);
-		return -1;
-	}
+/** Send a batch of datagrams, called from the tcpip thread */
+static err_t lwip_sendmmsg_batch(struct tcpip_api_call_data *call)
+{
+	struct lwip_sendmmsg_call *mcall = (struct lwip_sendmmsg_call *)call;
+	err_t err = ERR_OK;
 
-	if (!conn) {
-		LWIP_DEBUGF(SOCKETS_DEBUG, ("-1 / ENOBUFS (could not create netconn)\n"));
-		set_errno(ENOBUFS);
-		return -1;
+	for (mcall->sent = 0; mcall->sent < mcall->count; mcall->sent++) {
+		err = lwip_netconn_send_netbuf(mcall->conn, &mcall->bufs[mcall->sent]);
+		if (err != ERR_OK) {
+			break;
+		}
 	}
+	return err;
+}
 
-	i = alloc_socket(conn, 0);
+/** Copy one message into a netbuf as lwip_sendto() does, from all of its iovs */
+static err_t lwip_sendmmsg_copy(struct socket *sock, const struct msghdr *msg, struct netbuf *buf)
+{
+	size_t size = 0;
+	u16_t offset = 0;
+	u16_t remote_port;
+	int i;
 
-	if (i == -1) {
+	buf->p = buf->ptr = NULL;
+#if LWIP_CHECKSUM_ON_COPY
+	buf->flags = 0;
+#endif							/* LWIP_CHECKSUM_ON_COPY */
 
-		netconn_delete(conn);
-		set_errno(ENFILE);
-		return -1;
+	if ((msg->msg_iov == NULL && msg->msg_iovlen != 0) || msg->msg_iovlen < 0) {
+		return ERR_ARG;
+	}
+	if (!(((msg->msg_name == NULL) && (msg->msg_namelen == 0)) || (IS_SOCK_ADDR_LEN_VALID(msg->msg_namelen) && IS_SOCK_ADDR_TYPE_VALID((const struct sockaddr *)msg->msg_name) && IS_SOCK_ADDR_ALIGNED((const struct sockaddr *)msg->msg_name)))) {
+		return ERR_ARG;
+	}
+	for (i = 0; i < msg->msg_iovlen; i++) {
+		size += msg->msg_iov[i].iov_len;
+	}
+	if (size > 0xffff) {
+		return ERR_VAL;
 	}
-	conn->socket = i;
-	LWIP_DEBUGF(SOCKETS_DEBUG, ("%d\n", i));
-	set_errno(0);
-	return i;
-}
 
-int lwip_write(int s, const void *data, size_t size)
-{
-	return lwip_send(s, data, size, 0);
-}
+	if (msg->msg_name) {
+		SOCKADDR_TO_IPADDR_PORT((const struct sockaddr *)msg->msg_name, &buf->addr, remote_port);
+	} else {
+		remote_port = 0;
+		ip_addr_set_any(NETCONNTYPE_ISIPV6(netconn_type(sock->conn)), &buf->addr);
+	}
+	netbuf_fromport(buf) = remote_port;
 
-int lwip_writev(int s, const struct iovec *iov, int iovcnt)
-{
-	struct msghdr msg;
+#if LWIP_IPV4 && LWIP_IPV6
+	/* Dual-stack: Unmap IPv4 mapped IPv6 addresses */
+	if (IP_IS_V6_VAL(buf->addr) && ip6_addr_isipv4mappedipv6(ip_2_ip6(&buf->addr))) {
+		unmap_ipv4_mapped_ipv6(ip_2_ip4(&buf->addr), ip_2_ip6(&buf->addr));
+		IP_SET_TYPE_VAL(buf->addr, IPADDR_TYPE_V4);
+	}
+#endif							/* LWIP_IPV4 && LWIP_IPV6 */
 
-	msg.msg_name = NULL;
-	msg.msg_namelen = 0;
-	/* Hack: we have to cast via number to cast from 'const' pointer to non-const.
-	   Blame the opengroup standard for this inconsistency. */
-	msg.msg_iov = LWIP_CONST_CAST(struct iovec *, iov);
-	msg.msg_iovlen = iovcnt;
-	msg.msg_control = NULL;
-	msg.msg_controllen = 0;
-	msg.msg_flags = 0;
-	return lwip_sendmsg(s, &msg, 0);
+	/* The data is copied whatever LWIP_NETIF_TX_SINGLE_PBUF says: the
+	 * caller may reuse its buffers as soon as the call returns */
+	if (netbuf_alloc(buf, (u16_t)size) == NULL) {
+		return ERR_MEM;
+	}
+	for (i = 0; i < msg->msg_iovlen; i++) {
+		MEMCPY((u8_t *)buf->p->payload + offset, msg->msg_iov[i].iov_base, msg->msg_iov[i].iov_len);
+		offset += (u16_t)msg->msg_iov[i].iov_len;
+	}
+#if LWIP_CHECKSUM_ON_COPY
+	if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) != NETCONN_RAW) {
+		netbuf_set_chksum(buf, ~inet_chksum_pbuf(buf->p));
+	}
+#endif							/* LWIP_CHECKSUM_ON_COPY */
+	return ERR_OK;
 }
-
-#if LWIP_SELECT
+#endif							/* LWIP_UDP || LWIP_RAW */
 
 /**
- * Go through the readset and writeset lists and see which socket of the sockets
- * set in the sets has events. On return, readset, writeset and exceptset have
- * the sockets enabled that had events.
- *
- * exceptset is not used for now!!!
+ * Send several messages. The datagrams of a UDP or RAW socket are copied
+ * into netbufs in the calling thread and sent in batches of
+ * LWIP_SENDMMSG_BATCH, one tcpip thread transaction for each batch. With
+ * MSG_DONTWAIT or on a non-blocking socket a batch is not sent when the
+ * mailbox of the tcpip thread is full, EWOULDBLOCK if it is the first one.
+ * A TCP socket sends one message after the other with lwip_sendmsg().
  *
- * @param maxfdp1 the highest socket index in the sets
- * @param readset_in:    set of sockets to check for read events
- * @param writeset_in:   set of sockets to check for write events
- * @param exceptset_in:  set of sockets to check for error events
- * @param readset_out:   set of sockets that had read events
- * @param writeset_out:  set of sockets that had write events
- * @param exceptset_out: set os sockets that had error events
- * @return number of sockets that had events (read/write/exception) (>= 0)
+ * Returns the number of messages sent, which is less than vlen if one
+ * could not be sent, or -1 with errno set if the first one failed.
  */
-static int lwip_selscan(int maxfdp1, fd_set *readset_in, fd_set *writeset_in, fd_set *exceptset_in, fd_set *readset_out, fd_set *writeset_out, fd_set *exceptset_out)
+int lwip_sendmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags)
 {
-	int i, nready = 0;
-	fd_set lreadset, lwriteset, lexceptset;
 	struct socket *sock;
-	SYS_ARCH_DECL_PROTECT(lev);
+	unsigned int done = 0;
+	int ret;
 
-	FD_ZERO(&lreadset);
-	FD_ZERO(&lwriteset);
-	FD_ZERO(&lexceptset);
+	sock = get_socket(s);
+	if (!sock) {
+		return -1;
+	}
 
-	/* Go through each socket in each list to count number of sockets which
-	   currently match */
-	for (i = LWIP_SOCKET_OFFSET; i < maxfdp1; i++) {
-		/* if this FD is not in the set, continue */
-		if (!(readset_in && FD_ISSET(i, readset_in)) && !(writeset_in && FD_ISSET(i, writeset_in)) && !(exceptset_in && FD_ISSET(i, exceptset_in))) {
-			continue;
-		}
-		/* First get the socket's status (protected)... */
-		SYS_ARCH_PROTECT(lev);
-		sock = tryget_socket(i);
-		if (sock != NULL) {
-			void *lastdata = sock->lastdata;
-			s16_t rcvevent = sock->rcvevent;
-			u16_t sendevent = sock->sendevent;
-			u16_t errevent = sock->errevent;
-			SYS_ARCH_UNPROTECT(lev);
+	LWIP_ERROR("lwip_sendmmsg: invalid msgvec", msgvec != NULL || vlen == 0, sock_set_errno(sock, err_to_errno(ERR_ARG)); return -1;);
 
-			/* ... then examine it: */
-			/* See if netconn of this socket is ready for read */
-			if (readset_in && FD_ISSET(i, readset_in) && ((lastdata != NULL) || (rcvevent > 0))) {
-				FD_SET(i, &lreadset);
-				LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_selscan: fd=%d ready for reading\n", i));
-				nready++;
+	if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+		/* A stream has no datagrams to batch */
+		for (done = 0; done < vlen; done++) {
+			ret = lwip_sendmsg(s, &msgvec[done].msg_hdr, flags);
+			if (ret < 0) {
+				break;
 			}
-			/* See if netconn of this socket is ready for write */
-			if (writeset_in && FD_ISSET(i, writeset_in) && (sendevent != 0)) {
-				FD_SET(i, &lwriteset);
-				LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_selscan: fd=%d ready for writing\n", i));
-				nready++;
+			msgvec[done].msg_len = (unsigned int)ret;
+		}
+		if (done == 0 && vlen > 0) {
+			return -1;
+		}
+		sock_set_errno(sock, 0);
+		return (int)done;
+	}
+#if LWIP_UDP || LWIP_RAW
+	{
+		struct netbuf bufs[LWIP_SENDMMSG_BATCH];
+		struct lwip_sendmmsg_call mcall;
+		err_t err = ERR_OK;
+		u8_t block = !((flags & MSG_DONTWAIT) || netconn_is_nonblocking(sock->conn));
+		int count;
+		int i;
+
+		while (done < vlen && err == ERR_OK) {
+			/* Copy a batch in this thread, a bad message ends it */
+			for (count = 0; count < LWIP_SENDMMSG_BATCH && done + count < vlen; count++) {
+				err = lwip_sendmmsg_copy(sock, &msgvec[done + count].msg_hdr, &bufs[count]);
+				if (err != ERR_OK) {
+					netbuf_free(&bufs[count]);
+					break;
+				}
 			}
-			/* See if netconn of this socket had an error */
-			if (exceptset_in && FD_ISSET(i, exceptset_in) && (errevent != 0)) {
-				FD_SET(i, &lexceptset);
-				LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_selscan: fd=%d ready for exception\n", i));
-				nready++;
+			if (count == 0) {
+				break;
 			}
-		} else {
-			SYS_ARCH_UNPROTECT(lev);
-			/* continue on to next FD in list */
+
+			mcall.conn = sock->conn;
+			mcall.bufs = bufs;
+			mcall.count = count;
+			mcall.sent = 0;
+			ret = tcpip_api_call_with_block(lwip_sendmmsg_batch, &mcall.call, block);
+			if (mcall.sent < count) {
+				err = (err_t)ret;
+			}
+
+			for (i = 0; i < count; i++) {
+				if (i < mcall.sent) {
+					msgvec[done + i].msg_len = bufs[i].p->tot_len;
+				}
+				netbuf_free(&bufs[i]);
+			}
+			done += (unsigned int)mcall.sent;
 		}
-	}
-	/* copy local sets to the ones provided as arguments */
-	*readset_out = lreadset;
-	*writeset_out = lwriteset;
-	*exceptset_out = lexceptset;
 
-	LWIP_ASSERT("nready >= 0", nready >= 0);
-	return nready;
+		if (done == 0 && vlen > 0) {
+			sock_set_errno(sock, err_to_errno(err));
+			return -1;
+		}
+		sock_set_errno(sock, 0);
+		return (int)done;
+	}
+#else							/* LWIP_UDP || LWIP_RAW */
+	sock_set_errno(sock, err_to_errno(ERR_ARG));
+	return -1;
+#endif							/* LWIP_UDP || LWIP_RAW */
 }
 
-/**
- * Processing exceptset is not yet implemented.
- */
-int lwip_select(int maxfdp1, fd_set *readset, fd_set *writeset, fd_set *exceptset, struct timeval *timeout)
+#if LWIP_UDP || LWIP_RAW
+/** Receive one datagram into the iovs of msg, as lwip_recvfrom() does */
+static int lwip_recvmmsg_one(struct socket *sock, int s, struct msghdr *msg, int flags)
+{
+	struct netbuf *buf;
+	struct pbuf *p;
+	u16_t copied = 0;
+	u16_t copylen;
+	err_t err;
+	int i;
+
+	if ((msg->msg_iov == NULL && msg->msg_iovlen != 0) || msg->msg_iovlen < 0) {
+		sock_set_errno(sock, err_to_errno(ERR_ARG));
+		return -1;
+	}
+
+	if (sock->lastdata) {
+		buf = (struct netbuf *)sock->lastdata;
+	} else {
+		/* If this is non-blocking call, then check first */
+		if (((flags & MSG_DONTWAIT) || netconn_is_nonblocking(sock->conn)) && (sock->rcvevent <= 0)) {
+			LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvmmsg(%d): returning EWOULDBLOCK\n", s));
+			set_errno(EWOULDBLOCK);
+			return -1;
+		}
+		err = netconn_recv(sock->conn, &buf);
+		if (err != ERR_OK) {
+			sock_set_errno(sock, err_to_errno(err));
+			return -1;
+		}
+		sock->lastdata = buf;
+	}
+
+	/* Scatter the datagram, the rest of it is lost as for lwip_recvfrom() */
+	p = buf->p;
+	msg->msg_flags = 0;
+	for (i = 0; i < msg->msg_iovlen && copied < p->tot_len; i++) {
+		copylen = p->tot_len - copied;
+		if (msg->msg_iov[i].iov_len < copylen) {
+			copylen = (u16_t)msg->msg_iov[i].iov_len;
+		}
+		pbuf_copy_partial(p, msg->msg_iov[i].iov_base, copylen, copied);
+		copied += copylen;
+	}
+	if (copied < p->tot_len) {
+		msg->msg_flags |= MSG_TRUNC;
+	}
+	msg->msg_controllen = 0;
+
+	if (msg->msg_name && msg->msg_namelen) {
+		ip_addr_t *fromaddr = netbuf_fromaddr(buf);
+		union sockaddr_aligned saddr;
+
+#if LWIP_IPV4 && LWIP_IPV6
+		/* Dual-stack: Map IPv4 addresses to IPv4 mapped IPv6 */
+		if (NETCONNTYPE_ISIPV6(netconn_type(sock->conn)) && IP_IS_V4(fromaddr)) {
+			ip4_2_ipv4_mapped_ipv6(ip_2_ip6(fromaddr), ip_2_ip4(fromaddr));
+			IP_SET_TYPE(fromaddr, IPADDR_TYPE_V6);
+		}
+#endif							/* LWIP_IPV4 && LWIP_IPV6 */
+
+		IPADDR_PORT_TO_SOCKADDR(&saddr, fromaddr, netbuf_fromport(buf));
+		if (msg->msg_namelen > saddr.sa.sa_len) {
+			msg->msg_namelen = saddr.sa.sa_len;
+		}
+		MEMCPY(msg->msg_name, &saddr, msg->msg_namelen);
+	}
+
+	if ((flags & MSG_PEEK) == 0) {
+		sock->lastdata = NULL;
+		sock->lastoffset = 0;
+		netbuf_delete(buf);
+	}
+	return copied;
+}
+#endif							/* LWIP_UDP || LWIP_RAW */
+
+/**
+ * Receive several datagrams. With MSG_WAITFORONE only the first one is
+ * waited for. The timeout is checked after each datagram, so as on Linux
+ * it does not bound a receive which blocks.
+ *
+ * A UDP receive does not go through the tcpip thread, the datagrams are
+ * taken from the receive mailbox, so the gain is the single call and the
+ * scatter into the iovs.
+ *
+ * Returns the number of datagrams received, or -1 with errno set if the
+ * first one failed.
+ */
+int lwip_recvmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags, struct timespec *timeout)
+{
+	struct socket *sock;
+#if LWIP_UDP || LWIP_RAW
+	unsigned int done;
+	u32_t start = 0;
+	u32_t wait = 0;
+	int rflags;
+	int ret;
+#endif
+
+	sock = get_socket(s);
+	if (!sock) {
+		return -1;
+	}
+
+	LWIP_ERROR("lwip_recvmmsg: invalid msgvec", msgvec != NULL || vlen == 0, sock_set_errno(sock, err_to_errno(ERR_ARG)); return -1;);
+
+#if LWIP_UDP || LWIP_RAW
+	if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) != NETCONN_TCP) {
+		if (timeout) {
+			start = sys_now();
+			wait = (u32_t)timeout->tv_sec * 1000 + (u32_t)(timeout->tv_nsec / 1000000);
+		}
+
+		for (done = 0; done < vlen; done++) {
+			rflags = flags & ~MSG_WAITFORONE;
+			if (done > 0 && ((flags & MSG_WAITFORONE) || (timeout && (u32_t)(sys_now() - start) >= wait))) {
+				rflags |= MSG_DONTWAIT;
+			}
+			ret = lwip_recvmmsg_one(sock, s, &msgvec[done].msg_hdr, rflags);
+			if (ret < 0) {
+				break;
+			}
+			msgvec[done].msg_len = (unsigned int)ret;
+		}
+
+		if (done == 0 && vlen > 0) {
+			return -1;
+		}
+		sock_set_errno(sock, 0);
+		return (int)done;
+	}
+#endif							/* LWIP_UDP || LWIP_RAW */
+
+	/* A stream has no message boundaries */
+	LWIP_UNUSED_ARG(flags);
+	LWIP_UNUSED_ARG(timeout);
+	sock_set_errno(sock, EOPNOTSUPP);
+	return -1;
+}
+
+#if LWIP_ZEROCOPY
+/** Time lwip_close() waits for the peer to acknowledge the data sent by
+ * lwip_send_ref(), the connection is aborted after it (ms) */
+#ifndef LWIP_ZEROCOPY_CLOSE_WAIT
+#define LWIP_ZEROCOPY_CLOSE_WAIT 2000
+#endif
+
+#if LWIP_TCP
+/** Data sent by reference on a TCP socket, which segments may refer to */
+struct lwip_zc_send {
+	struct lwip_zc_send *next;
+	/** sequence number after the last byte */
+	u32_t end;
+	lwip_send_ref_done_fn done;
+	void *arg;
+};
+
+struct lwip_zc_call {
+	struct tcpip_api_call_data call;
+	struct socket *sock;
+	struct lwip_zc_send *zc;
+};
+
+/**
+ * Complete the data which no segment refers to any more.
+ * Called from the tcpip thread when data is acknowledged or the pcb is gone.
+ */
+static void lwip_zc_complete(struct socket *sock)
+{
+	struct lwip_zc_send *zc;
+	struct tcp_pcb *pcb;
+	struct tcp_seg *seg;
+	int err = 0;
+
+	pcb = sock->conn->pcb.tcp;
+	if (pcb == NULL) {
+		/* the segments were freed with the pcb */
+		err = ECONNABORTED;
+	}
+
+	while ((zc = sock->zc_sends) != NULL) {
+		if (pcb != NULL) {
+			/* A segment is freed only when all of it is acknowledged, so the
+			   data is done when no segment starts before its end. A
+			   retransmission moves unacked segments back to unsent, so the
+			   oldest segment is at the head of either queue */
+			seg = pcb->unacked;
+			if (seg == NULL || (pcb->unsent != NULL && TCP_SEQ_LT(lwip_ntohl(pcb->unsent->tcphdr->seqno), lwip_ntohl(seg->tcphdr->seqno)))) {
+				seg = pcb->unsent;
+			}
+			if (seg != NULL && TCP_SEQ_LT(lwip_ntohl(seg->tcphdr->seqno), zc->end)) {
+				break;
+			}
+		}
+		sock->zc_sends = zc->next;
+		zc->done(zc->arg, err);
+		mem_free(zc);
+	}
+}
+
+static err_t lwip_zc_queue(struct tcpip_api_call_data *call)
+{
+	struct lwip_zc_call *zcall = (struct lwip_zc_call *)call;
+	struct lwip_zc_send **tail;
+
+	/* the caller's write is done, so the data ends at the last byte queued */
+	if (zcall->sock->conn->pcb.tcp != NULL) {
+		zcall->zc->end = zcall->sock->conn->pcb.tcp->snd_lbb;
+	}
+	zcall->zc->next = NULL;
+	for (tail = &zcall->sock->zc_sends; *tail != NULL; tail = &(*tail)->next) {
+	}
+	*tail = zcall->zc;
+
+	/* it may be acknowledged already */
+	lwip_zc_complete(zcall->sock);
+	return ERR_OK;
+}
+
+static err_t lwip_zc_abort(struct tcpip_api_call_data *call)
+{
+	struct socket *sock = ((struct lwip_zc_call *)call)->sock;
+
+	if (sock->conn->pcb.tcp != NULL) {
+		/* frees the segments, err_tcp() reports the error */
+		tcp_abort(sock->conn->pcb.tcp);
+	}
+	lwip_zc_complete(sock);
+	return ERR_OK;
+}
+
+/**
+ * Wait until the peer acknowledges the data sent by reference, and abort
+ * the connection if it takes longer than LWIP_ZEROCOPY_CLOSE_WAIT.
+ * Called before the pcb is closed, a closed pcb cannot be watched.
+ */
+static void lwip_zc_drain(struct socket *sock)
+{
+	struct lwip_zc_call zcall;
+	u32_t waited;
+
+	for (waited = 0; sock->zc_sends != NULL && waited < LWIP_ZEROCOPY_CLOSE_WAIT; waited += 10) {
+		sys_msleep(10);
+	}
+	if (sock->zc_sends != NULL) {
+		LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_zc_drain: data sent by reference is not acknowledged, abort\n"));
+		zcall.sock = sock;
+		tcpip_api_call(lwip_zc_abort, &zcall.call);
+	}
+}
+#endif							/* LWIP_TCP */
+
+#if LWIP_UDP || LWIP_RAW
+/** Data sent by reference on a UDP or raw socket, done when the pbuf is freed */
+struct lwip_zc_pbuf {
+	struct pbuf_custom pc;
+	lwip_send_ref_done_fn done;
+	void *arg;
+};
+
+static void lwip_zc_pbuf_free(struct pbuf *p)
+{
+	struct lwip_zc_pbuf *zp = (struct lwip_zc_pbuf *)p;
+
+	if (zp->done != NULL) {
+		zp->done(zp->arg, 0);
+	}
+	mem_free(zp);
+}
+#endif							/* LWIP_UDP || LWIP_RAW */
+
+/**
+ * Send data without copying it into the stack. The data must stay valid
+ * and unchanged until done is called, which happens exactly once for each
+ * call which returns a positive count. For TCP, that is when the peer has
+ * acknowledged all of it or the connection is aborted, so a socket should
+ * have a few buffers in flight. For UDP and raw sockets, which must be
+ * connected, it is when the driver frees the packet. done may be called
+ * from the tcpip thread or the driver, it should only hand the buffer back.
+ *
+ * @param s the socket
+ * @param data the data to send
+ * @param size the number of bytes to send
+ * @param flags MSG_MORE and MSG_DONTWAIT
+ * @param done called when the stack does not refer to the data any more
+ * @param arg passed to done
+ * @return number of bytes sent (TCP may send less on a nonblocking socket), -1 on error
+ */
+int lwip_send_ref(int s, const void *data, size_t size, int flags, lwip_send_ref_done_fn done, void *arg)
+{
+	struct socket *sock;
+	err_t err;
+
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_send_ref(%d, data=%p, size=%" SZT_F ", flags=0x%x)\n", s, data, size, flags));
+
+	sock = get_socket(s);
+	if (!sock) {
+		return -1;
+	}
+
+	if (data == NULL || size == 0 || done == NULL) {
+		sock_set_errno(sock, EINVAL);
+		return -1;
+	}
+
+	if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+#if LWIP_TCP
+		struct lwip_zc_call zcall;
+		u8_t write_flags;
+		size_t written;
+
+		zcall.sock = sock;
+		zcall.zc = (struct lwip_zc_send *)mem_malloc(sizeof(struct lwip_zc_send));
+		if (zcall.zc == NULL) {
+			sock_set_errno(sock, ENOMEM);
+			return -1;
+		}
+		zcall.zc->done = done;
+		zcall.zc->arg = arg;
+
+		/* without NETCONN_COPY, the segments refer to the data */
+		write_flags = NETCONN_NOCOPY | ((flags & MSG_MORE) ? NETCONN_MORE : 0) | ((flags & MSG_DONTWAIT) ? NETCONN_DONTBLOCK : 0);
+		written = 0;
+		err = netconn_write_partly(sock->conn, data, size, write_flags, &written);
+		if (err != ERR_OK || written == 0) {
+			mem_free(zcall.zc);
+			sock_set_errno(sock, err_to_errno(err != ERR_OK ? err : ERR_WOULDBLOCK));
+			return -1;
+		}
+
+		/* watch the data until no segment refers to it, this cannot be skipped */
+		while (tcpip_api_call(lwip_zc_queue, &zcall.call) != ERR_OK) {
+			sys_msleep(1);
+		}
+
+		sock_set_errno(sock, 0);
+		return (int)written;
+#else							/* LWIP_TCP */
+		sock_set_errno(sock, err_to_errno(ERR_ARG));
+		return -1;
+#endif							/* LWIP_TCP */
+	}
+
+#if LWIP_UDP || LWIP_RAW
+	{
+#if LWIP_NETIF_TX_SINGLE_PBUF
+		/* the driver needs the packet in one pbuf, so it is copied anyway */
+		int ret;
+
+		LWIP_UNUSED_ARG(err);
+		ret = lwip_sendto(s, data, size, flags, NULL, 0);
+		if (ret > 0) {
+			done(arg, 0);
+		}
+		return ret;
+#else							/* LWIP_NETIF_TX_SINGLE_PBUF */
+		struct lwip_zc_pbuf *zp;
+		struct netbuf buf;
+
+		if (size > 0xffff) {
+			sock_set_errno(sock, EMSGSIZE);
+			return -1;
+		}
+
+		zp = (struct lwip_zc_pbuf *)mem_malloc(sizeof(struct lwip_zc_pbuf));
+		if (zp == NULL) {
+			sock_set_errno(sock, ENOMEM);
+			return -1;
+		}
+		zp->pc.custom_free_function = lwip_zc_pbuf_free;
+		zp->done = done;
+		zp->arg = arg;
+
+		buf.p = buf.ptr = pbuf_alloced_custom(PBUF_RAW, (u16_t)size, PBUF_REF, &zp->pc, (void *)data, (u16_t)size);
+#if LWIP_CHECKSUM_ON_COPY
+		buf.flags = 0;
+#endif							/* LWIP_CHECKSUM_ON_COPY */
+		ip_addr_set_any(NETCONNTYPE_ISIPV6(netconn_type(sock->conn)), &buf.addr);
+		netbuf_fromport(&buf) = 0;
+
+		err = netconn_send(sock->conn, &buf);
+		if (err != ERR_OK) {
+			/* the caller keeps the data */
+			zp->done = NULL;
+		}
+		/* done is called when the last reference is dropped, maybe now */
+		pbuf_free(buf.p);
+
+		sock_set_errno(sock, err_to_errno(err));
+		return (err == ERR_OK ? (int)size : -1);
+#endif							/* LWIP_NETIF_TX_SINGLE_PBUF */
+	}
+#else							/* LWIP_UDP || LWIP_RAW */
+	sock_set_errno(sock, err_to_errno(ERR_ARG));
+	return -1;
+#endif							/* LWIP_UDP || LWIP_RAW */
+}
+#endif							/* LWIP_ZEROCOPY */
+
+int lwip_socket(int domain, int type, int protocol)
+{
+	struct netconn *conn;
+	int i;
+
+	LWIP_UNUSED_ARG(domain);
+
+	/* create a netconn */
+	switch (type) {
+	case SOCK_RAW:
+		conn = netconn_new_with_proto_and_callback(DOMAIN_TO_NETCONN_TYPE(domain, NETCONN_RAW), (u8_t) protocol, event_callback);
+		LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_socket(%s, SOCK_RAW, %d) = ", domain == PF_INET ? "PF_INET" : "UNKNOWN", protocol));
+		break;
+	case SOCK_DGRAM:
+		conn = netconn_new_with_callback(DOMAIN_TO_NETCONN_TYPE(domain, ((protocol == IPPROTO_UDPLITE) ? NETCONN_UDPLITE : NETCONN_UDP)), event_callback);
+		LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_socket(%s, SOCK_DGRAM, %d) = ", domain == PF_INET ? "PF_INET" : "UNKNOWN", protocol));
+		break;
+	case SOCK_STREAM:
+		conn = netconn_new_with_callback(DOMAIN_TO_NETCONN_TYPE(domain, NETCONN_TCP), event_callback);
+		LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_socket(%s, SOCK_STREAM, %d) = ", domain == PF_INET ? "PF_INET" : "UNKNOWN", protocol));
+		break;
+	default:
+		LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_socket(%d, %d/UNKNOWN, %d) = -1\n", domain, type, protocol));
+		set_errno(EINVAL);
+		return -1;
+	}
+
+	if (!conn) {
+		LWIP_DEBUGF(SOCKETS_DEBUG, ("-1 / ENOBUFS (could not create netconn)\n"));
+		set_errno(ENOBUFS);
+		return -1;
+	}
+
+	i = alloc_socket(conn, 0);
+
+	if (i == -1) {
+
+		netconn_delete(conn);
+		set_errno(ENFILE);
+		return -1;
+	}
+	conn->socket = i;
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("%d\n", i));
+	set_errno(0);
+	return i;
+}
+
+int lwip_write(int s, const void *data, size_t size)
+{
+	return lwip_send(s, data, size, 0);
+}
+
+int lwip_writev(int s, const struct iovec *iov, int iovcnt)
+{
+	struct msghdr msg;
+
+	msg.msg_name = NULL;
+	msg.msg_namelen = 0;
+	/* Hack: we have to cast via number to cast from 'const' pointer to non-const.
+	   Blame the opengroup standard for this inconsistency. */
+	msg.msg_iov = LWIP_CONST_CAST(struct iovec *, iov);
+	msg.msg_iovlen = iovcnt;
+	msg.msg_control = NULL;
+	msg.msg_controllen = 0;
+	msg.msg_flags = 0;
+	return lwip_sendmsg(s, &msg, 0);
+}
+
+#if LWIP_SELECT
+
+/**
+ * Go through the readset and writeset lists and see which socket of the sockets
+ * set in the sets has events. On return, readset, writeset and exceptset have
+ * the sockets enabled that had events.
+ *
+ * exceptset is not used for now!!!
+ *
+ * @param maxfdp1 the highest socket index in the sets
+ * @param readset_in:    set of sockets to check for read events
+ * @param writeset_in:   set of sockets to check for write events
+ * @param exceptset_in:  set of sockets to check for error events
+ * @param readset_out:   set of sockets that had read events
+ * @param writeset_out:  set of sockets that had write events
+ * @param exceptset_out: set os sockets that had error events
+ * @return number of sockets that had events (read/write/exception) (>= 0)
+ */
+static int lwip_selscan(int maxfdp1, fd_set *readset_in, fd_set *writeset_in, fd_set *exceptset_in, fd_set *readset_out, fd_set *writeset_out, fd_set *exceptset_out)
+{
+	int i, nready = 0;
+	fd_set lreadset, lwriteset, lexceptset;
+	struct socket *sock;
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	FD_ZERO(&lreadset);
+	FD_ZERO(&lwriteset);
+	FD_ZERO(&lexceptset);
+
+	/* Go through each socket in each list to count number of sockets which
+	   currently match */
+	for (i = LWIP_SOCKET_OFFSET; i < maxfdp1; i++) {
+		/* if this FD is not in the set, continue */
+		if (!(readset_in && FD_ISSET(i, readset_in)) && !(writeset_in && FD_ISSET(i, writeset_in)) && !(exceptset_in && FD_ISSET(i, exceptset_in))) {
+			continue;
+		}
+		/* First get the socket's status (protected)... */
+		SYS_ARCH_PROTECT(lev);
+		sock = tryget_socket(i);
+		if (sock != NULL) {
+			void *lastdata = sock->lastdata;
+			s16_t rcvevent = sock->rcvevent;
+			u16_t sendevent = sock->sendevent;
+			u16_t errevent = sock->errevent;
+			SYS_ARCH_UNPROTECT(lev);
+
+			/* ... then examine it: */
+			/* See if netconn of this socket is ready for read */
+			if (readset_in && FD_ISSET(i, readset_in) && ((lastdata != NULL) || (rcvevent > 0))) {
+				FD_SET(i, &lreadset);
+				LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_selscan: fd=%d ready for reading\n", i));
+				nready++;
+			}
+			/* See if netconn of this socket is ready for write */
+			if (writeset_in && FD_ISSET(i, writeset_in) && (sendevent != 0)) {
+				FD_SET(i, &lwriteset);
+				LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_selscan: fd=%d ready for writing\n", i));
+				nready++;
+			}
+			/* See if netconn of this socket had an error */
+			if (exceptset_in && FD_ISSET(i, exceptset_in) && (errevent != 0)) {
+				FD_SET(i, &lexceptset);
+				LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_selscan: fd=%d ready for exception\n", i));
+				nready++;
+			}
+		} else {
+			SYS_ARCH_UNPROTECT(lev);
+			/* continue on to next FD in list */
+		}
+	}
+	/* copy local sets to the ones provided as arguments */
+	*readset_out = lreadset;
+	*writeset_out = lwriteset;
+	*exceptset_out = lexceptset;
+
+	LWIP_ASSERT("nready >= 0", nready >= 0);
+	return nready;
+}
+
+/**
+ * Processing exceptset is not yet implemented.
+ */
+int lwip_select(int maxfdp1, fd_set *readset, fd_set *writeset, fd_set *exceptset, struct timeval *timeout)
 {
 	u32_t waitres = 0;
 	int nready;
@@ -1734,153 +2489,604 @@ static int lwip_poll_setup(int fd, struct socket *sock, struct pollfd *fds)
 		return 0;
 	}
 
-	scb_size = LWIP_MEM_ALIGN_SIZE(sizeof(struct lwip_select_cb));
-	select_cb = (struct lwip_select_cb *)mem_malloc(scb_size);
+	scb_size = LWIP_MEM_ALIGN_SIZE(sizeof(struct lwip_select_cb));
+	select_cb = (struct lwip_select_cb *)mem_malloc(scb_size);
+
+	if (!select_cb) {
+		return -ENOMEM;
+	}
+
+	memset(select_cb, 0, scb_size);
+
+	/* None ready: add our semaphore to list: */
+
+	select_cb->next = NULL;
+	select_cb->prev = NULL;
+	select_cb->sem_signalled = 0;
+	select_cb->poll_sem = fds->sem;
+	select_cb->events = fds->events;
+
+	/* Protect the pollers list of the socket */
+	SYS_ARCH_PROTECT(lev);
+
+	/* Put this select_cb on top of list, event_callback only looks at
+	   the tasks polling the socket which had the event */
+	select_cb->next = sock->pollers;
+	if (sock->pollers != NULL) {
+		sock->pollers->prev = select_cb;
+	}
+
+	fds->scb = (void *)select_cb;
+	sock->pollers = select_cb;
+
+	/* Increase select_waiting for the socket */
+	sock->select_waiting++;
+
+	/* Now we can safely unprotect */
+	SYS_ARCH_UNPROTECT(lev);
+
+	/* Call lwip_pollscan again: there could have been events between
+	   the last scan (without us on the list) and putting us on the list! */
+	nready = lwip_poll_scan(fd, sock, fds);
+
+	/* Check if any requested events are already in effect */
+	if (nready > 0 && fds->revents != 0) {
+		/* Yes.. then signal the poll logic */
+
+		sys_sem_signal(fds->sem);
+	}
+
+	return 0;
+}
+
+static int lwip_poll_teardown(int fd, struct socket *sock, struct pollfd *fds)
+{
+	struct lwip_select_cb *select_cb = NULL;
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	select_cb = (struct lwip_select_cb *)fds->scb;
+
+	SYS_ARCH_PROTECT(lev);
+	if (sock->select_waiting > 0) {
+		sock->select_waiting--;
+	}
+
+	/* Take select_cb off the pollers list of the socket */
+	if (select_cb) {
+		if (select_cb->next != NULL) {
+			select_cb->next->prev = select_cb->prev;
+		}
+		if (sock->pollers == select_cb) {
+			LWIP_ASSERT("select_cb.prev == NULL", select_cb->prev == NULL);
+			sock->pollers = select_cb->next;
+		} else {
+			LWIP_ASSERT("select_cb.prev != NULL", select_cb->prev != NULL);
+			select_cb->prev->next = select_cb->next;
+		}
+	}
+	SYS_ARCH_UNPROTECT(lev);
+
+	if (select_cb) {
+		mem_free((void *)select_cb);
+	}
+
+	/* See what's set */
+	lwip_poll_scan(fd, sock, fds);
+
+	return 0;
+}
+
+/****************************************************************************
+ * Function: lwip_poll
+ *
+ * Description:
+ *   The standard poll() operation redirects operations on socket descriptors
+ *   to this function.
+ *
+ * Input Parameters:
+ *   sock - An instance of the lwip socket structure.
+ *   fds   - The structure describing the events to be monitored, OR NULL if
+ *           this is a request to stop monitoring events.
+ *   setup - true: Setup up the poll; false: Teardown the poll
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+int lwip_poll(int fd, struct pollfd *fds, bool setup)
+{
+
+	int ret = 0;
+
+	struct socket *sock = NULL;
+
+	/* First get the socket's status (protected)... */
+
+	sock = tryget_socket(fd);
+	if (!sock) {
+		/* Need to check select_waiting counter on socket ... */
+		sock = trycheck_selwait_socket(fd);
+		if (!sock) {
+			return -EBADF;
+		}
+		/* Suspisious case, try to make poll setup with invalid socket */
+		LWIP_ASSERT("setup = true", (setup == false));
+
+		/* Set to zero for send/rcv event to prevent setting abnormal value */
+		sock->sendevent = 0;
+		sock->rcvevent = 0;
+	}
+
+	/* Check if we are setting up or tearing down the poll */
+
+	if (setup) {
+		/* Perform the LWIP poll() setup */
+		ret = lwip_poll_setup(fd, sock, fds);
+	} else {
+		/* Perform the LWIP poll() teardown */
+		ret = lwip_poll_teardown(fd, sock, fds);
+	}
+
+	return ret;
+
+}
+
+#endif							/*LWIP_SELECT */
+
+#if LWIP_EPOLL
+/* The interest and ready lists are changed with SYS_ARCH protected, so
+ * event_callback can queue a ready socket without taking a semaphore.
+ * Items are allocated and freed outside of the protected sections.
+ */
+
+/** Events of the socket which the item waits for, 0 if there is none */
+static u32_t lwip_epoll_revents(struct socket *sock, u32_t events)
+{
+	u32_t revents = 0;
+
+	if ((events & ~(EPOLLET | EPOLLONESHOT)) == 0) {
+		/* disabled by EPOLLONESHOT */
+		return 0;
+	}
+	if ((events & EPOLLIN) && ((sock->lastdata != NULL) || (sock->rcvevent > 0))) {
+		revents |= EPOLLIN;
+	}
+	if ((events & EPOLLOUT) && (sock->sendevent != 0)) {
+		revents |= EPOLLOUT;
+	}
+	if (sock->errevent != 0) {
+		revents |= EPOLLERR;
+	}
+	return revents;
+}
+
+/** Append an item to the ready list, SYS_ARCH must be protected */
+static void lwip_epoll_enqueue(struct lwip_epitem *item)
+{
+	struct lwip_epoll *ep = item->ep;
+
+	if (item->ready) {
+		return;
+	}
+	item->ready = 1;
+	item->rdy_next = NULL;
+	if (ep->rdy_tail != NULL) {
+		ep->rdy_tail->rdy_next = item;
+	} else {
+		ep->rdy_head = item;
+		if (ep->waiting > 0) {
+			/* the tasks which come after this one are woken by it */
+			sys_sem_signal(&ep->sem);
+		}
+	}
+	ep->rdy_tail = item;
+}
+
+/** Take an item off the ready list, SYS_ARCH must be protected */
+static void lwip_epoll_dequeue(struct lwip_epitem *item)
+{
+	struct lwip_epoll *ep = item->ep;
+	struct lwip_epitem *prev = NULL;
+	struct lwip_epitem *cur;
+
+	if (!item->ready) {
+		return;
+	}
+	for (cur = ep->rdy_head; cur != item; cur = cur->rdy_next) {
+		prev = cur;
+	}
+	if (prev != NULL) {
+		prev->rdy_next = item->rdy_next;
+	} else {
+		ep->rdy_head = item->rdy_next;
+	}
+	if (ep->rdy_tail == item) {
+		ep->rdy_tail = prev;
+	}
+	item->ready = 0;
+}
+
+/** Take an item off the lists of its socket and its instance, SYS_ARCH must be protected */
+static void lwip_epoll_unlink(struct lwip_epitem *item)
+{
+	struct lwip_epitem **pp;
+
+	lwip_epoll_dequeue(item);
+
+	for (pp = &item->sock->epitems; *pp != item; pp = &(*pp)->sock_next) ;
+	*pp = item->sock_next;
+
+	if (item->ep_next != NULL) {
+		item->ep_next->ep_prev = item->ep_prev;
+	}
+	if (item->ep_prev != NULL) {
+		item->ep_prev->ep_next = item->ep_next;
+	} else {
+		item->ep->items = item->ep_next;
+	}
+}
+
+/** Queue the items of a socket which became ready, called by event_callback with SYS_ARCH protected */
+static void lwip_epoll_notify(struct socket *sock)
+{
+	struct lwip_epitem *item;
+
+	for (item = sock->epitems; item != NULL; item = item->sock_next) {
+		if (!item->ready && lwip_epoll_revents(sock, item->event.events) != 0) {
+			lwip_epoll_enqueue(item);
+		}
+	}
+}
+
+/** Remove a socket which is being closed from all interest lists */
+static void lwip_epoll_forget(struct socket *sock)
+{
+	struct lwip_epitem *item;
+	struct lwip_epitem *freelist = NULL;
+	SYS_ARCH_DECL_PROTECT(lev);
 
-	if (!select_cb) {
-		return -ENOMEM;
+	SYS_ARCH_PROTECT(lev);
+	while ((item = sock->epitems) != NULL) {
+		lwip_epoll_unlink(item);
+		item->sock_next = freelist;
+		freelist = item;
 	}
+	SYS_ARCH_UNPROTECT(lev);
 
-	memset(select_cb, 0, scb_size);
+	while ((item = freelist) != NULL) {
+		freelist = item->sock_next;
+		mem_free(item);
+	}
+}
 
-	/* None ready: add our semaphore to list: */
+/** Get the epoll instance of a descriptor, SYS_ARCH must be protected */
+static struct lwip_epoll *lwip_epoll_get(int s)
+{
+	s -= LWIP_SOCKET_OFFSET;
+	if ((s < 0) || (s >= NUM_SOCKETS)) {
+		return NULL;
+	}
+	return sockets[s].epoll;
+}
 
-	select_cb->next = NULL;
-	select_cb->prev = NULL;
-	select_cb->sem_signalled = 0;
-	select_cb->poll_sem = fds->sem;
-	select_cb->events = fds->events;
-	select_cb->sfd = fd;
+static void lwip_epoll_free(struct lwip_epoll *ep)
+{
+	sys_sem_free(&ep->sem);
+	mem_free(ep);
+}
 
-	/* Protect the select_cb_list */
-	SYS_ARCH_PROTECT(lev);
+/**
+ * Release an epoll descriptor.
+ *
+ * @param s externally used socket index
+ * @return 0 if s was an epoll descriptor, -1 if it was not
+ */
+static int lwip_epoll_close(int s)
+{
+	struct lwip_epoll *ep;
+	struct lwip_epitem *item;
+	struct lwip_epitem *freelist = NULL;
+	int waiting;
+	SYS_ARCH_DECL_PROTECT(lev);
 
-	/* Put this select_cb on top of list */
-	select_cb->next = select_cb_list;
-	if (select_cb_list != NULL) {
-		select_cb_list->prev = select_cb;
+	SYS_ARCH_PROTECT(lev);
+	ep = lwip_epoll_get(s);
+	if (ep == NULL) {
+		SYS_ARCH_UNPROTECT(lev);
+		return -1;
 	}
+	sockets[s - LWIP_SOCKET_OFFSET].epoll = NULL;
 
-	fds->scb = (void *)select_cb;
-	select_cb_list = select_cb;
+	while ((item = ep->items) != NULL) {
+		lwip_epoll_unlink(item);
+		item->sock_next = freelist;
+		freelist = item;
+	}
 
-	/* Increasing this counter tells event_callback that the list has changed. */
-	select_cb_ctr++;
+	/* the waiting tasks return EBADF, the last one frees the instance */
+	ep->closed = 1;
+	waiting = ep->waiting;
+	while (waiting-- > 0) {
+		sys_sem_signal(&ep->sem);
+	}
+	waiting = ep->waiting;
+	SYS_ARCH_UNPROTECT(lev);
 
-	/* Increase select_waiting for the socket */
-	sock->select_waiting++;
+	while ((item = freelist) != NULL) {
+		freelist = item->sock_next;
+		mem_free(item);
+	}
+	if (waiting == 0) {
+		lwip_epoll_free(ep);
+	}
+	set_errno(0);
+	return 0;
+}
 
-	/* Now we can safely unprotect */
-	SYS_ARCH_UNPROTECT(lev);
+int lwip_epoll_create(int flags)
+{
+	struct lwip_epoll *ep;
+	int i;
+	SYS_ARCH_DECL_PROTECT(lev);
 
-	/* Call lwip_pollscan again: there could have been events between
-	   the last scan (without us on the list) and putting us on the list! */
-	nready = lwip_poll_scan(fd, sock, fds);
+	if ((flags & ~EPOLL_CLOEXEC) != 0) {
+		set_errno(EINVAL);
+		return -1;
+	}
 
-	/* Check if any requested events are already in effect */
-	if (nready > 0 && fds->revents != 0) {
-		/* Yes.. then signal the poll logic */
+	ep = (struct lwip_epoll *)mem_malloc(sizeof(struct lwip_epoll));
+	if (ep == NULL) {
+		set_errno(ENOMEM);
+		return -1;
+	}
+	memset(ep, 0, sizeof(struct lwip_epoll));
+	if (sys_sem_new(&ep->sem, 0) != ERR_OK) {
+		mem_free(ep);
+		set_errno(ENOMEM);
+		return -1;
+	}
 
-		sys_sem_signal(fds->sem);
+	/* the instance takes a free socket slot, so close() finds it */
+	for (i = 0; i < NUM_SOCKETS; ++i) {
+		SYS_ARCH_PROTECT(lev);
+		if (!sockets[i].conn && (sockets[i].select_waiting == 0) && !SOCK_IS_EPOLL(&sockets[i])) {
+			sockets[i].epoll = ep;
+			SYS_ARCH_UNPROTECT(lev);
+			LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_epoll_create() = %d\n", i + LWIP_SOCKET_OFFSET));
+			set_errno(0);
+			return i + LWIP_SOCKET_OFFSET;
+		}
+		SYS_ARCH_UNPROTECT(lev);
 	}
 
-	return 0;
+	lwip_epoll_free(ep);
+	set_errno(ENFILE);
+	return -1;
 }
 
-static int lwip_poll_teardown(int fd, struct socket *sock, struct pollfd *fds)
+int lwip_epoll_ctl(int epfd, int op, int fd, struct epoll_event *event)
 {
-	struct lwip_select_cb *select_cb = NULL;
+	struct lwip_epoll *ep;
+	struct socket *sock;
+	struct lwip_epitem *item;
+	struct lwip_epitem *newitem = NULL;
+	int err = 0;
 	SYS_ARCH_DECL_PROTECT(lev);
 
-	select_cb = (struct lwip_select_cb *)fds->scb;
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_epoll_ctl(%d, %d, %d)\n", epfd, op, fd));
 
-	SYS_ARCH_PROTECT(lev);
-	if (sock->select_waiting > 0) {
-		sock->select_waiting--;
+	if (op != EPOLL_CTL_ADD && op != EPOLL_CTL_MOD && op != EPOLL_CTL_DEL) {
+		set_errno(EINVAL);
+		return -1;
+	}
+	if (op != EPOLL_CTL_DEL && event == NULL) {
+		set_errno(EFAULT);
+		return -1;
 	}
 
-	/* Take select_cb_list off the list */
-	if (select_cb) {
-		if (select_cb->next != NULL) {
-			select_cb->next->prev = select_cb->prev;
+	if (op == EPOLL_CTL_ADD) {
+		newitem = (struct lwip_epitem *)mem_malloc(sizeof(struct lwip_epitem));
+		if (newitem == NULL) {
+			set_errno(ENOMEM);
+			return -1;
 		}
-		if (select_cb_list == select_cb) {
-			LWIP_ASSERT("select_cb.prev == NULL", select_cb->prev == NULL);
-			select_cb_list = select_cb->next;
-		} else {
-			LWIP_ASSERT("select_cb.prev != NULL", select_cb->prev != NULL);
-			select_cb->prev->next = select_cb->next;
+		memset(newitem, 0, sizeof(struct lwip_epitem));
+	}
+
+	SYS_ARCH_PROTECT(lev);
+	ep = lwip_epoll_get(epfd);
+	sock = tryget_socket(fd);
+	if (ep == NULL || sock == NULL) {
+		err = EBADF;
+		goto out;
+	}
+
+	for (item = sock->epitems; item != NULL; item = item->sock_next) {
+		if (item->ep == ep) {
+			break;
 		}
+	}
 
-		mem_free((void *)select_cb);
-		/* Increasing this counter tells event_callback that the list has changed. */
-		select_cb_ctr++;
+	switch (op) {
+	case EPOLL_CTL_ADD:
+		if (item != NULL) {
+			err = EEXIST;
+			break;
+		}
+		item = newitem;
+		newitem = NULL;
+		item->ep = ep;
+		item->sock = sock;
+		item->event = *event;
+		item->sock_next = sock->epitems;
+		sock->epitems = item;
+		item->ep_next = ep->items;
+		if (ep->items != NULL) {
+			ep->items->ep_prev = item;
+		}
+		ep->items = item;
+		if (lwip_epoll_revents(sock, item->event.events) != 0) {
+			lwip_epoll_enqueue(item);
+		}
+		break;
+	case EPOLL_CTL_MOD:
+		if (item == NULL) {
+			err = ENOENT;
+			break;
+		}
+		item->event = *event;
+		/* a modified item is checked again, also for EPOLLET */
+		if (lwip_epoll_revents(sock, item->event.events) != 0) {
+			lwip_epoll_enqueue(item);
+		}
+		break;
+	default:
+		if (item == NULL) {
+			err = ENOENT;
+			break;
+		}
+		lwip_epoll_unlink(item);
+		newitem = item;
+		break;
 	}
-	SYS_ARCH_UNPROTECT(lev);
 
-	/* See what's set */
-	lwip_poll_scan(fd, sock, fds);
+out:
+	SYS_ARCH_UNPROTECT(lev);
 
+	if (newitem != NULL) {
+		mem_free(newitem);
+	}
+	if (err != 0) {
+		set_errno(err);
+		return -1;
+	}
+	set_errno(0);
 	return 0;
 }
 
-/****************************************************************************
- * Function: lwip_poll
- *
- * Description:
- *   The standard poll() operation redirects operations on socket descriptors
- *   to this function.
- *
- * Input Parameters:
- *   sock - An instance of the lwip socket structure.
- *   fds   - The structure describing the events to be monitored, OR NULL if
- *           this is a request to stop monitoring events.
- *   setup - true: Setup up the poll; false: Teardown the poll
- *
- * Returned Value:
- *  0: Success; Negated errno on failure
- *
- ****************************************************************************/
-
-int lwip_poll(int fd, struct pollfd *fds, bool setup)
+/** Move the ready items to events, SYS_ARCH must be protected */
+static int lwip_epoll_harvest(struct lwip_epoll *ep, struct epoll_event *events, int maxevents)
 {
+	struct lwip_epitem *item;
+	struct lwip_epitem *head = NULL;
+	struct lwip_epitem *tail = NULL;
+	u32_t revents;
+	int nready = 0;
 
-	int ret = 0;
+	while (nready < maxevents && (item = ep->rdy_head) != NULL) {
+		ep->rdy_head = item->rdy_next;
+		if (ep->rdy_head == NULL) {
+			ep->rdy_tail = NULL;
+		}
+		item->ready = 0;
 
-	struct socket *sock = NULL;
+		revents = lwip_epoll_revents(item->sock, item->event.events);
+		if (revents == 0) {
+			/* not ready anymore, it is queued again by the next event */
+			continue;
+		}
+		events[nready].events = revents;
+		events[nready].data = item->event.data;
+		nready++;
 
-	/* First get the socket's status (protected)... */
+		if (item->event.events & EPOLLONESHOT) {
+			item->event.events = 0;
+		} else if (!(item->event.events & EPOLLET)) {
+			/* level triggered: keep it and check it again on the next wait */
+			item->ready = 1;
+			item->rdy_next = NULL;
+			if (tail != NULL) {
+				tail->rdy_next = item;
+			} else {
+				head = item;
+			}
+			tail = item;
+		}
+	}
 
-	sock = tryget_socket(fd);
-	if (!sock) {
-		/* Need to check select_waiting counter on socket ... */
-		sock = trycheck_selwait_socket(fd);
-		if (!sock) {
-			return -EBADF;
+	/* the kept items go behind the ones which were not reported */
+	if (head != NULL) {
+		if (ep->rdy_tail != NULL) {
+			ep->rdy_tail->rdy_next = head;
+		} else {
+			ep->rdy_head = head;
 		}
-		/* Suspisious case, try to make poll setup with invalid socket */
-		LWIP_ASSERT("setup = true", (setup == false));
+		ep->rdy_tail = tail;
+	}
+	return nready;
+}
 
-		/* Set to zero for send/rcv event to prevent setting abnormal value */
-		sock->sendevent = 0;
-		sock->rcvevent = 0;
+int lwip_epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout)
+{
+	struct lwip_epoll *ep;
+	int nready;
+	int err = 0;
+	u32_t waitres;
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	if (events == NULL || maxevents <= 0) {
+		set_errno(EINVAL);
+		return -1;
 	}
 
-	/* Check if we are setting up or tearing down the poll */
+	SYS_ARCH_PROTECT(lev);
+	ep = lwip_epoll_get(epfd);
+	if (ep == NULL) {
+		SYS_ARCH_UNPROTECT(lev);
+		set_errno(EBADF);
+		return -1;
+	}
 
-	if (setup) {
-		/* Perform the LWIP poll() setup */
-		ret = lwip_poll_setup(fd, sock, fds);
-	} else {
-		/* Perform the LWIP poll() teardown */
-		ret = lwip_poll_teardown(fd, sock, fds);
+	for (;;) {
+		nready = lwip_epoll_harvest(ep, events, maxevents);
+		if (nready > 0 || timeout == 0) {
+			break;
+		}
+
+		ep->waiting++;
+		SYS_ARCH_UNPROTECT(lev);
+		waitres = sys_arch_sem_wait(&ep->sem, timeout < 0 ? 0 : (u32_t)timeout);
+		SYS_ARCH_PROTECT(lev);
+		ep->waiting--;
+
+		if (ep->closed) {
+			err = EBADF;
+			break;
+		}
+		if (waitres == SYS_ARCH_CANCELED) {
+			err = ECANCELED;
+			break;
+		}
+		if (waitres == SYS_ARCH_TIMEOUT) {
+			nready = lwip_epoll_harvest(ep, events, maxevents);
+			break;
+		}
+		if (timeout > 0) {
+			/* woken for an item which was not ready anymore */
+			timeout = (waitres < (u32_t)timeout) ? timeout - (int)waitres : 0;
+		}
 	}
 
-	return ret;
+	if (err == 0 && ep->rdy_head != NULL && ep->waiting > 0) {
+		/* pass the remaining items to the next waiting task */
+		sys_sem_signal(&ep->sem);
+	}
+	if (ep->closed && ep->waiting == 0) {
+		SYS_ARCH_UNPROTECT(lev);
+		lwip_epoll_free(ep);
+	} else {
+		SYS_ARCH_UNPROTECT(lev);
+	}
 
+	if (err != 0) {
+		set_errno(err);
+		return -1;
+	}
+	set_errno(0);
+	return nready;
 }
-
-#endif							/*LWIP_SELECT */
+#endif							/* LWIP_EPOLL */
 
 /**
  * Callback registered in the netconn layer for each socket-netconn.
@@ -1891,7 +3097,9 @@ static void event_callback(struct netconn *conn, enum netconn_evt evt, u16_t len
 	int s;
 	struct socket *sock;
 	struct lwip_select_cb *scb;
+#if LWIP_SELECT
 	int last_select_cb_ctr;
+#endif
 	SYS_ARCH_DECL_PROTECT(lev);
 
 	LWIP_UNUSED_ARG(len);
@@ -1925,6 +3133,19 @@ static void event_callback(struct netconn *conn, enum netconn_evt evt, u16_t len
 		return;
 	}
 
+#if LWIP_ZEROCOPY && LWIP_TCP
+	/* data sent by reference is done when it is acknowledged or the pcb is gone */
+	if (evt == NETCONN_EVT_ACKED) {
+		if (sock->zc_sends != NULL) {
+			lwip_zc_complete(sock);
+		}
+		return;
+	}
+	if (evt == NETCONN_EVT_ERROR && sock->zc_sends != NULL) {
+		lwip_zc_complete(sock);
+	}
+#endif
+
 	SYS_ARCH_PROTECT(lev);
 	/* Set event as required */
 	switch (evt) {
@@ -1948,12 +3169,21 @@ static void event_callback(struct netconn *conn, enum netconn_evt evt, u16_t len
 		break;
 	}
 
+#if LWIP_EPOLL
+	/* Only an event which can make the socket ready is passed on, so an
+	   edge triggered item is queued again only by new data or space */
+	if (sock->epitems != NULL && evt != NETCONN_EVT_RCVMINUS && evt != NETCONN_EVT_SENDMINUS) {
+		lwip_epoll_notify(sock);
+	}
+#endif
+
 	if (sock->select_waiting == 0) {
 		/* none is waiting for this socket, no need to check select_cb_list */
 		SYS_ARCH_UNPROTECT(lev);
 		return;
 	}
 
+#if LWIP_SELECT
 	/* Now decide if anyone is waiting for this socket */
 	/* NOTE: This code goes through the select_cb_list list multiple times
 	   ONLY IF a select was actually waiting. We go through the list the number
@@ -1967,35 +3197,19 @@ again:
 		if (scb->sem_signalled == 0) {
 			/* semaphore not signalled yet */
 			int do_signal = 0;
-			int check_set = 0;
 			/* Test this select call for our socket */
 			if (sock->rcvevent > 0) {
-#if LWIP_SELECT
-				check_set = scb->readset && FD_ISSET(s, scb->readset);
-#else
-				check_set = (scb->sfd == s) && (scb->events & POLLIN);
-#endif
-				if (check_set) {
+				if (scb->readset && FD_ISSET(s, scb->readset)) {
 					do_signal = 1;
 				}
 			}
 			if (sock->sendevent != 0) {
-#if LWIP_SELECT
-				check_set = scb->writeset && FD_ISSET(s, scb->writeset);
-#else
-				check_set = (scb->sfd == s) && (scb->events & POLLOUT);
-#endif
-				if (!do_signal && check_set) {
+				if (!do_signal && scb->writeset && FD_ISSET(s, scb->writeset)) {
 					do_signal = 1;
 				}
 			}
 			if (sock->errevent != 0) {
-#if LWIP_SELECT
-				check_set = scb->exceptset && FD_ISSET(s, scb->exceptset);
-#else
-				check_set = (scb->sfd == s) && (scb->events & POLLERR);
-#endif
-				if (!do_signal && check_set) {
+				if (!do_signal && scb->exceptset && FD_ISSET(s, scb->exceptset)) {
 					do_signal = 1;
 				}
 			}
@@ -2003,11 +3217,7 @@ again:
 				scb->sem_signalled = 1;
 				/* Don't call SYS_ARCH_UNPROTECT() before signaling the semaphore, as this might
 				   lead to the select thread taking itself off the list, invalidagin the semaphore. */
-#if LWIP_SELECT
 				sys_sem_signal(&scb->sem);
-#else
-				sys_sem_signal(scb->poll_sem);
-#endif
 			}
 		}
 		/* unlock interrupts with each step */
@@ -2019,6 +3229,18 @@ again:
 			goto again;
 		}
 	}
+#else
+	/* Only the tasks polling this socket are on its list, the list stays
+	   protected while it is walked as it is not shared with other sockets */
+	for (scb = sock->pollers; scb != NULL; scb = scb->next) {
+		if (scb->sem_signalled == 0) {
+			if (((scb->events & POLLIN) && (sock->rcvevent > 0)) || ((scb->events & POLLOUT) && (sock->sendevent != 0)) || ((scb->events & POLLERR) && (sock->errevent != 0))) {
+				scb->sem_signalled = 1;
+				sys_sem_signal(scb->poll_sem);
+			}
+		}
+	}
+#endif							/* LWIP_SELECT */
 	SYS_ARCH_UNPROTECT(lev);
 }
 
@@ -2059,6 +3281,12 @@ int lwip_shutdown(int s, int how)
 		sock_set_errno(sock, EINVAL);
 		return -1;
 	}
+#if LWIP_ZEROCOPY && LWIP_TCP
+	/* the FIN waits for data sent by reference, the pcb can go away with it */
+	if (shut_tx) {
+		lwip_zc_drain(sock);
+	}
+#endif
 	err = netconn_shutdown(sock->conn, shut_rx, shut_tx);
 
 	sock_set_errno(sock, err_to_errno(err));
@@ -2326,6 +3554,12 @@ static u8_t lwip_getsockopt_impl(int s, int level, int optname, void *optval, so
 			*(int *)optval = (udp_flags(sock->conn->pcb.udp) & UDP_FLAGS_NOCHKSUM) ? 1 : 0;
 			break;
 #endif							/* LWIP_UDP */
+#if PBUF_POOL_RESERVE
+		case SO_PRIORITY:
+			LWIP_SOCKOPT_CHECK_OPTLEN_CONN_PCB(sock, *optlen, int);
+			*(int *)optval = ip_get_prio(sock->conn->pcb.ip);
+			break;
+#endif							/* PBUF_POOL_RESERVE */
 		default:
 			LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_getsockopt(%d, SOL_SOCKET, UNIMPL: optname=0x%x, ..)\n", s, optname));
 			err = ENOPROTOOPT;
@@ -2669,6 +3903,15 @@ static u8_t lwip_setsockopt_impl(int s, int level, int optname, const void *optv
 			}
 			break;
 #endif							/* LWIP_UDP */
+#if PBUF_POOL_RESERVE
+		case SO_PRIORITY:
+			LWIP_SOCKOPT_CHECK_OPTLEN_CONN_PCB(sock, optlen, int);
+			if ((*(const int *)optval < 0) || (*(const int *)optval > 7)) {
+				return EINVAL;
+			}
+			ip_set_prio(sock->conn->pcb.ip, *(const int *)optval);
+			break;
+#endif							/* PBUF_POOL_RESERVE */
 		default:
 			LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_setsockopt(%d, SOL_SOCKET, UNIMPL: optname=0x%x, ..)\n", s, optname));
 			err = ENOPROTOOPT;
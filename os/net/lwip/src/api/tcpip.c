@@ -91,6 +91,76 @@ sys_mutex_t lock_tcpip_core;
 #define TCPIP_MBOX_FETCH(mbox, msg) sys_mbox_fetch(mbox, msg)
 #endif							/* LWIP_TIMERS */
 
+/** Messages handled per wakeup of tcpip_thread before the timeouts are checked again */
+#ifndef TCPIP_MBOX_BATCH
+#define TCPIP_MBOX_BATCH 16
+#endif
+
+/**
+ * Handle one message in tcpip_thread with the core locked.
+ *
+ * @param msg the message taken from the mailbox
+ */
+static void tcpip_thread_handle_msg(struct tcpip_msg *msg)
+{
+	if (msg == NULL) {
+		LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: invalid message: NULL\n"));
+		LWIP_ASSERT("tcpip_thread: invalid message", 0);
+		return;
+	}
+
+	switch (msg->type) {
+#if !LWIP_TCPIP_CORE_LOCKING
+	case TCPIP_MSG_API:
+		LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: API message %p\n", (void *)msg));
+		msg->msg.api_msg.function(msg->msg.api_msg.msg);
+		break;
+	case TCPIP_MSG_API_CALL:
+		LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: API CALL message %p\n", (void *)msg));
+		msg->msg.api_call.arg->err = msg->msg.api_call.function(msg->msg.api_call.arg);
+		sys_sem_signal(msg->msg.api_call.sem);
+		break;
+#endif							/* !LWIP_TCPIP_CORE_LOCKING */
+
+#if !LWIP_TCPIP_CORE_LOCKING_INPUT
+	case TCPIP_MSG_INPKT:
+		LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: PACKET %p\n", (void *)msg));
+		msg->msg.inp.input_fn(msg->msg.inp.p, msg->msg.inp.netif);
+		memp_free(MEMP_TCPIP_MSG_INPKT, msg);
+		break;
+#endif							/* !LWIP_TCPIP_CORE_LOCKING_INPUT */
+
+#if LWIP_TCPIP_TIMEOUT			// && LWIP_TIMERS
+	case TCPIP_MSG_TIMEOUT:
+		LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: TIMEOUT %p\n", (void *)msg));
+		sys_timeout(msg->msg.tmo.msecs, msg->msg.tmo.h, msg->msg.tmo.arg);
+		memp_free(MEMP_TCPIP_MSG_API, msg);
+		break;
+	case TCPIP_MSG_UNTIMEOUT:
+		LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: UNTIMEOUT %p\n", (void *)msg));
+		sys_untimeout(msg->msg.tmo.h, msg->msg.tmo.arg);
+		memp_free(MEMP_TCPIP_MSG_API, msg);
+		break;
+#endif							/* LWIP_TCPIP_TIMEOUT && LWIP_TIMERS */
+
+	case TCPIP_MSG_CALLBACK:
+		LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: CALLBACK %p\n", (void *)msg));
+		msg->msg.cb.function(msg->msg.cb.ctx);
+		memp_free(MEMP_TCPIP_MSG_API, msg);
+		break;
+
+	case TCPIP_MSG_CALLBACK_STATIC:
+		LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: CALLBACK_STATIC %p\n", (void *)msg));
+		msg->msg.cb.function(msg->msg.cb.ctx);
+		break;
+
+	default:
+		LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: invalid message: %d\n", msg->type));
+		LWIP_ASSERT("tcpip_thread: invalid message", 0);
+		break;
+	}
+}
+
 /**
  * The main lwIP thread. This thread has exclusive access to lwIP core functions
  * (unless access to them is not locked). Other threads communicate with this
@@ -104,6 +174,7 @@ sys_mutex_t lock_tcpip_core;
 static void tcpip_thread(void *arg)
 {
 	struct tcpip_msg *msg = NULL;
+	int batch;
 	LWIP_UNUSED_ARG(arg);
 
 	if (tcpip_init_done != NULL) {
@@ -119,62 +190,12 @@ static void tcpip_thread(void *arg)
 
 		LOCK_TCPIP_CORE();
 
-		if (msg == NULL) {
-			LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: invalid message: NULL\n"));
-			LWIP_ASSERT("tcpip_thread: invalid message", 0);
-			continue;
-		}
-
-		switch (msg->type) {
-#if !LWIP_TCPIP_CORE_LOCKING
-		case TCPIP_MSG_API:
-			LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: API message %p\n", (void *)msg));
-			msg->msg.api_msg.function(msg->msg.api_msg.msg);
-			break;
-		case TCPIP_MSG_API_CALL:
-			LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: API CALL message %p\n", (void *)msg));
-			msg->msg.api_call.arg->err = msg->msg.api_call.function(msg->msg.api_call.arg);
-			sys_sem_signal(msg->msg.api_call.sem);
-			break;
-#endif							/* !LWIP_TCPIP_CORE_LOCKING */
-
-#if !LWIP_TCPIP_CORE_LOCKING_INPUT
-		case TCPIP_MSG_INPKT:
-			LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: PACKET %p\n", (void *)msg));
-			msg->msg.inp.input_fn(msg->msg.inp.p, msg->msg.inp.netif);
-			memp_free(MEMP_TCPIP_MSG_INPKT, msg);
-			break;
-#endif							/* !LWIP_TCPIP_CORE_LOCKING_INPUT */
-
-#if LWIP_TCPIP_TIMEOUT			// && LWIP_TIMERS
-		case TCPIP_MSG_TIMEOUT:
-			LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: TIMEOUT %p\n", (void *)msg));
-			sys_timeout(msg->msg.tmo.msecs, msg->msg.tmo.h, msg->msg.tmo.arg);
-			memp_free(MEMP_TCPIP_MSG_API, msg);
-			break;
-		case TCPIP_MSG_UNTIMEOUT:
-			LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: UNTIMEOUT %p\n", (void *)msg));
-			sys_untimeout(msg->msg.tmo.h, msg->msg.tmo.arg);
-			memp_free(MEMP_TCPIP_MSG_API, msg);
-			break;
-#endif							/* LWIP_TCPIP_TIMEOUT && LWIP_TIMERS */
-
-		case TCPIP_MSG_CALLBACK:
-			LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: CALLBACK %p\n", (void *)msg));
-			msg->msg.cb.function(msg->msg.cb.ctx);
-			memp_free(MEMP_TCPIP_MSG_API, msg);
-			break;
-
-		case TCPIP_MSG_CALLBACK_STATIC:
-			LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: CALLBACK_STATIC %p\n", (void *)msg));
-			msg->msg.cb.function(msg->msg.cb.ctx);
-			break;
-
-		default:
-			LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: invalid message: %d\n", msg->type));
-			LWIP_ASSERT("tcpip_thread: invalid message", 0);
-			break;
-		}
+		/* handle the messages which were queued meanwhile without waiting
+		   again, taking a queued message does not block */
+		batch = 0;
+		do {
+			tcpip_thread_handle_msg(msg);
+		} while (++batch < TCPIP_MBOX_BATCH && sys_arch_mbox_tryfetch(&mbox, (void **)&msg) != SYS_MBOX_EMPTY);
 	}
 }
 
@@ -372,14 +393,19 @@ err_t tcpip_send_msg_wait_sem(tcpip_callback_fn fn, void *apimsg, sys_sem_t *sem
  * LWIP_NETCONN_SEM_PER_THREAD.
  * If not, a semaphore is created and destroyed on every call which is usually
  * an expensive/slow operation.
+ * With block 0 the call is not queued when the mailbox of the tcpip thread is
+ * full. The core lock of LWIP_TCPIP_CORE_LOCKING is taken in both modes.
  * @param fn Function to call
  * @param call Call parameters
- * @return Return value from tcpip_api_call_fn
+ * @param block 1 to block until the call is posted, 0 to non-blocking mode
+ * @return Return value from tcpip_api_call_fn, ERR_WOULDBLOCK if the call
+ *         was not posted
  */
-err_t tcpip_api_call(tcpip_api_call_fn fn, struct tcpip_api_call_data *call)
+err_t tcpip_api_call_with_block(tcpip_api_call_fn fn, struct tcpip_api_call_data *call, u8_t block)
 {
 #if LWIP_TCPIP_CORE_LOCKING
 	err_t err;
+	LWIP_UNUSED_ARG(block);
 	LOCK_TCPIP_CORE();
 	err = fn(call);
 	UNLOCK_TCPIP_CORE();
@@ -405,7 +431,15 @@ err_t tcpip_api_call(tcpip_api_call_fn fn, struct tcpip_api_call_data *call)
 #else							/* LWIP_NETCONN_SEM_PER_THREAD */
 	TCPIP_MSG_VAR_REF(msg).msg.api_call.sem = &call->sem;
 #endif							/* LWIP_NETCONN_SEM_PER_THREAD */
-	sys_mbox_post(&mbox, &TCPIP_MSG_VAR_REF(msg));
+	if (block) {
+		sys_mbox_post(&mbox, &TCPIP_MSG_VAR_REF(msg));
+	} else if (sys_mbox_trypost(&mbox, &TCPIP_MSG_VAR_REF(msg)) != ERR_OK) {
+		TCPIP_MSG_VAR_FREE(msg);
+#if !LWIP_NETCONN_SEM_PER_THREAD
+		sys_sem_free(&call->sem);
+#endif							/* LWIP_NETCONN_SEM_PER_THREAD */
+		return ERR_WOULDBLOCK;
+	}
 	sys_arch_sem_wait(TCPIP_MSG_VAR_REF(msg).msg.api_call.sem, 0);
 	TCPIP_MSG_VAR_FREE(msg);
 
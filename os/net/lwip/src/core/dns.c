@@ -349,6 +349,7 @@ void dns_init(void)
 	if (dns_pcbs[0] == NULL) {
 		dns_pcbs[0] = udp_new_ip_type(IPADDR_TYPE_ANY);
 		LWIP_ASSERT("dns_pcbs[0] != NULL", dns_pcbs[0] != NULL);
+		ip_set_prio(dns_pcbs[0], PBUF_POOL_RESERVE_PRIO);
 
 		/* initialize DNS table not needed (initialized to zero since it is a
 		 * global variable) */
@@ -838,6 +839,7 @@ static struct udp_pcb *dns_alloc_random_port(void)
 		/* out of memory, have to reuse an existing pcb */
 		return NULL;
 	}
+	ip_set_prio(ret, PBUF_POOL_RESERVE_PRIO);
 	do {
 		u16_t port = (u16_t) DNS_RAND_TXID();
 		if (!DNS_PORT_ALLOWED(port)) {
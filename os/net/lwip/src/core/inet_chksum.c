@@ -27,7 +27,7 @@
  * \#define LWIP_CHKSUM your_checksum_routine
  *
  * Or you can select from the implementations below by defining
- * LWIP_CHKSUM_ALGORITHM to 1, 2 or 3.
+ * LWIP_CHKSUM_ALGORITHM to 1, 2, 3 or 4.
  */
 
 /*
@@ -269,6 +269,138 @@ u16_t lwip_standard_chksum(const void *dataptr, int len)
 }
 #endif
 
+#if (LWIP_CHKSUM_ALGORITHM == 4) || (LWIP_CHKSUM_COPY_ALGORITHM == 2)
+/* Add a 32-bit word to a one's complement sum, carry goes back to bit 0 */
+#define CHKSUM_ADD32(sum, w) do { \
+		u32_t __w = (w); \
+		(sum) += __w; \
+		(sum) += ((sum) < __w); \
+	} while (0)
+#endif
+
+#if (LWIP_CHKSUM_ALGORITHM == 4)	/* Alternative version #4 */
+#if defined(__GNUC__) && (defined(__ARM_ARCH_7A__) || defined(__ARM_ARCH_7R__) || \
+	defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__))
+/**
+ * Sum nblocks blocks of 32 bytes. ldmia loads four words in one go and
+ * the adds/adcs chain keeps the carries in the flags, so one block costs
+ * two loads and nine additions.
+ */
+static u32_t lwip_chksum_blocks(const u32_t *pl, u32_t nblocks, u32_t sum)
+{
+	__asm__ __volatile__(
+		"1:\n\t"
+		"ldmia	%[p]!, {r3, r4, r5, r6}\n\t"
+		"adds	%[sum], %[sum], r3\n\t"
+		"adcs	%[sum], %[sum], r4\n\t"
+		"adcs	%[sum], %[sum], r5\n\t"
+		"adcs	%[sum], %[sum], r6\n\t"
+		"ldmia	%[p]!, {r3, r4, r5, r6}\n\t"
+		"adcs	%[sum], %[sum], r3\n\t"
+		"adcs	%[sum], %[sum], r4\n\t"
+		"adcs	%[sum], %[sum], r5\n\t"
+		"adcs	%[sum], %[sum], r6\n\t"
+		"adc	%[sum], %[sum], #0\n\t"
+		"subs	%[n], %[n], #1\n\t"
+		"bne	1b\n\t"
+		: [p] "+r"(pl), [n] "+r"(nblocks), [sum] "+r"(sum)
+		:
+		: "r3", "r4", "r5", "r6", "cc", "memory");
+	return sum;
+}
+#else
+/**
+ * Sum nblocks blocks of 32 bytes, eight independent loads per iteration
+ * so that the compiler can schedule them ahead of the additions.
+ */
+static u32_t lwip_chksum_blocks(const u32_t *pl, u32_t nblocks, u32_t sum)
+{
+	while (nblocks-- > 0) {
+		CHKSUM_ADD32(sum, pl[0]);
+		CHKSUM_ADD32(sum, pl[1]);
+		CHKSUM_ADD32(sum, pl[2]);
+		CHKSUM_ADD32(sum, pl[3]);
+		CHKSUM_ADD32(sum, pl[4]);
+		CHKSUM_ADD32(sum, pl[5]);
+		CHKSUM_ADD32(sum, pl[6]);
+		CHKSUM_ADD32(sum, pl[7]);
+		pl += 8;
+	}
+	return sum;
+}
+#endif
+
+/**
+ * Like version #3, but the aligned middle part is summed as 32-bit words
+ * in blocks of 32 bytes, with an ARMv7 assembly loop where available.
+ *
+ * @arg start of buffer to be checksummed. May be an odd byte address.
+ * @len number of bytes in the buffer to be checksummed.
+ * @return host order (!) lwip checksum (non-inverted Internet sum)
+ */
+u16_t lwip_standard_chksum(const void *dataptr, int len)
+{
+	const u8_t *pb = (const u8_t *)dataptr;
+	const u16_t *ps;
+	u16_t t = 0;
+	const u32_t *pl;
+	u32_t sum = 0;
+	/* starts at odd byte address? */
+	int odd = ((mem_ptr_t) pb & 1);
+
+	if (odd && len > 0) {
+		((u8_t *)&t)[1] = *pb++;
+		len--;
+	}
+
+	ps = (const u16_t *)(const void *)pb;
+
+	if (((mem_ptr_t) ps & 3) && len > 1) {
+		sum += *ps++;
+		len -= 2;
+	}
+
+	pl = (const u32_t *)(const void *)ps;
+
+	if (len >= 32) {
+		sum = lwip_chksum_blocks(pl, (u32_t)len >> 5, sum);
+		pl += ((u32_t)len >> 5) * 8;
+		len &= 31;
+	}
+
+	while (len > 3) {
+		CHKSUM_ADD32(sum, *pl++);
+		len -= 4;
+	}
+
+	/* make room in upper bits */
+	sum = FOLD_U32T(sum);
+
+	ps = (const u16_t *)pl;
+
+	if (len > 1) {
+		sum += *ps++;
+		len -= 2;
+	}
+
+	/* dangling tail byte remaining? */
+	if (len > 0) {
+		((u8_t *)&t)[0] = *(const u8_t *)ps;
+	}
+
+	sum += t;
+
+	sum = FOLD_U32T(sum);
+	sum = FOLD_U32T(sum);
+
+	if (odd) {
+		sum = SWAP_BYTES_IN_WORD(sum);
+	}
+
+	return (u16_t) sum;
+}
+#endif
+
 /** Parts of the pseudo checksum which are common to IPv4 and IPv6 */
 static u16_t inet_cksum_pseudo_base(struct pbuf *p, u8_t proto, u16_t proto_len, u32_t acc)
 {
@@ -601,3 +733,102 @@ u16_t lwip_chksum_copy(void *dst, const void *src, u16_t len)
 	return LWIP_CHKSUM(dst, len);
 }
 #endif							/* (LWIP_CHKSUM_COPY_ALGORITHM == 1) */
+
+#if (LWIP_CHKSUM_COPY_ALGORITHM == 2)	/* Version #2 */
+/** Copy and checksum in one pass: every word is summed while it is in a
+ * register on its way to dst. Needs src and dst with the same alignment
+ * (mod 4 for word copies, mod 2 for halfword copies), otherwise falls back
+ * to version #1.
+ */
+u16_t lwip_chksum_copy(void *dst, const void *src, u16_t len)
+{
+	const u8_t *s = (const u8_t *)src;
+	u8_t *d = (u8_t *)dst;
+	u16_t t = 0;
+	u32_t sum = 0;
+	u32_t w0, w1, w2, w3;
+	int n = len;
+	int odd;
+
+	if (((mem_ptr_t) s ^ (mem_ptr_t) d) & 1) {
+		MEMCPY(dst, src, len);
+		return LWIP_CHKSUM(dst, len);
+	}
+
+	/* starts at odd byte address? */
+	odd = ((mem_ptr_t) s & 1);
+	if (odd && n > 0) {
+		((u8_t *)&t)[1] = *s;
+		*d++ = *s++;
+		n--;
+	}
+
+	if ((((mem_ptr_t) s ^ (mem_ptr_t) d) & 3) == 0) {
+		if (((mem_ptr_t) s & 3) && n > 1) {
+			w0 = *(const u16_t *)(const void *)s;
+			*(u16_t *)(void *)d = (u16_t)w0;
+			sum += w0;
+			s += 2;
+			d += 2;
+			n -= 2;
+		}
+
+		while (n > 15) {
+			w0 = ((const u32_t *)(const void *)s)[0];
+			w1 = ((const u32_t *)(const void *)s)[1];
+			w2 = ((const u32_t *)(const void *)s)[2];
+			w3 = ((const u32_t *)(const void *)s)[3];
+			((u32_t *)(void *)d)[0] = w0;
+			((u32_t *)(void *)d)[1] = w1;
+			((u32_t *)(void *)d)[2] = w2;
+			((u32_t *)(void *)d)[3] = w3;
+			CHKSUM_ADD32(sum, w0);
+			CHKSUM_ADD32(sum, w1);
+			CHKSUM_ADD32(sum, w2);
+			CHKSUM_ADD32(sum, w3);
+			s += 16;
+			d += 16;
+			n -= 16;
+		}
+
+		while (n > 3) {
+			w0 = *(const u32_t *)(const void *)s;
+			*(u32_t *)(void *)d = w0;
+			CHKSUM_ADD32(sum, w0);
+			s += 4;
+			d += 4;
+			n -= 4;
+		}
+
+		/* make room in upper bits */
+		sum = FOLD_U32T(sum);
+	}
+
+	/* at most 32767 halfwords, the sum cannot overflow */
+	while (n > 1) {
+		w0 = *(const u16_t *)(const void *)s;
+		*(u16_t *)(void *)d = (u16_t)w0;
+		sum += w0;
+		s += 2;
+		d += 2;
+		n -= 2;
+	}
+
+	/* dangling tail byte remaining? */
+	if (n > 0) {
+		((u8_t *)&t)[0] = *s;
+		*d = *s;
+	}
+
+	sum += t;
+
+	sum = FOLD_U32T(sum);
+	sum = FOLD_U32T(sum);
+
+	if (odd) {
+		sum = SWAP_BYTES_IN_WORD(sum);
+	}
+
+	return (u16_t) sum;
+}
+#endif							/* (LWIP_CHKSUM_COPY_ALGORITHM == 2) */
@@ -303,7 +303,13 @@ PACK_STRUCT_END
 #ifdef LWIP_HOOK_MEMP_AVAILABLE
 #error "LWIP_HOOK_MEMP_AVAILABLE doesn't make sense with MEMP_MEM_MALLOC"
 #endif
+#if PBUF_POOL_RESERVE
+#error "PBUF_POOL_RESERVE doesn't make sense with MEMP_MEM_MALLOC"
+#endif
 #endif							/* MEMP_MEM_MALLOC */
+#if PBUF_POOL_RESERVE && (PBUF_POOL_RESERVE >= PBUF_POOL_SIZE)
+#error "PBUF_POOL_RESERVE must be smaller than PBUF_POOL_SIZE"
+#endif
 /* TCP sanity checks */
 #if !LWIP_DISABLE_TCP_SANITY_CHECKS
 #if LWIP_TCP
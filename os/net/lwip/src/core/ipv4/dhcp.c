@@ -248,6 +248,8 @@ static err_t dhcp_inc_pcb_refcount(void)
 		}
 
 		ip_set_option(dhcp_pcb, SOF_BROADCAST);
+		/* keep receiving leases while bulk traffic fills the pbuf pool */
+		ip_set_prio(dhcp_pcb, PBUF_POOL_RESERVE_PRIO);
 
 		/* set up local and remote port for the pcb -> listen on all interfaces on all src/dest IPs */
 		udp_bind(dhcp_pcb, IP4_ADDR_ANY, DHCP_CLIENT_PORT);
@@ -148,6 +148,33 @@ static void pbuf_pool_is_empty(void)
 }
 #endif							/* !LWIP_TCP || !TCP_QUEUE_OOSEQ || !PBUF_POOL_FREE_OOSEQ */
 
+#if PBUF_POOL_RESERVE
+/** Pool pbufs allocated, lowest number left free and packets refused to
+    keep PBUF_POOL_RESERVE pbufs for high priority traffic */
+static u16_t pbuf_pool_used;
+static u16_t pbuf_pool_min_avail = PBUF_POOL_SIZE;
+static u32_t pbuf_pool_refused;
+
+/** Count a pool pbuf taken by pbuf_alloc(), which may run in a driver */
+static void pbuf_pool_take(void)
+{
+	SYS_ARCH_DECL_PROTECT(old_level);
+
+	SYS_ARCH_PROTECT(old_level);
+	pbuf_pool_used++;
+	if ((u16_t)(PBUF_POOL_SIZE - pbuf_pool_used) < pbuf_pool_min_avail) {
+		pbuf_pool_min_avail = (u16_t)(PBUF_POOL_SIZE - pbuf_pool_used);
+	}
+	SYS_ARCH_UNPROTECT(old_level);
+}
+
+#define PBUF_POOL_TAKE() pbuf_pool_take()
+#define PBUF_POOL_GIVE() SYS_ARCH_DEC(pbuf_pool_used, 1)
+#else							/* PBUF_POOL_RESERVE */
+#define PBUF_POOL_TAKE()
+#define PBUF_POOL_GIVE()
+#endif							/* PBUF_POOL_RESERVE */
+
 /**
  * Allocates a pbuf of the given type (possibly a chain for PBUF_POOL type).
  *
@@ -222,6 +249,7 @@ struct pbuf *pbuf_alloc(pbuf_layer layer, u16_t length, pbuf_type type)
 			PBUF_POOL_IS_EMPTY();
 			return NULL;
 		}
+		PBUF_POOL_TAKE();
 		p->type = type;
 		p->next = NULL;
 
@@ -253,6 +281,7 @@ struct pbuf *pbuf_alloc(pbuf_layer layer, u16_t length, pbuf_type type)
 				/* bail out unsuccessfully */
 				return NULL;
 			}
+			PBUF_POOL_TAKE();
 			q->type = type;
 			q->flags = 0;
 			q->next = NULL;
@@ -677,6 +706,7 @@ u8_t pbuf_free(struct pbuf *p)
 				/* is this a pbuf from the pool? */
 				if (type == PBUF_POOL) {
 					memp_free(MEMP_PBUF_POOL, p);
+					PBUF_POOL_GIVE();
 					/* is this a ROM or RAM referencing pbuf? */
 				} else if (type == PBUF_ROM || type == PBUF_REF) {
 					memp_free(MEMP_PBUF, p);
@@ -720,6 +750,53 @@ u16_t pbuf_clen(const struct pbuf *p)
 	return len;
 }
 
+#if PBUF_POOL_RESERVE
+/**
+ * Decide whether a received packet may be queued on a pcb of the given
+ * priority. Below PBUF_POOL_RESERVE_PRIO, a packet in pool pbufs is
+ * refused once less than PBUF_POOL_RESERVE pool pbufs are free, so that
+ * the last ones stay available to high priority traffic. The pbufs of the
+ * packet itself count as taken.
+ *
+ * Called from the tcpip thread.
+ *
+ * @param p the received packet
+ * @param prio priority of the pcb which would queue it
+ * @return 1 if the packet may be queued, 0 if it should be dropped
+ */
+u8_t pbuf_pool_admit(const struct pbuf *p, u8_t prio)
+{
+	u16_t used;
+
+	if ((prio >= PBUF_POOL_RESERVE_PRIO) || (p->type != PBUF_POOL)) {
+		return 1;
+	}
+	SYS_ARCH_GET(pbuf_pool_used, used);
+	if ((u16_t)(PBUF_POOL_SIZE - used) >= PBUF_POOL_RESERVE) {
+		return 1;
+	}
+	pbuf_pool_refused++;
+	LWIP_DEBUGF(PBUF_DEBUG | LWIP_DBG_TRACE, ("pbuf_pool_admit: %" U16_F " pool pbufs free, refused prio %" U16_F "\n", (u16_t)(PBUF_POOL_SIZE - used), (u16_t)prio));
+	return 0;
+}
+
+/**
+ * Get the use of the pbuf pool and of its reserve.
+ *
+ * @param stats filled with the current state
+ */
+void pbuf_pool_reserve_stats(struct pbuf_pool_reserve_stats *stats)
+{
+	SYS_ARCH_DECL_PROTECT(old_level);
+
+	SYS_ARCH_PROTECT(old_level);
+	stats->avail = (u16_t)(PBUF_POOL_SIZE - pbuf_pool_used);
+	stats->min_avail = pbuf_pool_min_avail;
+	stats->refused = pbuf_pool_refused;
+	SYS_ARCH_UNPROTECT(old_level);
+}
+#endif							/* PBUF_POOL_RESERVE */
+
 /**
  * Increment the reference count of the pbuf.
  *
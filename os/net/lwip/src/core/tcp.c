@@ -705,6 +705,7 @@ struct tcp_pcb *tcp_listen_with_backlog_and_err(struct tcp_pcb *pcb, u8_t backlo
 	lpcb->so_options = pcb->so_options;
 	lpcb->ttl = pcb->ttl;
 	lpcb->tos = pcb->tos;
+	ip_set_prio(lpcb, ip_get_prio(pcb));
 #if LWIP_IPV4 && LWIP_IPV6
 	IP_SET_TYPE_VAL(lpcb->remote_ip, pcb->local_ip.type);
 #endif							/* LWIP_IPV4 && LWIP_IPV6 */
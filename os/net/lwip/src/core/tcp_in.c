@@ -82,6 +82,20 @@
 /** Initial CWND calculation as defined RFC 2581 */
 #define LWIP_TCP_CALC_INITIAL_CWND(mss) LWIP_MIN((4U * (mss)), LWIP_MAX((2U * (mss)), 4380U));
 
+/* Limits of the data queued on ooseq: the same for all pcbs, and lower
+   for the pcbs which may not use the pbuf pool reserve */
+#if TCP_OOSEQ_MAX_BYTES || TCP_OOSEQ_MAX_PBUFS
+#define TCP_OOSEQ_OVER_LIMIT(blen, qlen) (((blen) > TCP_OOSEQ_MAX_BYTES) || ((qlen) > TCP_OOSEQ_MAX_PBUFS))
+#else
+#define TCP_OOSEQ_OVER_LIMIT(blen, qlen) 0
+#endif
+#if PBUF_POOL_RESERVE
+#define TCP_OOSEQ_OVER_PRIO_LIMIT(pcb, qlen) ((ip_get_prio(pcb) < PBUF_POOL_RESERVE_PRIO) && ((qlen) > TCP_OOSEQ_PRIO_MAX_PBUFS))
+#else
+#define TCP_OOSEQ_OVER_PRIO_LIMIT(pcb, qlen) 0
+#endif
+#define TCP_OOSEQ_LIMITED (TCP_QUEUE_OOSEQ && (TCP_OOSEQ_MAX_BYTES || TCP_OOSEQ_MAX_PBUFS || PBUF_POOL_RESERVE))
+
 /* These variables are global to all functions involved in the input
    processing of TCP segments. They are set by the tcp_input()
    function. */
@@ -99,6 +113,12 @@ static u8_t flags;
 static u8_t recv_flags;
 static struct pbuf *recv_data;
 
+#if LWIP_TCP_SACK
+/* SACK blocks of the incoming segment, left and right edges in host order */
+static u32_t tcp_sack_blocks[2 * 4];
+static u8_t tcp_sack_num;
+#endif							/* LWIP_TCP_SACK */
+
 struct tcp_pcb *tcp_input_pcb;
 
 /* Forward declarations. */
@@ -373,6 +393,18 @@ void tcp_input(struct pbuf *p, struct netif *inp)
 				goto aborted;
 			}
 		}
+#if PBUF_POOL_RESERVE
+		/* Data of a low priority connection would hold pool pbufs kept for
+		   high priority traffic, drop the segment as if it were lost and
+		   let the remote host retransmit it. */
+		if ((p->tot_len > 0) && !pbuf_pool_admit(p, ip_get_prio(pcb))) {
+			LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_input: pbuf pool reserve, dropping seqno %" U32_F "\n", seqno));
+			TCP_STATS_INC(tcp.memerr);
+			TCP_STATS_INC(tcp.drop);
+			TCP_PCB_STATS_ADD(pcb, drops, 1);
+			goto aborted;
+		}
+#endif							/* PBUF_POOL_RESERVE */
 		tcp_input_pcb = pcb;
 		err = tcp_process(pcb);
 		/* A return value of ERR_ABRT means that tcp_abort() was called
@@ -608,6 +640,7 @@ static void tcp_listen_input(struct tcp_pcb_listen *pcb)
 #endif							/* LWIP_CALLBACK_API || TCP_LISTEN_BACKLOG */
 		/* inherit socket options */
 		npcb->so_options = pcb->so_options & SOF_INHERITED;
+		ip_set_prio(npcb, ip_get_prio(pcb));
 		/* Register the new PCB so that we can begin receiving segments
 		   for it. */
 		TCP_REG_ACTIVE(npcb);
@@ -965,6 +998,71 @@ static void tcp_oos_insert_segment(struct tcp_seg *cseg, struct tcp_seg *next)
 }
 #endif							/* TCP_QUEUE_OOSEQ */
 
+#if LWIP_TCP_SACK
+/**
+ * Mark the segments on pcb->unacked which are covered by the SACK blocks of
+ * the incoming ACK. Blocks which are not above the cumulative ACK or not
+ * below snd_nxt are ignored.
+ *
+ * @param pcb the tcp_pcb which received the ACK
+ * @return number of SACKed segments which this ACK does not acknowledge
+ */
+static u16_t tcp_sack_update(struct tcp_pcb *pcb)
+{
+	struct tcp_seg *seg;
+	u32_t left, right, seg_seqno;
+	u16_t sacked = 0;
+	u8_t i;
+
+	for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+		seg_seqno = lwip_ntohl(seg->tcphdr->seqno);
+		if (TCP_SEQ_LEQ(seg_seqno + TCP_TCPLEN(seg), ackno)) {
+			/* Freed by this ACK */
+			continue;
+		}
+		if (!(seg->flags & TF_SEG_SACKED)) {
+			for (i = 0; i < tcp_sack_num; i++) {
+				left = tcp_sack_blocks[2 * i];
+				right = tcp_sack_blocks[2 * i + 1];
+				if (TCP_SEQ_GEQ(left, ackno) && TCP_SEQ_LEQ(right, pcb->snd_nxt) && TCP_SEQ_LEQ(left, seg_seqno) && TCP_SEQ_LEQ(seg_seqno + TCP_TCPLEN(seg), right)) {
+					seg->flags |= TF_SEG_SACKED;
+					break;
+				}
+			}
+		}
+		if (seg->flags & TF_SEG_SACKED) {
+			sacked++;
+		}
+	}
+	return sacked;
+}
+
+/**
+ * Find the next segment to retransmit during SACK recovery: the first one
+ * on pcb->unacked which is neither SACKed nor already retransmitted, and
+ * which has SACKed data above it.
+ *
+ * @param pcb the tcp_pcb in fast recovery
+ * @return the segment or NULL if there is no such hole
+ */
+static struct tcp_seg *tcp_sack_next_hole(struct tcp_pcb *pcb)
+{
+	struct tcp_seg *seg;
+	struct tcp_seg *hole = NULL;
+
+	for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+		if (seg->flags & TF_SEG_SACKED) {
+			if (hole != NULL) {
+				return hole;
+			}
+		} else if (hole == NULL && !(seg->flags & TF_SEG_SACK_REXMIT)) {
+			hole = seg;
+		}
+	}
+	return NULL;
+}
+#endif							/* LWIP_TCP_SACK */
+
 /**
  * Called by tcp_process. Checks if the given segment is an ACK for outstanding
  * data, and if so frees the memory of the buffered data. Next, is places the
@@ -988,16 +1086,29 @@ static void tcp_receive(struct tcp_pcb *pcb)
 	u32_t right_wnd_edge;
 	u16_t new_tot_len;
 	int found_dupack = 0;
-#if TCP_OOSEQ_MAX_BYTES || TCP_OOSEQ_MAX_PBUFS
+#if LWIP_TCP_SACK
+	u16_t sacked = 0;
+	u8_t in_recovery = 0;
+	u8_t sack_partial = 0;
+	u8_t sack_fill = 0;
+#endif							/* LWIP_TCP_SACK */
+#if TCP_OOSEQ_LIMITED
 	u32_t ooseq_blen;
 	u16_t ooseq_qlen;
-#endif							/* TCP_OOSEQ_MAX_BYTES || TCP_OOSEQ_MAX_PBUFS */
+#endif							/* TCP_OOSEQ_LIMITED */
 
 	LWIP_ASSERT("tcp_receive: wrong state", pcb->state >= ESTABLISHED);
 
 	if (flags & TCP_ACK) {
 		right_wnd_edge = pcb->snd_wnd + pcb->snd_wl2;
 
+#if LWIP_TCP_SACK
+		if (pcb->flags & TF_SACK) {
+			in_recovery = (pcb->flags & TF_INFR) != 0;
+			sacked = tcp_sack_update(pcb);
+		}
+#endif							/* LWIP_TCP_SACK */
+
 		/* Update window. */
 		if (TCP_SEQ_LT(pcb->snd_wl1, seqno) || (pcb->snd_wl1 == seqno && TCP_SEQ_LT(pcb->snd_wl2, ackno)) || (pcb->snd_wl2 == ackno && (u32_t) SND_WND_SCALE(pcb, tcphdr->wnd) > pcb->snd_wnd)) {
 			pcb->snd_wnd = SND_WND_SCALE(pcb, tcphdr->wnd);
@@ -1058,6 +1169,7 @@ static void tcp_receive(struct tcp_pcb *pcb)
 						/* Clause 5 */
 						if (pcb->lastack == ackno) {
 							found_dupack = 1;
+							TCP_PCB_STATS_ADD(pcb, dupacks, 1);
 							if ((u8_t)(pcb->dupacks + 1) > pcb->dupacks) {
 								++pcb->dupacks;
 							}
@@ -1087,8 +1199,17 @@ static void tcp_receive(struct tcp_pcb *pcb)
 			   in fast retransmit. Also reset the congestion window to the
 			   slow start threshold. */
 			if (pcb->flags & TF_INFR) {
-				pcb->flags &= ~TF_INFR;
-				pcb->cwnd = pcb->ssthresh;
+#if LWIP_TCP_SACK
+				if ((pcb->flags & TF_SACK) && TCP_SEQ_LT(ackno, pcb->sack_recover)) {
+					/* Partial ACK, stay in fast recovery and resend the next
+					   hole below instead of waiting for the RTO. */
+					sack_partial = 1;
+				} else
+#endif							/* LWIP_TCP_SACK */
+				{
+					pcb->flags &= ~TF_INFR;
+					pcb->cwnd = pcb->ssthresh;
+				}
 			}
 
 			/* Reset the number of retransmissions. */
@@ -1099,10 +1220,16 @@ static void tcp_receive(struct tcp_pcb *pcb)
 
 			/* Reset the fast retransmit variables. */
 			pcb->dupacks = 0;
+			TCP_PCB_STATS_ADD(pcb, bytes_out, ackno - pcb->lastack);
 			pcb->lastack = ackno;
 
 			/* Update the congestion control variables (cwnd and
 			   ssthresh). */
+#if LWIP_TCP_SACK
+			if (sack_partial) {
+				/* The window does not grow during recovery */
+			} else
+#endif							/* LWIP_TCP_SACK */
 			if (pcb->state >= ESTABLISHED) {
 				if (pcb->cwnd < pcb->ssthresh) {
 					if ((tcpwnd_size_t)(pcb->cwnd + pcb->mss) > pcb->cwnd) {
@@ -1191,6 +1318,27 @@ static void tcp_receive(struct tcp_pcb *pcb)
 		pcb->snd_buf += recv_acked;
 		/* End of ACK for new data processing. */
 
+#if LWIP_TCP_SACK
+		if ((pcb->flags & TF_SACK) && pcb->unacked != NULL) {
+			if (!(pcb->flags & TF_INFR)) {
+				/* Three segments SACKed above the first unacked one: it is
+				   lost even if some of the duplicate ACKs were (RFC 6675). */
+				if (sacked >= 3) {
+					tcp_rexmit_fast(pcb);
+				}
+			} else if (in_recovery && (found_dupack || sack_partial)) {
+				/* Every ACK during recovery resends one hole. Data which is
+				   not SACKed yet may still be in flight, so only segments
+				   with SACKed data above them are taken as lost. */
+				next = tcp_sack_next_hole(pcb);
+				if (next != NULL) {
+					LWIP_DEBUGF(TCP_FR_DEBUG, ("tcp_receive: SACK recovery, retransmit %" U32_F "\n", lwip_ntohl(next->tcphdr->seqno)));
+					tcp_rexmit_seg(pcb, next);
+				}
+			}
+		}
+#endif							/* LWIP_TCP_SACK */
+
 		LWIP_DEBUGF(TCP_RTO_DEBUG, ("tcp_receive: pcb->rttest %" U32_F " rtseq %" U32_F " ackno %" U32_F "\n", pcb->rttest, pcb->rtseq, ackno));
 
 		/* RTT estimation calculations. This is done by checking if the
@@ -1387,6 +1535,7 @@ static void tcp_receive(struct tcp_pcb *pcb)
 #endif							/* TCP_QUEUE_OOSEQ */
 
 				pcb->rcv_nxt = seqno + tcplen;
+				TCP_PCB_STATS_ADD(pcb, bytes_in, inseg.len);
 
 				/* Update the receiver's (our) window. */
 				LWIP_ASSERT("tcp_receive: tcplen > rcv_wnd\n", pcb->rcv_wnd >= tcplen);
@@ -1417,12 +1566,18 @@ static void tcp_receive(struct tcp_pcb *pcb)
 #if TCP_QUEUE_OOSEQ
 				/* We now check if we have segments on the ->ooseq queue that
 				   are now in sequence. */
+#if LWIP_TCP_SACK
+				/* The segment filled (part of) a hole, tell the sender at once
+				   (RFC 5681, section 4.2) */
+				sack_fill = ((pcb->flags & TF_SACK) && pcb->ooseq != NULL);
+#endif							/* LWIP_TCP_SACK */
 				while (pcb->ooseq != NULL && pcb->ooseq->tcphdr->seqno == pcb->rcv_nxt) {
 
 					cseg = pcb->ooseq;
 					seqno = pcb->ooseq->tcphdr->seqno;
 
 					pcb->rcv_nxt += TCP_TCPLEN(cseg);
+					TCP_PCB_STATS_ADD(pcb, bytes_in, cseg->len);
 					LWIP_ASSERT("tcp_receive: ooseq tcplen > rcv_wnd\n", pcb->rcv_wnd >= TCP_TCPLEN(cseg));
 					pcb->rcv_wnd -= TCP_TCPLEN(cseg);
 
@@ -1452,7 +1607,14 @@ static void tcp_receive(struct tcp_pcb *pcb)
 #endif							/* TCP_QUEUE_OOSEQ */
 
 				/* Acknowledge the segment(s). */
-				tcp_ack(pcb);
+#if LWIP_TCP_SACK
+				if (sack_fill) {
+					tcp_ack_now(pcb);
+				} else
+#endif							/* LWIP_TCP_SACK */
+				{
+					tcp_ack(pcb);
+				}
 
 #if LWIP_IPV6 && LWIP_ND6_TCP_REACHABILITY_HINTS
 				if (ip_current_is_v6()) {
@@ -1463,8 +1625,11 @@ static void tcp_receive(struct tcp_pcb *pcb)
 
 			} else {
 				/* We get here if the incoming segment is out-of-sequence. */
-				tcp_send_empty_ack(pcb);
 #if TCP_QUEUE_OOSEQ
+#if LWIP_TCP_SACK
+				/* Report the block with this segment first */
+				pcb->rcv_sack_seq = seqno;
+#endif							/* LWIP_TCP_SACK */
 				/* We queue the segment on the ->ooseq queue. */
 				if (pcb->ooseq == NULL) {
 					pcb->ooseq = tcp_seg_copy(&inseg);
@@ -1580,7 +1745,7 @@ static void tcp_receive(struct tcp_pcb *pcb)
 						prev = next;
 					}
 				}
-#if TCP_OOSEQ_MAX_BYTES || TCP_OOSEQ_MAX_PBUFS
+#if TCP_OOSEQ_LIMITED
 				/* Check that the data on ooseq doesn't exceed one of the limits
 				   and throw away everything above that limit. */
 				ooseq_blen = 0;
@@ -1590,8 +1755,9 @@ static void tcp_receive(struct tcp_pcb *pcb)
 					struct pbuf *p = next->p;
 					ooseq_blen += p->tot_len;
 					ooseq_qlen += pbuf_clen(p);
-					if ((ooseq_blen > TCP_OOSEQ_MAX_BYTES) || (ooseq_qlen > TCP_OOSEQ_MAX_PBUFS)) {
+					if (TCP_OOSEQ_OVER_LIMIT(ooseq_blen, ooseq_qlen) || TCP_OOSEQ_OVER_PRIO_LIMIT(pcb, ooseq_qlen)) {
 						/* too much ooseq data, dump this and everything after it */
+						TCP_PCB_STATS_ADD(pcb, drops, 1);
 						tcp_segs_free(next);
 						if (prev == NULL) {
 							/* first ooseq segment is too much, dump the whole queue */
@@ -1603,8 +1769,11 @@ static void tcp_receive(struct tcp_pcb *pcb)
 						break;
 					}
 				}
-#endif							/* TCP_OOSEQ_MAX_BYTES || TCP_OOSEQ_MAX_PBUFS */
+#endif							/* TCP_OOSEQ_LIMITED */
 #endif							/* TCP_QUEUE_OOSEQ */
+				/* The duplicate ACK is sent after queueing, so that it can
+				   carry SACK blocks for this segment. */
+				tcp_send_empty_ack(pcb);
 			}
 		} else {
 			/* The incoming segment is not within the window. */
@@ -1645,6 +1814,12 @@ static void tcp_parseopt(struct tcp_pcb *pcb)
 #if LWIP_TCP_TIMESTAMPS
 	u32_t tsval;
 #endif
+#if LWIP_TCP_SACK
+	u32_t edge;
+	u8_t i;
+
+	tcp_sack_num = 0;
+#endif
 
 	/* Parse the TCP MSS option, if present. */
 	if (tcphdr_optlen != 0) {
@@ -1722,6 +1897,46 @@ static void tcp_parseopt(struct tcp_pcb *pcb)
 				/* Advance to next option (6 bytes already read) */
 				tcp_optidx += LWIP_TCP_OPT_LEN_TS - 6;
 				break;
+#endif
+#if LWIP_TCP_SACK
+			case LWIP_TCP_OPT_SACK_PERM:
+				LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: SACK_PERM\n"));
+				if (tcp_getoptbyte() != LWIP_TCP_OPT_LEN_SACK_PERM || (tcp_optidx - 2 + LWIP_TCP_OPT_LEN_SACK_PERM) > tcphdr_optlen) {
+					/* Bad length */
+					LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: bad length\n"));
+					return;
+				}
+				/* SACK is only negotiated in the SYN */
+				if (flags & TCP_SYN) {
+					pcb->flags |= TF_SACK;
+				}
+				break;
+			case LWIP_TCP_OPT_SACK:
+				LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: SACK\n"));
+				data = tcp_getoptbyte();
+				if (data < 10 || ((data - 2) % 8) != 0 || (tcp_optidx - 2 + data) > tcphdr_optlen) {
+					/* Bad length */
+					LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: bad length\n"));
+					return;
+				}
+				if (!(pcb->flags & TF_SACK) || !(flags & TCP_ACK)) {
+					/* Not negotiated, skip the blocks */
+					tcp_optidx += data - 2;
+					break;
+				}
+				for (i = 0; i < (data - 2) / 4; i++) {
+					edge = (u32_t)tcp_getoptbyte() << 24;
+					edge |= (u32_t)tcp_getoptbyte() << 16;
+					edge |= (u32_t)tcp_getoptbyte() << 8;
+					edge |= tcp_getoptbyte();
+					if (tcp_sack_num < LWIP_ARRAYSIZE(tcp_sack_blocks) / 2) {
+						tcp_sack_blocks[2 * tcp_sack_num + (i & 1)] = edge;
+						if (i & 1) {
+							tcp_sack_num++;
+						}
+					}
+				}
+				break;
 #endif
 			default:
 				LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: other\n"));
@@ -781,6 +781,12 @@ err_t tcp_enqueue_flags(struct tcp_pcb *pcb, u8_t flags)
 			optflags |= TF_SEG_OPTS_WND_SCALE;
 		}
 #endif							/* LWIP_WND_SCALE */
+#if LWIP_TCP_SACK
+		if ((pcb->state != SYN_RCVD) || (pcb->flags & TF_SACK)) {
+			/* Same for SACK permitted */
+			optflags |= TF_SEG_OPTS_SACK_PERM;
+		}
+#endif							/* LWIP_TCP_SACK */
 	}
 #if LWIP_TCP_TIMESTAMPS
 	if ((pcb->flags & TF_TIMESTAMP)) {
@@ -869,6 +875,76 @@ static void tcp_build_wnd_scale_option(u32_t *opts)
 }
 #endif
 
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+/** Find the block of contiguous data on ooseq which starts with seg
+ *
+ * @param seg first segment of the block
+ * @param right returns the right edge of the block
+ * @return the first segment after the block
+ */
+static struct tcp_seg *tcp_sack_block(struct tcp_seg *seg, u32_t *right)
+{
+	*right = seg->tcphdr->seqno + TCP_TCPLEN(seg);
+	for (seg = seg->next; seg != NULL && seg->tcphdr->seqno == *right; seg = seg->next) {
+		*right += TCP_TCPLEN(seg);
+	}
+	return seg;
+}
+
+/** Collect the SACK blocks to send from the ooseq queue. The block holding
+ * the most recently received segment goes first (RFC 2018), the others
+ * follow in sequence order.
+ *
+ * @param pcb tcp_pcb with data on ooseq
+ * @param blocks returns left and right edges of the blocks (host order)
+ * @param max maximum number of blocks
+ * @return number of blocks
+ */
+static u8_t tcp_sack_collect(struct tcp_pcb *pcb, u32_t *blocks, u8_t max)
+{
+	struct tcp_seg *seg, *next;
+	u32_t right;
+	u8_t num = 0;
+
+	for (seg = pcb->ooseq; seg != NULL; seg = next) {
+		next = tcp_sack_block(seg, &right);
+		if (TCP_SEQ_BETWEEN(pcb->rcv_sack_seq, seg->tcphdr->seqno, right - 1)) {
+			blocks[0] = seg->tcphdr->seqno;
+			blocks[1] = right;
+			num = 1;
+			break;
+		}
+	}
+	for (seg = pcb->ooseq; seg != NULL && num < max; seg = next) {
+		next = tcp_sack_block(seg, &right);
+		if (num > 0 && blocks[0] == seg->tcphdr->seqno) {
+			continue;
+		}
+		blocks[2 * num] = seg->tcphdr->seqno;
+		blocks[2 * num + 1] = right;
+		num++;
+	}
+	return num;
+}
+
+/** Build a SACK option with num blocks at the specified options pointer
+ *
+ * @param opts option pointer where to store the SACK option
+ * @param blocks left and right edges of the blocks (host order)
+ * @param num number of blocks
+ */
+static void tcp_build_sack_option(u32_t *opts, const u32_t *blocks, u8_t num)
+{
+	u8_t i;
+
+	/* Pad with two NOP options to make everything nicely aligned */
+	opts[0] = lwip_htonl(0x01010500 | (2 + 8 * num));
+	for (i = 0; i < 2 * num; i++) {
+		opts[1 + i] = lwip_htonl(blocks[i]);
+	}
+}
+#endif							/* LWIP_TCP_SACK && TCP_QUEUE_OOSEQ */
+
 /**
  * Send an ACK without data.
  *
@@ -880,15 +956,26 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb)
 	struct pbuf *p;
 	u8_t optlen = 0;
 	struct netif *netif;
-#if LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP
+#if LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP || LWIP_TCP_SACK
 	struct tcp_hdr *tcphdr;
-#endif							/* LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP */
+#endif							/* LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP || LWIP_TCP_SACK */
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+	u32_t sack_blocks[2 * LWIP_TCP_MAX_SACK_NUM];
+	u8_t num_sacks = 0;
+#endif							/* LWIP_TCP_SACK && TCP_QUEUE_OOSEQ */
 
 #if LWIP_TCP_TIMESTAMPS
 	if (pcb->flags & TF_TIMESTAMP) {
 		optlen = LWIP_TCP_OPT_LENGTH(TF_SEG_OPTS_TS);
 	}
 #endif
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+	if ((pcb->flags & TF_SACK) && pcb->ooseq != NULL) {
+		/* The options must fit into 40 bytes */
+		num_sacks = tcp_sack_collect(pcb, sack_blocks, LWIP_MIN(LWIP_TCP_MAX_SACK_NUM, (40 - 4 - optlen) / 8));
+		optlen += LWIP_TCP_OPT_LEN_SACK_OUT(num_sacks);
+	}
+#endif							/* LWIP_TCP_SACK && TCP_QUEUE_OOSEQ */
 
 	p = tcp_output_alloc_header(pcb, optlen, 0, lwip_htonl(pcb->snd_nxt));
 	if (p == NULL) {
@@ -897,9 +984,9 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb)
 		LWIP_DEBUGF(TCP_OUTPUT_DEBUG, ("tcp_output: (ACK) could not allocate pbuf\n"));
 		return ERR_BUF;
 	}
-#if LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP
+#if LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP || LWIP_TCP_SACK
 	tcphdr = (struct tcp_hdr *)p->payload;
-#endif							/* LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP */
+#endif							/* LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP || LWIP_TCP_SACK */
 	LWIP_DEBUGF(TCP_OUTPUT_DEBUG, ("tcp_output: sending ACK for %" U32_F "\n", pcb->rcv_nxt));
 
 	/* NB. MSS option is only sent on SYNs, so ignore it here */
@@ -910,6 +997,11 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb)
 		tcp_build_timestamp_option(pcb, (u32_t *)(tcphdr + 1));
 	}
 #endif
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+	if (num_sacks > 0) {
+		tcp_build_sack_option((u32_t *)(void *)((u8_t *)(tcphdr + 1) + optlen - LWIP_TCP_OPT_LEN_SACK_OUT(num_sacks)), sack_blocks, num_sacks);
+	}
+#endif							/* LWIP_TCP_SACK && TCP_QUEUE_OOSEQ */
 
 	netif = ip_route(&pcb->local_ip, &pcb->remote_ip);
 	if (netif == NULL) {
@@ -1173,6 +1265,13 @@ static err_t tcp_output_segment(struct tcp_seg *seg, struct tcp_pcb *pcb, struct
 		opts += 1;
 	}
 #endif
+#if LWIP_TCP_SACK
+	if (seg->flags & TF_SEG_OPTS_SACK_PERM) {
+		/* Pad with two NOP options to make everything nicely aligned */
+		*opts = PP_HTONL(0x01010402);
+		opts += 1;
+	}
+#endif
 
 	/* Set retransmission timer running if it is not currently enabled
 	   This must be set before checking the route. */
@@ -1318,6 +1417,14 @@ void tcp_rexmit_rto(struct tcp_pcb *pcb)
 		return;
 	}
 
+#if LWIP_TCP_SACK
+	/* After a timeout the SACK information is no longer trusted (RFC 2018,
+	   section 8), everything is sent again. */
+	for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+		seg->flags &= ~(TF_SEG_SACKED | TF_SEG_SACK_REXMIT);
+	}
+#endif							/* LWIP_TCP_SACK */
+
 	/* Move all unacked segments to the head of the unsent queue */
 	for (seg = pcb->unacked; seg->next != NULL; seg = seg->next) ;
 	/* concatenate unsent queue after unacked queue */
@@ -1337,6 +1444,7 @@ void tcp_rexmit_rto(struct tcp_pcb *pcb)
 	if (pcb->nrtx < 0xFF) {
 		++pcb->nrtx;
 	}
+	TCP_PCB_STATS_ADD(pcb, rto, 1);
 
 	/* Don't take any RTT measurements after retransmitting. */
 	pcb->rttest = 0;
@@ -1346,26 +1454,25 @@ void tcp_rexmit_rto(struct tcp_pcb *pcb)
 }
 
 /**
- * Requeue the first unacked segment for retransmission
- *
- * Called by tcp_receive() for fast retramsmit.
+ * Requeue an unacked segment for retransmission
  *
- * @param pcb the tcp_pcb for which to retransmit the first unacked segment
+ * @param pcb the tcp_pcb for which to retransmit the segment
+ * @param seg the segment to retransmit, must be on pcb->unacked
  */
-void tcp_rexmit(struct tcp_pcb *pcb)
+void tcp_rexmit_seg(struct tcp_pcb *pcb, struct tcp_seg *seg)
 {
-	struct tcp_seg *seg;
 	struct tcp_seg **cur_seg;
 
-	if (pcb->unacked == NULL) {
-		return;
+	/* Move the segment from the unacked queue to the unsent queue */
+	for (cur_seg = &(pcb->unacked); *cur_seg != seg; cur_seg = &((*cur_seg)->next)) {
+		LWIP_ASSERT("tcp_rexmit_seg: segment not on unacked", *cur_seg != NULL);
 	}
+	*cur_seg = seg->next;
+#if LWIP_TCP_SACK
+	seg->flags |= TF_SEG_SACK_REXMIT;
+#endif							/* LWIP_TCP_SACK */
 
-	/* Move the first unacked segment to the unsent queue */
 	/* Keep the unsent queue sorted. */
-	seg = pcb->unacked;
-	pcb->unacked = seg->next;
-
 	cur_seg = &(pcb->unsent);
 	while (*cur_seg && TCP_SEQ_LT(lwip_ntohl((*cur_seg)->tcphdr->seqno), lwip_ntohl(seg->tcphdr->seqno))) {
 		cur_seg = &((*cur_seg)->next);
@@ -1382,6 +1489,7 @@ void tcp_rexmit(struct tcp_pcb *pcb)
 	if (pcb->nrtx < 0xFF) {
 		++pcb->nrtx;
 	}
+	TCP_PCB_STATS_ADD(pcb, rexmit, 1);
 
 	/* Don't take any rtt measurements after retransmitting. */
 	pcb->rttest = 0;
@@ -1392,6 +1500,22 @@ void tcp_rexmit(struct tcp_pcb *pcb)
 	   and thus tcp_output directly returns. */
 }
 
+/**
+ * Requeue the first unacked segment for retransmission
+ *
+ * Called by tcp_receive() for fast retramsmit.
+ *
+ * @param pcb the tcp_pcb for which to retransmit the first unacked segment
+ */
+void tcp_rexmit(struct tcp_pcb *pcb)
+{
+	if (pcb->unacked == NULL) {
+		return;
+	}
+
+	tcp_rexmit_seg(pcb, pcb->unacked);
+}
+
 /**
  * Handle retransmission after three dupacks received
  *
@@ -1416,6 +1540,10 @@ void tcp_rexmit_fast(struct tcp_pcb *pcb)
 
 		pcb->cwnd = pcb->ssthresh + 3 * pcb->mss;
 		pcb->flags |= TF_INFR;
+#if LWIP_TCP_SACK
+		/* Recovery ends when everything sent so far is acknowledged */
+		pcb->sack_recover = pcb->snd_nxt;
+#endif							/* LWIP_TCP_SACK */
 
 		/* Reset the retransmission timer to prevent immediate rto retransmissions */
 		pcb->rtime = 0;
@@ -348,6 +348,17 @@ void udp_input(struct pbuf *p, struct netif *inp)
 		}
 
 		if (pcb != NULL) {
+#if PBUF_POOL_RESERVE
+			/* the datagram would hold pool pbufs kept for higher priority traffic */
+			if (!pbuf_pool_admit(p, ip_get_prio(pcb))) {
+				LWIP_DEBUGF(UDP_DEBUG | LWIP_DBG_TRACE, ("udp_input: pbuf pool reserve, dropping datagram\n"));
+				UDP_STATS_INC(udp.memerr);
+				UDP_STATS_INC(udp.drop);
+				MIB2_STATS_INC(mib2.udpinerrors);
+				pbuf_free(p);
+				goto end;
+			}
+#endif							/* PBUF_POOL_RESERVE */
 			MIB2_STATS_INC(mib2.udpindatagrams);
 #if SO_REUSE && SO_REUSE_RXTOALL
 			if (ip_get_option(pcb, SOF_REUSEADDR) && (broadcast || ip_addr_ismulticast(ip_current_dest_addr()))) {
@@ -23,11 +23,14 @@
 /* tinyara includes */
 #include <errno.h>
 #include <fcntl.h>
+#include <sched.h>
 #include <time.h>
+#include <unistd.h>
 #include <assert.h>
 #include <errno.h>
 #include <tinyara/clock.h>
 #include <tinyara/arch.h>
+#include <tinyara/irq.h>
 #include <tinyara/cancelpt.h>
 #include <tinyara/kthread.h>
 #include <tinyara/semaphore.h>
@@ -52,6 +55,22 @@
 
 static u16_t s_nextthread = 0;
 
+/* A mailbox is a ring of message pointers protected by disabling the
+ * interrupts, and one counting semaphore which counts the messages in it.
+ * A post puts the message in the ring and signals the semaphore, so it can
+ * be done from an interrupt handler. A fetch which finds messages waiting
+ * takes them without blocking, so the receiving thread handles all the
+ * messages queued while it was busy with one wakeup.
+ */
+
+/* A poster which finds the mailbox full waits on a semaphore of its own,
+ * linked from the mailbox until a fetch makes room.
+ */
+struct sys_mbox_waiter {
+	struct sys_mbox_waiter *next;
+	sem_t wake;
+};
+
 /*---------------------------------------------------------------------------*
  * Routine:  sys_mbox_new
  *---------------------------------------------------------------------------*
@@ -65,24 +84,29 @@ static u16_t s_nextthread = 0;
  *---------------------------------------------------------------------------*/
 err_t sys_mbox_new(sys_mbox_t *mbox, int queue_sz)
 {
-	err_t err = ERR_OK;
+	if (queue_sz <= 0 || queue_sz > SYS_MBOX_MAXSIZE) {
+		queue_sz = SYS_MBOX_MAXSIZE;
+	}
+
 	mbox->is_valid = 1;
 #if LWIP_STATS
 	mbox->id = lwip_stats.sys.mbox.used + 1;
 #endif
 	mbox->queue_size = queue_sz;
-	mbox->wait_send = 0;
-	mbox->wait_fetch = 0;
-	mbox->front = mbox->rear = 0;
-	sys_sem_new(&(mbox->mail), 0);
-	sys_sem_new(&(mbox->mutex), 1);
+	mbox->front = 0;
+	mbox->count = 0;
+	mbox->waiters = NULL;
+	if (sys_sem_new(&(mbox->mail), 0) != ERR_OK) {
+		mbox->is_valid = 0;
+		return ERR_MEM;
+	}
 
 #if SYS_STATS
 	SYS_STATS_INC_USED(mbox);
 #endif							/* SYS_STATS */
 
 	LWIP_DEBUGF(SYS_DEBUG, ("Succesfully Created MBOX with id %d", mbox->id));
-	return err;
+	return ERR_OK;
 }
 
 /*---------------------------------------------------------------------------*
@@ -104,10 +128,9 @@ void sys_mbox_free(sys_mbox_t *mbox)
 		mbox->is_valid = 0;
 		mbox->id = 0;
 		mbox->queue_size = 0;
-		mbox->wait_send = 0;
-		mbox->wait_fetch = 0;
+		mbox->count = 0;
+		mbox->waiters = NULL;
 		sys_sem_free(&(mbox->mail));
-		sys_sem_free(&(mbox->mutex));
 
 		LWIP_DEBUGF(SYS_DEBUG, ("Succesfully deleted MBOX with id %d", mbox->id));
 #if SYS_STATS
@@ -122,55 +145,49 @@ void sys_mbox_free(sys_mbox_t *mbox)
  * Routine:  sys_mbox_post (Blocking Call)
  *---------------------------------------------------------------------------*
  * Description:
- *      Post the "msg" to the mailbox.
+ *      Post the "msg" to the mailbox. While the mailbox is full, the task
+ *      waits until a fetch makes room, it is never dropped. Only tasks
+ *      using the API post this way, the stack itself uses sys_mbox_trypost.
  * Inputs:
  *      sys_mbox_t mbox        -- Handle of mailbox
  *      void *msg              -- Pointer to data to post
  *---------------------------------------------------------------------------*/
 void sys_mbox_post(sys_mbox_t *mbox, void *msg)
 {
-	u8_t first_msg = 0;
-	u32_t tmp = 0;
-	u32_t status = OK;
-	status = sys_arch_sem_wait(&(mbox->mutex), 0);
-	if (status == SYS_ARCH_CANCELED) {
-		return;
-	}
-	LWIP_DEBUGF(SYS_DEBUG, ("mbox %p msg %p\n", (void *)mbox, (void *)msg));
-	/* Wait while the queue is full */
-	tmp = (mbox->rear + 1) % mbox->queue_size;
-	if (tmp == mbox->front) {
-		LWIP_DEBUGF(SYS_DEBUG, ("Queue Full, Wait until gets free\n"));
-	}
-	while (tmp == mbox->front) {
-		mbox->wait_send++;
-		sys_sem_signal(&(mbox->mutex));
-		sys_arch_sem_wait(&(mbox->mail), 0);
-		status = sys_arch_sem_wait(&(mbox->mutex), 0);
-		mbox->wait_send--;
-		if (status == SYS_ARCH_CANCELED) {
-			return;
-		}
-	}
+	struct sys_mbox_waiter waiter;
+	struct sys_mbox_waiter **tail;
+	irqstate_t flags;
+	int cancelstate;
 
-	if (mbox->rear == mbox->front) {
-		first_msg = 1;
-	} else {
-		first_msg = 0;
-	}
+	LWIP_DEBUGF(SYS_DEBUG, ("mbox %p msg %p\n", (void *)mbox, (void *)msg));
 
-	mbox->rear = tmp;
-	mbox->msgs[mbox->rear] = msg;
-	LWIP_DEBUGF(SYS_DEBUG, ("Post SUCCESS\n"));
+	while (sys_mbox_trypost(mbox, msg) != ERR_OK) {
+		sem_init(&waiter.wake, 0, 0);
+		sem_setprotocol(&waiter.wake, SEM_PRIO_NONE);
+		waiter.next = NULL;
+
+		/* Queue up unless a fetch made room meanwhile */
+		flags = irqsave();
+		if (mbox->count < mbox->queue_size) {
+			irqrestore(flags);
+			sem_destroy(&waiter.wake);
+			continue;
+		}
+		for (tail = &mbox->waiters; *tail != NULL; tail = &(*tail)->next) {
+		}
+		*tail = &waiter;
+		irqrestore(flags);
 
-	/* If msg was posted to an empty queue, Release semaphore for
-	   some fetch api blocked on this sem due to Empty queue. */
-	if (first_msg && mbox->wait_fetch) {
-		sys_sem_signal(&(mbox->mail));
+		/* The fetch which makes room dequeues the waiter, so the wait
+		   must not be left before, not even for a cancellation */
+		LWIP_DEBUGF(SYS_DEBUG, ("Queue Full, Wait until gets free\n"));
+		task_setcancelstate(TASK_CANCEL_DISABLE, &cancelstate);
+		while (sem_wait(&waiter.wake) != OK) {
+			LWIP_ASSERT("errno == EINTR", get_errno() == EINTR);
+		}
+		task_setcancelstate(cancelstate, NULL);
+		sem_destroy(&waiter.wake);
 	}
-
-	sys_sem_signal(&(mbox->mutex));
-	return;
 }
 
 /*---------------------------------------------------------------------------*
@@ -178,7 +195,7 @@ void sys_mbox_post(sys_mbox_t *mbox, void *msg)
  *---------------------------------------------------------------------------*
  * Description:
  *      Try to post the "msg" to the mailbox.  Returns immediately with
- *      error if cannot.
+ *      error if cannot. It can be called from an interrupt handler.
  * Inputs:
  *      sys_mbox_t mbox         -- Handle of mailbox
  *      void *msg               -- Pointer to data to post
@@ -188,40 +205,62 @@ void sys_mbox_post(sys_mbox_t *mbox, void *msg)
  *---------------------------------------------------------------------------*/
 err_t sys_mbox_trypost(sys_mbox_t *mbox, void *msg)
 {
-	err_t err = ERR_OK;
-	u8_t first_msg = 0;
-	u32_t tmp = 0;
-	sys_arch_sem_wait(&(mbox->mutex), 0);
+	u32_t rear;
+	irqstate_t flags;
 
-	LWIP_DEBUGF(SYS_DEBUG, ("mbox %p msg %p\n", (void *)mbox, (void *)msg));
+	flags = irqsave();
 	/* Check if the queue is full */
-	tmp = (mbox->rear + 1) % mbox->queue_size;
-	if (tmp == mbox->front) {
+	if (mbox->count >= mbox->queue_size) {
+		irqrestore(flags);
 		LWIP_DEBUGF(SYS_DEBUG, ("Queue Full, returning error\n"));
-		err = ERR_MEM;
-		goto errout_with_mutex;
+		return ERR_MEM;
 	}
 
-	if (mbox->rear == mbox->front) {
-		first_msg = 1;
-	} else {
-		first_msg = 0;
+	rear = mbox->front + mbox->count;
+	if (rear >= mbox->queue_size) {
+		rear -= mbox->queue_size;
 	}
+	mbox->msgs[rear] = msg;
+	mbox->count++;
+	irqrestore(flags);
 
-	mbox->rear = tmp;
-	mbox->msgs[mbox->rear] = msg;
-	LWIP_DEBUGF(SYS_DEBUG, ("Post SUCCESS\n"));
+	/* One count per message, the message is in the ring before it */
+	sys_sem_signal(&(mbox->mail));
 
-	/* If msg was posted to an empty queue, Release semaphore for
-	   some fetch api blocked on this sem due to Empty queue. */
-	if (first_msg && mbox->wait_fetch) {
-		sys_sem_signal(&(mbox->mail));
-	}
+	LWIP_DEBUGF(SYS_DEBUG, ("mbox %p msg %p\n", (void *)mbox, (void *)msg));
+	return ERR_OK;
+}
 
-errout_with_mutex:
-	sys_sem_signal(&(mbox->mutex));
+/* Take the oldest message, the caller has taken its count of the semaphore */
+static void *sys_mbox_take(sys_mbox_t *mbox)
+{
+	void *msg;
+	struct sys_mbox_waiter *waiter;
+	irqstate_t flags;
+
+	flags = irqsave();
+	LWIP_ASSERT("mbox->count > 0", mbox->count > 0);
+	msg = mbox->msgs[mbox->front];
+	if (++mbox->front >= mbox->queue_size) {
+		mbox->front = 0;
+	}
+	mbox->count--;
+	waiter = mbox->waiters;
+	if (waiter != NULL) {
+		mbox->waiters = waiter->next;
+	}
+	irqrestore(flags);
+
+	/* There is room for one message now. The waiter is on the stack of the
+	   poster, which may return as soon as it runs, so it must not run
+	   before sem_post() is done with the semaphore */
+	if (waiter != NULL) {
+		sched_lock();
+		sem_post(&waiter->wake);
+		sched_unlock();
+	}
 
-	return err;
+	return msg;
 }
 
 /*---------------------------------------------------------------------------*
@@ -252,64 +291,27 @@ errout_with_mutex:
  *---------------------------------------------------------------------------*/
 u32_t sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout)
 {
-	u32_t time = 0;
-	u32_t status = OK;
+	u32_t time;
+	void *m;
 
-	/* The mutex lock is quick so we don't bother with the timeout
-	   stuff here. */
-
-	status = sys_arch_sem_wait(&(mbox->mutex), 0);
-	if (status == SYS_ARCH_CANCELED) {
-		return SYS_ARCH_CANCELED;
+	/* We block while waiting for a mail to arrive in the mailbox. We
+	   must be prepared to timeout. */
+	if (timeout != 0 && timeout < MSEC_PER_TICK) {
+		timeout = MSEC_PER_TICK;
 	}
-
-	/* wait while the queue is empty */
-	while (mbox->front == mbox->rear) {
-		mbox->wait_fetch++;
-		sys_sem_signal(&(mbox->mutex));
-
-		/* We block while waiting for a mail to arrive in the mailbox. We
-		   must be prepared to timeout. */
-		if (timeout != 0) {
-
-			if (timeout < MSEC_PER_TICK)
-				timeout = MSEC_PER_TICK;
-
-			time = sys_arch_sem_wait(&(mbox->mail), timeout);
-
-			if (time == SYS_ARCH_TIMEOUT) {
-				sys_arch_sem_wait(&(mbox->mutex), 0);
-				mbox->wait_fetch--;
-				sys_sem_signal(&(mbox->mutex));
-				return SYS_ARCH_TIMEOUT;
-			}
-		} else {
-			sys_arch_sem_wait(&(mbox->mail), 0);
-		}
-
-		status = sys_arch_sem_wait(&(mbox->mutex), 0);
-		mbox->wait_fetch--;
-		if (status == SYS_ARCH_CANCELED) {
-			return SYS_ARCH_CANCELED;
-		}
+	time = sys_arch_sem_wait(&(mbox->mail), timeout);
+	if (time == SYS_ARCH_CANCELED || time == SYS_ARCH_TIMEOUT) {
+		return time;
 	}
 
-	mbox->front = (mbox->front + 1) % mbox->queue_size;
+	m = sys_mbox_take(mbox);
 	if (msg != NULL) {
-		*msg = mbox->msgs[mbox->front];
+		*msg = m;
 		LWIP_DEBUGF(SYS_DEBUG, (" mbox %p msg %p\n", (void *)mbox, *msg));
 	} else {
 		LWIP_DEBUGF(SYS_DEBUG, (" mbox %p, null msg\n", (void *)mbox));
 	}
 
-	/* We just fetched a msg, Release semaphore for
-	   some post api blocked on this sem due to queue full. */
-	if (mbox->wait_send) {
-		sys_sem_signal(&(mbox->mail));
-	}
-
-	sys_sem_signal(&(mbox->mutex));
-
 	return time;
 }
 
@@ -329,35 +331,24 @@ u32_t sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout)
  *---------------------------------------------------------------------------*/
 u32_t sys_arch_mbox_tryfetch(sys_mbox_t *mbox, void **msg)
 {
-	u32_t err = ERR_OK;
-	/* The mutex lock is quick so we don't bother with the timeout
-	   stuff here. */
-	sys_arch_sem_wait(&(mbox->mutex), 0);
+	void *m;
 
-	/* check if the queue is empty */
-	if (mbox->front == mbox->rear) {
+	/* check if the queue is empty, the count is read without the
+	   semaphore first so that an empty mailbox costs nothing */
+	if (mbox->count == 0 || sem_trywait(&(mbox->mail)) != OK) {
 		LWIP_DEBUGF(SYS_DEBUG, ("SYS_MBOX_EMPTY , returning\n"));
-		err = SYS_MBOX_EMPTY;
-		goto errout_with_mutex;
+		return SYS_MBOX_EMPTY;
 	}
 
-	mbox->front = (mbox->front + 1) % mbox->queue_size;
+	m = sys_mbox_take(mbox);
 	if (msg != NULL) {
+		*msg = m;
 		LWIP_DEBUGF(SYS_DEBUG, ("mbox %p msg %p\n", (void *)mbox, *msg));
-		*msg = mbox->msgs[mbox->front];
 	} else {
 		LWIP_DEBUGF(SYS_DEBUG, ("mbox %p, null msg\n", (void *)mbox));
 	}
 
-	/* We just fetched a msg, Release semaphore for
-	   some post api blocked on this sem due to queue full. */
-	if (mbox->wait_send) {
-		sys_sem_signal(&(mbox->mail));
-	}
-
-errout_with_mutex:
-	sys_sem_signal(&(mbox->mutex));
-	return err;
+	return ERR_OK;
 }
 
 /*---------------------------------------------------------------------------*
@@ -0,0 +1,217 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include "test_chksum.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <net/lwip/def.h>
+#include <net/lwip/inet_chksum.h>
+
+#if !LWIP_CHECKSUM_ON_COPY
+#error "This tests needs LWIP_CHECKSUM_ON_COPY enabled"
+#endif
+
+#define CHKSUM_BUF_SIZE    2048
+#define CHKSUM_ROUNDS      20000
+#define CHKSUM_BENCH_LEN   1460
+#define CHKSUM_BENCH_BYTES (64 * 1024 * 1024)
+
+static u8_t src_buf[CHKSUM_BUF_SIZE + 8];
+static u8_t dst_buf[CHKSUM_BUF_SIZE + 8];
+static u8_t ref_buf[CHKSUM_BUF_SIZE + 8];
+static u32_t chksum_seed;
+
+/* Setups/teardown functions */
+
+static void chksum_setup(void)
+{
+	chksum_seed = 0x2545f491;
+}
+
+static void chksum_teardown(void)
+{
+}
+
+static u32_t chksum_rand(void)
+{
+	/* xorshift, so that every run checks the same cases */
+	chksum_seed ^= chksum_seed << 13;
+	chksum_seed ^= chksum_seed >> 17;
+	chksum_seed ^= chksum_seed << 5;
+	return chksum_seed;
+}
+
+static void chksum_fill(u8_t *buf, int len)
+{
+	int i;
+	for (i = 0; i < len; i++) {
+		buf[i] = (u8_t)chksum_rand();
+	}
+}
+
+/** Reference: RFC 1071 over big-endian 16-bit words, in the byte order
+ * which lwip_standard_chksum returns.
+ */
+static u16_t chksum_reference(const u8_t *data, int len)
+{
+	u32_t sum = 0;
+	int i;
+
+	for (i = 0; i + 1 < len; i += 2) {
+		sum += ((u32_t)data[i] << 8) | data[i + 1];
+	}
+	if (len & 1) {
+		sum += (u32_t)data[len - 1] << 8;
+	}
+	while (sum >> 16) {
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+	return lwip_htons((u16_t)sum);
+}
+
+static double chksum_mbps(clock_t start, clock_t end, u32_t bytes)
+{
+	double secs = (double)(end - start) / CLOCKS_PER_SEC;
+	if (secs <= 0) {
+		return 0;
+	}
+	return bytes / secs / (1024 * 1024);
+}
+
+/* Test functions */
+
+/** Compare LWIP_CHKSUM with the reference over random lengths and alignments */
+START_TEST(test_chksum_random)
+{
+	int round;
+	LWIP_UNUSED_ARG(_i);
+
+	for (round = 0; round < CHKSUM_ROUNDS; round++) {
+		int off = chksum_rand() & 7;
+		int len = chksum_rand() % (CHKSUM_BUF_SIZE + 1);
+		u16_t ref;
+		u16_t sum;
+
+		chksum_fill(src_buf + off, len);
+		ref = chksum_reference(src_buf + off, len);
+		sum = LWIP_CHKSUM(src_buf + off, len);
+		fail_unless(sum == ref, "len %d off %d: 0x%04x != 0x%04x", len, off, sum, ref);
+	}
+}
+
+END_TEST
+/** All-ones data makes every addition carry, check the carries are not lost */
+START_TEST(test_chksum_carry)
+{
+	int off;
+	int len;
+	LWIP_UNUSED_ARG(_i);
+
+	memset(src_buf, 0xff, sizeof(src_buf));
+	for (off = 0; off < 8; off++) {
+		for (len = 0; len <= 300; len++) {
+			fail_unless(LWIP_CHKSUM(src_buf + off, len) == chksum_reference(src_buf + off, len));
+		}
+		len = CHKSUM_BUF_SIZE;
+		fail_unless(LWIP_CHKSUM(src_buf + off, len) == chksum_reference(src_buf + off, len));
+	}
+}
+
+END_TEST
+/** LWIP_CHKSUM_COPY must copy exactly len bytes and sum them, whatever the
+ * alignment of source and destination
+ */
+START_TEST(test_chksum_copy)
+{
+	int round;
+	LWIP_UNUSED_ARG(_i);
+
+	for (round = 0; round < CHKSUM_ROUNDS; round++) {
+		int soff = chksum_rand() & 7;
+		int doff = chksum_rand() & 7;
+		int len = chksum_rand() % (CHKSUM_BUF_SIZE + 1);
+		u16_t sum;
+
+		chksum_fill(src_buf + soff, len);
+		chksum_fill(dst_buf, sizeof(dst_buf));
+		memcpy(ref_buf, dst_buf, sizeof(ref_buf));
+		memcpy(ref_buf + doff, src_buf + soff, len);
+
+		sum = LWIP_CHKSUM_COPY(dst_buf + doff, src_buf + soff, (u16_t)len);
+		fail_unless(sum == chksum_reference(src_buf + soff, len), "len %d src %d dst %d", len, soff, doff);
+		fail_unless(memcmp(dst_buf, ref_buf, sizeof(ref_buf)) == 0, "len %d src %d dst %d", len, soff, doff);
+	}
+}
+
+END_TEST
+/** Print the throughput of the reference, LWIP_CHKSUM, and copy then
+ * checksum against LWIP_CHKSUM_COPY for segment sized buffers
+ */
+START_TEST(test_chksum_throughput)
+{
+	u32_t done;
+	u32_t sink = 0;
+	clock_t start;
+	double ref, sum, two_pass, one_pass;
+	LWIP_UNUSED_ARG(_i);
+
+	chksum_fill(src_buf, sizeof(src_buf));
+
+	start = clock();
+	for (done = 0; done < CHKSUM_BENCH_BYTES; done += CHKSUM_BENCH_LEN) {
+		sink += chksum_reference(src_buf + 2, CHKSUM_BENCH_LEN);
+	}
+	ref = chksum_mbps(start, clock(), done);
+
+	start = clock();
+	for (done = 0; done < CHKSUM_BENCH_BYTES; done += CHKSUM_BENCH_LEN) {
+		sink += LWIP_CHKSUM(src_buf + 2, CHKSUM_BENCH_LEN);
+	}
+	sum = chksum_mbps(start, clock(), done);
+
+	start = clock();
+	for (done = 0; done < CHKSUM_BENCH_BYTES; done += CHKSUM_BENCH_LEN) {
+		memcpy(dst_buf + 2, src_buf + 2, CHKSUM_BENCH_LEN);
+		sink += LWIP_CHKSUM(dst_buf + 2, CHKSUM_BENCH_LEN);
+	}
+	two_pass = chksum_mbps(start, clock(), done);
+
+	start = clock();
+	for (done = 0; done < CHKSUM_BENCH_BYTES; done += CHKSUM_BENCH_LEN) {
+		sink += LWIP_CHKSUM_COPY(dst_buf + 2, src_buf + 2, CHKSUM_BENCH_LEN);
+	}
+	one_pass = chksum_mbps(start, clock(), done);
+
+	printf("chksum %d bytes: reference %.0f MB/s, LWIP_CHKSUM %.0f MB/s, copy+chksum %.0f MB/s, LWIP_CHKSUM_COPY %.0f MB/s (%" U32_F ")\n", CHKSUM_BENCH_LEN, ref, sum, two_pass, one_pass, sink & 1);
+}
+
+END_TEST
+/** Create the suite including all tests for this module */
+Suite *chksum_suite(void)
+{
+	TFun tests[] = {
+		test_chksum_random,
+		test_chksum_carry,
+		test_chksum_copy,
+		test_chksum_throughput
+	};
+	return create_suite("CHKSUM", tests, sizeof(tests) / sizeof(TFun), chksum_setup, chksum_teardown);
+}
@@ -0,0 +1,235 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include "test_pbuf_reserve.h"
+
+#include <net/lwip/tcp_impl.h>
+#include <net/lwip/pbuf.h>
+#include <net/lwip/stats.h>
+#include "../tcp/tcp_helper.h"
+
+#if !PBUF_POOL_RESERVE
+#error "This tests needs PBUF_POOL_RESERVE enabled"
+#endif
+#if !TCP_QUEUE_OOSEQ
+#error "This tests needs TCP_QUEUE_OOSEQ enabled"
+#endif
+
+/* helper functions */
+
+/** The application of the bulk connection does not read, so the stack
+ * keeps every pbuf it delivers */
+static struct pbuf *bulk_held[PBUF_POOL_SIZE];
+static int bulk_nheld;
+
+static err_t bulk_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+	LWIP_UNUSED_ARG(arg);
+	LWIP_UNUSED_ARG(pcb);
+	LWIP_UNUSED_ARG(err);
+
+	if (p != NULL) {
+		EXPECT_RETX(bulk_nheld < PBUF_POOL_SIZE, ERR_OK);
+		bulk_held[bulk_nheld++] = p;
+	}
+	return ERR_OK;
+}
+
+/** The application finally reads */
+static void bulk_release(void)
+{
+	while (bulk_nheld > 0) {
+		pbuf_free(bulk_held[--bulk_nheld]);
+	}
+}
+
+static struct tcp_pcb *bulk_new_pcb(void)
+{
+	struct tcp_pcb *pcb = tcp_new();
+	if (pcb != NULL) {
+		tcp_recv(pcb, bulk_recv);
+		pcb->snd_wnd = TCP_WND;
+		pcb->snd_wnd_max = TCP_WND;
+	}
+	return pcb;
+}
+
+/** Get the numbers of pbufs on the ooseq list */
+static int reserve_ooseq_pbufs(struct tcp_pcb *pcb)
+{
+	int num = 0;
+	struct tcp_seg *seg;
+
+	for (seg = pcb->ooseq; seg != NULL; seg = seg->next) {
+		num += pbuf_clen(seg->p);
+	}
+	return num;
+}
+
+/* Setup/teardown functions */
+
+static void pbuf_reserve_setup(void)
+{
+	bulk_release();
+	tcp_remove_all();
+}
+
+static void pbuf_reserve_teardown(void)
+{
+	bulk_release();
+	tcp_remove_all();
+}
+
+/* Test functions */
+
+/** Flood a low priority connection whose application does not read with
+ * more segments than the pool has pbufs. The connection keeps all but
+ * PBUF_POOL_RESERVE pbufs, and a connection of PBUF_POOL_RESERVE_PRIO
+ * still receives all of its data. */
+START_TEST(test_pbuf_reserve_tcp_flood)
+{
+	struct test_tcp_counters counters;
+	struct pbuf_pool_reserve_stats before, after;
+	struct tcp_pcb *bulk, *control;
+	struct pbuf *p;
+	char data[16];
+	ip_addr_t remote_ip, local_ip;
+	u32_t rcv_nxt;
+	struct netif netif;
+	int i;
+	LWIP_UNUSED_ARG(_i);
+
+	/* initialize local vars */
+	memset(&netif, 0, sizeof(netif));
+	memset(data, 0x5a, sizeof(data));
+	IP4_ADDR(&local_ip, 192, 168, 1, 1);
+	IP4_ADDR(&remote_ip, 192, 168, 1, 2);
+	memset(&counters, 0, sizeof(counters));
+
+	/* create and initialize the pcbs */
+	bulk = bulk_new_pcb();
+	EXPECT_RET(bulk != NULL);
+	tcp_set_state(bulk, ESTABLISHED, &local_ip, &remote_ip, 0x101, 0x100);
+	control = test_tcp_new_counters_pcb(&counters);
+	EXPECT_RET(control != NULL);
+	ip_set_prio(control, PBUF_POOL_RESERVE_PRIO);
+	tcp_set_state(control, ESTABLISHED, &local_ip, &remote_ip, 0x102, 0x100);
+
+	pbuf_pool_reserve_stats(&before);
+	EXPECT(before.avail == PBUF_POOL_SIZE);
+	rcv_nxt = bulk->rcv_nxt;
+
+	/* flood: a dropped segment is sent again, like a retransmission */
+	for (i = 0; i < PBUF_POOL_SIZE; i++) {
+		p = tcp_create_rx_segment(bulk, data, sizeof(data), 0, 0, TCP_ACK);
+		/* the pool never runs out */
+		EXPECT_RET(p != NULL);
+		test_tcp_input(p, &netif);
+	}
+
+	/* the bulk connection got all but the reserve and the rest was dropped */
+	EXPECT(bulk_nheld == PBUF_POOL_SIZE - PBUF_POOL_RESERVE);
+	EXPECT(bulk->rcv_nxt == rcv_nxt + (PBUF_POOL_SIZE - PBUF_POOL_RESERVE) * sizeof(data));
+	pbuf_pool_reserve_stats(&after);
+	EXPECT(after.avail == PBUF_POOL_RESERVE);
+	EXPECT(after.min_avail < PBUF_POOL_RESERVE);
+	EXPECT(after.refused - before.refused == PBUF_POOL_RESERVE);
+#if LWIP_TCP_PCB_STATS
+	EXPECT(bulk->stats.drops == PBUF_POOL_RESERVE);
+#endif
+
+	/* the control connection is not affected by the flood */
+	for (i = 0; i < 2 * PBUF_POOL_SIZE; i++) {
+		p = tcp_create_rx_segment(control, data, sizeof(data), 0, 0, TCP_ACK);
+		EXPECT_RET(p != NULL);
+		test_tcp_input(p, &netif);
+	}
+	EXPECT(counters.recv_calls == 2 * PBUF_POOL_SIZE);
+	EXPECT(counters.recved_bytes == 2 * PBUF_POOL_SIZE * sizeof(data));
+	pbuf_pool_reserve_stats(&after);
+	EXPECT(after.refused - before.refused == PBUF_POOL_RESERVE);
+
+	/* once the application reads, the bulk connection gets data again */
+	bulk_release();
+	p = tcp_create_rx_segment(bulk, data, sizeof(data), 0, 0, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT(bulk_nheld == 1);
+	bulk_release();
+}
+
+END_TEST
+/** Segments after a hole are kept on ooseq up to TCP_OOSEQ_PRIO_MAX_PBUFS
+ * pbufs for a low priority connection, and without that limit for a
+ * connection of PBUF_POOL_RESERVE_PRIO */
+START_TEST(test_pbuf_reserve_ooseq_cap)
+{
+	struct test_tcp_counters counters;
+	struct tcp_pcb *bulk, *control;
+	struct pbuf *p;
+	char data = 0x5a;
+	ip_addr_t remote_ip, local_ip;
+	struct netif netif;
+	int i;
+	LWIP_UNUSED_ARG(_i);
+
+	/* initialize local vars */
+	memset(&netif, 0, sizeof(netif));
+	IP4_ADDR(&local_ip, 192, 168, 1, 1);
+	IP4_ADDR(&remote_ip, 192, 168, 1, 2);
+	memset(&counters, 0, sizeof(counters));
+
+	/* create and initialize the pcbs */
+	bulk = bulk_new_pcb();
+	EXPECT_RET(bulk != NULL);
+	tcp_set_state(bulk, ESTABLISHED, &local_ip, &remote_ip, 0x101, 0x100);
+	control = test_tcp_new_counters_pcb(&counters);
+	EXPECT_RET(control != NULL);
+	ip_set_prio(control, PBUF_POOL_RESERVE_PRIO);
+	tcp_set_state(control, ESTABLISHED, &local_ip, &remote_ip, 0x102, 0x100);
+
+	/* every other byte is missing, so each segment stays on ooseq */
+	for (i = 0; i < TCP_OOSEQ_PRIO_MAX_PBUFS + 2; i++) {
+		p = tcp_create_rx_segment(bulk, &data, 1, 2 * i + 1, 0, TCP_ACK);
+		EXPECT_RET(p != NULL);
+		test_tcp_input(p, &netif);
+	}
+	EXPECT(reserve_ooseq_pbufs(bulk) == TCP_OOSEQ_PRIO_MAX_PBUFS);
+#if LWIP_TCP_PCB_STATS
+	EXPECT(bulk->stats.drops == 2);
+#endif
+
+	for (i = 0; i < TCP_OOSEQ_PRIO_MAX_PBUFS + 2; i++) {
+		p = tcp_create_rx_segment(control, &data, 1, 2 * i + 1, 0, TCP_ACK);
+		EXPECT_RET(p != NULL);
+		test_tcp_input(p, &netif);
+	}
+	EXPECT(reserve_ooseq_pbufs(control) == TCP_OOSEQ_PRIO_MAX_PBUFS + 2);
+	EXPECT(counters.recv_calls == 0);
+}
+
+END_TEST
+/** Create the suite including all tests for this module */
+Suite *pbuf_reserve_suite(void)
+{
+	TFun tests[] = {
+		test_pbuf_reserve_tcp_flood,
+		test_pbuf_reserve_ooseq_cap
+	};
+	return create_suite("PBUF_RESERVE", tests, sizeof(tests) / sizeof(TFun), pbuf_reserve_setup, pbuf_reserve_teardown);
+}
@@ -61,8 +61,20 @@
 #define MEMP_NUM_TCP_SEG                TCP_SND_QUEUELEN
 #define TCP_SND_BUF                     (12 * TCP_MSS)
 #define TCP_WND                         (10 * TCP_MSS)
+#define LWIP_TCP_SACK                   1
 
 /* Minimal changes to opt.h required for etharp unit tests: */
 #define ETHARP_SUPPORT_STATIC_ENTRIES   1
 
+/* Pbuf pool reserve checked by the pbuf_reserve unit tests. The pool is
+   large enough for the other tests to stay clear of the reserve: */
+#define PBUF_POOL_SIZE                  32
+#define PBUF_POOL_RESERVE               4
+#define LWIP_TCP_PCB_STATS              1
+
+/* Checksum implementations checked by the chksum unit tests: */
+#define LWIP_CHKSUM_ALGORITHM           4
+#define LWIP_CHECKSUM_ON_COPY           1
+#define LWIP_CHKSUM_COPY_ALGORITHM      2
+
 #endif							/* __LWIPOPTS_H__ */
@@ -918,6 +918,330 @@ FIN_TEST(test_tcp_recv_ooseq_double_FIN_13, 13)
 FIN_TEST(test_tcp_recv_ooseq_double_FIN_14, 14)
 FIN_TEST(test_tcp_recv_ooseq_double_FIN_15, 15)
 
+#if LWIP_TCP_SACK
+/** Get the SACK blocks of an outgoing segment
+ *
+ * @param p copy of the outgoing IP packet
+ * @param base sequence number the edges are made relative to
+ * @param blocks returns left and right edges of the blocks
+ * @param max maximum number of blocks
+ * @return number of SACK blocks in the segment
+ */
+static int tcp_sack_get_blocks(struct pbuf *p, u32_t base, u32_t *blocks, int max)
+{
+	u8_t *opts = (u8_t *)p->payload + IP_HLEN + TCP_HLEN;
+	int optlen = TCPH_HDRLEN((struct tcp_hdr *)((u8_t *)p->payload + IP_HLEN)) * 4 - TCP_HLEN;
+	int i, k, num;
+
+	for (i = 0; i < optlen;) {
+		if (opts[i] == LWIP_TCP_OPT_NOP) {
+			i++;
+		} else if (opts[i] == LWIP_TCP_OPT_EOL) {
+			break;
+		} else if (opts[i] == LWIP_TCP_OPT_SACK) {
+			num = (opts[i + 1] - 2) / 8;
+			for (k = 0; k < 2 * num && k < 2 * max; k++) {
+				blocks[k] = (((u32_t)opts[i + 2 + 4 * k] << 24) | ((u32_t)opts[i + 3 + 4 * k] << 16) | ((u32_t)opts[i + 4 + 4 * k] << 8) | opts[i + 5 + 4 * k]) - base;
+			}
+			return num;
+		} else {
+			i += opts[i + 1];
+		}
+	}
+	return 0;
+}
+
+/** Pass ooseq segments to a SACK enabled pcb and check the SACK blocks of
+ * the ACKs it sends */
+START_TEST(test_tcp_recv_ooseq_sack_blocks)
+{
+	struct test_tcp_counters counters;
+	struct test_tcp_txcounters txcounters;
+	struct tcp_pcb *pcb;
+	struct pbuf *p;
+	char data[] = {
+		1, 2, 3, 4,
+		5, 6, 7, 8,
+		9, 10, 11, 12,
+		13, 14, 15, 16,
+		17, 18, 19, 20
+	};
+	ip_addr_t remote_ip, local_ip, netmask;
+	u16_t remote_port = 0x100, local_port = 0x101;
+	struct netif netif;
+	u32_t blocks[2 * LWIP_TCP_MAX_SACK_NUM];
+	LWIP_UNUSED_ARG(_i);
+
+	/* initialize local vars */
+	IP4_ADDR(&local_ip, 192, 168, 1, 1);
+	IP4_ADDR(&remote_ip, 192, 168, 1, 2);
+	IP4_ADDR(&netmask, 255, 255, 255, 0);
+	test_tcp_init_netif(&netif, &txcounters, &local_ip, &netmask);
+	txcounters.copy_tx_packets = 1;
+	/* initialize counter struct */
+	memset(&counters, 0, sizeof(counters));
+	counters.expected_data_len = sizeof(data);
+	counters.expected_data = data;
+
+	/* create and initialize the pcb */
+	pcb = test_tcp_new_counters_pcb(&counters);
+	EXPECT_RET(pcb != NULL);
+	tcp_set_state(pcb, ESTABLISHED, &local_ip, &remote_ip, local_port, remote_port);
+	pcb->rcv_nxt = 0x8000;
+	pcb->flags |= TF_SACK;
+
+	/* seqno 8..11: one block */
+	p = tcp_create_rx_segment(pcb, &data[8], 4, 8, 0, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT_RET(txcounters.num_tx_calls == 1);
+	EXPECT(tcp_sack_get_blocks(txcounters.tx_packets, pcb->rcv_nxt, blocks, LWIP_TCP_MAX_SACK_NUM) == 1);
+	EXPECT(blocks[0] == 8 && blocks[1] == 12);
+	pbuf_free(txcounters.tx_packets);
+	txcounters.tx_packets = NULL;
+
+	/* seqno 16..19: the block of the latest segment goes first */
+	p = tcp_create_rx_segment(pcb, &data[16], 4, 16, 0, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT_RET(txcounters.num_tx_calls == 2);
+	EXPECT(tcp_sack_get_blocks(txcounters.tx_packets, pcb->rcv_nxt, blocks, LWIP_TCP_MAX_SACK_NUM) == 2);
+	EXPECT(blocks[0] == 16 && blocks[1] == 20);
+	EXPECT(blocks[2] == 8 && blocks[3] == 12);
+	pbuf_free(txcounters.tx_packets);
+	txcounters.tx_packets = NULL;
+
+	/* seqno 12..15 joins both blocks */
+	p = tcp_create_rx_segment(pcb, &data[12], 4, 12, 0, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT_RET(txcounters.num_tx_calls == 3);
+	EXPECT(tcp_sack_get_blocks(txcounters.tx_packets, pcb->rcv_nxt, blocks, LWIP_TCP_MAX_SACK_NUM) == 1);
+	EXPECT(blocks[0] == 8 && blocks[1] == 20);
+	pbuf_free(txcounters.tx_packets);
+	txcounters.tx_packets = NULL;
+
+	/* seqno 0..3 is in sequence but a hole is left, it is ACKed at once */
+	p = tcp_create_rx_segment(pcb, &data[0], 4, 0, 0, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT(counters.recved_bytes == 4);
+	EXPECT_RET(txcounters.num_tx_calls == 4);
+	EXPECT(tcp_sack_get_blocks(txcounters.tx_packets, pcb->rcv_nxt, blocks, LWIP_TCP_MAX_SACK_NUM) == 1);
+	EXPECT(blocks[0] == 4 && blocks[1] == 16);
+	pbuf_free(txcounters.tx_packets);
+	txcounters.tx_packets = NULL;
+
+	/* seqno 4..7 fills the hole, no SACK blocks any more */
+	p = tcp_create_rx_segment(pcb, &data[4], 4, 0, 0, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT(counters.recved_bytes == sizeof(data));
+	EXPECT(pcb->ooseq == NULL);
+	EXPECT_RET(txcounters.num_tx_calls == 5);
+	EXPECT(tcp_sack_get_blocks(txcounters.tx_packets, pcb->rcv_nxt, blocks, LWIP_TCP_MAX_SACK_NUM) == 0);
+	pbuf_free(txcounters.tx_packets);
+	txcounters.tx_packets = NULL;
+
+	/* make sure the pcb is freed */
+	EXPECT(lwip_stats.memp[MEMP_TCP_PCB].used == 1);
+	tcp_abort(pcb);
+	EXPECT(lwip_stats.memp[MEMP_TCP_PCB].used == 0);
+}
+
+END_TEST
+/* number of TCP_MSS segments sent by the loss pattern tests */
+#define SACK_TEST_SEGS  10
+static u8_t sack_tx_data[SACK_TEST_SEGS * TCP_MSS];
+
+/** Build the SACK option the simulated receiver sends
+ *
+ * @param opts returns NOP, NOP, SACK option
+ * @param received which segments the receiver has
+ * @param isn sequence number of the first segment
+ * @param latest index of the segment which was received last
+ * @return length of the options, 0 if there is no SACK block
+ */
+static u8_t tcp_sack_build_blocks(u8_t *opts, const u8_t *received, u32_t isn, int latest)
+{
+	u32_t edges[2 * SACK_TEST_SEGS];
+	int i, k, num = 0;
+
+	/* blocks above the first hole, in sequence order */
+	for (i = 0; i < SACK_TEST_SEGS && received[i]; i++) ;
+	while (i < SACK_TEST_SEGS) {
+		if (!received[i]) {
+			i++;
+			continue;
+		}
+		for (k = i; k < SACK_TEST_SEGS && received[k]; k++) ;
+		if (latest >= i && latest < k && num > 0) {
+			/* the block of the latest segment goes first */
+			edges[2 * num] = edges[0];
+			edges[2 * num + 1] = edges[1];
+			edges[0] = isn + i * TCP_MSS;
+			edges[1] = isn + k * TCP_MSS;
+		} else {
+			edges[2 * num] = isn + i * TCP_MSS;
+			edges[2 * num + 1] = isn + k * TCP_MSS;
+		}
+		num++;
+		i = k;
+	}
+	if (num == 0) {
+		return 0;
+	}
+	/* at most 3 blocks fit next to the timestamp option */
+	num = LWIP_MIN(num, 3);
+
+	opts[0] = LWIP_TCP_OPT_NOP;
+	opts[1] = LWIP_TCP_OPT_NOP;
+	opts[2] = LWIP_TCP_OPT_SACK;
+	opts[3] = (u8_t)(2 + 8 * num);
+	for (i = 0; i < 2 * num; i++) {
+		opts[4 + 4 * i] = (u8_t)(edges[i] >> 24);
+		opts[5 + 4 * i] = (u8_t)(edges[i] >> 16);
+		opts[6 + 4 * i] = (u8_t)(edges[i] >> 8);
+		opts[7 + 4 * i] = (u8_t)edges[i];
+	}
+	return (u8_t)(4 + 8 * num);
+}
+
+/** Send SACK_TEST_SEGS segments to a simulated receiver which drops the
+ * first transmission of the segments in 'lost' and ACKs every segment it
+ * gets. Each round delivers the segments sent in the round before, so the
+ * number of rounds is the transfer time in round trips. When nothing is in
+ * flight, the TCP timer runs until the RTO sends something again.
+ *
+ * @param lost indexes of the lost segments
+ * @param num_lost number of lost segments
+ * @param sack 1 to use SACK
+ * @param rounds returns the number of round trips
+ * @param ticks returns the number of TCP timer ticks waited for the RTO
+ */
+static void test_tcp_sack_loss_pattern(const u8_t *lost, int num_lost, u8_t sack, int *rounds, int *ticks)
+{
+	struct netif netif;
+	struct test_tcp_txcounters txcounters;
+	struct test_tcp_counters counters;
+	struct tcp_pcb *pcb;
+	struct pbuf *p, *q, *sent;
+	ip_addr_t remote_ip, local_ip, netmask;
+	u16_t remote_port = 0x100, local_port = 0x101;
+	u8_t received[SACK_TEST_SEGS], dropped[SACK_TEST_SEGS];
+	u8_t opts[4 + 8 * 3];
+	u8_t optlen;
+	u32_t isn, ackno;
+	int i, idx;
+	err_t err;
+
+	*rounds = 0;
+	*ticks = 0;
+	memset(received, 0, sizeof(received));
+	memset(dropped, 0, sizeof(dropped));
+	for (i = 0; i < num_lost; i++) {
+		dropped[lost[i]] = 1;
+	}
+
+	/* initialize local vars */
+	IP4_ADDR(&local_ip, 192, 168, 1, 1);
+	IP4_ADDR(&remote_ip, 192, 168, 1, 2);
+	IP4_ADDR(&netmask, 255, 255, 255, 0);
+	test_tcp_init_netif(&netif, &txcounters, &local_ip, &netmask);
+	txcounters.copy_tx_packets = 1;
+	memset(&counters, 0, sizeof(counters));
+
+	/* create and initialize the pcb */
+	pcb = test_tcp_new_counters_pcb(&counters);
+	EXPECT_RET(pcb != NULL);
+	tcp_set_state(pcb, ESTABLISHED, &local_ip, &remote_ip, local_port, remote_port);
+	pcb->mss = TCP_MSS;
+	/* disable initial congestion window (we don't send a SYN here...) */
+	pcb->cwnd = pcb->snd_wnd;
+	if (sack) {
+		pcb->flags |= TF_SACK;
+	}
+	tcp_nagle_disable(pcb);
+	isn = pcb->snd_nxt;
+
+	err = tcp_write(pcb, sack_tx_data, sizeof(sack_tx_data), 0);
+	EXPECT_RET(err == ERR_OK);
+	err = tcp_output(pcb);
+	EXPECT_RET(err == ERR_OK);
+
+	while (pcb->unacked != NULL || pcb->unsent != NULL) {
+		sent = txcounters.tx_packets;
+		txcounters.tx_packets = NULL;
+		if (sent == NULL) {
+			/* stalled until the RTO */
+			tcp_tmr();
+			(*ticks)++;
+			EXPECT_RET(*ticks < 1000);
+			continue;
+		}
+		(*rounds)++;
+		EXPECT_RET(*rounds < 100);
+
+		/* every pbuf on the chain is one packet */
+		for (q = sent; q != NULL; q = q->next) {
+			idx = (lwip_ntohl(((struct tcp_hdr *)((u8_t *)q->payload + IP_HLEN))->seqno) - isn) / TCP_MSS;
+			EXPECT_RET(idx >= 0 && idx < SACK_TEST_SEGS);
+			if (dropped[idx]) {
+				/* only the first transmission is lost */
+				dropped[idx] = 0;
+				continue;
+			}
+			received[idx] = 1;
+
+			for (i = 0; i < SACK_TEST_SEGS && received[i]; i++) ;
+			ackno = isn + i * TCP_MSS;
+			optlen = tcp_sack_build_blocks(opts, received, isn, idx);
+			p = tcp_create_rx_segment_opts(pcb, NULL, 0, 0, ackno - pcb->lastack, TCP_ACK, opts, optlen);
+			EXPECT_RET(p != NULL);
+			test_tcp_input(p, &netif);
+		}
+		pbuf_free(sent);
+	}
+	EXPECT(counters.err_calls == 0);
+	if (txcounters.tx_packets != NULL) {
+		pbuf_free(txcounters.tx_packets);
+	}
+
+	/* make sure the pcb is freed */
+	EXPECT_RET(lwip_stats.memp[MEMP_TCP_PCB].used == 1);
+	tcp_abort(pcb);
+	EXPECT_RET(lwip_stats.memp[MEMP_TCP_PCB].used == 0);
+}
+
+/** Run one loss pattern with and without SACK and report the recovery time.
+ * With SACK every pattern which leaves at least 3 segments behind the last
+ * loss must recover without an RTO. */
+static void test_tcp_sack_recover(const char *name, const u8_t *lost, int num_lost)
+{
+	int rounds, ticks, reno_rounds, reno_ticks;
+
+	test_tcp_sack_loss_pattern(lost, num_lost, 0, &reno_rounds, &reno_ticks);
+	test_tcp_sack_loss_pattern(lost, num_lost, 1, &rounds, &ticks);
+	printf("TCP SACK %s: %d round trips, %d RTO ticks (without SACK: %d round trips, %d RTO ticks)\n", name, rounds, ticks, reno_rounds, reno_ticks);
+
+	EXPECT(ticks == 0);
+	EXPECT(rounds <= reno_rounds);
+}
+
+#define SACK_LOSS_TEST(name, ...) \
+START_TEST(name) \
+{ \
+	const u8_t lost[] = { __VA_ARGS__ }; \
+	LWIP_UNUSED_ARG(_i); \
+	test_tcp_sack_recover(#name, lost, sizeof(lost)); \
+} \
+END_TEST
+SACK_LOSS_TEST(test_tcp_sack_loss_single, 1)
+SACK_LOSS_TEST(test_tcp_sack_loss_two, 1, 3)
+SACK_LOSS_TEST(test_tcp_sack_loss_burst, 1, 2, 3)
+SACK_LOSS_TEST(test_tcp_sack_loss_spread, 2, 4, 6)
+#endif							/* LWIP_TCP_SACK */
+
 /** Create the suite including all tests for this module */
 Suite *tcp_oos_suite(void)
 {
@@ -942,7 +1266,14 @@ Suite *tcp_oos_suite(void)
 		test_tcp_recv_ooseq_double_FIN_12,
 		test_tcp_recv_ooseq_double_FIN_13,
 		test_tcp_recv_ooseq_double_FIN_14,
-		test_tcp_recv_ooseq_double_FIN_15
+		test_tcp_recv_ooseq_double_FIN_15,
+#if LWIP_TCP_SACK
+		test_tcp_recv_ooseq_sack_blocks,
+		test_tcp_sack_loss_single,
+		test_tcp_sack_loss_two,
+		test_tcp_sack_loss_burst,
+		test_tcp_sack_loss_spread
+#endif							/* LWIP_TCP_SACK */
 	};
 	return create_suite("TCP_OOS", tests, sizeof(tests) / sizeof(TFun), tcp_oos_setup, tcp_oos_teardown);
 }
@@ -0,0 +1,799 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * net/procfs/net_procfs.c
+ *
+ *   /proc/net/tcp lists the TCP connections of lwIP with their windows,
+ *   round trip estimates, queues and counters.  /proc/net/memp lists the
+ *   use and high-water marks of the lwIP heap and memp pools, the pbuf
+ *   pool among them, and the use of the pbuf pool reserve.
+ *
+ *   The state is copied in one tcpip_api_call(), with the core locked,
+ *   when the file is opened, and it is formatted afterwards so that the
+ *   stack is held only for the copy.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/procfs.h>
+#include <tinyara/fs/dirent.h>
+
+#include <net/lwip/opt.h>
+#include <net/lwip/ip_addr.h>
+#include <net/lwip/memp.h>
+#include <net/lwip/stats.h>
+#include <net/lwip/tcp.h>
+#include <net/lwip/priv/tcp_priv.h>
+#include <net/lwip/priv/tcpip_priv.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#if !defined(CONFIG_FS_PROCFS_EXCLUDE_NET) && LWIP_TCP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NET_DIRNAME           "net"
+
+/* The pool of pcbs may grow with MEMP_MEM_MALLOC, the snapshot holds this
+ * many connections and counts the ones left out
+ */
+
+#define NET_TCP_MAXPCBS       (MEMP_NUM_TCP_PCB + MEMP_NUM_TCP_PCB_LISTEN)
+
+/* Longest line of the listing, the addresses take most of it */
+
+#if LWIP_IPV6
+#define NET_ADDRLEN           (IP6ADDR_STRLEN_MAX + 8)
+#else
+#define NET_ADDRLEN           (IP4ADDR_STRLEN_MAX + 8)
+#endif
+#define NET_TCP_LINELEN       (2 * NET_ADDRLEN + 160)
+#define NET_MEMP_LINELEN      64
+
+#define NET_HAVE_MEMP         ((LWIP_STATS && (MEM_STATS || MEMP_STATS)) || PBUF_POOL_RESERVE)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum net_node_e {
+	NET_LEVEL0 = 0,				/* The net directory */
+	NET_TCP,					/* TCP connections */
+	NET_MEMP					/* Heap and memp pools */
+};
+
+struct net_node_s {
+	FAR const char *relpath;	/* Relative path to the node */
+	FAR const char *name;		/* Terminal node segment name */
+	uint8_t nodetype;			/* Type of node (see enum net_node_e) */
+	uint8_t dtype;				/* dirent type (see include/dirent.h) */
+};
+
+struct net_dir_s {
+	struct procfs_dir_priv_s base;	/* Base directory private data */
+	FAR const struct net_node_s *node;	/* Directory node description */
+};
+
+/* One connection as it was when the file was opened */
+
+struct net_tcp_entry_s {
+	ip_addr_t local_ip;
+	ip_addr_t remote_ip;
+	u16_t local_port;
+	u16_t remote_port;
+	u8_t state;
+	u8_t nrtx;					/* Retransmissions of the oldest segment */
+	tcpwnd_size_t snd_wnd;
+	tcpwnd_size_t rcv_wnd;
+	tcpwnd_size_t cwnd;
+	tcpwnd_size_t ssthresh;
+	u32_t srtt;					/* ms */
+	u32_t rttvar;				/* ms */
+	u32_t rto;					/* ms */
+	u16_t unsent;				/* Segments and bytes on the queues */
+	u16_t unacked;
+	u16_t ooseq;
+	u32_t unsent_bytes;
+	u32_t unacked_bytes;
+	u32_t ooseq_bytes;
+#if LWIP_TCP_PCB_STATS
+	struct tcp_pcb_stats stats;
+#endif
+};
+
+struct net_tcp_snapshot_s {
+	struct tcpip_api_call_data call;
+	FAR struct net_tcp_entry_s *entry;
+	int nentries;
+	int npcbs;					/* Connections found, may be more than nentries */
+};
+
+#if NET_HAVE_MEMP
+struct net_memp_snapshot_s {
+	struct tcpip_api_call_data call;
+#if MEM_STATS
+	struct stats_mem mem;
+#endif
+#if MEMP_STATS
+	struct stats_mem memp[MEMP_MAX];
+#endif
+#if PBUF_POOL_RESERVE
+	struct pbuf_pool_reserve_stats reserve;
+#endif
+};
+#endif
+
+/* This structure describes one open "file" */
+
+struct net_file_s {
+	struct procfs_file_s base;	/* Base open file structure */
+	FAR const struct net_node_s *node;	/* Describes the file node */
+	FAR char *text;				/* The formatted listing */
+	size_t textlen;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int netprocfs_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
+static int netprocfs_close(FAR struct file *filep);
+static ssize_t netprocfs_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+static int netprocfs_opendir(FAR const char *relpath, FAR struct fs_dirent_s *dir);
+static int netprocfs_closedir(FAR struct fs_dirent_s *dir);
+static int netprocfs_readdir(FAR struct fs_dirent_s *dir);
+static int netprocfs_rewinddir(FAR struct fs_dirent_s *dir);
+static int netprocfs_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+
+static const struct net_node_s g_net_level0 = {
+	"", NET_DIRNAME, (uint8_t)NET_LEVEL0, DTYPE_DIRECTORY
+};
+
+static const struct net_node_s g_net_tcp = {
+	"tcp", "tcp", (uint8_t)NET_TCP, DTYPE_FILE
+};
+
+#if NET_HAVE_MEMP
+static const struct net_node_s g_net_memp = {
+	"memp", "memp", (uint8_t)NET_MEMP, DTYPE_FILE
+};
+#endif
+
+static FAR const struct net_node_s *const g_net_nodeinfo[] = {
+	&g_net_level0,
+	&g_net_tcp,
+#if NET_HAVE_MEMP
+	&g_net_memp,
+#endif
+};
+
+#define NET_NNODES (sizeof(g_net_nodeinfo) / sizeof(FAR const struct net_node_s *const))
+
+static FAR const struct net_node_s *const g_net_level0info[] = {
+	&g_net_tcp,
+#if NET_HAVE_MEMP
+	&g_net_memp,
+#endif
+};
+
+#define NET_NLEVEL0NODES (sizeof(g_net_level0info) / sizeof(FAR const struct net_node_s *const))
+
+static FAR const char *const g_net_tcp_state[] = {
+	"CLOSED",
+	"LISTEN",
+	"SYN_SENT",
+	"SYN_RCVD",
+	"ESTABLISHED",
+	"FIN_WAIT_1",
+	"FIN_WAIT_2",
+	"CLOSE_WAIT",
+	"CLOSING",
+	"LAST_ACK",
+	"TIME_WAIT"
+};
+
+#if MEMP_STATS
+static FAR const char *const g_net_memp_name[] = {
+#define LWIP_MEMPOOL(name, num, size, desc) #name,
+#include <net/lwip/priv/memp_std.h>
+};
+#endif
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+/* See fs_procfs.c -- this structure is explicitly externed there. */
+
+const struct procfs_operations net_procfsoperations = {
+	netprocfs_open,			/* open */
+	netprocfs_close,		/* close */
+	netprocfs_read,			/* read */
+	NULL,					/* write */
+
+	NULL,					/* dup */
+
+	netprocfs_opendir,		/* opendir */
+	netprocfs_closedir,		/* closedir */
+	netprocfs_readdir,		/* readdir */
+	netprocfs_rewinddir,	/* rewinddir */
+
+	netprocfs_stat			/* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_tcp_copy
+ *
+ * Description:
+ *   Copy the state of one connection.  Called with the core locked.
+ *
+ ****************************************************************************/
+
+static void net_tcp_copy(FAR struct net_tcp_entry_s *entry, FAR struct tcp_pcb *pcb)
+{
+	FAR struct tcp_seg *seg;
+
+	memset(entry, 0, sizeof(*entry));
+	ip_addr_copy(entry->local_ip, pcb->local_ip);
+	ip_addr_copy(entry->remote_ip, pcb->remote_ip);
+	entry->local_port = pcb->local_port;
+	entry->remote_port = pcb->remote_port;
+	entry->state = (u8_t)pcb->state;
+	entry->nrtx = pcb->nrtx;
+	entry->snd_wnd = pcb->snd_wnd;
+	entry->rcv_wnd = pcb->rcv_wnd;
+	entry->cwnd = pcb->cwnd;
+	entry->ssthresh = pcb->ssthresh;
+
+	/* sa is 8 times and sv 4 times the estimate, in slow timer ticks */
+
+	entry->srtt = (u32_t)(pcb->sa >> 3) * TCP_SLOW_INTERVAL;
+	entry->rttvar = (u32_t)(pcb->sv >> 2) * TCP_SLOW_INTERVAL;
+	entry->rto = (u32_t)pcb->rto * TCP_SLOW_INTERVAL;
+
+	for (seg = pcb->unsent; seg != NULL; seg = seg->next) {
+		entry->unsent++;
+		entry->unsent_bytes += seg->len;
+	}
+	for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+		entry->unacked++;
+		entry->unacked_bytes += seg->len;
+	}
+#if TCP_QUEUE_OOSEQ
+	for (seg = pcb->ooseq; seg != NULL; seg = seg->next) {
+		entry->ooseq++;
+		entry->ooseq_bytes += seg->len;
+	}
+#endif
+#if LWIP_TCP_PCB_STATS
+	entry->stats = pcb->stats;
+#endif
+}
+
+/****************************************************************************
+ * Name: net_tcp_snapshot
+ *
+ * Description:
+ *   Copy the listening, active and TIME_WAIT connections, in the tcpip
+ *   thread or with the core locked.
+ *
+ ****************************************************************************/
+
+static err_t net_tcp_snapshot(FAR struct tcpip_api_call_data *call)
+{
+	FAR struct net_tcp_snapshot_s *snap = (FAR struct net_tcp_snapshot_s *)call;
+	FAR struct net_tcp_entry_s *entry;
+	FAR struct tcp_pcb_listen *lpcb;
+	FAR struct tcp_pcb *pcb;
+	FAR struct tcp_pcb *const *list[2];
+	int i;
+
+	snap->npcbs = 0;
+
+	for (lpcb = tcp_listen_pcbs.listen_pcbs; lpcb != NULL; lpcb = lpcb->next) {
+		if (snap->npcbs < snap->nentries) {
+			entry = &snap->entry[snap->npcbs];
+			memset(entry, 0, sizeof(*entry));
+			ip_addr_copy(entry->local_ip, lpcb->local_ip);
+			ip_addr_copy(entry->remote_ip, lpcb->remote_ip);
+			entry->local_port = lpcb->local_port;
+			entry->state = (u8_t)lpcb->state;
+		}
+		snap->npcbs++;
+	}
+
+	list[0] = &tcp_active_pcbs;
+	list[1] = &tcp_tw_pcbs;
+	for (i = 0; i < 2; i++) {
+		for (pcb = *list[i]; pcb != NULL; pcb = pcb->next) {
+			if (snap->npcbs < snap->nentries) {
+				net_tcp_copy(&snap->entry[snap->npcbs], pcb);
+			}
+			snap->npcbs++;
+		}
+	}
+
+	return ERR_OK;
+}
+
+/****************************************************************************
+ * Name: net_addr_format
+ ****************************************************************************/
+
+static void net_addr_format(FAR char *buf, size_t len, FAR const ip_addr_t *addr, u16_t port)
+{
+	char ip[NET_ADDRLEN];
+
+	if (ipaddr_ntoa_r(addr, ip, sizeof(ip)) == NULL) {
+		strncpy(ip, "?", sizeof(ip));
+	}
+	snprintf(buf, len, "%s:%u", ip, port);
+}
+
+/****************************************************************************
+ * Name: net_tcp_format
+ *
+ * Description:
+ *   Take the snapshot and format it into nfile->text.
+ *
+ ****************************************************************************/
+
+static int net_tcp_format(FAR struct net_file_s *nfile)
+{
+	struct net_tcp_snapshot_s snap;
+	FAR struct net_tcp_entry_s *entry;
+	char local[NET_ADDRLEN];
+	char remote[NET_ADDRLEN];
+	size_t size;
+	size_t len;
+	int n;
+	int i;
+
+	snap.entry = (FAR struct net_tcp_entry_s *)kmm_malloc(NET_TCP_MAXPCBS * sizeof(struct net_tcp_entry_s));
+	if (snap.entry == NULL) {
+		return -ENOMEM;
+	}
+	snap.nentries = NET_TCP_MAXPCBS;
+	tcpip_api_call(net_tcp_snapshot, &snap.call);
+
+	/* The stack is not held any more, format the copy */
+
+	n = snap.npcbs < snap.nentries ? snap.npcbs : snap.nentries;
+	size = (size_t)(n + 2) * NET_TCP_LINELEN;
+	nfile->text = (FAR char *)kmm_malloc(size);
+	if (nfile->text == NULL) {
+		kmm_free(snap.entry);
+		return -ENOMEM;
+	}
+
+	len = snprintf(nfile->text, size, "%-*s %-*s %-11s %6s %6s %6s %8s %5s %6s %5s %3s %11s %11s %11s"
+#if LWIP_TCP_PCB_STATS
+				   " %8s %6s %6s %6s %10s %10s"
+#endif
+				   "\n", NET_ADDRLEN - 1, "local", NET_ADDRLEN - 1, "remote", "state", "sndwnd", "rcvwnd", "cwnd", "ssthresh", "srtt", "rttvar", "rto", "rtx", "unsent", "unacked", "ooseq"
+#if LWIP_TCP_PCB_STATS
+				   , "timeouts", "rexmit", "dupack", "drops", "rx_bytes", "tx_bytes"
+#endif
+				  );
+
+	for (i = 0; i < n && len < size; i++) {
+		entry = &snap.entry[i];
+		net_addr_format(local, sizeof(local), &entry->local_ip, entry->local_port);
+		net_addr_format(remote, sizeof(remote), &entry->remote_ip, entry->remote_port);
+		len += snprintf(nfile->text + len, size - len, "%-*s %-*s %-11s %6u %6u %6u %8u %5u %6u %5u %3u %4u/%-6u %4u/%-6u %4u/%-6u"
+#if LWIP_TCP_PCB_STATS
+						" %8u %6u %6u %6u %10u %10u"
+#endif
+						"\n", NET_ADDRLEN - 1, local, NET_ADDRLEN - 1, remote, entry->state < sizeof(g_net_tcp_state) / sizeof(g_net_tcp_state[0]) ? g_net_tcp_state[entry->state] : "?", (unsigned)entry->snd_wnd, (unsigned)entry->rcv_wnd, (unsigned)entry->cwnd, (unsigned)entry->ssthresh, (unsigned)entry->srtt, (unsigned)entry->rttvar, (unsigned)entry->rto, (unsigned)entry->nrtx, entry->unsent, (unsigned)entry->unsent_bytes, entry->unacked, (unsigned)entry->unacked_bytes, entry->ooseq, (unsigned)entry->ooseq_bytes
+#if LWIP_TCP_PCB_STATS
+						, (unsigned)entry->stats.rto, (unsigned)entry->stats.rexmit, (unsigned)entry->stats.dupacks, (unsigned)entry->stats.drops, (unsigned)entry->stats.bytes_in, (unsigned)entry->stats.bytes_out
+#endif
+					   );
+	}
+
+	if (snap.npcbs > n && len < size) {
+		len += snprintf(nfile->text + len, size - len, "%d more connections not shown\n", snap.npcbs - n);
+	}
+
+	nfile->textlen = len < size ? len : size - 1;
+	kmm_free(snap.entry);
+	return OK;
+}
+
+#if NET_HAVE_MEMP
+/****************************************************************************
+ * Name: net_memp_snapshot
+ ****************************************************************************/
+
+static err_t net_memp_snapshot(FAR struct tcpip_api_call_data *call)
+{
+	FAR struct net_memp_snapshot_s *snap = (FAR struct net_memp_snapshot_s *)call;
+#if MEMP_STATS
+	int i;
+#endif
+
+#if MEM_STATS
+	snap->mem = lwip_stats.mem;
+#endif
+#if MEMP_STATS
+	for (i = 0; i < MEMP_MAX; i++) {
+		snap->memp[i] = *lwip_stats.memp[i];
+	}
+#endif
+#if PBUF_POOL_RESERVE
+	pbuf_pool_reserve_stats(&snap->reserve);
+#endif
+	return ERR_OK;
+}
+
+#if MEM_STATS || MEMP_STATS
+/****************************************************************************
+ * Name: net_memp_line
+ ****************************************************************************/
+
+static size_t net_memp_line(FAR char *buf, size_t len, FAR const char *name, FAR const struct stats_mem *mem)
+{
+	return snprintf(buf, len, "%-16s %8u %8u %8u %8u\n", name, (unsigned)mem->used, (unsigned)mem->max, (unsigned)mem->avail, (unsigned)mem->err);
+}
+#endif
+
+/****************************************************************************
+ * Name: net_memp_format
+ ****************************************************************************/
+
+static int net_memp_format(FAR struct net_file_s *nfile)
+{
+	FAR struct net_memp_snapshot_s *snap;
+	size_t size;
+	size_t len;
+#if MEMP_STATS
+	int i;
+#endif
+
+	/* The pool statistics are too large for the stack */
+
+	snap = (FAR struct net_memp_snapshot_s *)kmm_malloc(sizeof(struct net_memp_snapshot_s));
+	if (snap == NULL) {
+		return -ENOMEM;
+	}
+	tcpip_api_call(net_memp_snapshot, &snap->call);
+
+	size = (MEMP_MAX + 4) * NET_MEMP_LINELEN;
+	nfile->text = (FAR char *)kmm_malloc(size);
+	if (nfile->text == NULL) {
+		kmm_free(snap);
+		return -ENOMEM;
+	}
+
+	/* With MEMP_MEM_MALLOC the pools come from the heap and avail is 0 */
+
+	len = 0;
+#if MEM_STATS || MEMP_STATS
+	len += snprintf(nfile->text, size, "%-16s %8s %8s %8s %8s\n", "pool", "used", "max", "avail", "err");
+#endif
+#if MEM_STATS
+	len += net_memp_line(nfile->text + len, size - len, "HEAP", &snap->mem);
+#endif
+#if MEMP_STATS
+	for (i = 0; i < MEMP_MAX && len < size; i++) {
+		len += net_memp_line(nfile->text + len, size - len, g_net_memp_name[i], &snap->memp[i]);
+	}
+#endif
+#if PBUF_POOL_RESERVE
+	if (len < size) {
+		len += snprintf(nfile->text + len, size - len, "PBUF_POOL reserve %u for priority %u: %u free, %u lowest, %u refused\n", PBUF_POOL_RESERVE, PBUF_POOL_RESERVE_PRIO, snap->reserve.avail, snap->reserve.min_avail, (unsigned)snap->reserve.refused);
+	}
+#endif
+
+	nfile->textlen = len < size ? len : size - 1;
+	kmm_free(snap);
+	return OK;
+}
+#endif							/* NET_HAVE_MEMP */
+
+/****************************************************************************
+ * Name: netprocfs_findnode
+ ****************************************************************************/
+
+static FAR const struct net_node_s *netprocfs_findnode(FAR const char *relpath)
+{
+	int i;
+
+	/* "net" is the directory, "net/<node>" a file in it */
+
+	if (strncmp(relpath, NET_DIRNAME, strlen(NET_DIRNAME)) != 0) {
+		fdbg("ERROR: Bad relpath: %s\n", relpath);
+		return NULL;
+	}
+	relpath += strlen(NET_DIRNAME);
+
+	if (relpath[0] == '/') {
+		relpath++;
+	}
+
+	for (i = 0; i < NET_NNODES; i++) {
+		if (strcmp(g_net_nodeinfo[i]->relpath, relpath) == 0) {
+			return g_net_nodeinfo[i];
+		}
+	}
+
+	return NULL;
+}
+
+/****************************************************************************
+ * Name: netprocfs_open
+ ****************************************************************************/
+
+static int netprocfs_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	FAR struct net_file_s *nfile;
+	FAR const struct net_node_s *node;
+	int ret;
+
+	fvdbg("Open '%s'\n", relpath);
+
+	/* PROCFS is read-only */
+
+	if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0) {
+		fdbg("ERROR: Only O_RDONLY supported\n");
+		return -EACCES;
+	}
+
+	node = netprocfs_findnode(relpath);
+	if (!node) {
+		fdbg("ERROR: Invalid path \"%s\"\n", relpath);
+		return -ENOENT;
+	}
+
+	if (!DIRENT_ISFILE(node->dtype)) {
+		fdbg("ERROR: Path \"%s\" is not a regular file\n", relpath);
+		return -EISDIR;
+	}
+
+	nfile = (FAR struct net_file_s *)kmm_zalloc(sizeof(struct net_file_s));
+	if (!nfile) {
+		fdbg("ERROR: Failed to allocate file container\n");
+		return -ENOMEM;
+	}
+	nfile->node = node;
+
+	/* The listing is taken once, so that reads in small pieces see one
+	 * consistent state
+	 */
+
+	switch (node->nodetype) {
+	case NET_TCP:
+		ret = net_tcp_format(nfile);
+		break;
+#if NET_HAVE_MEMP
+	case NET_MEMP:
+		ret = net_memp_format(nfile);
+		break;
+#endif
+	default:
+		ret = -ENOENT;
+		break;
+	}
+
+	if (ret < 0) {
+		kmm_free(nfile);
+		return ret;
+	}
+
+	filep->f_priv = (FAR void *)nfile;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: netprocfs_close
+ ****************************************************************************/
+
+static int netprocfs_close(FAR struct file *filep)
+{
+	FAR struct net_file_s *nfile;
+
+	nfile = (FAR struct net_file_s *)filep->f_priv;
+	DEBUGASSERT(nfile);
+
+	if (nfile->text) {
+		kmm_free(nfile->text);
+	}
+	kmm_free(nfile);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: netprocfs_read
+ ****************************************************************************/
+
+static ssize_t netprocfs_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct net_file_s *nfile;
+	off_t offset;
+	ssize_t ret;
+
+	fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+	nfile = (FAR struct net_file_s *)filep->f_priv;
+	DEBUGASSERT(nfile);
+
+	offset = filep->f_pos;
+	ret = procfs_memcpy(nfile->text, nfile->textlen, buffer, buflen, &offset);
+
+	/* Update the file offset */
+
+	if (ret > 0) {
+		filep->f_pos += ret;
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: netprocfs_opendir
+ ****************************************************************************/
+
+static int netprocfs_opendir(FAR const char *relpath, FAR struct fs_dirent_s *dir)
+{
+	FAR struct net_dir_s *net_dir;
+	FAR const struct net_node_s *node;
+
+	fvdbg("relpath: \"%s\"\n", relpath ? relpath : "NULL");
+	DEBUGASSERT(relpath && dir && !dir->u.procfs);
+
+	node = netprocfs_findnode(relpath);
+	if (!node) {
+		fdbg("ERROR: Invalid path \"%s\"\n", relpath);
+		return -ENOENT;
+	}
+
+	if (!DIRENT_ISDIRECTORY(node->dtype)) {
+		fdbg("ERROR: Path \"%s\" is not a regular directory\n", relpath);
+		return -ENOTDIR;
+	}
+
+	net_dir = (FAR struct net_dir_s *)kmm_zalloc(sizeof(struct net_dir_s));
+	if (!net_dir) {
+		fdbg("ERROR: Failed to allocate the directory structure\n");
+		return -ENOMEM;
+	}
+
+	net_dir->base.level = 1;
+	net_dir->base.nentries = NET_NLEVEL0NODES;
+	net_dir->base.index = 0;
+	net_dir->node = node;
+
+	dir->u.procfs = (FAR void *)net_dir;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: netprocfs_closedir
+ ****************************************************************************/
+
+static int netprocfs_closedir(FAR struct fs_dirent_s *dir)
+{
+	DEBUGASSERT(dir && dir->u.procfs);
+
+	kmm_free(dir->u.procfs);
+	dir->u.procfs = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: netprocfs_readdir
+ ****************************************************************************/
+
+static int netprocfs_readdir(FAR struct fs_dirent_s *dir)
+{
+	FAR struct net_dir_s *net_dir;
+	FAR const struct net_node_s *node;
+	unsigned int index;
+
+	DEBUGASSERT(dir && dir->u.procfs);
+	net_dir = dir->u.procfs;
+
+	/* The end of the directory is signalled with -ENOENT */
+
+	index = net_dir->base.index;
+	if (index >= net_dir->base.nentries) {
+		fvdbg("Entry %d: End of directory\n", index);
+		return -ENOENT;
+	}
+
+	node = g_net_level0info[index];
+	dir->fd_dir.d_type = node->dtype;
+	strncpy(dir->fd_dir.d_name, node->name, NAME_MAX + 1);
+
+	net_dir->base.index = index + 1;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: netprocfs_rewinddir
+ ****************************************************************************/
+
+static int netprocfs_rewinddir(FAR struct fs_dirent_s *dir)
+{
+	FAR struct net_dir_s *priv;
+
+	DEBUGASSERT(dir && dir->u.procfs);
+	priv = dir->u.procfs;
+
+	priv->base.index = 0;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: netprocfs_stat
+ ****************************************************************************/
+
+static int netprocfs_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+	FAR const struct net_node_s *node;
+
+	node = netprocfs_findnode(relpath);
+	if (!node) {
+		fdbg("ERROR: Invalid path \"%s\"\n", relpath);
+		return -ENOENT;
+	}
+
+	if (node->dtype == DTYPE_FILE) {
+		buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+	} else {
+		buf->st_mode = S_IFDIR | S_IROTH | S_IRGRP | S_IRUSR;
+	}
+
+	buf->st_size = 0;
+	buf->st_blksize = 0;
+	buf->st_blocks = 0;
+	return OK;
+}
+
+#endif							/* !CONFIG_FS_PROCFS_EXCLUDE_NET && LWIP_TCP */
+#endif							/* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
@@ -60,6 +60,9 @@
 
 #include <sys/socket.h>
 #include <sys/types.h>
+#ifdef CONFIG_NET_EPOLL
+#include <sys/epoll.h>
+#endif
 #include <netinet/in.h>
 #include <net/lwip/netdb.h>
 #include <net/lwip/sockets.h>
@@ -168,6 +171,24 @@ ssize_t sendto(int s, const void *data, size_t size, int flags, const struct soc
 	return result;
 }
 
+int sendmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+	/* Treat as a cancellation point */
+	(void)enter_cancellation_point();
+	int result = lwip_sendmmsg(sockfd, msgvec, vlen, flags);
+	leave_cancellation_point();
+	return result;
+}
+
+int recvmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen, int flags, struct timespec *timeout)
+{
+	/* Treat as a cancellation point */
+	(void)enter_cancellation_point();
+	int result = lwip_recvmmsg(sockfd, msgvec, vlen, flags, timeout);
+	leave_cancellation_point();
+	return result;
+}
+
 static int socket_argument_validation(int domain, int type, int protocol)
 {
 	if (domain != AF_INET && domain != AF_INET6 && domain != AF_UNSPEC) {
@@ -224,4 +245,25 @@ int select(int maxfdp1, fd_set *readset, fd_set *writeset, fd_set *exceptset, st
 }
 #endif
 
+#ifdef CONFIG_NET_EPOLL
+int epoll_create1(int flags)
+{
+	return lwip_epoll_create(flags);
+}
+
+int epoll_ctl(int epfd, int op, int fd, struct epoll_event *event)
+{
+	return lwip_epoll_ctl(epfd, op, fd, event);
+}
+
+int epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout)
+{
+	/* Treat as a cancellation point */
+	(void)enter_cancellation_point();
+	int result = lwip_epoll_wait(epfd, events, maxevents, timeout);
+	leave_cancellation_point();
+	return result;
+}
+#endif
+
 #endif
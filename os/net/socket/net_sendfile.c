@@ -0,0 +1,336 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * net/socket/net_sendfile.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_SENDFILE)
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/semaphore.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/ioctl.h>
+#include <tinyara/net/net.h>
+#include <net/lwip/sockets.h>
+
+#include "socket/socket.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A piece of the file which the stack may refer to */
+
+struct sendfile_chunk_s {
+	FAR uint8_t *buf;			/* Kernel buffer, NULL for data on the media */
+	int calls;					/* lwip_send_ref() calls not completed yet */
+};
+
+struct sendfile_s {
+	int sockfd;
+	sem_t done;					/* Posted once for each completed call */
+	int err;					/* errno of a connection which was aborted */
+	struct sendfile_chunk_s chunk[CONFIG_NET_SENDFILE_NCHUNKS];
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sendfile_done
+ *
+ * Description:
+ *   Completion of lwip_send_ref(), called from the tcpip thread.  A TCP
+ *   socket completes the calls in the order they were made.
+ *
+ ****************************************************************************/
+
+static void sendfile_done(FAR void *arg, int err)
+{
+	FAR struct sendfile_s *xfer = (FAR struct sendfile_s *)arg;
+
+	if (err != 0 && xfer->err == 0) {
+		xfer->err = err;
+	}
+	sem_post(&xfer->done);
+}
+
+/****************************************************************************
+ * Name: sendfile_wait
+ *
+ * Description:
+ *   Wait until the stack does not refer to the chunk any more.  The calls
+ *   complete in order, so the oldest chunk is the first one to be free.
+ *
+ ****************************************************************************/
+
+static void sendfile_wait(FAR struct sendfile_s *xfer, FAR struct sendfile_chunk_s *chunk)
+{
+	while (chunk->calls > 0) {
+		/* The data must not be reused before it is done, even on a signal */
+
+		if (sem_wait(&xfer->done) == OK) {
+			chunk->calls--;
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: sendfile_send
+ *
+ * Description:
+ *   Send the data of a chunk by reference.  Returns the number of bytes
+ *   queued, which is less than len only if the send timed out, or a
+ *   negated errno value if nothing was queued.
+ *
+ ****************************************************************************/
+
+static ssize_t sendfile_send(FAR struct sendfile_s *xfer, FAR struct sendfile_chunk_s *chunk, FAR const uint8_t *data, size_t len, int flags)
+{
+	size_t sent = 0;
+	int ret;
+
+	while (sent < len) {
+		ret = lwip_send_ref(xfer->sockfd, data + sent, len - sent, flags, sendfile_done, xfer);
+		if (ret <= 0) {
+			if (sent == 0) {
+				return -get_errno();
+			}
+			break;
+		}
+		chunk->calls++;
+		sent += ret;
+	}
+
+	return (ssize_t)sent;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: net_sendfile
+ *
+ * Description:
+ *   Send a file to a TCP socket without copying the data into a user
+ *   buffer and then into the stack.  A file on directly accessible media
+ *   (FIOC_MMAP) is sent straight from the media.  Other files are read
+ *   into CONFIG_NET_SENDFILE_NCHUNKS kernel chunks which are sent by
+ *   reference and reused as the peer acknowledges them.
+ *
+ *   The function returns when the peer has acknowledged all the data, so
+ *   the file may be changed afterwards.
+ *
+ * Parameters:
+ *   outfd    Socket descriptor of a connected TCP socket
+ *   infile   The file to read
+ *   offset   Same as for sendfile()
+ *   count    The number of bytes to send
+ *
+ * Returned Value:
+ *   The number of bytes sent, which is less than count if an error ended
+ *   the transfer, or -1 with errno set if nothing was sent.  ENOSYS means
+ *   that the socket is not a TCP socket and the caller should copy the
+ *   data.
+ *
+ ****************************************************************************/
+
+ssize_t net_sendfile(int outfd, FAR struct file *infile, FAR off_t *offset, size_t count)
+{
+	struct sendfile_s xfer;
+	FAR struct sendfile_chunk_s *chunk;
+	FAR struct inode *inode;
+	FAR uint8_t *buffer = NULL;
+	FAR uint8_t *media = NULL;
+	socklen_t optlen;
+	off_t startpos;
+	off_t endpos = 0;
+	off_t pos;
+	size_t ntransferred = 0;
+	ssize_t nbytes;
+	ssize_t nread;
+	int errval = 0;
+	int type;
+	int head;
+	int i;
+
+	/* Only the completions of a TCP socket come in order */
+
+	optlen = sizeof(type);
+	if (getsockopt(outfd, SOL_SOCKET, SO_TYPE, &type, &optlen) < 0) {
+		return ERROR;
+	}
+	if (type != SOCK_STREAM) {
+		set_errno(ENOSYS);
+		return ERROR;
+	}
+
+	startpos = file_seek(infile, 0, SEEK_CUR);
+	if (startpos == (off_t)-1) {
+		return ERROR;
+	}
+	pos = (offset != NULL) ? *offset : startpos;
+
+	xfer.sockfd = outfd;
+	xfer.err = 0;
+	for (i = 0; i < CONFIG_NET_SENDFILE_NCHUNKS; i++) {
+		xfer.chunk[i].buf = NULL;
+		xfer.chunk[i].calls = 0;
+	}
+
+	/* This semaphore is used for signaling and, hence, should not have
+	 * priority inheritance enabled.
+	 */
+
+	sem_init(&xfer.done, 0, 0);
+	sem_setprotocol(&xfer.done, SEM_PRIO_NONE);
+
+	/* Is the file directly accessible, like a ROMFS file on XIP flash? */
+
+	inode = infile->f_inode;
+	if (inode != NULL && inode->u.i_ops != NULL && inode->u.i_ops->ioctl != NULL && inode->u.i_ops->ioctl(infile, FIOC_MMAP, (unsigned long)&media) == OK && media != NULL) {
+		endpos = file_seek(infile, 0, SEEK_END);
+		if (endpos == (off_t)-1) {
+			media = NULL;
+		}
+	} else {
+		media = NULL;
+	}
+
+	if (media != NULL) {
+		/* Yes.. send it from the media in one go */
+
+		if (pos < endpos) {
+			if (count > (size_t)(endpos - pos)) {
+				count = (size_t)(endpos - pos);
+			}
+			nbytes = sendfile_send(&xfer, &xfer.chunk[0], media + pos, count, 0);
+			if (nbytes < 0) {
+				errval = -nbytes;
+			} else {
+				ntransferred = (size_t)nbytes;
+			}
+		}
+	} else {
+		/* No.. read it into the chunks */
+
+		if (file_seek(infile, pos, SEEK_SET) == (off_t)-1) {
+			errval = get_errno();
+			goto errout;
+		}
+
+		buffer = (FAR uint8_t *)kmm_malloc(CONFIG_NET_SENDFILE_CHUNKSIZE * CONFIG_NET_SENDFILE_NCHUNKS);
+		if (buffer == NULL) {
+			errval = ENOMEM;
+			goto errout;
+		}
+		for (i = 0; i < CONFIG_NET_SENDFILE_NCHUNKS; i++) {
+			xfer.chunk[i].buf = buffer + i * CONFIG_NET_SENDFILE_CHUNKSIZE;
+		}
+
+		for (head = 0; ntransferred < count; head = (head + 1) % CONFIG_NET_SENDFILE_NCHUNKS) {
+			chunk = &xfer.chunk[head];
+			sendfile_wait(&xfer, chunk);
+			if (xfer.err != 0) {
+				break;
+			}
+
+			nread = count - ntransferred;
+			if (nread > CONFIG_NET_SENDFILE_CHUNKSIZE) {
+				nread = CONFIG_NET_SENDFILE_CHUNKSIZE;
+			}
+			nread = file_read(infile, chunk->buf, (size_t)nread);
+			if (nread <= 0) {
+				/* End of file or a read error */
+
+				if (nread < 0) {
+					errval = get_errno();
+				}
+				break;
+			}
+
+			/* MSG_MORE lets the stack wait for the next chunk to fill a segment */
+
+			nbytes = sendfile_send(&xfer, chunk, chunk->buf, (size_t)nread, (ntransferred + nread < count) ? MSG_MORE : 0);
+			if (nbytes < 0) {
+				errval = -nbytes;
+				break;
+			}
+			ntransferred += (size_t)nbytes;
+			if (nbytes < nread) {
+				/* The send timed out, the rest of the chunk is not sent */
+
+				break;
+			}
+		}
+	}
+
+	/* Wait until the stack is done with all of the data */
+
+	for (i = 0; i < CONFIG_NET_SENDFILE_NCHUNKS; i++) {
+		sendfile_wait(&xfer, &xfer.chunk[i]);
+	}
+	if (errval == 0) {
+		errval = xfer.err;
+	}
+
+	if (buffer != NULL) {
+		kmm_free(buffer);
+	}
+
+errout:
+	sem_destroy(&xfer.done);
+
+	/* The file position follows what was sent, not what was read ahead */
+
+	pos += (off_t)ntransferred;
+	if (offset != NULL) {
+		*offset = pos;
+		(void)file_seek(infile, startpos, SEEK_SET);
+	} else {
+		(void)file_seek(infile, pos, SEEK_SET);
+	}
+
+	/* As for send(), an error is reported only if nothing was sent */
+
+	if (errval != 0) {
+		ndbg("sendfile failed after %lu bytes: %d\n", (unsigned long)ntransferred, errval);
+		if (ntransferred == 0) {
+			set_errno(errval);
+			return ERROR;
+		}
+	}
+
+	return (ssize_t)ntransferred;
+}
+
+#endif							/* CONFIG_NET && CONFIG_NET_SENDFILE */
@@ -339,6 +339,13 @@ SYSCALL_LOOKUP(sendto,                  6, STUB_sendto)
 SYSCALL_LOOKUP(setsockopt,              5, STUB_setsockopt)
 SYSCALL_LOOKUP(shutdown,                2, STUB_shutdown)
 SYSCALL_LOOKUP(socket,                  3, STUB_socket)
+SYSCALL_LOOKUP(recvmmsg,                5, STUB_recvmmsg)
+SYSCALL_LOOKUP(sendmmsg,                4, STUB_sendmmsg)
+#ifdef CONFIG_NET_EPOLL
+SYSCALL_LOOKUP(epoll_create1,           1, STUB_epoll_create1)
+SYSCALL_LOOKUP(epoll_ctl,               4, STUB_epoll_ctl)
+SYSCALL_LOOKUP(epoll_wait,              4, STUB_epoll_wait)
+#endif
 #endif
 
 /* The following is defined only if CONFIG_TASK_NAME_SIZE > 0 */
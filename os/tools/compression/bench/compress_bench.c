@@ -0,0 +1,235 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Host benchmark of the codecs for compressed binaries.  Every file is
+ * compressed in blocks as mkcompressimg does, then the blocks are
+ * decompressed as compress_read does and the ratio and the decode speed of
+ * each codec are printed.
+ *
+ *   make -C os/tools/compression bench
+ *   ./compress_bench [-b block size] file...
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "LzmaLib.h"
+#include "lz4.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define DEFAULT_BLOCK_SIZE   2048
+#define MAX_BLOCK_SIZE       8192
+
+/* Decode every file for at least this long to get a stable speed */
+#define MIN_DECODE_SEC       0.3
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct codec_s {
+	const char *name;
+	int (*compress)(const unsigned char *src, size_t srclen, unsigned char *dst, size_t dstlen);
+	int (*decompress)(const unsigned char *src, size_t srclen, unsigned char *dst, size_t dstlen);
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* The same parameters as mkcompressimg, 5 bytes of properties first */
+
+static int lzma_compress(const unsigned char *src, size_t srclen, unsigned char *dst, size_t dstlen)
+{
+	size_t destlen = dstlen - LZMA_PROPS_SIZE;
+	size_t propslen = LZMA_PROPS_SIZE;
+
+	if (LzmaCompress(dst + LZMA_PROPS_SIZE, &destlen, src, srclen, dst, &propslen, -1, 0, -1, -1, -1, -1, -1) != SZ_OK) {
+		return -1;
+	}
+	return destlen + LZMA_PROPS_SIZE;
+}
+
+static int lzma_decompress(const unsigned char *src, size_t srclen, unsigned char *dst, size_t dstlen)
+{
+	size_t destlen = dstlen;
+	size_t inlen = srclen - LZMA_PROPS_SIZE;
+
+	if (LzmaUncompress(dst, &destlen, src + LZMA_PROPS_SIZE, &inlen, src, LZMA_PROPS_SIZE) != SZ_OK) {
+		return -1;
+	}
+	return destlen;
+}
+
+static int lz4_compress_block(const unsigned char *src, size_t srclen, unsigned char *dst, size_t dstlen)
+{
+	return lz4_compress(src, srclen, dst, dstlen);
+}
+
+static int lz4_decompress_block(const unsigned char *src, size_t srclen, unsigned char *dst, size_t dstlen)
+{
+	return lz4_decompress(src, srclen, dst, dstlen);
+}
+
+static const struct codec_s g_codecs[] = {
+	{"lzma", lzma_compress, lzma_decompress},
+	{"lz4", lz4_compress_block, lz4_decompress_block},
+};
+
+#define NCODECS (sizeof(g_codecs) / sizeof(g_codecs[0]))
+
+static int bench_file(const char *path, int block_size)
+{
+	FILE *fp;
+	long size;
+	int nblocks;
+	int index;
+	int rounds;
+	unsigned int codec;
+	int ret = 0;
+	size_t maxout = 2 * block_size + 64;	/* LZMA can expand random data more than LZ4 */
+	unsigned char *data;
+	unsigned char *packed;
+	unsigned char *out;
+	int *offsets;
+	double start;
+	double elapsed;
+	long total;
+
+	fp = fopen(path, "rb");
+	if (fp == NULL) {
+		fprintf(stderr, "%s: cannot open\n", path);
+		return -1;
+	}
+	fseek(fp, 0, SEEK_END);
+	size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	if (size <= 0) {
+		fclose(fp);
+		return 0;
+	}
+
+	nblocks = (size + block_size - 1) / block_size;
+	data = malloc(size);
+	packed = malloc((size_t)nblocks * maxout);
+	out = malloc(block_size);
+	offsets = malloc((nblocks + 1) * sizeof(int));
+	if (!data || !packed || !out || !offsets || fread(data, 1, size, fp) != (size_t)size) {
+		fprintf(stderr, "%s: cannot read\n", path);
+		fclose(fp);
+		return -1;
+	}
+	fclose(fp);
+
+	for (codec = 0; codec < NCODECS; codec++) {
+		const struct codec_s *c = &g_codecs[codec];
+
+		/* Compress block by block */
+		offsets[0] = 0;
+		for (index = 0; index < nblocks; index++) {
+			int len = size - (long)index * block_size < block_size ? size - (long)index * block_size : block_size;
+			int n = c->compress(data + (long)index * block_size, len, packed + offsets[index], maxout);
+			if (n < 0) {
+				fprintf(stderr, "%s: %s compression failed\n", path, c->name);
+				ret = -1;
+				goto done;
+			}
+			offsets[index + 1] = offsets[index] + n;
+		}
+
+		/* Decompress all blocks until enough time passed */
+		rounds = 0;
+		total = 0;
+		start = now();
+		do {
+			for (index = 0; index < nblocks; index++) {
+				int len = size - (long)index * block_size < block_size ? size - (long)index * block_size : block_size;
+				int n = c->decompress(packed + offsets[index], offsets[index + 1] - offsets[index], out, len);
+				if (n != len || (rounds == 0 && memcmp(out, data + (long)index * block_size, len) != 0)) {
+					fprintf(stderr, "%s: %s block %d does not decompress\n", path, c->name, index);
+					ret = -1;
+					goto done;
+				}
+				total += n;
+			}
+			rounds++;
+			elapsed = now() - start;
+		} while (elapsed < MIN_DECODE_SEC);
+
+		printf("%-40s %-5s %9ld -> %9d  %5.1f%%  %8.1f MB/s\n", path, c->name, size, offsets[nblocks], offsets[nblocks] * 100.0 / size, total / elapsed / 1e6);
+	}
+
+done:
+	free(data);
+	free(packed);
+	free(out);
+	free(offsets);
+	return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+int main(int argc, char *argv[])
+{
+	int block_size = DEFAULT_BLOCK_SIZE;
+	int opt;
+	int ret = 0;
+
+	while ((opt = getopt(argc, argv, "b:")) != -1) {
+		if (opt == 'b') {
+			block_size = atoi(optarg);
+		} else {
+			optind = argc + 1;
+			break;
+		}
+	}
+
+	if (optind >= argc || block_size <= 0 || block_size > MAX_BLOCK_SIZE) {
+		fprintf(stderr, "USAGE: %s [-b block size] file...\n", argv[0]);
+		return 1;
+	}
+
+	printf("block size %d\n", block_size);
+	printf("%-40s %-5s %9s    %9s  %6s  %13s\n", "file", "codec", "size", "packed", "ratio", "decode");
+	for (; optind < argc; optind++) {
+		if (bench_file(argv[optind], block_size) < 0) {
+			ret = 1;
+		}
+	}
+
+	return ret;
+}
@@ -29,20 +29,17 @@ SRCDIR=$COMPRESSION_TOOL_PATH/src
 #load .config file
 source $OS_PATH/.config
 
-# Compression Algorithm specific initialization
-if [ $CONFIG_COMPRESSION_TYPE == 1 ]
-then
-	mkdir -p $SRCDIR/lzma
-	TMPDIR=$SRCDIR/lzma
-	SOURCEDIR=$OS_PATH/compression/lzma/
-fi
+# The tool can produce every compression type, copy all codecs
+CODECS="lzma lz4"
 
 APPNAME=mkcompressimg
 
-echo $TMPDIR
-echo $SOURCEDIR
-echo "==========Copying lzma files====================="
-cp $SOURCEDIR/*.* $TMPDIR/
+for CODEC in $CODECS
+do
+	mkdir -p $SRCDIR/$CODEC
+	echo "==========Copying $CODEC files====================="
+	cp $OS_PATH/compression/$CODEC/*.[ch] $SRCDIR/$CODEC/
+done
 
 echo "Copying Done"
 
@@ -51,6 +48,9 @@ make -C $COMPRESSION_TOOL_PATH
 
 #Waiting for make to complete
 
-rm -rf $TMPDIR/*
+for CODEC in $CODECS
+do
+	rm -rf $SRCDIR/$CODEC/*
+done
 
 echo -e "Generated compression tool \nDone"
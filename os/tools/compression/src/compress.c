@@ -30,12 +30,14 @@
 #include "../config.h"
 #include "../compression.h"
 
-#if CONFIG_COMPRESSION_TYPE == 1
 #include "lzma/LzmaLib.h"
-#endif
+#include "lz4/lz4.h"
 
 #define MAX_BLOCK_SIZE 8192
 
+/* Largest compressed block of any format */
+#define MAX_OUT_SIZE(block_size) LZ4_COMPRESSBOUND(block_size)
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -87,7 +89,7 @@ static void compress(int block_size, int type, char *in_file, char *out_file)
 		goto error;
 	}
 
-	out_buf = (unsigned char *)malloc(block_size + LZMA_PROPS_SIZE);
+	out_buf = (unsigned char *)malloc(MAX_OUT_SIZE(block_size));
 	if (!out_buf) {
 		printf("Failed to allocate memory for out_buf\n");
 		goto error;
@@ -146,20 +148,27 @@ static void compress(int block_size, int type, char *in_file, char *out_file)
 				tptr += nbytes;
 			}
 		}
-		writesize = block_size;
-#if CONFIG_COMPRESSION_TYPE == 1
-		/* LZMA Compression for data in read_buf into out_buf */
-		ret = LzmaCompress(&out_buf[LZMA_PROPS_SIZE], &writesize, read_buf, (block_size - readsize), out_buf, &propsSize, -1, 0, -1, -1, -1, -1, -1);
-		if (ret != SZ_OK) {
-			printf("LZMA Compress failed, ret = %d\n", ret);
-		}
+		if (type == COMPRESSION_TYPE_LZMA) {
+			/* LZMA Compression for data in read_buf into out_buf */
+			writesize = block_size;
+			ret = LzmaCompress(&out_buf[LZMA_PROPS_SIZE], &writesize, read_buf, (block_size - readsize), out_buf, &propsSize, -1, 0, -1, -1, -1, -1, -1);
+			if (ret != SZ_OK) {
+				printf("LZMA Compress failed, ret = %d\n", ret);
+			}
+			writesize += LZMA_PROPS_SIZE;
+
+			printf("==> lzma_compress %d writesize %lu\n", index, writesize);
+		} else {
+			/* LZ4 Compression for data in read_buf into out_buf */
+			ret = lz4_compress(read_buf, (block_size - readsize), out_buf, MAX_OUT_SIZE(block_size));
+			if (ret < 0) {
+				printf("LZ4 Compress failed, ret = %d\n", ret);
+				goto error;
+			}
+			writesize = ret;
 
-		printf("==> lzma_compress %d writesize %lu\n", index, writesize);
-#else
-		printf("Compression for type %d not supported\n", CONFIG_COMPRESSION_TYPE);
-		printf("Set CONFIG_COMPRESSION_TYPE to %d, then generate mkcompressimg again for this type", CONFIG_COMPRESSION_TYPE);
-		exit(1);
-#endif
+			printf("==> lz4_compress %d writesize %lu\n", index, writesize);
+		}
 		phdr->secoff[index + 1] = phdr->secoff[index] + writesize;
 
 		/* Write out_buf to output file */
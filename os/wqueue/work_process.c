@@ -63,6 +63,7 @@
 
 #include <tinyara/clock.h>
 #include <tinyara/wqueue.h>
+#include <tinyara/ttrace.h>
 
 #include <arch/irq.h>
 
@@ -209,7 +210,9 @@ void work_process(FAR struct wqueue_s *wqueue, int wndx)
 #else
 				irqrestore(flags);
 #endif
+				trace_work_start(worker);
 				worker(arg);
+				trace_work_end(worker);
 
 				/* Now, unfortunately, since we re-enabled interrupts we don't
 				 * know the state of the work list and we will have to start
@@ -0,0 +1,30 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/* Minimal configuration to build the lock-free ring library on the host */
+
+#ifndef __TOOLS_LFRING_BENCH_INCLUDE_TINYARA_CONFIG_H
+#define __TOOLS_LFRING_BENCH_INCLUDE_TINYARA_CONFIG_H
+
+#include <assert.h>
+
+#define FAR
+#define OK 0
+#define DEBUGASSERT(x) assert(x)
+
+#endif
@@ -0,0 +1,400 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/* Host throughput benchmark of the lock-free ring buffer.
+ *
+ * A producer thread streams data to a consumer thread through:
+ *   - "byte+lock"  : a mutex protected ring copied one byte at a time with
+ *                    modulo wraparound, as the pipe driver used to do
+ *   - "copy+lock"  : a mutex protected ring with a two segment memcpy
+ *   - "lfring"     : the lock-free SPSC ring
+ * and then several producers push records to one consumer through a mutex
+ * protected record queue and through the lock-free MPSC queue.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include <tinyara/lfring.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BENCH_RINGSIZE      4096
+#define BENCH_TOTAL         (256 * 1024 * 1024)
+#define BENCH_RECSIZE       16
+#define BENCH_NRECS         256
+#define BENCH_RECORDS       (4 * 1024 * 1024)
+#define BENCH_MAXPRODUCERS  4
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Lock based ring used as the baseline */
+
+struct lockring_s {
+	pthread_mutex_t lock;
+	uint8_t *buffer;
+	size_t size;
+	size_t rdndx;
+	size_t wrndx;
+	size_t used;
+};
+
+struct bench_s {
+	const char *name;
+	size_t (*write)(void *ring, const uint8_t *data, size_t len);
+	size_t (*read)(void *ring, uint8_t *data, size_t len);
+	void *ring;
+	size_t chunk;
+};
+
+struct mpbench_s {
+	int (*put)(void *ring, const void *rec);
+	int (*get)(void *ring, void *rec);
+	void *ring;
+	size_t nrecs;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static double bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void lockring_init(struct lockring_s *ring, size_t size)
+{
+	pthread_mutex_init(&ring->lock, NULL);
+	ring->buffer = malloc(size);
+	ring->size = size;
+	ring->rdndx = 0;
+	ring->wrndx = 0;
+	ring->used = 0;
+}
+
+static void lockring_deinit(struct lockring_s *ring)
+{
+	pthread_mutex_destroy(&ring->lock);
+	free(ring->buffer);
+}
+
+static size_t byteloop_write(void *arg, const uint8_t *data, size_t len)
+{
+	struct lockring_s *ring = arg;
+	size_t n = 0;
+
+	pthread_mutex_lock(&ring->lock);
+	while (n < len && ring->used < ring->size) {
+		ring->buffer[ring->wrndx] = data[n++];
+		ring->wrndx = (ring->wrndx + 1) % ring->size;
+		ring->used++;
+	}
+	pthread_mutex_unlock(&ring->lock);
+	return n;
+}
+
+static size_t byteloop_read(void *arg, uint8_t *data, size_t len)
+{
+	struct lockring_s *ring = arg;
+	size_t n = 0;
+
+	pthread_mutex_lock(&ring->lock);
+	while (n < len && ring->used > 0) {
+		data[n++] = ring->buffer[ring->rdndx];
+		ring->rdndx = (ring->rdndx + 1) % ring->size;
+		ring->used--;
+	}
+	pthread_mutex_unlock(&ring->lock);
+	return n;
+}
+
+static size_t lockcopy_write(void *arg, const uint8_t *data, size_t len)
+{
+	struct lockring_s *ring = arg;
+	size_t first;
+
+	pthread_mutex_lock(&ring->lock);
+	if (len > ring->size - ring->used) {
+		len = ring->size - ring->used;
+	}
+	first = ring->size - ring->wrndx;
+	if (first > len) {
+		first = len;
+	}
+	memcpy(ring->buffer + ring->wrndx, data, first);
+	memcpy(ring->buffer, data + first, len - first);
+	ring->wrndx = (ring->wrndx + len) % ring->size;
+	ring->used += len;
+	pthread_mutex_unlock(&ring->lock);
+	return len;
+}
+
+static size_t lockcopy_read(void *arg, uint8_t *data, size_t len)
+{
+	struct lockring_s *ring = arg;
+	size_t first;
+
+	pthread_mutex_lock(&ring->lock);
+	if (len > ring->used) {
+		len = ring->used;
+	}
+	first = ring->size - ring->rdndx;
+	if (first > len) {
+		first = len;
+	}
+	memcpy(data, ring->buffer + ring->rdndx, first);
+	memcpy(data + first, ring->buffer, len - first);
+	ring->rdndx = (ring->rdndx + len) % ring->size;
+	ring->used -= len;
+	pthread_mutex_unlock(&ring->lock);
+	return len;
+}
+
+static size_t lfring_bench_write(void *ring, const uint8_t *data, size_t len)
+{
+	return lfring_write(ring, data, len);
+}
+
+static size_t lfring_bench_read(void *ring, uint8_t *data, size_t len)
+{
+	return lfring_read(ring, data, len);
+}
+
+static void *bench_producer(void *arg)
+{
+	struct bench_s *bench = arg;
+	uint8_t *chunk = malloc(bench->chunk);
+	size_t total = 0;
+	size_t off;
+
+	memset(chunk, 0x5a, bench->chunk);
+	while (total < BENCH_TOTAL) {
+		off = 0;
+		while (off < bench->chunk) {
+			size_t n = bench->write(bench->ring, chunk + off, bench->chunk - off);
+			if (n == 0) {
+				sched_yield();
+			}
+			off += n;
+		}
+		total += bench->chunk;
+	}
+
+	free(chunk);
+	return NULL;
+}
+
+static void *bench_consumer(void *arg)
+{
+	struct bench_s *bench = arg;
+	uint8_t *chunk = malloc(bench->chunk);
+	size_t total = 0;
+
+	while (total < BENCH_TOTAL) {
+		size_t n = bench->read(bench->ring, chunk, bench->chunk);
+		if (n == 0) {
+			sched_yield();
+		}
+		total += n;
+	}
+
+	free(chunk);
+	return NULL;
+}
+
+static double bench_stream(struct bench_s *bench)
+{
+	pthread_t producer;
+	pthread_t consumer;
+	double start;
+
+	start = bench_now();
+	pthread_create(&consumer, NULL, bench_consumer, bench);
+	pthread_create(&producer, NULL, bench_producer, bench);
+	pthread_join(producer, NULL);
+	pthread_join(consumer, NULL);
+
+	return BENCH_TOTAL / (bench_now() - start) / (1024 * 1024);
+}
+
+static void run_stream_benchmark(void)
+{
+	static const size_t chunks[] = { 16, 64, 256, 1024, 4096 };
+	struct lockring_s lockring;
+	struct lfring_s ring;
+	struct bench_s bench;
+	uint8_t *buffer;
+	int i;
+
+	printf("SPSC byte stream, %d MB through a %d byte ring (MB/s)\n", BENCH_TOTAL >> 20, BENCH_RINGSIZE);
+	printf("%8s %12s %12s %12s\n", "chunk", "byte+lock", "copy+lock", "lfring");
+
+	buffer = malloc(BENCH_RINGSIZE);
+	for (i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+		printf("%8zu", chunks[i]);
+		bench.chunk = chunks[i];
+
+		lockring_init(&lockring, BENCH_RINGSIZE);
+		bench.write = byteloop_write;
+		bench.read = byteloop_read;
+		bench.ring = &lockring;
+		printf(" %12.1f", bench_stream(&bench));
+		lockring_deinit(&lockring);
+
+		lockring_init(&lockring, BENCH_RINGSIZE);
+		bench.write = lockcopy_write;
+		bench.read = lockcopy_read;
+		printf(" %12.1f", bench_stream(&bench));
+		lockring_deinit(&lockring);
+
+		lfring_init(&ring, buffer, BENCH_RINGSIZE, 0);
+		bench.write = lfring_bench_write;
+		bench.read = lfring_bench_read;
+		bench.ring = &ring;
+		printf(" %12.1f\n", bench_stream(&bench));
+		fflush(stdout);
+	}
+	free(buffer);
+}
+
+static int lockrec_put(void *arg, const void *rec)
+{
+	return lockcopy_write(arg, rec, BENCH_RECSIZE) == BENCH_RECSIZE ? OK : -ENOSPC;
+}
+
+static int lockrec_get(void *arg, void *rec)
+{
+	return lockcopy_read(arg, rec, BENCH_RECSIZE) == BENCH_RECSIZE ? OK : -EAGAIN;
+}
+
+static int mpsc_put(void *ring, const void *rec)
+{
+	return lfring_mpsc_put(ring, rec);
+}
+
+static int mpsc_get(void *ring, void *rec)
+{
+	return lfring_mpsc_get(ring, rec);
+}
+
+static void *mp_producer(void *arg)
+{
+	struct mpbench_s *bench = arg;
+	uint8_t rec[BENCH_RECSIZE];
+	size_t i;
+
+	memset(rec, 0xa5, sizeof(rec));
+	for (i = 0; i < bench->nrecs; i++) {
+		while (bench->put(bench->ring, rec) != OK) {
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+static double bench_records(struct mpbench_s *bench, int nproducers)
+{
+	pthread_t producers[BENCH_MAXPRODUCERS];
+	uint8_t rec[BENCH_RECSIZE];
+	size_t total = 0;
+	double start;
+	int i;
+
+	bench->nrecs = BENCH_RECORDS / nproducers;
+	start = bench_now();
+	for (i = 0; i < nproducers; i++) {
+		pthread_create(&producers[i], NULL, mp_producer, bench);
+	}
+
+	while (total < bench->nrecs * nproducers) {
+		if (bench->get(bench->ring, rec) == OK) {
+			total++;
+		} else {
+			sched_yield();
+		}
+	}
+
+	for (i = 0; i < nproducers; i++) {
+		pthread_join(producers[i], NULL);
+	}
+
+	return total / (bench_now() - start) / 1e6;
+}
+
+static void run_record_benchmark(void)
+{
+	struct lockring_s lockring;
+	struct lfring_mpsc_s ring;
+	struct mpbench_s bench;
+	uint32_t *buffer;
+	int nproducers;
+
+	printf("\nMPSC %d byte records, %d M records (M records/s)\n", BENCH_RECSIZE, BENCH_RECORDS >> 20);
+	printf("%8s %12s %12s\n", "writers", "copy+lock", "lfring_mpsc");
+
+	buffer = malloc(LFRING_MPSC_BUFSIZE(BENCH_NRECS, BENCH_RECSIZE));
+	for (nproducers = 1; nproducers <= BENCH_MAXPRODUCERS; nproducers++) {
+		printf("%8d", nproducers);
+
+		lockring_init(&lockring, BENCH_NRECS * BENCH_RECSIZE);
+		bench.put = lockrec_put;
+		bench.get = lockrec_get;
+		bench.ring = &lockring;
+		printf(" %12.2f", bench_records(&bench, nproducers));
+		lockring_deinit(&lockring);
+
+		lfring_mpsc_init(&ring, buffer, BENCH_NRECS, BENCH_RECSIZE);
+		bench.put = mpsc_put;
+		bench.get = mpsc_get;
+		bench.ring = &ring;
+		printf(" %12.2f\n", bench_records(&bench, nproducers));
+		fflush(stdout);
+	}
+	free(buffer);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+	run_stream_benchmark();
+	run_record_benchmark();
+	return 0;
+}
@@ -0,0 +1,33 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/* Host replacement of include/debug.h for the lwIP sources */
+
+#ifndef __TOOLS_LWIP_BENCH_DEBUG_H
+#define __TOOLS_LWIP_BENCH_DEBUG_H
+
+#include <assert.h>
+#include <stdio.h>
+
+#define lwipdbg(format, ...)	fprintf(stderr, format, ##__VA_ARGS__)
+#define ndbg(format, ...)	fprintf(stderr, format, ##__VA_ARGS__)
+
+#define ASSERT(f)		assert(f)
+#define DEBUGASSERT(f)		assert(f)
+
+#endif							/* __TOOLS_LWIP_BENCH_DEBUG_H */
@@ -0,0 +1,69 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/* Host replacement of include/net/lwip/arch/cc.h. The types are the ones of
+ * the target, except mem_ptr_t which has to hold a pointer of the host.
+ */
+
+#ifndef __CC_H__
+#define __CC_H__
+
+#include <assert.h>
+#include <debug.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <net/lwip/arch/cpu.h>
+
+/* Declared before the lwIP headers on the target */
+struct netif;
+struct netconn;
+struct pollfd;
+
+/* Declared by sys/types.h of the target */
+typedef unsigned int socklen_t;
+
+typedef uint8_t u8_t;
+typedef int8_t s8_t;
+typedef uint16_t u16_t;
+typedef int16_t s16_t;
+typedef uint32_t u32_t;
+typedef int32_t s32_t;
+typedef uintptr_t mem_ptr_t;
+typedef int sys_prot_t;
+
+#define U16_F "hu"
+#define S16_F "d"
+#define X16_F "hx"
+#define U32_F "u"
+#define S32_F "d"
+#define X32_F "x"
+#define SZT_F "zu"
+
+#define PACK_STRUCT_BEGIN
+#define PACK_STRUCT_STRUCT __attribute__ ((__packed__))
+#define PACK_STRUCT_END
+#define PACK_STRUCT_FIELD(x) x
+
+#define LWIP_PLATFORM_DIAG(msg) do { lwipdbg msg; } while (0)
+#define LWIP_STATS_DIAG(msg) do { printf msg; } while (0)
+#define LWIP_PLATFORM_ASSERT(x) do { fprintf(stderr, "lwIP assert \"%s\" at %s:%d\n", x, __FILE__, __LINE__); abort(); } while (0)
+
+#endif							/* __CC_H__ */
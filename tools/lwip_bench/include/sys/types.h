@@ -0,0 +1,31 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/* Host replacement of include/sys/types.h: the types of the host libc with
+ * the return values of the target
+ */
+
+#ifndef __TOOLS_LWIP_BENCH_SYS_TYPES_H
+#define __TOOLS_LWIP_BENCH_SYS_TYPES_H
+
+#include_next <sys/types.h>
+
+#define ERROR			-1
+#define OK			0
+
+#endif							/* __TOOLS_LWIP_BENCH_SYS_TYPES_H */
@@ -0,0 +1,50 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/* Host replacement of include/tinyara/fs/fs.h with the part of a file which
+ * net_sendfile() uses. The file functions of fs/vfs are in memfile.c.
+ */
+
+#ifndef __TOOLS_LWIP_BENCH_TINYARA_FS_FS_H
+#define __TOOLS_LWIP_BENCH_TINYARA_FS_FS_H
+
+#include <sys/types.h>
+
+struct file;
+
+struct file_operations {
+	int (*ioctl)(FAR struct file *filep, int cmd, unsigned long arg);
+};
+
+struct inode {
+	union {
+		FAR const struct file_operations *i_ops;
+	} u;
+};
+
+struct file {
+	int f_oflags;
+	off_t f_pos;
+	FAR struct inode *f_inode;
+	void *f_priv;
+};
+
+ssize_t file_read(FAR struct file *filep, FAR void *buf, size_t nbytes);
+off_t file_seek(FAR struct file *filep, off_t offset, int whence);
+
+#endif							/* __TOOLS_LWIP_BENCH_TINYARA_FS_FS_H */
@@ -0,0 +1,37 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/* Host replacement of include/tinyara/semaphore.h, the semaphores of the
+ * host have no priority inheritance to turn off
+ */
+
+#ifndef __TOOLS_LWIP_BENCH_TINYARA_SEMAPHORE_H
+#define __TOOLS_LWIP_BENCH_TINYARA_SEMAPHORE_H
+
+#include <semaphore.h>
+
+#define SEM_PRIO_NONE		0
+#define SEM_PRIO_INHERIT	1
+#define SEM_PRIO_PROTECT	2
+
+static inline int sem_setprotocol(sem_t *sem, int protocol)
+{
+	return 0;
+}
+
+#endif							/* __TOOLS_LWIP_BENCH_TINYARA_SEMAPHORE_H */
@@ -0,0 +1,1040 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/* Host benchmark of the TizenRT lwIP configuration.
+ *
+ * Two netifs of one stack are connected by the in-memory link of memlink.c
+ * and the raw API runs in the tcpip thread, as the socket layer does on the
+ * target. The workloads are:
+ *   - "bulk"     : one TCP connection sending as fast as the window allows
+ *   - "rr"       : TCP request / response, one transaction in flight
+ *   - "udp"      : a flood of UDP datagrams
+ *   - "dgram"    : small datagrams between two UDP sockets, with
+ *                  lwip_sendto() or lwip_sendmmsg() and lwip_recvmmsg()
+ *   - "file"     : a file sent to a TCP socket through a user buffer as
+ *                  lib_sendfile() does, then with net_sendfile()
+ * Each one reports its rate, the process CPU time per payload byte and the
+ * high-water marks of the heap and the memp pools while it ran.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#include <net/lwip/opt.h>
+#include <net/lwip/init.h>
+#include <net/lwip/pbuf.h>
+#include <net/lwip/memp.h>
+#include <net/lwip/sockets.h>
+#include <net/lwip/stats.h>
+#include <net/lwip/tcp.h>
+#include <net/lwip/udp.h>
+#include <net/lwip/tcpip.h>
+#include <net/lwip/priv/tcpip_priv.h>
+#include <net/lwip/timeouts.h>
+#include <tinyara/net/net.h>
+
+#include "memfile.h"
+#include "memlink.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BENCH_BULK_PORT		5001
+#define BENCH_RR_PORT		5002
+#define BENCH_UDP_PORT		5003
+
+#define BENCH_CHUNK		16384
+#define BENCH_UDP_BURST		32
+#define BENCH_MAX_SAMPLES	(1024 * 1024)
+#define BENCH_DRAIN_SECS	30
+#define BENCH_DGRAM_BATCH	8
+#define BENCH_DGRAM_MAXBATCH	64
+
+/* sendfile(): the file and the buffer of the read()/write() loop of
+ * lib_sendfile() (CONFIG_LIB_SENDFILE_BUFSIZE). The chunks of
+ * net_sendfile() come from bench.config.
+ */
+
+#define BENCH_FILE_SIZE		(256 * 1024)
+#define BENCH_FILE_COPYBUF	512
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct bench_call_s {
+	tcpip_callback_fn func;
+	void *arg;
+	sem_t done;
+};
+
+enum bench_file_e {
+	BENCH_SENDFILE_COPY,		/* read() into a user buffer, then write() */
+	BENCH_SENDFILE_CHUNK,		/* net_sendfile() through its kernel chunks */
+	BENCH_SENDFILE_MMAP,		/* net_sendfile() from the media */
+	BENCH_SENDFILE_MODES
+};
+
+struct bench_s {
+	/* Options */
+
+	int secs;
+	int reqsize;
+	int respsize;
+	int udpsize;
+	int dgramsize;
+	int dgrambatch;
+	struct memlink_param_s link;
+
+	/* State of the running workload, shared with the tcpip thread */
+
+	volatile int running;
+	volatile int done;
+	volatile int error;
+	struct tcp_pcb *listener;
+	struct tcp_pcb *client;
+	struct udp_pcb *usender;
+	struct udp_pcb *ureceiver;
+	uint64_t first;
+	uint64_t last;
+	uint64_t bytes;
+	uint64_t sent;
+	uint64_t received;
+	int pending;
+	uint64_t start;
+	uint32_t *samples;
+	uint32_t nsamples;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct bench_s g_bench;
+static ip4_addr_t g_addr[2];
+static u8_t g_data[BENCH_CHUNK];
+static u8_t g_rxdata[BENCH_CHUNK];
+static u8_t g_file[BENCH_FILE_SIZE];
+static u8_t g_copybuf[BENCH_FILE_COPYBUF];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint64_t bench_usec(clockid_t clock)
+{
+	struct timespec ts;
+
+	clock_gettime(clock, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static uint64_t bench_now(void)
+{
+	return bench_usec(CLOCK_MONOTONIC);
+}
+
+static void bench_call_func(void *arg)
+{
+	struct bench_call_s *call = arg;
+
+	call->func(call->arg);
+	sem_post(&call->done);
+}
+
+/* Run func in the tcpip thread and wait until it returns */
+
+static void bench_call(tcpip_callback_fn func, void *arg)
+{
+	struct bench_call_s call;
+
+	call.func = func;
+	call.arg = arg;
+	sem_init(&call.done, 0, 0);
+	tcpip_callback(bench_call_func, &call);
+	while (sem_wait(&call.done) != 0) ;
+	sem_destroy(&call.done);
+}
+
+static int bench_wait_done(int secs)
+{
+	uint64_t end = bench_now() + (uint64_t)secs * 1000000;
+
+	while (!g_bench.done && bench_now() < end) {
+		usleep(1000);
+	}
+	return g_bench.done ? 0 : -1;
+}
+
+static void bench_reset(void *arg)
+{
+	int i;
+
+	g_bench.running = 1;
+	g_bench.done = 0;
+	g_bench.error = 0;
+	g_bench.first = 0;
+	g_bench.last = 0;
+	g_bench.bytes = 0;
+	g_bench.sent = 0;
+	g_bench.received = 0;
+	g_bench.pending = 0;
+	g_bench.nsamples = 0;
+
+	/* The high-water marks count from the current use on */
+
+	lwip_stats.mem.max = lwip_stats.mem.used;
+	for (i = 0; i < MEMP_MAX; i++) {
+		lwip_stats.memp[i]->max = lwip_stats.memp[i]->used;
+	}
+}
+
+static void bench_stop(void *arg)
+{
+	g_bench.running = 0;
+}
+
+static void bench_report(uint64_t cpu, uint64_t bytes)
+{
+	struct memlink_stats_s link;
+	int i;
+
+	memlink_get_stats(&link, 1);
+
+	printf("  cpu: %.2f ns/byte (%llu ms for %llu bytes)\n", bytes ? cpu * 1000.0 / bytes : 0.0, (unsigned long long)cpu / 1000, (unsigned long long)bytes);
+	printf("  link: %u frames, %u lost, %u reordered, %u queue drops, %u no pbuf, %u input drops, queue max %u\n", link.frames, link.lost, link.reordered, link.qdrops, link.nobufs, link.indrops, link.qmax);
+	printf("  high-water: heap %u of %u bytes", (unsigned)lwip_stats.mem.max, (unsigned)lwip_stats.mem.avail);
+	for (i = 0; i < MEMP_MAX; i++) {
+		if (lwip_stats.memp[i]->max == 0) {
+			continue;
+		}
+		/* The pools come from the heap with MEMP_MEM_MALLOC, no limit */
+		if (lwip_stats.memp[i]->avail != 0) {
+			printf(", %s %u/%u", lwip_stats.memp[i]->name, (unsigned)lwip_stats.memp[i]->max, (unsigned)lwip_stats.memp[i]->avail);
+		} else {
+			printf(", %s %u", lwip_stats.memp[i]->name, (unsigned)lwip_stats.memp[i]->max);
+		}
+	}
+	printf("\n");
+}
+
+static void bench_tcp_err(void *arg, err_t err)
+{
+	if (arg == &g_bench.client) {
+		g_bench.client = NULL;
+	}
+	g_bench.error = err;
+	g_bench.done = 1;
+}
+
+/* The pcbs of the previous run may still hold the port with a delay */
+
+static void bench_listen(u16_t port, tcp_accept_fn accept)
+{
+	struct tcp_pcb *pcb;
+
+	pcb = tcp_new();
+	ip_set_option(pcb, SOF_REUSEADDR);
+	tcp_bind(pcb, &g_addr[1], port);
+	g_bench.listener = tcp_listen(pcb);
+	tcp_accept(g_bench.listener, accept);
+}
+
+static void bench_sockaddr(struct sockaddr_in *sin, const ip4_addr_t *addr, u16_t port)
+{
+	memset(sin, 0, sizeof(*sin));
+	sin->sin_len = sizeof(*sin);
+	sin->sin_family = AF_INET;
+	sin->sin_port = lwip_htons(port);
+	sin->sin_addr.s_addr = ip4_addr_get_u32(addr);
+}
+
+/* A socket of the application bound to one end of the link */
+
+static int bench_socket(int type, const ip4_addr_t *addr, u16_t port)
+{
+	struct sockaddr_in sin;
+	int s;
+
+	s = lwip_socket(AF_INET, type, 0);
+	if (s < 0) {
+		return -1;
+	}
+	bench_sockaddr(&sin, addr, port);
+	if (lwip_bind(s, (struct sockaddr *)&sin, sizeof(sin)) < 0) {
+		lwip_close(s);
+		return -1;
+	}
+	return s;
+}
+
+/****************************************************************************
+ * Bulk TCP
+ ****************************************************************************/
+
+static void bulk_fill(struct tcp_pcb *pcb)
+{
+	u16_t len;
+
+	while (g_bench.running) {
+		len = tcp_sndbuf(pcb);
+		if (len > BENCH_CHUNK) {
+			len = BENCH_CHUNK;
+		}
+		if (len == 0 || tcp_write(pcb, g_data, len, TCP_WRITE_FLAG_COPY) != ERR_OK) {
+			break;
+		}
+	}
+	tcp_output(pcb);
+}
+
+static err_t bulk_sent(void *arg, struct tcp_pcb *pcb, u16_t len)
+{
+	bulk_fill(pcb);
+	return ERR_OK;
+}
+
+static err_t bulk_connected(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+	tcp_sent(pcb, bulk_sent);
+	bulk_fill(pcb);
+	return ERR_OK;
+}
+
+static err_t bulk_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+	if (p == NULL) {
+		g_bench.last = bench_now();
+		/* The end of this connection must not fail the next run */
+		tcp_err(pcb, NULL);
+		tcp_recv(pcb, NULL);
+		tcp_close(pcb);
+		g_bench.done = 1;
+		return ERR_OK;
+	}
+
+	if (g_bench.first == 0) {
+		g_bench.first = bench_now();
+	}
+	g_bench.bytes += p->tot_len;
+	tcp_recved(pcb, p->tot_len);
+	pbuf_free(p);
+	return ERR_OK;
+}
+
+static err_t bulk_accept(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+	tcp_err(pcb, bench_tcp_err);
+	tcp_recv(pcb, bulk_recv);
+	return ERR_OK;
+}
+
+static void bulk_start(void *arg)
+{
+	bench_listen(BENCH_BULK_PORT, bulk_accept);
+
+	g_bench.client = tcp_new();
+	tcp_arg(g_bench.client, &g_bench.client);
+	tcp_err(g_bench.client, bench_tcp_err);
+	tcp_bind(g_bench.client, &g_addr[0], 0);
+	tcp_connect(g_bench.client, &g_addr[1], BENCH_BULK_PORT, bulk_connected);
+}
+
+/* Stop writing, the close sends the FIN behind the queued data */
+
+static void bulk_stop(void *arg)
+{
+	g_bench.running = 0;
+	if (g_bench.client != NULL) {
+		tcp_sent(g_bench.client, NULL);
+		tcp_err(g_bench.client, NULL);
+		tcp_close(g_bench.client);
+		g_bench.client = NULL;
+	}
+}
+
+static void bench_close_listener(void *arg)
+{
+	if (g_bench.listener != NULL) {
+		tcp_close(g_bench.listener);
+		g_bench.listener = NULL;
+	}
+}
+
+static void bench_bulk(void)
+{
+	uint64_t cpu;
+	uint64_t usecs;
+
+	printf("bulk TCP:\n");
+	bench_call(bench_reset, NULL);
+	cpu = bench_usec(CLOCK_PROCESS_CPUTIME_ID);
+	bench_call(bulk_start, NULL);
+	sleep(g_bench.secs);
+	bench_call(bulk_stop, NULL);
+	if (bench_wait_done(BENCH_DRAIN_SECS) != 0 || g_bench.error != ERR_OK) {
+		printf("  failed, error %d\n", g_bench.error);
+	}
+	cpu = bench_usec(CLOCK_PROCESS_CPUTIME_ID) - cpu;
+	bench_call(bench_close_listener, NULL);
+
+	usecs = g_bench.last > g_bench.first ? g_bench.last - g_bench.first : 1;
+	printf("  %.1f Mbps, %llu bytes in %.2f s\n", g_bench.bytes * 8.0 / usecs, (unsigned long long)g_bench.bytes, usecs / 1e6);
+	bench_report(cpu, g_bench.bytes);
+}
+
+/****************************************************************************
+ * sendfile() to TCP
+ ****************************************************************************/
+
+/* The loop of lib_sendfile(), with file_read() and lwip_write() in place
+ * of read() and write() on the descriptors.
+ */
+
+static ssize_t file_copy(int s, struct file *filep, size_t count)
+{
+	size_t ntransferred = 0;
+	ssize_t nread;
+	ssize_t nwritten;
+	ssize_t off;
+
+	while (ntransferred < count) {
+		nread = file_read(filep, g_copybuf, BENCH_FILE_COPYBUF);
+		if (nread <= 0) {
+			break;
+		}
+		for (off = 0; off < nread; off += nwritten) {
+			nwritten = lwip_write(s, g_copybuf + off, nread - off);
+			if (nwritten < 0) {
+				return ntransferred > 0 ? (ssize_t)ntransferred : -1;
+			}
+		}
+		ntransferred += (size_t)nread;
+	}
+	return (ssize_t)ntransferred;
+}
+
+static void file_listen(void *arg)
+{
+	bench_listen(BENCH_BULK_PORT, bulk_accept);
+}
+
+/* The whole file is sent over and over from the application thread. The
+ * receiving end is the one of bulk, on the raw API.
+ */
+
+static void bench_file(void)
+{
+	static const char *names[BENCH_SENDFILE_MODES] = {
+		"read()/write() through a user buffer",
+		"net_sendfile(), kernel chunks sent by reference",
+		"net_sendfile(), by reference from the media (FIOC_MMAP)"
+	};
+	struct memfile_s mf;
+	struct file *filep;
+	struct sockaddr_in to;
+	uint64_t cpu;
+	uint64_t usecs;
+	uint64_t end;
+	off_t offset;
+	ssize_t ret;
+	int mode;
+	int s;
+
+	printf("sendfile TCP (%d chunks of %d bytes):\n", CONFIG_NET_SENDFILE_NCHUNKS, CONFIG_NET_SENDFILE_CHUNKSIZE);
+	for (mode = 0; mode < BENCH_SENDFILE_MODES; mode++) {
+		printf(" %s:\n", names[mode]);
+		bench_call(bench_reset, NULL);
+		bench_call(file_listen, NULL);
+		cpu = bench_usec(CLOCK_PROCESS_CPUTIME_ID);
+
+		s = bench_socket(SOCK_STREAM, &g_addr[0], 0);
+		bench_sockaddr(&to, &g_addr[1], BENCH_BULK_PORT);
+		if (s < 0 || lwip_connect(s, (struct sockaddr *)&to, sizeof(to)) < 0) {
+			printf("  no connection, errno %d\n", errno);
+			if (s >= 0) {
+				lwip_close(s);
+			}
+			bench_call(bench_close_listener, NULL);
+			continue;
+		}
+
+		filep = memfile_open(&mf, g_file, BENCH_FILE_SIZE, mode == BENCH_SENDFILE_MMAP);
+		end = bench_now() + (uint64_t)g_bench.secs * 1000000;
+		while (bench_now() < end) {
+			if (mode == BENCH_SENDFILE_COPY) {
+				file_seek(filep, 0, SEEK_SET);
+				ret = file_copy(s, filep, BENCH_FILE_SIZE);
+			} else {
+				offset = 0;
+				ret = net_sendfile(s, filep, &offset, BENCH_FILE_SIZE);
+			}
+			if (ret != BENCH_FILE_SIZE) {
+				printf("  sent %ld of %d bytes, errno %d\n", (long)ret, BENCH_FILE_SIZE, errno);
+				break;
+			}
+		}
+
+		/* The close sends the FIN behind the queued data */
+
+		lwip_close(s);
+		if (bench_wait_done(BENCH_DRAIN_SECS) != 0 || g_bench.error != ERR_OK) {
+			printf("  failed, error %d\n", g_bench.error);
+		}
+		cpu = bench_usec(CLOCK_PROCESS_CPUTIME_ID) - cpu;
+		bench_call(bench_close_listener, NULL);
+
+		usecs = g_bench.last > g_bench.first ? g_bench.last - g_bench.first : 1;
+		printf("  %.1f Mbps, %llu bytes in %.2f s\n", g_bench.bytes * 8.0 / usecs, (unsigned long long)g_bench.bytes, usecs / 1e6);
+		bench_report(cpu, g_bench.bytes);
+	}
+}
+
+/****************************************************************************
+ * TCP request / response
+ ****************************************************************************/
+
+static void rr_request(struct tcp_pcb *pcb)
+{
+	g_bench.pending = g_bench.respsize;
+	g_bench.start = bench_now();
+	tcp_write(pcb, g_data, g_bench.reqsize, TCP_WRITE_FLAG_COPY);
+	tcp_output(pcb);
+}
+
+static err_t rr_client_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+	if (p == NULL) {
+		g_bench.done = 1;
+		return ERR_OK;
+	}
+
+	g_bench.bytes += p->tot_len;
+	g_bench.pending -= p->tot_len;
+	tcp_recved(pcb, p->tot_len);
+	pbuf_free(p);
+	if (g_bench.pending > 0) {
+		return ERR_OK;
+	}
+
+	if (g_bench.nsamples < BENCH_MAX_SAMPLES) {
+		g_bench.samples[g_bench.nsamples++] = (uint32_t)(bench_now() - g_bench.start);
+	}
+	if (g_bench.running && g_bench.nsamples < BENCH_MAX_SAMPLES) {
+		rr_request(pcb);
+	} else {
+		tcp_recv(pcb, NULL);
+		tcp_close(pcb);
+		g_bench.client = NULL;
+		g_bench.done = 1;
+	}
+	return ERR_OK;
+}
+
+static err_t rr_server_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+	int *received = arg;
+
+	if (p == NULL) {
+		tcp_arg(pcb, NULL);
+		tcp_recv(pcb, NULL);
+		tcp_close(pcb);
+		free(received);
+		return ERR_OK;
+	}
+
+	g_bench.bytes += p->tot_len;
+	*received += p->tot_len;
+	tcp_recved(pcb, p->tot_len);
+	pbuf_free(p);
+	while (*received >= g_bench.reqsize) {
+		*received -= g_bench.reqsize;
+		tcp_write(pcb, g_data, g_bench.respsize, TCP_WRITE_FLAG_COPY);
+	}
+	tcp_output(pcb);
+	return ERR_OK;
+}
+
+static err_t rr_accept(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+	int *received;
+
+	received = calloc(1, sizeof(*received));
+	if (received == NULL) {
+		return ERR_MEM;
+	}
+	tcp_nagle_disable(pcb);
+	tcp_arg(pcb, received);
+	tcp_recv(pcb, rr_server_recv);
+	return ERR_OK;
+}
+
+static err_t rr_connected(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+	tcp_recv(pcb, rr_client_recv);
+	rr_request(pcb);
+	return ERR_OK;
+}
+
+static void rr_start(void *arg)
+{
+	bench_listen(BENCH_RR_PORT, rr_accept);
+
+	g_bench.client = tcp_new();
+	tcp_nagle_disable(g_bench.client);
+	tcp_arg(g_bench.client, &g_bench.client);
+	tcp_err(g_bench.client, bench_tcp_err);
+	tcp_bind(g_bench.client, &g_addr[0], 0);
+	tcp_connect(g_bench.client, &g_addr[1], BENCH_RR_PORT, rr_connected);
+}
+
+static int bench_cmp_u32(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+static void bench_rr(void)
+{
+	uint64_t cpu;
+	uint32_t n;
+
+	printf("TCP request/response (%d / %d bytes):\n", g_bench.reqsize, g_bench.respsize);
+	bench_call(bench_reset, NULL);
+	cpu = bench_usec(CLOCK_PROCESS_CPUTIME_ID);
+	bench_call(rr_start, NULL);
+	sleep(g_bench.secs);
+	bench_call(bench_stop, NULL);
+	if (bench_wait_done(BENCH_DRAIN_SECS) != 0 || g_bench.error != ERR_OK) {
+		printf("  failed, error %d\n", g_bench.error);
+	}
+	cpu = bench_usec(CLOCK_PROCESS_CPUTIME_ID) - cpu;
+	bench_call(bench_close_listener, NULL);
+
+	n = g_bench.nsamples;
+	if (n == 0) {
+		printf("  no transactions\n");
+		return;
+	}
+	qsort(g_bench.samples, n, sizeof(uint32_t), bench_cmp_u32);
+	printf("  %u transactions, %.0f per second\n", n, n / (double)g_bench.secs);
+	printf("  rtt: p50 %u us, p90 %u us, p99 %u us, max %u us\n", g_bench.samples[n / 2], g_bench.samples[(uint64_t)n * 90 / 100], g_bench.samples[(uint64_t)n * 99 / 100], g_bench.samples[n - 1]);
+	bench_report(cpu, g_bench.bytes);
+}
+
+/****************************************************************************
+ * UDP flood
+ ****************************************************************************/
+
+static void udp_flood(void *arg);
+
+static void udp_flood_timeout(void *arg)
+{
+	udp_flood(arg);
+}
+
+/* Send a burst and queue the next one behind the packets which came in
+ * meanwhile, so that the receiver gets its share of the tcpip thread.
+ */
+
+static void udp_flood(void *arg)
+{
+	struct pbuf *p;
+	int i;
+
+	if (!g_bench.running) {
+		return;
+	}
+
+	for (i = 0; i < BENCH_UDP_BURST; i++) {
+		p = pbuf_alloc(PBUF_TRANSPORT, g_bench.udpsize, PBUF_RAM);
+		if (p == NULL) {
+			break;
+		}
+		pbuf_take(p, g_data, g_bench.udpsize);
+		if (udp_sendto(g_bench.usender, p, &g_addr[1], BENCH_UDP_PORT) == ERR_OK) {
+			g_bench.sent++;
+		}
+		pbuf_free(p);
+	}
+
+	if (tcpip_callback_with_block(udp_flood, NULL, 0) != ERR_OK) {
+		sys_timeout(1, udp_flood_timeout, NULL);
+	}
+}
+
+static void udp_recv_cb(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port)
+{
+	g_bench.received++;
+	g_bench.bytes += p->tot_len;
+	pbuf_free(p);
+}
+
+static void udp_start(void *arg)
+{
+	g_bench.ureceiver = udp_new();
+	udp_bind(g_bench.ureceiver, &g_addr[1], BENCH_UDP_PORT);
+	udp_recv(g_bench.ureceiver, udp_recv_cb, NULL);
+
+	g_bench.usender = udp_new();
+	udp_bind(g_bench.usender, &g_addr[0], 0);
+
+	g_bench.first = bench_now();
+	udp_flood(NULL);
+}
+
+static void udp_end(void *arg)
+{
+	udp_remove(g_bench.usender);
+	udp_remove(g_bench.ureceiver);
+	g_bench.usender = NULL;
+	g_bench.ureceiver = NULL;
+}
+
+static void bench_udp(void)
+{
+	uint64_t cpu;
+	uint64_t usecs;
+	uint64_t received;
+
+	printf("UDP flood (%d bytes):\n", g_bench.udpsize);
+	bench_call(bench_reset, NULL);
+	cpu = bench_usec(CLOCK_PROCESS_CPUTIME_ID);
+	bench_call(udp_start, NULL);
+	sleep(g_bench.secs);
+	bench_call(bench_stop, NULL);
+	usecs = bench_now() - g_bench.first;
+
+	/* Let the datagrams on the link come in */
+
+	usleep(g_bench.link.delay_us * 2 + 100000);
+	cpu = bench_usec(CLOCK_PROCESS_CPUTIME_ID) - cpu;
+	bench_call(udp_end, NULL);
+
+	received = g_bench.received;
+	printf("  sent %.0f pps, received %.0f pps, %.1f Mbps, %.2f%% lost\n", g_bench.sent * 1e6 / usecs, received * 1e6 / usecs, g_bench.bytes * 8.0 / usecs, g_bench.sent ? (g_bench.sent - received) * 100.0 / g_bench.sent : 0.0);
+	bench_report(cpu, g_bench.bytes);
+}
+
+/****************************************************************************
+ * Datagram rate
+ ****************************************************************************/
+
+/* Drain the receiving socket with recvmmsg(), waiting for the first
+ * datagram of each call only.
+ */
+
+static void *dgram_receiver(void *arg)
+{
+	struct mmsghdr msgs[BENCH_DGRAM_MAXBATCH];
+	struct iovec iov;
+	int s = *(int *)arg;
+	int ret;
+	int i;
+
+	iov.iov_base = g_rxdata;
+	iov.iov_len = sizeof(g_rxdata);
+	memset(msgs, 0, sizeof(msgs));
+	for (i = 0; i < BENCH_DGRAM_MAXBATCH; i++) {
+		msgs[i].msg_hdr.msg_iov = &iov;
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	for (;;) {
+		ret = lwip_recvmmsg(s, msgs, BENCH_DGRAM_MAXBATCH, MSG_WAITFORONE, NULL);
+		if (ret <= 0) {
+			if (!g_bench.running) {
+				break;
+			}
+			continue;
+		}
+		g_bench.received += ret;
+		for (i = 0; i < ret; i++) {
+			g_bench.bytes += msgs[i].msg_len;
+		}
+	}
+	return NULL;
+}
+
+/* The application thread sends with lwip_sendto(), or lwip_sendmmsg() for
+ * a batch of more than one datagram, and a second one receives them. The
+ * datagrams the receive mailbox of the socket has no room for are lost.
+ */
+
+static void dgram_run(int batch)
+{
+	struct mmsghdr msgs[BENCH_DGRAM_MAXBATCH];
+	struct sockaddr_in to;
+	struct timeval tv;
+	struct iovec iov;
+	pthread_t receiver;
+	uint64_t cpu;
+	uint64_t usecs;
+	uint64_t end;
+	uint64_t calls = 0;
+	int sender;
+	int rs;
+	int ret;
+	int i;
+
+	printf("  batch %d%s:\n", batch, batch == 1 ? " (sendto)" : " (sendmmsg)");
+	bench_call(bench_reset, NULL);
+	rs = bench_socket(SOCK_DGRAM, &g_addr[1], BENCH_UDP_PORT);
+	sender = bench_socket(SOCK_DGRAM, &g_addr[0], 0);
+	if (rs < 0 || sender < 0) {
+		printf("  no socket\n");
+		if (rs >= 0) {
+			lwip_close(rs);
+		}
+		return;
+	}
+
+	/* The receiver checks for the end of the run between datagrams */
+
+	tv.tv_sec = 0;
+	tv.tv_usec = 100000;
+	lwip_setsockopt(rs, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+	bench_sockaddr(&to, &g_addr[1], BENCH_UDP_PORT);
+	iov.iov_base = g_data;
+	iov.iov_len = g_bench.dgramsize;
+	memset(msgs, 0, sizeof(msgs));
+	for (i = 0; i < batch; i++) {
+		msgs[i].msg_hdr.msg_name = &to;
+		msgs[i].msg_hdr.msg_namelen = sizeof(to);
+		msgs[i].msg_hdr.msg_iov = &iov;
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	pthread_create(&receiver, NULL, dgram_receiver, &rs);
+	cpu = bench_usec(CLOCK_PROCESS_CPUTIME_ID);
+	g_bench.first = bench_now();
+	end = g_bench.first + (uint64_t)g_bench.secs * 1000000;
+
+	while (bench_now() < end) {
+		if (batch == 1) {
+			if (lwip_sendto(sender, g_data, g_bench.dgramsize, 0, (struct sockaddr *)&to, sizeof(to)) >= 0) {
+				g_bench.sent++;
+			}
+		} else {
+			ret = lwip_sendmmsg(sender, msgs, batch, 0);
+			if (ret > 0) {
+				g_bench.sent += ret;
+			}
+		}
+		calls++;
+	}
+	usecs = bench_now() - g_bench.first;
+
+	/* Let the datagrams on the link come in */
+
+	usleep(g_bench.link.delay_us * 2 + 100000);
+	bench_call(bench_stop, NULL);
+	pthread_join(receiver, NULL);
+	cpu = bench_usec(CLOCK_PROCESS_CPUTIME_ID) - cpu;
+	lwip_close(sender);
+	lwip_close(rs);
+
+	printf("  %llu calls, sent %.0f pps, received %.0f pps, %.0f ns cpu/datagram\n", (unsigned long long)calls, g_bench.sent * 1e6 / usecs, g_bench.received * 1e6 / usecs, g_bench.sent ? cpu * 1000.0 / g_bench.sent : 0.0);
+	bench_report(cpu, g_bench.bytes);
+}
+
+static void bench_dgram(void)
+{
+	printf("Datagram rate (%d bytes):\n", g_bench.dgramsize);
+	dgram_run(1);
+	if (g_bench.dgrambatch > 1) {
+		dgram_run(g_bench.dgrambatch);
+	}
+}
+
+/****************************************************************************
+ * Setup
+ ****************************************************************************/
+
+static void bench_tcpip_ready(void *arg)
+{
+	ip4_addr_t netmask;
+
+	IP4_ADDR(&g_addr[0], 10, 0, 0, 1);
+	IP4_ADDR(&g_addr[1], 10, 0, 0, 2);
+	IP4_ADDR(&netmask, 255, 255, 255, 0);
+	if (memlink_init(&g_addr[0], &g_addr[1], &netmask) != 0) {
+		fprintf(stderr, "memlink_init failed\n");
+		exit(EXIT_FAILURE);
+	}
+	sem_post((sem_t *)arg);
+}
+
+static void show_usage(const char *progname)
+{
+	fprintf(stderr, "USAGE: %s [options] [bulk] [rr] [udp] [dgram] [file]\n", progname);
+	fprintf(stderr, "  -t secs     : duration of each workload (default 3)\n");
+	fprintf(stderr, "  -d ms       : one way delay of the link (default 0)\n");
+	fprintf(stderr, "  -l percent  : frame loss (default 0)\n");
+	fprintf(stderr, "  -r percent  : frames held back behind the next ones (default 0)\n");
+	fprintf(stderr, "  -b kbps     : link rate, 0 for no limit (default 0)\n");
+	fprintf(stderr, "  -q frames   : frames queued per direction before drops (default 256)\n");
+	fprintf(stderr, "  -s seed     : seed of the loss and reordering (default 1)\n");
+	fprintf(stderr, "  -m bytes    : request size of rr (default 64)\n");
+	fprintf(stderr, "  -M bytes    : response size of rr (default 1024)\n");
+	fprintf(stderr, "  -u bytes    : datagram size of udp (default 1024)\n");
+	fprintf(stderr, "  -U bytes    : datagram size of dgram (default 64)\n");
+	fprintf(stderr, "  -g count    : datagrams per sendmmsg() call of dgram (default %d)\n", BENCH_DGRAM_BATCH);
+	exit(EXIT_FAILURE);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* As net/socket/bsd_socket_api.c on the target, for net_sendfile() */
+
+int getsockopt(int s, int level, int optname, void *optval, socklen_t *optlen)
+{
+	return lwip_getsockopt(s, level, optname, optval, optlen);
+}
+
+int main(int argc, char **argv)
+{
+	sem_t ready;
+	int opt;
+	int i;
+	int all;
+
+	g_bench.secs = 3;
+	g_bench.reqsize = 64;
+	g_bench.respsize = 1024;
+	g_bench.udpsize = 1024;
+	g_bench.dgramsize = 64;
+	g_bench.dgrambatch = BENCH_DGRAM_BATCH;
+	g_bench.link.qlimit = 256;
+	g_bench.link.seed = 1;
+
+	while ((opt = getopt(argc, argv, "t:d:l:r:b:q:s:m:M:u:U:g:h")) != -1) {
+		switch (opt) {
+		case 't':
+			g_bench.secs = atoi(optarg);
+			break;
+		case 'd':
+			g_bench.link.delay_us = (uint32_t)(atof(optarg) * 1000);
+			break;
+		case 'l':
+			g_bench.link.loss = atof(optarg);
+			break;
+		case 'r':
+			g_bench.link.reorder = atof(optarg);
+			break;
+		case 'b':
+			g_bench.link.rate_kbps = atoi(optarg);
+			break;
+		case 'q':
+			g_bench.link.qlimit = atoi(optarg);
+			break;
+		case 's':
+			g_bench.link.seed = atoi(optarg);
+			break;
+		case 'm':
+			g_bench.reqsize = atoi(optarg);
+			break;
+		case 'M':
+			g_bench.respsize = atoi(optarg);
+			break;
+		case 'u':
+			g_bench.udpsize = atoi(optarg);
+			break;
+		case 'U':
+			g_bench.dgramsize = atoi(optarg);
+			break;
+		case 'g':
+			g_bench.dgrambatch = atoi(optarg);
+			break;
+		default:
+			show_usage(argv[0]);
+		}
+	}
+	if (g_bench.secs <= 0 || g_bench.reqsize <= 0 || g_bench.respsize <= 0 || g_bench.udpsize <= 0 || g_bench.udpsize > 65000 || g_bench.dgramsize <= 0 || g_bench.dgramsize > BENCH_CHUNK || g_bench.dgrambatch <= 0 || g_bench.dgrambatch > BENCH_DGRAM_MAXBATCH) {
+		show_usage(argv[0]);
+	}
+
+	g_bench.samples = malloc(BENCH_MAX_SAMPLES * sizeof(uint32_t));
+	if (g_bench.samples == NULL) {
+		return EXIT_FAILURE;
+	}
+	for (i = 0; i < BENCH_CHUNK; i++) {
+		g_data[i] = (u8_t)i;
+	}
+	for (i = 0; i < BENCH_FILE_SIZE; i++) {
+		g_file[i] = (u8_t)(i * 7);
+	}
+
+	/* As net_setup() and net_initialize() do on the target */
+
+	lwip_init();
+	sem_init(&ready, 0, 0);
+	tcpip_init(bench_tcpip_ready, &ready);
+	while (sem_wait(&ready) != 0) ;
+	memlink_set_param(&g_bench.link);
+
+	printf("link: delay %.1f ms, loss %.2f%%, reorder %.2f%%, rate %u kbps (0 for no limit), queue %u frames\n", g_bench.link.delay_us / 1000.0, g_bench.link.loss, g_bench.link.reorder, g_bench.link.rate_kbps, g_bench.link.qlimit);
+	printf("lwIP: TCP_MSS %d, TCP_WND %d, TCP_SND_BUF %d, PBUF_POOL_SIZE %d, SACK %s\n", TCP_MSS, TCP_WND, TCP_SND_BUF, PBUF_POOL_SIZE, LWIP_TCP_SACK ? "on" : "off");
+
+	all = optind == argc;
+	for (i = optind; i <= argc; i++) {
+		const char *name = i < argc ? argv[i] : NULL;
+
+		if (all || (name != NULL && strcmp(name, "bulk") == 0)) {
+			bench_bulk();
+		}
+		if (all || (name != NULL && strcmp(name, "rr") == 0)) {
+			bench_rr();
+		}
+		if (all || (name != NULL && strcmp(name, "udp") == 0)) {
+			bench_udp();
+		}
+		if (all || (name != NULL && strcmp(name, "dgram") == 0)) {
+			bench_dgram();
+		}
+		if (all || (name != NULL && strcmp(name, "file") == 0)) {
+			bench_file();
+		}
+		if (all) {
+			break;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,117 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/* Host port of the file functions of fs/vfs which net_sendfile() calls, for
+ * a file in memory.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/ioctl.h>
+
+#include "memfile.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int memfile_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+	struct memfile_s *mf = filep->f_priv;
+
+	if (cmd != FIOC_MMAP) {
+		return -ENOTTY;
+	}
+	*(FAR const uint8_t **)arg = mf->data;
+	return OK;
+}
+
+static const struct file_operations g_memfile_mmap_ops = {
+	memfile_ioctl
+};
+
+static const struct file_operations g_memfile_ops = {
+	NULL
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+struct file *memfile_open(struct memfile_s *mf, const uint8_t *data, size_t size, int mmap)
+{
+	memset(mf, 0, sizeof(*mf));
+	mf->data = data;
+	mf->size = size;
+	mf->inode.u.i_ops = mmap ? &g_memfile_mmap_ops : &g_memfile_ops;
+	mf->file.f_inode = &mf->inode;
+	mf->file.f_priv = mf;
+	return &mf->file;
+}
+
+ssize_t file_read(FAR struct file *filep, FAR void *buf, size_t nbytes)
+{
+	struct memfile_s *mf = filep->f_priv;
+
+	if (filep->f_pos >= (off_t)mf->size) {
+		return 0;
+	}
+	if (nbytes > mf->size - (size_t)filep->f_pos) {
+		nbytes = mf->size - (size_t)filep->f_pos;
+	}
+	memcpy(buf, mf->data + filep->f_pos, nbytes);
+	filep->f_pos += (off_t)nbytes;
+	return (ssize_t)nbytes;
+}
+
+off_t file_seek(FAR struct file *filep, off_t offset, int whence)
+{
+	struct memfile_s *mf = filep->f_priv;
+	off_t pos;
+
+	switch (whence) {
+	case SEEK_SET:
+		pos = offset;
+		break;
+	case SEEK_CUR:
+		pos = filep->f_pos + offset;
+		break;
+	case SEEK_END:
+		pos = (off_t)mf->size + offset;
+		break;
+	default:
+		set_errno(EINVAL);
+		return (off_t)ERROR;
+	}
+	if (pos < 0) {
+		set_errno(EINVAL);
+		return (off_t)ERROR;
+	}
+	filep->f_pos = pos;
+	return pos;
+}
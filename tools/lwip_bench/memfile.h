@@ -1,6 +1,6 @@
 /****************************************************************************
  *
- * Copyright 2017 Samsung Electronics All Rights Reserved.
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
  *
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
@@ -15,63 +15,41 @@
  * language governing permissions and limitations under the License.
  *
  ****************************************************************************/
-/**
- * @defgroup TTRACE_LIBC TTRACE
- * @ingroup KERNEL
- *
- * @{
- */
 
-///@file tinyara/ringbuf.h
-///@brief ttrace ringbuffer APIs
+/* In-memory file for net_sendfile() in the host build */
 
-#ifndef __INCLUDE_TINYARA_TTRACE_RINGBUF_H
-#define __INCLUDE_TINYARA_TTRACE_RINGBUF_H
+#ifndef __TOOLS_LWIP_BENCH_MEMFILE_H
+#define __TOOLS_LWIP_BENCH_MEMFILE_H
 
 /****************************************************************************
  * Included Files
  ****************************************************************************/
 
-#include <tinyara/config.h>
-
-#include <stdio.h>
+#include <stddef.h>
 #include <stdint.h>
-#include <stdarg.h>
-#include <stdbool.h>
-#include <debug.h>
-#include <time.h>
-#include <sys/types.h>
+
+#include <tinyara/fs/fs.h>
 
 /****************************************************************************
- * Public Type Declarations
+ * Public Types
  ****************************************************************************/
 
-struct ringbuf {
-	char buffer[CONFIG_TTRACE_BUFSIZE];
-	size_t bufsize;
-	uint16_t index;
-	int is_overwritten;
-	int is_overwritable;
+struct memfile_s {
+	struct file file;			/* Given to net_sendfile() */
+	struct inode inode;
+	const uint8_t *data;
+	size_t size;
 };
 
-/****************************************************************************
- * Public Variables
- ****************************************************************************/
-
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
-#if defined(__cplusplus)
-extern "C" {
-#endif
+/* Open data as a file at position 0. With mmap set the file answers
+ * FIOC_MMAP as a ROMFS file on XIP flash does, so that it is sent from the
+ * media.
+ */
 
-void printBuf(char *buf, struct ringbuf *rbp);
-ssize_t ringbuf_write(FAR const char *buffer, size_t len, struct ringbuf *rbp);
-ssize_t ringbuf_read(char *buffer, size_t len, struct ringbuf *rbp);
+struct file *memfile_open(struct memfile_s *mf, const uint8_t *data, size_t size, int mmap);
 
-#if defined(__cplusplus)
-}
-#endif
-#endif							/* __INCLUDE_TINYARA_TTRACE_RINGBUF_H */
-/** @} */
+#endif							/* __TOOLS_LWIP_BENCH_MEMFILE_H */
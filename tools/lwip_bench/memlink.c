@@ -0,0 +1,329 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/* In-memory link between two netifs of one lwIP stack.
+ *
+ * A frame sent on either netif is copied out of its pbufs and queued for the
+ * other end with the configured delay, serialization rate, loss and
+ * reordering. The link thread hands each frame to netif->input of the
+ * receiving end in a new PBUF_POOL chain when it is due, as the Ethernet
+ * drivers do from their receive path.
+ *
+ * Both ends live in the same stack and share a subnet, so ip4_route() alone
+ * would send everything on the first netif of the list. memlink_route() is
+ * the LWIP_HOOK_IP4_ROUTE_SRC of the host build and sends on the netif
+ * which owns the source address instead.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+#include <net/lwip/opt.h>
+#include <net/lwip/pbuf.h>
+#include <net/lwip/netif.h>
+#include <net/lwip/tcpip.h>
+
+#include "memlink.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MEMLINK_MTU		1500
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct memlink_frame_s {
+	struct memlink_frame_s *flink;
+	uint64_t due;				/* Delivery time in us */
+	int end;					/* Receiving end */
+	u16_t len;
+	u8_t data[];
+};
+
+struct memlink_s {
+	struct netif netif[2];
+	struct memlink_param_s param;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	struct memlink_frame_s *head;	/* Frames in the order they are due */
+	struct memlink_frame_s *tail;
+	uint32_t queued[2];
+	uint64_t busy_until[2];		/* End of the last frame on the wire */
+	struct memlink_stats_s stats;
+	pthread_t thread;
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* Kept by netif_add() for the netdev layer of the target */
+
+struct netif *g_netdevices;
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct memlink_s g_link;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint64_t memlink_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int memlink_chance(double percent)
+{
+	return percent > 0 && rand_r(&g_link.param.seed) < percent / 100 * ((double)RAND_MAX + 1);
+}
+
+/* Insert in due order, behind the frames due at the same time */
+
+static void memlink_enqueue(struct memlink_frame_s *frame)
+{
+	struct memlink_frame_s **prev;
+
+	frame->flink = NULL;
+	if (g_link.tail == NULL || g_link.tail->due <= frame->due) {
+		if (g_link.tail != NULL) {
+			g_link.tail->flink = frame;
+		} else {
+			g_link.head = frame;
+		}
+		g_link.tail = frame;
+		return;
+	}
+
+	for (prev = &g_link.head; (*prev)->due <= frame->due; prev = &(*prev)->flink) ;
+	frame->flink = *prev;
+	*prev = frame;
+}
+
+static err_t memlink_output(struct netif *netif, struct pbuf *p, const ip4_addr_t *ipaddr)
+{
+	struct memlink_frame_s *frame;
+	uint64_t now;
+	uint64_t start;
+	int end;
+
+	end = netif == &g_link.netif[0] ? 1 : 0;
+
+	frame = malloc(sizeof(*frame) + p->tot_len);
+	if (frame == NULL) {
+		return ERR_MEM;
+	}
+	frame->end = end;
+	frame->len = pbuf_copy_partial(p, frame->data, p->tot_len, 0);
+
+	pthread_mutex_lock(&g_link.lock);
+	if (memlink_chance(g_link.param.loss)) {
+		g_link.stats.lost++;
+		pthread_mutex_unlock(&g_link.lock);
+		free(frame);
+		return ERR_OK;
+	}
+	if (g_link.param.qlimit != 0 && g_link.queued[end] >= g_link.param.qlimit) {
+		g_link.stats.qdrops++;
+		pthread_mutex_unlock(&g_link.lock);
+		free(frame);
+		return ERR_OK;
+	}
+
+	now = memlink_now();
+	start = now;
+	if (g_link.param.rate_kbps != 0) {
+		if (g_link.busy_until[end] > start) {
+			start = g_link.busy_until[end];
+		}
+		g_link.busy_until[end] = start + (uint64_t)frame->len * 8000 / g_link.param.rate_kbps;
+		start = g_link.busy_until[end];
+	}
+	frame->due = start + g_link.param.delay_us;
+
+	/* Held back for one more delay, at least 1 ms, so that the frames sent
+	 * meanwhile overtake it.
+	 */
+	if (memlink_chance(g_link.param.reorder)) {
+		frame->due += g_link.param.delay_us > 1000 ? g_link.param.delay_us : 1000;
+		g_link.stats.reordered++;
+	}
+
+	memlink_enqueue(frame);
+	if (++g_link.queued[end] > g_link.stats.qmax) {
+		g_link.stats.qmax = g_link.queued[end];
+	}
+	pthread_cond_signal(&g_link.cond);
+	pthread_mutex_unlock(&g_link.lock);
+
+	return ERR_OK;
+}
+
+static void memlink_deliver(struct memlink_frame_s *frame)
+{
+	struct netif *netif = &g_link.netif[frame->end];
+	struct pbuf *p;
+
+	p = pbuf_alloc(PBUF_RAW, frame->len, PBUF_POOL);
+	if (p == NULL) {
+		pthread_mutex_lock(&g_link.lock);
+		g_link.stats.nobufs++;
+		pthread_mutex_unlock(&g_link.lock);
+		return;
+	}
+	pbuf_take(p, frame->data, frame->len);
+
+	if (netif->input(p, netif) != ERR_OK) {
+		pbuf_free(p);
+		pthread_mutex_lock(&g_link.lock);
+		g_link.stats.indrops++;
+		pthread_mutex_unlock(&g_link.lock);
+		return;
+	}
+
+	pthread_mutex_lock(&g_link.lock);
+	g_link.stats.frames++;
+	g_link.stats.bytes += frame->len;
+	pthread_mutex_unlock(&g_link.lock);
+}
+
+static void *memlink_thread(void *arg)
+{
+	struct memlink_frame_s *frame;
+	struct timespec ts;
+	uint64_t now;
+
+	pthread_mutex_lock(&g_link.lock);
+	for (;;) {
+		frame = g_link.head;
+		if (frame == NULL) {
+			pthread_cond_wait(&g_link.cond, &g_link.lock);
+			continue;
+		}
+
+		now = memlink_now();
+		if (frame->due > now) {
+			ts.tv_sec = frame->due / 1000000;
+			ts.tv_nsec = (frame->due % 1000000) * 1000;
+			pthread_cond_timedwait(&g_link.cond, &g_link.lock, &ts);
+			continue;
+		}
+
+		g_link.head = frame->flink;
+		if (g_link.head == NULL) {
+			g_link.tail = NULL;
+		}
+		g_link.queued[frame->end]--;
+		pthread_mutex_unlock(&g_link.lock);
+
+		memlink_deliver(frame);
+		free(frame);
+
+		pthread_mutex_lock(&g_link.lock);
+	}
+
+	return NULL;
+}
+
+static err_t memlink_netif_init(struct netif *netif)
+{
+	netif->name[0] = 'm';
+	netif->name[1] = 'l';
+	netif->mtu = MEMLINK_MTU;
+	netif->output = memlink_output;
+	netif->flags = NETIF_FLAG_LINK_UP;
+	return ERR_OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int memlink_init(const ip4_addr_t *addr0, const ip4_addr_t *addr1, const ip4_addr_t *netmask)
+{
+	pthread_condattr_t attr;
+	int end;
+
+	pthread_mutex_init(&g_link.lock, NULL);
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&g_link.cond, &attr);
+	pthread_condattr_destroy(&attr);
+
+	for (end = 0; end < 2; end++) {
+		if (netif_add(&g_link.netif[end], end == 0 ? addr0 : addr1, netmask, IP4_ADDR_ANY4, NULL, memlink_netif_init, tcpip_input) == NULL) {
+			return -1;
+		}
+		netif_set_up(&g_link.netif[end]);
+	}
+
+	return pthread_create(&g_link.thread, NULL, memlink_thread, NULL) == 0 ? 0 : -1;
+}
+
+struct netif *memlink_route(const ip4_addr_t *dest, const ip4_addr_t *src)
+{
+	int end;
+
+	for (end = 0; end < 2; end++) {
+		if (ip4_addr_cmp(src, netif_ip4_addr(&g_link.netif[end])) && ip4_addr_cmp(dest, netif_ip4_addr(&g_link.netif[end ^ 1]))) {
+			return &g_link.netif[end];
+		}
+	}
+	return NULL;
+}
+
+struct netif *memlink_netif(int end)
+{
+	return &g_link.netif[end];
+}
+
+void memlink_set_param(const struct memlink_param_s *param)
+{
+	pthread_mutex_lock(&g_link.lock);
+	g_link.param = *param;
+	pthread_mutex_unlock(&g_link.lock);
+}
+
+void memlink_get_stats(struct memlink_stats_s *stats, int reset)
+{
+	pthread_mutex_lock(&g_link.lock);
+	*stats = g_link.stats;
+	if (reset) {
+		memset(&g_link.stats, 0, sizeof(g_link.stats));
+		g_link.stats.qmax = g_link.queued[0] > g_link.queued[1] ? g_link.queued[0] : g_link.queued[1];
+	}
+	pthread_mutex_unlock(&g_link.lock);
+}
@@ -0,0 +1,82 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/* In-memory link between two lwIP netifs of the host build */
+
+#ifndef __TOOLS_LWIP_BENCH_MEMLINK_H
+#define __TOOLS_LWIP_BENCH_MEMLINK_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+
+#include <net/lwip/netif.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Behaviour of the link, the same in both directions */
+
+struct memlink_param_s {
+	uint32_t delay_us;			/* One way delay */
+	uint32_t rate_kbps;			/* Serialization rate, 0 for no limit */
+	uint32_t qlimit;			/* Frames waiting per direction before tail drop */
+	double loss;				/* Percentage of frames lost */
+	double reorder;				/* Percentage of frames held back behind the next ones */
+	unsigned int seed;			/* Seed of the loss and reorder decisions */
+};
+
+struct memlink_stats_s {
+	uint32_t frames;			/* Frames delivered */
+	uint64_t bytes;				/* Bytes delivered */
+	uint32_t lost;				/* Frames lost on purpose */
+	uint32_t reordered;			/* Frames held back */
+	uint32_t qdrops;			/* Frames dropped at the tail of a full queue */
+	uint32_t nobufs;			/* Frames dropped for no PBUF_POOL buffer */
+	uint32_t indrops;			/* Frames refused by netif->input */
+	uint32_t qmax;				/* Most frames waiting in one direction */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* Add the two netifs and start the thread which delivers the frames. It has
+ * to run in the tcpip thread, end 0 gets addr0 and end 1 gets addr1.
+ */
+
+int memlink_init(const ip4_addr_t *addr0, const ip4_addr_t *addr1, const ip4_addr_t *netmask);
+
+/* Route a packet from the address of one end to the other one on the netif
+ * of the sending end, NULL for ip4_route() to decide.
+ */
+
+struct netif *memlink_route(const ip4_addr_t *dest, const ip4_addr_t *src);
+
+struct netif *memlink_netif(int end);
+
+void memlink_set_param(const struct memlink_param_s *param);
+
+/* Copy the counters and clear them when reset is set */
+
+void memlink_get_stats(struct memlink_stats_s *stats, int reset);
+
+#endif							/* __TOOLS_LWIP_BENCH_MEMLINK_H */
@@ -0,0 +1,304 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/* Host port of the lwIP operating system abstraction (os/net/lwip/sys/arch).
+ *
+ * The mailbox keeps the ring and counting semaphore of the target port, the
+ * interrupt masking around the ring is a mutex here. Threads are pthreads
+ * and sys_now() is CLOCK_MONOTONIC in milliseconds.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <net/lwip/opt.h>
+#include <net/lwip/sys.h>
+#include <net/lwip/stats.h>
+
+#include <tinyara/clock.h>
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Stands for irqsave() around the mailbox rings */
+
+static pthread_mutex_t g_mbox_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Stands for sched_lock() of SYS_ARCH_PROTECT, which may nest */
+
+static pthread_mutex_t g_protect_lock;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void *sys_mbox_take(sys_mbox_t *mbox)
+{
+	void *msg;
+
+	pthread_mutex_lock(&g_mbox_lock);
+	LWIP_ASSERT("mbox->count > 0", mbox->count > 0);
+	msg = mbox->msgs[mbox->front];
+	if (++mbox->front >= mbox->queue_size) {
+		mbox->front = 0;
+	}
+	mbox->count--;
+	pthread_mutex_unlock(&g_mbox_lock);
+
+	return msg;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void sys_init(void)
+{
+	pthread_mutexattr_t attr;
+
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&g_protect_lock, &attr);
+	pthread_mutexattr_destroy(&attr);
+}
+
+u32_t sys_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+err_t sys_sem_new(sys_sem_t *sem, u8_t count)
+{
+	if (sem_init(sem, 0, count) != 0) {
+		SYS_STATS_INC(sem.err);
+		return ERR_MEM;
+	}
+	SYS_STATS_INC_USED(sem);
+	return ERR_OK;
+}
+
+u32_t sys_arch_sem_wait(sys_sem_t *sem, u32_t timeout)
+{
+	u32_t start = sys_now();
+	struct timespec abstime;
+
+	if (timeout == 0) {
+		while (sem_wait(sem) != 0) {
+			LWIP_ASSERT("errno == EINTR", errno == EINTR);
+		}
+		return sys_now() - start;
+	}
+
+	clock_gettime(CLOCK_REALTIME, &abstime);
+	abstime.tv_sec += timeout / 1000;
+	abstime.tv_nsec += (timeout % 1000) * 1000000;
+	if (abstime.tv_nsec >= 1000000000) {
+		abstime.tv_sec++;
+		abstime.tv_nsec -= 1000000000;
+	}
+	while (sem_timedwait(sem, &abstime) != 0) {
+		if (errno == ETIMEDOUT) {
+			return SYS_ARCH_TIMEOUT;
+		}
+		LWIP_ASSERT("errno == EINTR", errno == EINTR);
+	}
+	return sys_now() - start;
+}
+
+void sys_sem_signal(sys_sem_t *sem)
+{
+	sem_post(sem);
+}
+
+void sys_sem_free(sys_sem_t *sem)
+{
+	if (sem_destroy(sem) == 0) {
+		SYS_STATS_DEC(sem.used);
+	}
+}
+
+int sys_sem_valid(sys_sem_t *sem)
+{
+	return sem != SYS_SEM_NULL;
+}
+
+void sys_sem_set_invalid(sys_sem_t *sem)
+{
+}
+
+err_t sys_mbox_new(sys_mbox_t *mbox, int queue_sz)
+{
+	if (queue_sz <= 0 || queue_sz > SYS_MBOX_MAXSIZE) {
+		queue_sz = SYS_MBOX_MAXSIZE;
+	}
+
+	mbox->is_valid = 1;
+	mbox->queue_size = queue_sz;
+	mbox->front = 0;
+	mbox->count = 0;
+	if (sys_sem_new(&(mbox->mail), 0) != ERR_OK) {
+		mbox->is_valid = 0;
+		return ERR_MEM;
+	}
+	SYS_STATS_INC_USED(mbox);
+	return ERR_OK;
+}
+
+void sys_mbox_free(sys_mbox_t *mbox)
+{
+	LWIP_ASSERT("mbox is empty", mbox->count == 0);
+	sys_sem_free(&(mbox->mail));
+	mbox->is_valid = 0;
+	SYS_STATS_DEC(mbox.used);
+}
+
+err_t sys_mbox_trypost(sys_mbox_t *mbox, void *msg)
+{
+	u32_t rear;
+
+	pthread_mutex_lock(&g_mbox_lock);
+	if (mbox->count >= mbox->queue_size) {
+		pthread_mutex_unlock(&g_mbox_lock);
+		SYS_STATS_INC(mbox.err);
+		return ERR_MEM;
+	}
+
+	rear = mbox->front + mbox->count;
+	if (rear >= mbox->queue_size) {
+		rear -= mbox->queue_size;
+	}
+	mbox->msgs[rear] = msg;
+	mbox->count++;
+	pthread_mutex_unlock(&g_mbox_lock);
+
+	sys_sem_signal(&(mbox->mail));
+	return ERR_OK;
+}
+
+void sys_mbox_post(sys_mbox_t *mbox, void *msg)
+{
+	while (sys_mbox_trypost(mbox, msg) != ERR_OK) {
+		usleep(USEC_PER_TICK);
+	}
+}
+
+u32_t sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout)
+{
+	u32_t time;
+	void *m;
+
+	time = sys_arch_sem_wait(&(mbox->mail), timeout);
+	if (time == SYS_ARCH_TIMEOUT) {
+		return time;
+	}
+
+	m = sys_mbox_take(mbox);
+	if (msg != NULL) {
+		*msg = m;
+	}
+	return time;
+}
+
+u32_t sys_arch_mbox_tryfetch(sys_mbox_t *mbox, void **msg)
+{
+	void *m;
+
+	if (mbox->count == 0 || sem_trywait(&(mbox->mail)) != 0) {
+		return SYS_MBOX_EMPTY;
+	}
+
+	m = sys_mbox_take(mbox);
+	if (msg != NULL) {
+		*msg = m;
+	}
+	return ERR_OK;
+}
+
+int sys_mbox_valid(sys_mbox_t *mbox)
+{
+	return mbox->is_valid == 1;
+}
+
+void sys_mbox_set_invalid(sys_mbox_t *mbox)
+{
+	mbox->is_valid = 0;
+}
+
+struct sys_thread_arg_s {
+	lwip_thread_fn entry;
+	void *arg;
+};
+
+static void *sys_thread_start(void *data)
+{
+	struct sys_thread_arg_s start = *(struct sys_thread_arg_s *)data;
+
+	free(data);
+	start.entry(start.arg);
+	return NULL;
+}
+
+sys_thread_t sys_thread_new(const char *name, lwip_thread_fn entry_function, void *arg, int stacksize, int priority)
+{
+	static sys_thread_t s_nextthread;
+	struct sys_thread_arg_s *start;
+	pthread_t thread;
+
+	start = malloc(sizeof(*start));
+	if (start == NULL) {
+		return -1;
+	}
+	start->entry = entry_function;
+	start->arg = arg;
+	if (pthread_create(&thread, NULL, sys_thread_start, start) != 0) {
+		free(start);
+		return -1;
+	}
+	pthread_detach(thread);
+	return ++s_nextthread;
+}
+
+sys_thread_t sys_kernel_thread_new(const char *name, lwip_thread_fn entry_function, void *arg, int stacksize, int priority)
+{
+	return sys_thread_new(name, entry_function, arg, stacksize, priority);
+}
+
+sys_prot_t sys_arch_protect(void)
+{
+	pthread_mutex_lock(&g_protect_lock);
+	return 1;
+}
+
+void sys_arch_unprotect(sys_prot_t p)
+{
+	pthread_mutex_unlock(&g_protect_lock);
+}
@@ -22,83 +22,263 @@
 #include <getopt.h>
 #include <string.h>
 
-#define CODE_VARIABLE        0
-#define CODE_UNIQUE         (1 << 7)
+#define MAGIC                0x43525454
+#define VERSION              2
 
-#define MSG_BYTES            32
-#define COMM_BYTES           12
-#define BYTE_ALIGN           4
+#define REC_BEGIN            1
+#define REC_BEGIN_UID        2
+#define REC_END              3
+#define REC_SCHED            4
+#define REC_BEGIN_STR        5
+#define REC_KEVENT           6
+
+#define KEV_IRQ_ENTER        1
+#define KEV_WORK_START       10
+
+#define VARINT_MAXBYTES      10
 
 #define INVALID -1
 #define VALID 0
 
-#define packed_struct __attribute__ ((packed))
-
 int param = 0;
 
-struct sched_message {
-	short prev_pid;
-	unsigned char prev_prio;
-	unsigned char prev_state;
-	char prev_comm[COMM_BYTES];
-	short next_pid;
-	unsigned char next_prio;
-	char pad;
-	char next_comm[COMM_BYTES];
+/* Little endian layout of struct ttrace_header_s and ttrace_task_s */
+
+struct trace_header {
+	unsigned int magic;
+	unsigned char version;
+	unsigned char hdrlen;
+	unsigned short ntasks;
+	unsigned int freq;
+	unsigned int ts_base_lo;
+	unsigned int ts_base_hi;
+	unsigned int dropped;
+	unsigned int strtab_len;
 };
 
-union trace_message {
-	char message[MSG_BYTES];	// 24B, message(192b)
-	struct sched_message sched_msg;
+struct trace_task {
+	unsigned short pid;
+	unsigned short strid;
 };
 
-struct trace_packet {			// total 40 byte(message), 16byte(uid)
-	int tv_sec;
-	int tv_nsec;
-	short pid;					// 2B, int16_t(16b)
-	char event_type;			// 1B, char(8b)
-	unsigned char codelen;		// 1B, code(1b) + variable length(7b) or uid(7b)
-	int pad;
-	union trace_message msg;
+struct trace_capture {
+	const struct trace_header *hdr;
+	const unsigned char *strtab;
+	const struct trace_task *tasks;
+	unsigned long long ts;
 };
 
-static int print_uid_packet(struct trace_packet *packet)
+static int get_varint(const unsigned char *buf, int len, unsigned long long *v)
+{
+	unsigned long long val = 0;
+	int n;
+
+	for (n = 0; n < len && n < VARINT_MAXBYTES; n++) {
+		val |= (unsigned long long)(buf[n] & 0x7f) << (7 * n);
+		if ((buf[n] & 0x80) == 0) {
+			*v = val;
+			return n + 1;
+		}
+	}
+	return 0;
+}
+
+static int find_string(const struct trace_capture *cap, unsigned long long id, const char **str)
+{
+	unsigned int off = 0;
+
+	while (off < cap->hdr->strtab_len) {
+		if (--id == 0) {
+			*str = (const char *)&cap->strtab[off + 1];
+			return cap->strtab[off];
+		}
+		off += 1 + cap->strtab[off];
+	}
+
+	*str = "unknown";
+	return strlen(*str);
+}
+
+static int find_task(const struct trace_capture *cap, unsigned long long pid, const char **name)
 {
-	unsigned char uid = packet->codelen & (unsigned char)(~CODE_UNIQUE);
-	printf("[%06d:%06d] %03u: %c|%u\r\n", packet->tv_sec, packet->tv_nsec / 1000, (unsigned int)packet->pid, (unsigned int)packet->event_type, uid);
-	return sizeof(struct trace_packet) - MSG_BYTES;
+	int i;
+
+	for (i = 0; i < cap->hdr->ntasks; i++) {
+		if (cap->tasks[i].pid == pid && cap->tasks[i].strid != 0) {
+			return find_string(cap, cap->tasks[i].strid, name);
+		}
+	}
+
+	*name = "unknown";
+	return strlen(*name);
 }
 
-static int print_message_packet(struct trace_packet *packet)
+/* Text of the kernel events by id, NULL for the end of a span */
+
+static const char *const kevent_formats[] = {
+	NULL,
+	"irq %u",
+	NULL,
+	"sem_block 0x%08x holder=%u",
+	"sem_wake 0x%08x pid=%u",
+	"prio_boost pid=%u prio=%u",
+	"prio_restore pid=%u prio=%u",
+	"mq_send_block 0x%08x",
+	"mq_recv_block 0x%08x",
+	"mq_wake 0x%08x pid=%u",
+	"work 0x%08x",
+	NULL,
+	"malloc 0x%08x size=%u",
+	"free 0x%08x size=%u",
+};
+
+/* A kernel event is a begin or an end, or both at the same time for the
+ * events without a duration.
+ */
+
+static int print_kevent(const unsigned char *rec, int len, unsigned int pid, unsigned long long usec)
 {
-	printf("[%06d:%06d] %03u: %c|%s\r\n", packet->tv_sec, packet->tv_nsec / 1000, (unsigned int)packet->pid, packet->event_type, packet->msg.message);
-	return sizeof(struct trace_packet);
+	unsigned long long arg0, arg1;
+	const char *fmt;
+	int n = 1, ret;
+
+	if (len < 1 || (ret = get_varint(&rec[n], len - n, &arg0)) == 0) {
+		return 0;
+	}
+	n += ret;
+	if ((ret = get_varint(&rec[n], len - n, &arg1)) == 0) {
+		return 0;
+	}
+	n += ret;
+
+	if (rec[0] == 0 || rec[0] >= sizeof(kevent_formats) / sizeof(kevent_formats[0])) {
+		printf("%03u: b|kevent %u %u %u\r\n", pid, rec[0], (unsigned int)arg0, (unsigned int)arg1);
+		return n;
+	}
+
+	fmt = kevent_formats[rec[0]];
+	if (fmt == NULL) {
+		printf("%03u: e|0\r\n", pid);
+		return n;
+	}
+
+	printf("%03u: b|", pid);
+	printf(fmt, (unsigned int)arg0, (unsigned int)arg1);
+	printf("\r\n");
+	if (rec[0] != KEV_IRQ_ENTER && rec[0] != KEV_WORK_START) {
+		printf("[%06u:%06u] %03u: e|0\r\n", (unsigned int)(usec / 1000000), (unsigned int)(usec % 1000000), pid);
+	}
+	return n;
 }
 
-static int print_sched_packet(struct trace_packet *packet)
+static int print_record(struct trace_capture *cap, const unsigned char *rec, int len)
 {
-	printf("[%06d:%06d] %03u: %c|prev_comm=%s prev_pid=%u prev_prio=%u prev_state=%u ==> next_comm=%s next_pid=%u next_prio=%u\r\n", packet->tv_sec, packet->tv_nsec / 1000, (unsigned int)packet->pid, packet->event_type, packet->msg.sched_msg.prev_comm, (unsigned int)packet->msg.sched_msg.prev_pid, (unsigned int)packet->msg.sched_msg.prev_prio, (unsigned int)packet->msg.sched_msg.prev_state, packet->msg.sched_msg.next_comm, (unsigned int)packet->msg.sched_msg.next_pid, (unsigned int)packet->msg.sched_msg.next_prio);
-	return sizeof(struct trace_packet);
+	unsigned long long delta, usec, pid, val, next_pid;
+	const char *str, *next_str;
+	int slen, next_slen, n, ret;
+
+	if (len < 2 || (ret = get_varint(&rec[1], len - 1, &delta)) == 0) {
+		return 0;
+	}
+	/* The delta is zigzag encoded, it can be negative */
+	delta = (delta >> 1) ^ -(delta & 1);
+	n = 1 + ret;
+	if ((ret = get_varint(&rec[n], len - n, &pid)) == 0) {
+		return 0;
+	}
+	n += ret;
+
+	cap->ts += delta;
+	usec = cap->ts * 1000000 / cap->hdr->freq;
+	printf("[%06u:%06u] ", (unsigned int)(usec / 1000000), (unsigned int)(usec % 1000000));
+
+	switch (rec[0]) {
+	case REC_BEGIN:
+		if ((ret = get_varint(&rec[n], len - n, &val)) == 0) {
+			return 0;
+		}
+		n += ret;
+		slen = find_string(cap, val, &str);
+		printf("%03u: b|%.*s\r\n", (unsigned int)pid, slen, str);
+		break;
+	case REC_BEGIN_STR:
+		if (n >= len || n + 1 + rec[n] > len) {
+			return 0;
+		}
+		printf("%03u: b|%.*s\r\n", (unsigned int)pid, rec[n], (const char *)&rec[n + 1]);
+		n += 1 + rec[n];
+		break;
+	case REC_BEGIN_UID:
+		if (n >= len) {
+			return 0;
+		}
+		printf("%03u: b|%u\r\n", (unsigned int)pid, rec[n]);
+		n += 1;
+		break;
+	case REC_END:
+		printf("%03u: e|0\r\n", (unsigned int)pid);
+		break;
+	case REC_SCHED:
+		if (n + 2 > len || (ret = get_varint(&rec[n + 2], len - n - 2, &next_pid)) == 0 || n + 2 + ret >= len) {
+			return 0;
+		}
+		slen = find_task(cap, pid, &str);
+		next_slen = find_task(cap, next_pid, &next_str);
+		printf("%03u: s|prev_comm=%.*s prev_pid=%u prev_prio=%u prev_state=%u ==> next_comm=%.*s next_pid=%u next_prio=%u\r\n", (unsigned int)pid, slen, str, (unsigned int)pid, rec[n], rec[n + 1], next_slen, next_str, (unsigned int)next_pid, rec[n + 2 + ret]);
+		n += 2 + ret + 1;
+		break;
+	case REC_KEVENT:
+		if ((ret = print_kevent(&rec[n], len - n, (unsigned int)pid, usec)) == 0) {
+			return 0;
+		}
+		n += ret;
+		break;
+	default:
+		return 0;
+	}
+
+	return n;
 }
 
-static int print_packet(struct trace_packet *packet)
+static int print_capture(const char *buffer, int len)
 {
-	int isSched = (packet->event_type == 's') ? 1 : 0;
-	int isUnique = (packet->codelen & CODE_UNIQUE);
+	struct trace_capture cap;
+	int offset, ret;
+
+	cap.hdr = (const struct trace_header *)buffer;
+	if (len < (int)sizeof(struct trace_header) || cap.hdr->magic != MAGIC || cap.hdr->version != VERSION || cap.hdr->freq == 0) {
+		fprintf(stderr, "Invalid trace header\r\n");
+		return INVALID;
+	}
+
+	offset = cap.hdr->hdrlen;
+	cap.strtab = (const unsigned char *)buffer + offset;
+	offset += cap.hdr->strtab_len;
+	cap.tasks = (const struct trace_task *)(buffer + offset);
+	offset += cap.hdr->ntasks * sizeof(struct trace_task);
+	cap.ts = ((unsigned long long)cap.hdr->ts_base_hi << 32) | cap.hdr->ts_base_lo;
+
+	if (offset > len) {
+		fprintf(stderr, "Truncated trace tables\r\n");
+		return INVALID;
+	}
 
-	if (isSched) {
-		return print_sched_packet(packet);
-	} else if (isUnique) {
-		return print_uid_packet(packet);
-	} else {
-		return print_message_packet(packet);
+	while (offset < len) {
+		ret = print_record(&cap, (const unsigned char *)buffer + offset, len - offset);
+		if (ret == 0) {
+			fprintf(stderr, "Broken record at %d\r\n", offset);
+			return INVALID;
+		}
+		offset += ret;
 	}
+
+	return VALID;
 }
 
 static void show_help()
 {
-	printf("usage: parse_dump [dumpfile]\r\n");
-	printf("example: ./parse_dump ramdump\r\n");
+	printf("usage: parse_dump [capturefile]\r\n");
+	printf("example: ./parse_dump trace.bin\r\n");
 }
 
 static int check_args_validation(int argc, char **args)
@@ -162,7 +342,7 @@ static void free_tracebuffer(char *buffer)
 static int read_tracebuffer(FILE *file, int bufsize)
 {
 	char *buffer = NULL;
-	int read_len = 0, offset = 0;
+	int read_len = 0, ret;
 
 	buffer = alloc_tracebuffer(bufsize);
 	if (buffer == NULL) {
@@ -175,12 +355,10 @@ static int read_tracebuffer(FILE *file, int bufsize)
 		return INVALID;
 	}
 
-	while (offset < read_len) {
-		offset += print_packet((struct trace_packet *)(buffer + offset));
-	}
+	ret = print_capture(buffer, read_len);
 
 	free_tracebuffer(buffer);
-	return VALID;
+	return ret;
 }
 
 int main(int argc, char **args)
@@ -0,0 +1,269 @@
+#!/usr/bin/env python
+###########################################################################
+#
+# Copyright 2019 Samsung Electronics All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+# either express or implied. See the License for the specific
+# language governing permissions and limitations under the License.
+#
+###########################################################################
+
+# Convert a binary T-trace capture (ttrace -w) into the Trace Event JSON
+# format which chrome://tracing and ui.perfetto.dev can open.
+
+from __future__ import print_function
+import json
+import optparse
+import os
+import struct
+import sys
+
+MAGIC = 0x43525454
+VERSION = 2
+
+REC_BEGIN = 1
+REC_BEGIN_UID = 2
+REC_END = 3
+REC_SCHED = 4
+REC_BEGIN_STR = 5
+REC_KEVENT = 6
+
+# Kernel events: name, names of the arguments, 'B'/'E' for the begin and
+# end of a span, 'i' for an event without a duration
+KEVENTS = {
+    1: ("irq", ("irq",), 'B'),
+    2: ("irq", ("irq",), 'E'),
+    3: ("sem_block", ("sem", "holder"), 'i'),
+    4: ("sem_wake", ("sem", "pid"), 'i'),
+    5: ("prio_boost", ("pid", "prio"), 'i'),
+    6: ("prio_restore", ("pid", "prio"), 'i'),
+    7: ("mq_send_block", ("msgq",), 'i'),
+    8: ("mq_recv_block", ("msgq",), 'i'),
+    9: ("mq_wake", ("msgq", "pid"), 'i'),
+    10: ("work", ("worker",), 'B'),
+    11: ("work", ("worker",), 'E'),
+    12: ("malloc", ("addr", "size"), 'i'),
+    13: ("free", ("addr", "size"), 'i'),
+}
+ADDRESS_ARGS = ("sem", "msgq", "worker", "addr")
+
+HEADER_FORMAT = '<IBBHIIIII'
+TASK_FORMAT = '<HH'
+
+TRACE_PID = 1       # Everything runs in one address space
+CPU_TID = 100000    # Pseudo thread which shows the running task
+IRQ_TID = 100001    # Pseudo thread which shows the interrupt handlers
+
+
+class TraceError(Exception):
+    pass
+
+
+class Capture:
+    def __init__(self, data):
+        self.data = bytearray(data)
+        hdrsize = struct.calcsize(HEADER_FORMAT)
+        if len(self.data) < hdrsize:
+            raise TraceError("capture is too short")
+
+        (magic, version, hdrlen, ntasks, self.freq, base_lo, base_hi,
+                self.dropped, strtab_len) = struct.unpack_from(
+                        HEADER_FORMAT, bytes(self.data), 0)
+        if magic != MAGIC or version != VERSION or self.freq == 0:
+            raise TraceError("not a T-trace capture")
+
+        self.ts = (base_hi << 32) | base_lo
+        self.strings = [None]
+        off = hdrlen
+        end = hdrlen + strtab_len
+        while off < end:
+            length = self.data[off]
+            self.strings.append(self.decode(self.data[off + 1:off + 1 + length]))
+            off += 1 + length
+
+        self.tasks = {}
+        tasksize = struct.calcsize(TASK_FORMAT)
+        for i in range(ntasks):
+            pid, strid = struct.unpack_from(TASK_FORMAT, bytes(self.data), off)
+            if strid != 0:
+                self.tasks[pid] = self.string(strid)
+            off += tasksize
+
+        if off > len(self.data):
+            raise TraceError("truncated trace tables")
+        self.offset = off
+
+    @staticmethod
+    def decode(raw):
+        return bytes(raw).decode('utf-8', 'replace')
+
+    def string(self, strid):
+        if 0 < strid < len(self.strings):
+            return self.strings[strid]
+        return "unknown"
+
+    def task(self, pid):
+        return self.tasks.get(pid, "unknown")
+
+    def varint(self):
+        val = 0
+        shift = 0
+        while True:
+            if self.offset >= len(self.data):
+                raise TraceError("broken record at %d" % self.offset)
+            byte = self.data[self.offset]
+            self.offset += 1
+            val |= (byte & 0x7f) << shift
+            if byte & 0x80 == 0:
+                return val
+            shift += 7
+
+    def byte(self):
+        if self.offset >= len(self.data):
+            raise TraceError("broken record at %d" % self.offset)
+        self.offset += 1
+        return self.data[self.offset - 1]
+
+    def usec(self):
+        return self.ts * 1000000.0 / self.freq
+
+    def records(self):
+        while self.offset < len(self.data):
+            rtype = self.byte()
+            delta = self.varint()
+            self.ts += (delta >> 1) ^ -(delta & 1)
+            pid = self.varint()
+            if rtype == REC_BEGIN:
+                yield rtype, pid, self.string(self.varint())
+            elif rtype == REC_BEGIN_STR:
+                length = self.byte()
+                text = self.data[self.offset:self.offset + length]
+                self.offset += length
+                yield rtype, pid, self.decode(text)
+            elif rtype == REC_BEGIN_UID:
+                yield rtype, pid, "uid %d" % self.byte()
+            elif rtype == REC_END:
+                yield rtype, pid, None
+            elif rtype == REC_SCHED:
+                prio = self.byte()
+                state = self.byte()
+                next_pid = self.varint()
+                next_prio = self.byte()
+                yield rtype, pid, (prio, state, next_pid, next_prio)
+            elif rtype == REC_KEVENT:
+                kid = self.byte()
+                arg0 = self.varint()
+                arg1 = self.varint()
+                yield rtype, pid, (kid, arg0, arg1)
+            else:
+                raise TraceError("unknown record type %d" % rtype)
+
+
+def kevent(arg, pid, ts):
+    kid, arg0, arg1 = arg
+    name, argnames, ph = KEVENTS.get(kid, ("kevent %d" % kid, ("arg0", "arg1"), 'i'))
+    args = {}
+    for argname, val in zip(argnames, (arg0, arg1)):
+        args[argname] = "0x%08x" % val if argname in ADDRESS_ARGS else val
+    if kid in (1, 2):
+        # Interrupts preempt the task, show them on their own thread
+        name = "irq %d" % arg0
+        args["pid"] = pid
+        pid = IRQ_TID
+    elif kid == 10:
+        name = "work %s" % args["worker"]
+    event = {"name": name, "ph": ph, "ts": ts, "pid": TRACE_PID, "tid": pid,
+            "args": args}
+    if ph == 'i':
+        event["s"] = "t"
+    return event
+
+
+def convert(capture):
+    events = []
+    running = None
+
+    events.append({"name": "process_name", "ph": "M", "pid": TRACE_PID,
+            "args": {"name": "TizenRT"}})
+    events.append({"name": "thread_name", "ph": "M", "pid": TRACE_PID,
+            "tid": CPU_TID, "args": {"name": "CPU"}})
+    events.append({"name": "thread_name", "ph": "M", "pid": TRACE_PID,
+            "tid": IRQ_TID, "args": {"name": "IRQ"}})
+    for pid, name in sorted(capture.tasks.items()):
+        events.append({"name": "thread_name", "ph": "M", "pid": TRACE_PID,
+                "tid": pid, "args": {"name": "%s-%d" % (name, pid)}})
+
+    for rtype, pid, arg in capture.records():
+        ts = capture.usec()
+        if rtype in (REC_BEGIN, REC_BEGIN_STR, REC_BEGIN_UID):
+            events.append({"name": arg, "ph": "B", "ts": ts,
+                    "pid": TRACE_PID, "tid": pid})
+        elif rtype == REC_END:
+            events.append({"ph": "E", "ts": ts, "pid": TRACE_PID, "tid": pid})
+        elif rtype == REC_SCHED:
+            prio, state, next_pid, next_prio = arg
+            if running is not None:
+                events.append({"name": capture.task(running[0]), "ph": "X",
+                        "ts": running[1], "dur": ts - running[1],
+                        "pid": TRACE_PID, "tid": CPU_TID,
+                        "args": {"pid": running[0], "prio": running[2],
+                            "state_out": state}})
+            running = (next_pid, ts, next_prio)
+        elif rtype == REC_KEVENT:
+            events.append(kevent(arg, pid, ts))
+
+    # Records collected from the user buffer can be older than the ones
+    # before them, the stable sort keeps the order of equal timestamps.
+    events.sort(key=lambda e: e.get("ts", -1))
+    return {"traceEvents": events, "displayTimeUnit": "ns",
+            "otherData": {"dropped": capture.dropped,
+                "frequency": capture.freq}}
+
+
+def main():
+    usage = "Usage: %prog -i [capturefile] -o [jsonfile]"
+    desc = "Example: %prog -i trace.bin -o trace.json"
+    parser = optparse.OptionParser(usage=usage, description=desc)
+    parser.add_option('-i', '--input', dest='inputFile',
+            metavar='FILENAME',
+            help="Binary capture saved by 'ttrace -w'")
+    parser.add_option('-o', '--output', dest='outputFile',
+            metavar='FILENAME',
+            help="JSON file to write, "
+            "[default: input file name with .json]")
+    options, args = parser.parse_args()
+
+    if options.inputFile is None:
+        parser.print_help()
+        return 1
+    if options.outputFile is None:
+        options.outputFile = os.path.splitext(options.inputFile)[0] + '.json'
+
+    with open(options.inputFile, 'rb') as capfile:
+        data = capfile.read()
+
+    try:
+        capture = Capture(data)
+        trace = convert(capture)
+    except TraceError as e:
+        print("%s: %s" % (options.inputFile, e), file=sys.stderr)
+        return 1
+
+    with open(options.outputFile, 'w') as jsonfile:
+        json.dump(trace, jsonfile)
+
+    print("%d events, %d dropped records -> %s" % (len(trace["traceEvents"]),
+            capture.dropped, options.outputFile))
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
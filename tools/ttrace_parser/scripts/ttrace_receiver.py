@@ -0,0 +1,270 @@
+#!/usr/bin/env python
+###########################################################################
+#
+# Copyright 2019 Samsung Electronics All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+# either express or implied. See the License for the specific
+# language governing permissions and limitations under the License.
+#
+###########################################################################
+
+# Receive the T-trace stream (CONFIG_TTRACE_STREAM) from a TCP connection,
+# a serial port or a file, and write it as rolling capture files which
+# ttrace_json.py and parse_dump can open.
+
+from __future__ import print_function
+import optparse
+import socket
+import struct
+import sys
+import time
+
+MAGIC = 0x43525454
+STREAM_MAGIC = 0x53525454
+VERSION = 2
+
+CHUNK_HEADER = 1
+CHUNK_STRINGS = 2
+CHUNK_TASKS = 3
+CHUNK_RECORDS = 4
+CHUNK_STATS = 5
+
+REC_BEGIN = 1
+REC_BEGIN_UID = 2
+REC_END = 3
+REC_SCHED = 4
+REC_BEGIN_STR = 5
+REC_KEVENT = 6
+
+CHUNK_FORMAT = '<IBBH'
+HEADER_FORMAT = '<IBBHIIIII'
+TASK_FORMAT = '<HH'
+STATS_FORMAT = '<IIIII'
+
+
+class StreamError(Exception):
+    pass
+
+
+def varint(data, off):
+    val = 0
+    shift = 0
+    while True:
+        if off >= len(data):
+            raise StreamError("broken record")
+        byte = data[off]
+        off += 1
+        val |= (byte & 0x7f) << shift
+        if byte & 0x80 == 0:
+            return val, off
+        shift += 7
+
+
+def skip_record(data, off):
+    """Return the timestamp delta of the record at off and its end."""
+    rtype = data[off]
+    delta, off = varint(data, off + 1)
+    pid, off = varint(data, off)
+    if rtype == REC_BEGIN:
+        strid, off = varint(data, off)
+    elif rtype == REC_BEGIN_STR:
+        off += 1 + data[off]
+    elif rtype == REC_BEGIN_UID:
+        off += 1
+    elif rtype == REC_SCHED:
+        next_pid, off = varint(data, off + 2)
+        off += 1
+    elif rtype == REC_KEVENT:
+        arg0, off = varint(data, off + 1)
+        arg1, off = varint(data, off)
+    elif rtype != REC_END:
+        raise StreamError("unknown record type %d" % rtype)
+    if off > len(data):
+        raise StreamError("broken record")
+    return (delta >> 1) ^ -(delta & 1), off
+
+
+class Receiver:
+    def __init__(self, prefix, max_bytes, max_secs):
+        self.prefix = prefix
+        self.max_bytes = max_bytes
+        self.max_secs = max_secs
+        self.pending = bytearray()
+        self.freq = 0
+        self.dropped = 0
+        self.strtab = bytearray()
+        self.tasks = {}
+        self.ts = 0
+        self.index = 0
+        self.records = None
+        self.skipped = 0
+
+    def start_file(self):
+        self.records = bytearray()
+        self.file_ts = self.ts
+        self.file_time = time.time()
+
+    def flush(self):
+        """Write the records received so far as one standalone capture."""
+        if not self.records:
+            self.records = None
+            return
+        name = "%s_%04d.bin" % (self.prefix, self.index)
+        self.index += 1
+        tasks = sorted(self.tasks.items())
+        hdr = struct.pack(HEADER_FORMAT, MAGIC, VERSION,
+                struct.calcsize(HEADER_FORMAT), len(tasks), self.freq,
+                self.file_ts & 0xffffffff, self.file_ts >> 32,
+                self.dropped, len(self.strtab))
+        with open(name, 'wb') as capfile:
+            capfile.write(hdr)
+            capfile.write(bytes(self.strtab))
+            for pid, strid in tasks:
+                capfile.write(struct.pack(TASK_FORMAT, pid, strid))
+            capfile.write(bytes(self.records))
+        print("%s: %d bytes of records" % (name, len(self.records)))
+        self.records = None
+
+    def full(self):
+        return (len(self.records) >= self.max_bytes or
+                (self.max_secs and time.time() - self.file_time >= self.max_secs))
+
+    def chunk(self, ctype, payload):
+        if ctype == CHUNK_HEADER:
+            (magic, version, hdrlen, ntasks, self.freq, base_lo, base_hi,
+                    self.dropped, strtab_len) = struct.unpack_from(
+                            HEADER_FORMAT, bytes(payload), 0)
+            if magic != MAGIC or version != VERSION:
+                raise StreamError("unsupported capture version %d" % version)
+            # The tables are sent again after every header
+            self.flush()
+            self.ts = (base_hi << 32) | base_lo
+            self.strtab = bytearray()
+            self.tasks = {}
+        elif ctype == CHUNK_STRINGS:
+            off = struct.unpack_from('<I', bytes(payload), 0)[0]
+            del self.strtab[off:]
+            self.strtab += payload[4:]
+        elif ctype == CHUNK_TASKS:
+            for off in range(0, len(payload), struct.calcsize(TASK_FORMAT)):
+                pid, strid = struct.unpack_from(TASK_FORMAT, bytes(payload), off)
+                if strid != 0:
+                    self.tasks[pid] = strid
+        elif ctype == CHUNK_RECORDS:
+            if self.freq == 0:
+                return
+            if self.records is None:
+                self.start_file()
+            elif self.full():
+                self.flush()
+                self.start_file()
+            off = 0
+            while off < len(payload):
+                delta, off = skip_record(payload, off)
+                self.ts += delta
+            self.records += payload
+        elif ctype == CHUNK_STATS:
+            sent, lost, errors, max_used, max_write = struct.unpack_from(
+                    STATS_FORMAT, bytes(payload), 0)
+            print("target: sent %d bytes, %d records lost, %d errors, "
+                    "max %d bytes waiting, longest write %d ms" %
+                    (sent, lost, errors, max_used, max_write))
+
+    def feed(self, data):
+        """Take the next bytes of the stream, in pieces of any size."""
+        self.pending += data
+        size = struct.calcsize(CHUNK_FORMAT)
+        while len(self.pending) >= size:
+            magic, ctype, reserved, length = struct.unpack_from(
+                    CHUNK_FORMAT, bytes(self.pending), 0)
+            if magic != STREAM_MAGIC:
+                # Lost bytes on a serial line, find the next chunk
+                del self.pending[0]
+                self.skipped += 1
+                continue
+            if len(self.pending) < size + length:
+                break
+            payload = self.pending[size:size + length]
+            del self.pending[:size + length]
+            try:
+                self.chunk(ctype, payload)
+            except (StreamError, struct.error) as e:
+                print("bad chunk: %s" % e, file=sys.stderr)
+
+
+def receive_tcp(receiver, port):
+    server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    server.bind(('', port))
+    server.listen(1)
+    print("Waiting for the target on port %d" % port)
+    while True:
+        conn, addr = server.accept()
+        print("Connected from %s:%d" % addr)
+        while True:
+            data = conn.recv(4096)
+            if not data:
+                break
+            receiver.feed(bytearray(data))
+        conn.close()
+        receiver.flush()
+        print("Disconnected")
+
+
+def receive_file(receiver, path):
+    # Unbuffered, so that a serial port is read as the bytes arrive
+    with open(path, 'rb', 0) as infile:
+        while True:
+            data = infile.read(4096)
+            if not data:
+                break
+            receiver.feed(bytearray(data))
+    receiver.flush()
+
+
+def main():
+    usage = "Usage: %prog [-p port | -i file] [-o prefix]"
+    desc = "Example: %prog -p 5555 -o trace -s 1048576"
+    parser = optparse.OptionParser(usage=usage, description=desc)
+    parser.add_option('-p', '--port', dest='port', type='int',
+            help="TCP port which the target connects to")
+    parser.add_option('-i', '--input', dest='inputFile',
+            metavar='FILENAME',
+            help="Stream file or serial device to read")
+    parser.add_option('-o', '--output', dest='prefix', default='trace',
+            help="Prefix of the capture files, [default: %default]")
+    parser.add_option('-s', '--size', dest='size', type='int',
+            default=1024 * 1024,
+            help="Record bytes in one capture file, [default: %default]")
+    parser.add_option('-t', '--time', dest='secs', type='int', default=0,
+            help="Seconds of trace in one capture file, [default: no limit]")
+    options, args = parser.parse_args()
+
+    if (options.port is None) == (options.inputFile is None):
+        parser.print_help()
+        return 1
+
+    receiver = Receiver(options.prefix, options.size, options.secs)
+    try:
+        if options.port is not None:
+            receive_tcp(receiver, options.port)
+        else:
+            receive_file(receiver, options.inputFile)
+    except KeyboardInterrupt:
+        receiver.flush()
+
+    if receiver.skipped:
+        print("%d bytes skipped to find chunks" % receiver.skipped)
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())